@@ -0,0 +1,70 @@
+// ============================================================================
+// Bench — results table, serial report and /user/bench.json
+// ============================================================================
+
+#include "bench.h"
+#include "display_ui.h"
+#include "sd_storage.h"
+#include <ArduinoJson.h>
+
+static const char* BENCH_JSON = "/user/bench.json";
+
+static BenchResult s_results[BENCH_MAX_RESULTS];
+static int         s_count = 0;
+
+static void keep(const BenchResult& r) {
+    if (s_count < BENCH_MAX_RESULTS) s_results[s_count++] = r;
+    else Serial.printf("[Bench] Table full — %s not saved\n", r.name);
+}
+
+void benchRecord(const BenchResult& r) {
+    uint32_t cpc = r.iters ? (uint32_t)(r.totalCycles / r.iters) : 0;
+    if (r.units)
+        Serial.printf("[Bench] %-24s %4u x  %10u cyc  %8u us  %8.1f cyc/%s\n", r.name,
+                      (unsigned)r.iters, (unsigned)cpc, (unsigned)(r.iters ? r.totalUs / r.iters : 0),
+                      (float)cpc / r.units, r.unit ? r.unit : "unit");
+    else
+        Serial.printf("[Bench] %-24s %4u x  %10u cyc  %8u us\n", r.name, (unsigned)r.iters,
+                      (unsigned)cpc, (unsigned)(r.iters ? r.totalUs / r.iters : 0));
+    keep(r);
+}
+
+void benchRecordMs(const char* name, uint32_t iters, uint32_t totalMs) {
+    BenchResult r = { name, iters, 0, 0, totalMs * 1000, 0, nullptr };
+    Serial.printf("[Bench] %-24s %4u x  %10s      %8u us\n", name, (unsigned)iters, "-",
+                  (unsigned)(iters ? r.totalUs / iters : 0));
+    keep(r);
+}
+
+bool benchFinish() {
+    DynamicJsonDocument doc(1024 + s_count * 192);
+    doc["firmware"] = FW_VERSION;
+    doc["built"]    = __DATE__ " " __TIME__;
+    doc["cpu_mhz"]  = getCpuFrequencyMhz();
+    JsonArray cases = doc.createNestedArray("cases");
+    for (int i = 0; i < s_count; i++) {
+        const BenchResult& r = s_results[i];
+        JsonObject c = cases.createNestedObject();
+        c["name"]  = r.name;
+        c["iters"] = r.iters;
+        c["us"]    = r.iters ? r.totalUs / r.iters : 0;
+        if (r.totalCycles) {
+            c["cycles"]     = (uint32_t)(r.totalCycles / r.iters);
+            c["min_cycles"] = r.minCycles;
+        }
+        if (r.units) {
+            c["units"] = r.units;
+            c["unit"]  = r.unit ? r.unit : "unit";
+        }
+    }
+
+    String json;
+    serializeJsonPretty(doc, json);
+    if (!sdMounted() || !sdWriteText(BENCH_JSON, json)) {
+        Serial.printf("[Bench] %d cases — no SD, %s not written\n", s_count, BENCH_JSON);
+        return false;
+    }
+    Serial.printf("[Bench] %d cases → %s (%u bytes)\n", s_count, BENCH_JSON,
+                  (unsigned)json.length());
+    return true;
+}
@@ -0,0 +1,61 @@
+// ============================================================================
+// Bench — cycle-counted microbenchmarks of the device's hot paths
+//
+// Built only by the `bench` environment (POD_BENCH), whose firmware
+// (bench_main.cpp) replaces main.cpp: it brings up the same hardware,
+// runs every case once at a fixed clock, prints each result and writes
+// the set to /user/bench.json so runs can be compared across versions.
+//
+//   benchRun("qr_encode_setup", 50, [&] { qrcode_initText(...); });
+//
+// Each call of the body is timed with the CPU cycle counter (32-bit: a
+// single call must stay under ~17 s at 240 MHz).  Cases inside modules
+// (displayBench(), audioBench()) use the same calls, so they can reach
+// static state.
+// ============================================================================
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+
+#define BENCH_MAX_RESULTS 48
+
+struct BenchResult {
+    const char* name;
+    uint32_t    iters;
+    uint32_t    minCycles;      // fastest single call
+    uint64_t    totalCycles;
+    uint32_t    totalUs;
+    uint32_t    units;          // work items per call (frames, bytes…); 0 = n/a
+    const char* unit;
+};
+
+// Record a measured case (benchRun() does this for you)
+void benchRecord(const BenchResult& r);
+
+// Time `iters` calls of `fn`.  `units` work items per call adds a
+// cycles-per-unit column (e.g. per output frame).
+template <typename F>
+void benchRun(const char* name, uint32_t iters, F fn, uint32_t units = 0,
+              const char* unit = nullptr) {
+    BenchResult r = { name, iters, UINT32_MAX, 0, 0, units, unit };
+    for (uint32_t i = 0; i < iters; i++) {
+        uint32_t t0 = micros();
+        uint32_t c0 = ESP.getCycleCount();
+        fn();
+        uint32_t dc = ESP.getCycleCount() - c0;
+        r.totalUs += micros() - t0;
+        r.totalCycles += dc;
+        if (dc < r.minCycles) r.minCycles = dc;
+    }
+    benchRecord(r);
+}
+
+// A case measured by other means (e.g. panel BUSY time from the driver)
+void benchRecordMs(const char* name, uint32_t iters, uint32_t totalMs);
+
+// Print the table and write /user/bench.json (false if SD is missing)
+bool benchFinish();
+
+#endif
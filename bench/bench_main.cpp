@@ -0,0 +1,211 @@
+// ============================================================================
+// Bench firmware — replaces main.cpp in the `bench` environment
+//
+//   pio run -e bench -t upload && pio device monitor
+//
+// Brings up the panel, SD and audio the way main.cpp does, holds the CPU
+// at POWER_MAX_MHZ with light sleep off, runs every case once and writes
+// /user/bench.json.  No WiFi: the JSON cases parse captured responses with
+// the same filters and document sizes as the modules that receive them.
+// Put the usual /graphics BMPs on the card for the SD and BMP-frame cases.
+// ============================================================================
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <GxEPD2_BW.h>
+#include <WS_EPD154V2.h>
+#include <ArduinoJson.h>
+
+#include "bench.h"
+#include "audio.h"
+#include "battery.h"
+#include "display_ui.h"
+#include "poll_arena.h"
+#include "power_policy.h"
+#include "sd_storage.h"
+#include "status_frames.h"
+
+// Same wiring as main.cpp
+#define EPD_DC_PIN    10
+#define EPD_CS_PIN    11
+#define EPD_SCK_PIN   12
+#define EPD_MOSI_PIN  13
+#define EPD_RST_PIN   9
+#define EPD_BUSY_PIN  8
+#define EPD_PWR_PIN   6    // ACTIVE LOW — LOW = on
+#define VBAT_PWR_PIN  17   // Battery power latch — HIGH = stay on
+
+GxEPD2_BW<WS_EPD154V2, WS_EPD154V2::HEIGHT> display(
+    WS_EPD154V2(EPD_CS_PIN, EPD_DC_PIN, EPD_RST_PIN, EPD_BUSY_PIN)
+);
+
+// ============================================================================
+// Captured responses (ids and tokens shortened, shapes as received)
+// ============================================================================
+
+static const char PRESENCE_JSON[] =
+    "{\"@odata.context\":\"https://graph.microsoft.com/v1.0/$metadata#users('8b08e7f2')/presence/$entity\","
+    "\"id\":\"8b08e7f2-1c4a-4d2e-9c1f-6a0f3e2b7d51\",\"availability\":\"Busy\","
+    "\"activity\":\"InAMeeting\",\"statusMessage\":null,"
+    "\"outOfOfficeSettings\":{\"message\":null,\"isOutOfOffice\":false}}";
+
+static const char TOKEN_JSON[] =
+    "{\"token_type\":\"Bearer\",\"scope\":\"Presence.Read Calendars.Read User.Read profile openid email\","
+    "\"expires_in\":4310,\"ext_expires_in\":4310,"
+    "\"access_token\":\"eyJ0eXAiOiJKV1QiLCJub25jZSI6IkFfU2ltU2ltU2ltIiwiYWxnIjoiUlMyNTYiLCJ4NXQiOiJYUnZrbyJ9."
+    "eyJhdWQiOiIwMDAwMDAwMy0wMDAwLTAwMDAtYzAwMC0wMDAwMDAwMDAwMDAiLCJpc3MiOiJodHRwczovL3N0cy53aW5kb3dzLm5ldC8i"
+    "LCJpYXQiOjE3NjA0MzUyMDAsIm5iZiI6MTc2MDQzNTIwMCwiZXhwIjoxNzYwNDM5NTEwLCJzY3AiOiJQcmVzZW5jZS5SZWFkIn0."
+    "c2lnbmF0dXJlLXNpZ25hdHVyZS1zaWduYXR1cmUtc2lnbmF0dXJlLXNpZ25hdHVyZS1zaWduYXR1cmUtc2lnbmF0dXJl\","
+    "\"refresh_token\":\"0.AXkA8n3qW1bRk0y0x7aR2r4mRgMAAAAAAAAAAAAAAAAAAAB5AAA.AgABAwEAAAApTwJmzXqdR4BN2miheQMY"
+    "AgDs_wUA9P8KzZ2y5wR7c1t8q3V0a9b1c2d3e4f5g6h7i8j9k0l1m2n3o4p5q6r7s8t9u0v1w2x3y4z5\","
+    "\"id_token\":\"eyJ0eXAiOiJKV1QiLCJhbGciOiJSUzI1NiJ9.eyJhdWQiOiIwMDAwMDAwMSJ9.c2ln\"}";
+
+// One calendarView event, repeated for a working day
+static const char CAL_EVENT[] =
+    "{\"@odata.etag\":\"W/\\\"DwAAABYAAAB3tJxq3XcBTr1m4j2XKq0RAAT7H8up\\\"\","
+    "\"id\":\"AAMkAGI2TG93AAA=AAMkAGI2TG93AAA=AAMkAGI2TG93AAA=AAMkAGI2TG93AAA=\","
+    "\"subject\":\"Weekly sync\",\"bodyPreview\":\"Agenda to follow\",\"isAllDay\":false,"
+    "\"isCancelled\":false,\"showAs\":\"busy\","
+    "\"start\":{\"dateTime\":\"2026-10-19T09:00:00.0000000\",\"timeZone\":\"UTC\"},"
+    "\"end\":{\"dateTime\":\"2026-10-19T09:30:00.0000000\",\"timeZone\":\"UTC\"},"
+    "\"location\":{\"displayName\":\"Microsoft Teams Meeting\",\"locationType\":\"default\"},"
+    "\"organizer\":{\"emailAddress\":{\"name\":\"Sam Lee\",\"address\":\"sam@contoso.com\"}}}";
+static const int CAL_EVENTS = 12;
+
+// ============================================================================
+// JSON — stream-parsed, as the modules read an HttpsBody
+// ============================================================================
+
+class MemStream : public Stream
+{
+  public:
+    MemStream(const char* data, size_t len) : _data(data), _len(len), _pos(0) {}
+    int    available() override { return (int)(_len - _pos); }
+    int    read() override      { return _pos < _len ? (uint8_t)_data[_pos++] : -1; }
+    int    peek() override      { return _pos < _len ? (uint8_t)_data[_pos] : -1; }
+    size_t write(uint8_t) override { return 0; }
+    size_t readBytes(char* buf, size_t n) override {
+        if (n > _len - _pos) n = _len - _pos;
+        memcpy(buf, _data + _pos, n);
+        _pos += n;
+        return n;
+    }
+  private:
+    const char* _data;
+    size_t      _len;
+    size_t      _pos;
+};
+
+static void benchJson() {
+    {   // teams_presence.cpp
+        StaticJsonDocument<64> filter;
+        filter["availability"] = true;
+        filter["activity"]     = true;
+        benchRun("json_presence", 200, [&] {
+            StaticJsonDocument<192> doc;
+            MemStream in(PRESENCE_JSON, sizeof(PRESENCE_JSON) - 1);
+            deserializeJson(doc, in, DeserializationOption::Filter(filter));
+        }, sizeof(PRESENCE_JSON) - 1, "byte");
+    }
+    {   // teams_auth.cpp readTokenResponse()
+        StaticJsonDocument<96> filter;
+        filter["access_token"]  = true;
+        filter["refresh_token"] = true;
+        filter["expires_in"]    = true;
+        benchRun("json_token", 100, [&] {
+            ArenaJsonDocument doc(4096 + 3072 + 256);   // ACCESS_ + REFRESH_TOKEN_MAX + 256
+            MemStream in(TOKEN_JSON, sizeof(TOKEN_JSON) - 1);
+            deserializeJson(doc, in, DeserializationOption::Filter(filter));
+        }, sizeof(TOKEN_JSON) - 1, "byte");
+    }
+    {   // calendar_schedule.cpp
+        String body = "{\"@odata.context\":\"https://graph.microsoft.com/v1.0/$metadata#users('8b08e7f2')/calendarView\",\"value\":[";
+        for (int i = 0; i < CAL_EVENTS; i++) {
+            if (i) body += ",";
+            body += CAL_EVENT;
+        }
+        body += "]}";
+
+        StaticJsonDocument<256> filter;
+        JsonObject f = filter["value"].createNestedObject();
+        f["start"]["dateTime"] = true;
+        f["end"]["dateTime"]   = true;
+        f["showAs"]            = true;
+        f["isCancelled"]       = true;
+        f["isAllDay"]          = true;
+        benchRun("json_calendar", 50, [&] {
+            ArenaJsonDocument doc(JSON_OBJECT_SIZE(1) + JSON_ARRAY_SIZE(40) + 40 * 224);   // CAL_DOC_BYTES
+            MemStream in(body.c_str(), body.length());
+            deserializeJson(doc, in, DeserializationOption::Filter(filter));
+        }, body.length(), "byte");
+    }
+    pollArenaReset();
+}
+
+// ============================================================================
+// SD — BMP decode into a panel frame
+// ============================================================================
+
+static void benchSd() {
+    if (!sdMounted()) {
+        Serial.println("[Bench] No SD — sd_load_bmp skipped");
+        return;
+    }
+    static uint8_t frame[STATUS_FRAME_BYTES];
+    const char* path = nullptr;
+    for (int slot = 0; slot < FRAME_SLOT_COUNT && !path; slot++)
+        if (sdFileExists(statusFrameBmpPath(slot))) path = statusFrameBmpPath(slot);
+    if (!path) {
+        Serial.println("[Bench] No /graphics status BMP — sd_load_bmp skipped");
+        return;
+    }
+    Serial.printf("[Bench] sd_load_bmp: %s\n", path);
+    benchRun("sd_load_bmp", 10, [&] { sdLoadBMP(path, frame, sizeof(frame)); },
+             STATUS_FRAME_BYTES, "byte");
+}
+
+// ============================================================================
+// setup / loop
+// ============================================================================
+
+void setup() {
+    pinMode(VBAT_PWR_PIN, OUTPUT);
+    digitalWrite(VBAT_PWR_PIN, HIGH);
+    Serial.begin(115200);
+    delay(1000);
+    Serial.printf("\n=== Status Pod bench v%s ===\n\n", FW_VERSION);
+
+    powerPolicyInit();
+    pollArenaInit();
+    batteryInit();
+
+    pinMode(EPD_PWR_PIN, OUTPUT);
+    digitalWrite(EPD_PWR_PIN, LOW);
+    delay(200);
+    displayBegin();
+    SPI.end();
+    SPI.begin(EPD_SCK_PIN, -1, EPD_MOSI_PIN, -1);
+
+    sdInit();
+    displayPrepareStatusFrames();
+    audioInit(false);
+
+    {
+        // One clock for every case, and no light sleep between them
+        PowerLock cpu(PM_LOCK_CPU_MAX);
+        PowerLock apb(PM_LOCK_APB_MAX);
+        Serial.printf("[Bench] CPU %u MHz\n", (unsigned)getCpuFrequencyMhz());
+
+        benchJson();
+        benchSd();
+        displayBench();
+        audioBench();
+    }
+    benchFinish();
+    displayWarmSleep();
+    Serial.println("[Bench] Done");
+}
+
+void loop() {
+    delay(1000);
+}
@@ -36,10 +36,12 @@ void audioTone(int freqHz, int durationMs);
 
 // --- Canned sound effects ---
 
-// Short click for button presses — plays /audio/click.mp3 or fallback tone
+// Short click for button presses — starts /audio/click.mp3 (non-blocking)
+// or plays the fallback tone.  Skipped while a clip is playing.
 void audioClick();
 
-// Short beep (~100ms, 2kHz) — plays /audio/click.mp3 or fallback tone
+// Short beep (~100ms, 2kHz) — starts /audio/click.mp3 or fallback tone.
+// Skipped while a clip is playing.
 void audioBeep();
 
 // Confirmation tone (two ascending beeps)
@@ -48,18 +50,47 @@ void audioConfirm();
 // Error/warning tone (low buzz)
 void audioError();
 
-// Status-change notification — plays /audio/notify.mp3 or fallback tone
+// Status-change notification — plays /audio/notify.mp3 or fallback tone.
+// Blocking (it runs as an output-pipeline stage).
 void audioNotify();
 
-// Attention tone — plays /audio/attention.mp3, repeated `repeats` times.
-// Falls back to synthesized tone if MP3 not found.  Blocking.
+// Attention tone — starts /audio/attention.mp3 with `repeats` queued on
+// the player (decoded once, replayed from PSRAM).  Returns at once; the
+// synthesized fallback, used if the MP3 is missing, blocks.
 void audioAttention(int repeats = 3);
 
+// Decode the canned-effect clips into the sound bank now (normal boot), so
+// the first click doesn't wait for SD + decode.  Otherwise each clip is
+// decoded on its first use.
+void audioPreload();
+
 // --- MP3 playback ---
+//
+// Files stream from SD through a PSRAM ring into a decoder task, so any
+// length plays and the caller isn't blocked.  The codec is suspended again
+// when a clip ends.  Tones wait for a running clip.
+
+// Start playing an MP3 from SD, `repeats` times with a short gap (stops
+// any clip already playing).  False if the file is missing or the player
+// isn't available — the caller should fall back to a tone.
+bool audioStart(const char* path, int repeats = 1);
+
+// Stop the current clip and wait until the player is idle
+void audioStop();
 
-// Play an MP3 file from SD card.  Returns true on success, false if
-// the file is missing / unreadable (caller should fall back to a tone).
-// The caller is responsible for calling audioAutoSuspend() afterwards.
+// True while a clip is playing
+bool audioIsPlaying();
+
+// Block until the current clip has finished, or for at most `timeoutMs`
+// (0 = no limit).  True if the player is idle.
+bool audioWaitIdle(uint32_t timeoutMs = 0);
+
+// Play an MP3 and wait for it to finish.  Same return as audioStart().
 bool audioPlayMP3(const char* path);
 
+#ifdef POD_BENCH
+// mp3DataCallback() resampling and audioTone() cases (bench/bench.h)
+void audioBench();
+#endif
+
 #endif
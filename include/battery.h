@@ -19,11 +19,28 @@ float batteryReadVoltage();
 // Convert voltage to percentage (LiPo: 4.20V = 100%, 3.00V = 0%)
 int batteryPercent(float voltage);
 
+// Battery voltage at or above which USB power is assumed (charge overshoot)
+#define BATTERY_USB_V 4.25f
+
 // Returns true when running on USB power (voltage >= 4.25V typical with
 // simultaneous charge), false on battery alone.  Approximate — the charging
 // IC keeps voltage near 4.2V so this detects the small overshoot.
 bool batteryOnUSB(float voltage);
 
+// Inverse of batteryPercent(): the voltage reading `pct`
+float batteryVoltageAtPercent(int pct);
+
+// ---- Raw ADC1 readings (for the ULP monitor, which has no calibration) ----
+
+// ADC1 channel of the battery pin (GPIO 4)
+#define BATTERY_ADC_CHANNEL 3
+
+// Smallest 12-bit raw reading (11 dB) that means at least `voltage`
+uint16_t batteryRawForVoltage(float voltage);
+
+// Battery voltage for a 12-bit raw reading, using the eFuse calibration
+float batteryVoltageFromRaw(uint16_t raw);
+
 // Green charge LED on GPIO 3 (active HIGH)
 #define CHARGE_LED_PIN 3
 
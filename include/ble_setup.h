@@ -4,21 +4,19 @@
 #include <Arduino.h>
 
 // BLE Service and Characteristic UUIDs
+//
+// One provisioning characteristic carries the whole configuration.  A write
+// is a little-endian uint16 byte count followed by that many bytes of JSON,
+// split across as many writes as the link needs (one at a 517-byte MTU for
+// a typical config).  When the last byte lands the fields are applied,
+// stored in one pass and the pod reboots.  Keys (all strings, any may be
+// left out — it keeps the current value):
+//   ssid pass cid tid sec plat lt lip lkey laux tz oh wnew zacct zcid
+// A read returns the same JSON object (without "pass").
 #define BLE_SERVICE_UUID        0x00FF
-#define BLE_CHAR_SSID           "0001ff01-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_PASSWORD       "0001ff02-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_CLIENT_ID      "0001ff03-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_TENANT_ID      "0001ff04-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_SAVE           "0001ff05-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_LIGHT_TYPE     "0001ff06-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_LIGHT_IP       "0001ff07-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_LIGHT_KEY      "0001ff08-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_LIGHT_AUX      "0001ff09-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_CLIENT_SECRET  "0001ff0a-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_PLATFORM       "0001ff0b-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_TIMEZONE       "0001ff0c-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_OFFICE_HOURS   "0001ff0d-0000-1000-8000-00805f9b34fb"
-#define BLE_CHAR_WLED_NEW      "0001ff0e-0000-1000-8000-00805f9b34fb"
+#define BLE_CHAR_CONFIG         "0001ff11-0000-1000-8000-00805f9b34fb"
+#define BLE_CONFIG_MAX          1536    // JSON bytes accepted in one blob
+#define BLE_MTU                 517
 
 // NVS Storage Keys
 #define NVS_NAMESPACE           "puck_creds"
@@ -29,9 +27,19 @@
 
 // Function declarations
 void initializeBLE();
+// Stop NimBLE and hand the host + controller memory back to the heap.  Also
+// call it when BLE was never started — the controller's reserved RAM is
+// released either way.  After this BLE only comes back with a reboot.
 void deinitBLE();
+// Settings → BLE Setup: reboot into setup mode (the stack can't be restarted
+// once deinitBLE() has released it)
+void bleRequestSetup();
+// True once after a bleRequestSetup() reboot
+bool bleSetupRequested();
 void startBLEAdvertising();
 void stopBLEAdvertising();
+// Setup-mode loop: once a whole config has arrived, store it and reboot
+void bleSetupService();
 bool hasStoredCredentials();
 void loadCredentialsFromNVS();
 void saveCredentialsToNVS();
@@ -51,5 +59,9 @@ extern String g_platform;
 extern String g_timezone;
 extern String g_office_hours;
 extern String g_wled_new;
+// Teams+Zoom only: Zoom's S2S ids (client_id / tenant_id are the Azure
+// app's; the Zoom secret stays in client_secret — Teams has none)
+extern String g_zoom_account;
+extern String g_zoom_client_id;
 
 #endif
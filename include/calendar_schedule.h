@@ -0,0 +1,40 @@
+// ============================================================================
+// Calendar Schedule — sleep until the next likely presence transition
+//
+// Fetches Graph /me/calendarView for the next 24 h and keeps the meeting
+// start/end times as a compact boundary list in RTC memory.  Deep-sleep
+// intervals are then computed from that list: the normal poll cadence
+// around each boundary, and one long sleep across the gaps, capped by
+// PodSettings::maxStaleness.  Without calendar data (Zoom, no
+// Calendars.Read consent, fetch failed) the caller's fixed interval is
+// used unchanged.
+// ============================================================================
+
+#ifndef CALENDAR_SCHEDULE_H
+#define CALENDAR_SCHEDULE_H
+
+#include <Arduino.h>
+
+// True when the boundary list is missing, older than 6 h, from another
+// day, or marked stale by calendarNotePresenceChange().
+bool calendarNeedsRefresh();
+
+// Fetch the next 24 h of events.  403 (no consent) backs off for a day.
+bool calendarRefresh(const char* accessToken);
+
+// True if a boundary list from a successful fetch is available
+bool calendarHasSchedule();
+
+// Seconds to sleep before the next poll.  `baseSec` is the normal poll
+// interval (used near boundaries), `maxSec` caps gap sleeps.
+int  calendarNextSleep(int baseSec, int maxSec);
+
+// Report a status change.  One far from any known boundary means the
+// calendar probably changed — refetch on the next wake.
+void calendarNotePresenceChange();
+
+// Two short lines for the Auth Info screen (event count / next boundary,
+// last sleep decision)
+void calendarDescribe(char* line1, size_t len1, char* line2, size_t len2);
+
+#endif
@@ -0,0 +1,36 @@
+// ============================================================================
+// Clock Sync — wall-clock time kept by the RTC, NTP only when due
+//
+// time() keeps counting through deep sleep, so a wake only needs NTP when
+// the clock has never been set, the last sync is older than
+// NTP_RESYNC_HOURS, or the measured RTC drift puts the estimated error
+// over NTP_MAX_ERROR_SEC.  The sync itself runs in the background (SNTP
+// task) so it overlaps the presence request instead of preceding it.
+// ============================================================================
+
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <Arduino.h>
+
+// Apply the POSIX TZ string (empty = UTC).  No network.  Call every boot —
+// the TZ environment does not survive deep sleep.
+void clockInit(const String& timezone);
+
+// True if the wall clock has been set (now or on a previous wake)
+bool clockIsValid();
+
+// True when an NTP resync is due (never synced / too old / drifted)
+bool clockNeedsSync();
+
+// Kick off an SNTP request in the background (needs WiFi)
+void clockStartSync();
+
+// Wait up to timeoutMs for a sync started by clockStartSync().
+// Returns clockIsValid() — true if a previous sync still covers us.
+bool clockFinishSync(unsigned long timeoutMs);
+
+// Estimated clock error in seconds since the last sync
+long clockEstimatedErrorSec();
+
+#endif
@@ -0,0 +1,34 @@
+// ============================================================================
+// Config Snapshot — everything a timer wake needs, without the SD card
+//
+// PodSettings, LightConfig and the BLE credentials packed into one fixed
+// binary record (versioned, CRC-32 checked).  The record lives in RTC
+// memory, with a copy in NVS for when RTC memory was lost.  It is built at
+// normal boot from the full SD/NVS load, updated by saveSettings() /
+// saveLightConfig(), and dropped when BLE setup rewrites the stores
+// piecemeal.  NVS is only written when the record actually changes.
+// ============================================================================
+
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+
+#include <Arduino.h>
+#include "settings.h"
+#include "light_control.h"
+
+// Rebuild from the live config plus the credential globals (ble_setup.h).
+// Fails (and drops the snapshot) if a string is too long for the record.
+bool configSnapshotCapture(const PodSettings& s, const LightConfig& light);
+
+// Restore settings, light config and credential globals.  False if there
+// is no valid snapshot — load the slow way and capture.
+bool configSnapshotRestore(PodSettings& s, LightConfig& light);
+
+// Update one part of a valid snapshot (no-op without one)
+void configSnapshotUpdateSettings(const PodSettings& s);
+void configSnapshotUpdateLight(const LightConfig& light);
+
+// Forget the snapshot (RTC and NVS)
+void configSnapshotInvalidate();
+
+#endif
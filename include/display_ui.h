@@ -8,18 +8,38 @@
 #include "light_control.h"
 #include "light_devices.h"
 
-// Display object — defined in main.cpp, used by display_ui.cpp
+// Display object — defined in main.cpp (bench_main.cpp in the bench build)
 extern GxEPD2_BW<WS_EPD154V2, WS_EPD154V2::HEIGHT> display;
 
 // Firmware version — single source of truth
 #define FW_VERSION "0.15.005"
 
+// Promote every Nth partial update to a full refresh (ghosting); 0 = never
+void displaySetFullRefreshEvery(int n);
+
+// display.init() — warm after a displayWarmSleep(), so the first update
+// can be partial against the panel's retained image
+void displayBegin();
+
+// Save the panel state to RTC and hibernate the panel (before deep sleep)
+void displayWarmSleep();
+
+// Block until an async panel refresh has finished (see WS_EPD154V2.h)
+void displayWaitIdle();
+
 // ---- Screen-drawing functions ----
 void drawSplashScreen(const char* platformLabel = nullptr);  // boot splash
 void drawSetupScreen();
 void drawQRAuthScreen(const char* userCode, const char* qrUrl);
 void drawAuthCodeScreen(const char* userCode);
-void drawStatusScreen(const char* availability, const char* activity);
+void drawStatusScreen(Availability availability, Activity activity);
+
+// Team board (team_board.h): partial-refreshes only the rows set in
+// `changedRows`, or draws the whole board if it isn't on the panel
+void drawTeamBoard(uint8_t changedRows);
+
+// Render the status frame cache if firmware or SD assets changed (boot)
+void displayPrepareStatusFrames();
 void drawErrorScreen(const char* title, const char* detail);
 void drawShutdownScreen();
 void drawLowBatteryScreen(int percent, bool critical);
@@ -41,6 +61,7 @@ enum SettingsItem {
     SET_INVERT,
     SET_AUDIO,
     SET_POLL_INTERVAL,
+    SET_POLL_PROFILE,
     SET_BLE_SETUP,
     SET_BACK,
     SET_COUNT
@@ -54,9 +75,14 @@ void drawDeviceInfoScreen(const char* ssid, const char* ip,
                           const char* clientId, const char* tenantId,
                           float battV, int battPct,
                           bool outsideOfficeHours = false,
+                          const char* profLine1 = nullptr,
+                          const char* profLine2 = nullptr,
+                          const char* heapLine = nullptr,
                           bool partial = false);
 void drawAuthInfoScreen(bool tokenValid, long expirySeconds,
                         const char* lastStatus,
+                        const char* calLine = nullptr,
+                        const char* sleepLine = nullptr,
                         bool partial = false);
 
 // ---- WLED Provisioning progress screen ----
@@ -85,4 +111,10 @@ enum LightAction {
 void drawLightActionScreen(const LightDevice& dev, int selected,
                            bool partial = false);
 
+#ifdef POD_BENCH
+// Status render, QR and full/partial refresh cases (bench/bench.h).
+// Leaves the panel showing a test frame; the next screen is a full refresh.
+void displayBench();
+#endif
+
 #endif
@@ -0,0 +1,94 @@
+// ============================================================================
+// HTTPS Connection Manager — shared TLS clients for Graph, login and Zoom
+//
+// One WiFiClientSecure per known host, kept open between requests
+// (HTTP keep-alive) so repeated calls to the same host skip the TLS
+// handshake.  Certificates are verified against the root CAs pinned per
+// host in tls_roots.h, or against the embedded Mozilla CA bundle when
+// built with -DPOD_TLS_CA_BUNDLE (see platformio.ini).
+//
+// Two tasks may have requests in flight at once, to different hosts.
+// Each request holds the PM_LOCK_CPU_MAX power lock from httpsBegin() to
+// httpsEnd(), so the handshake and record crypto run at full clock.
+//
+// Usage:
+//   HTTPClient http;
+//   if (!httpsBegin(http, url)) return false;
+//   http.addHeader(...);
+//   int code = httpsSend(http, "POST", body);
+//   HttpsBody body(http);                 // or StrBuf::readFrom() for errors
+//   deserializeJson(doc, body, DeserializationOption::Filter(filter));
+//   body.drain();
+//   httpsEnd(http);
+// ============================================================================
+
+#ifndef HTTPS_CONN_H
+#define HTTPS_CONN_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include "poll_arena.h"
+
+// Attach `http` to the shared client for the URL's host, connecting (and
+// logging the handshake) if it isn't already open.
+bool httpsBegin(HTTPClient& http, const String& url);
+
+// Send the request.  A reused socket the server has since closed is
+// reconnected once and the request retried.  Returns the HTTP status code
+// (negative = HTTPClient transport error).
+int  httpsSend(HTTPClient& http, const char* method, const String& body = "");
+int  httpsSend(HTTPClient& http, const char* method, const char* body, size_t len);  // StrBuf
+
+// "Authorization: Bearer <token>", built in the poll arena
+void httpsAddBearer(HTTPClient& http, const char* token);
+
+// An error response: its start into `out` (up to out's capacity), the rest
+// drained so the keep-alive socket stays usable
+void httpsReadError(HTTPClient& http, StrBuf& out);
+
+// Finish the request — the socket stays open when the server allows it
+void httpsEnd(HTTPClient& http);
+
+// Close every open connection (call before WiFi off / sleep)
+void httpsCloseAll();
+
+// Log handshake count / time and socket reuse since boot
+void httpsLogStats();
+
+// Log at boot how certificates are verified — a warning when the build
+// uses -DPOD_TLS_INSECURE and every connection skips verification
+void httpsLogTlsMode();
+
+// Response body as a Stream, read straight off the socket — de-chunks
+// Transfer-Encoding: chunked and stops at Content-Length — so ArduinoJson
+// can parse it without first copying the payload into a String.
+class HttpsBody : public Stream
+{
+  public:
+    explicit HttpsBody(HTTPClient& http, unsigned long timeoutMs = 5000);
+    int    available() override;
+    int    read() override;
+    int    peek() override;
+    size_t readBytes(char* buffer, size_t length) override;
+    size_t write(uint8_t) override { return 0; }
+    void   flush() override {}
+    // Consume whatever the parser left unread, so a keep-alive socket is
+    // positioned at the next response
+    void   drain();
+    size_t bytesRead() const { return _total; }
+  private:
+    bool   _fill();
+    bool   _nextChunk();
+    int    _rawRead();
+    WiFiClient* _client;
+    bool    _chunked;
+    long    _left;       // bytes left in the body or current chunk, -1 = until close
+    bool    _eof;
+    uint8_t _buf[128];
+    size_t  _pos;
+    size_t  _len;
+    size_t  _total;
+    unsigned long _start;
+};
+
+#endif
@@ -0,0 +1,60 @@
+// ============================================================================
+// Input — debounced button events from GPIO interrupts
+//
+// Each button's interrupt is level-triggered and armed for the level it
+// isn't at yet (LOW while released, HIGH while held).  The same level is
+// its light-sleep GPIO wake source, so a press also wakes the chip from
+// automatic or manual light sleep.  The ISR masks the pin and (re)starts a
+// debounce timer.  The timer reads the settled level, posts BTN_PRESS /
+// BTN_RELEASE to a queue and re-arms the pin for the other level; a second
+// timer posts BTN_LONG if the button is still down after INPUT_LONG_MS.
+// Callers block on the queue, so nothing polls between presses.
+// ============================================================================
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <Arduino.h>
+
+enum PodButton : uint8_t {
+    BTN_BOOT = 0,
+    BTN_PWR,
+    BTN_COUNT
+};
+
+enum ButtonAction : uint8_t {
+    BTN_PRESS = 0,      // went down
+    BTN_LONG,           // still down INPUT_LONG_MS after the press
+    BTN_RELEASE,        // went up (heldMs says whether BTN_LONG came first)
+};
+
+struct ButtonEvent {
+    PodButton    button;
+    ButtonAction action;
+    uint32_t     heldMs;    // LONG / RELEASE: time since the press
+};
+
+#define INPUT_DEBOUNCE_MS 30
+#define INPUT_LONG_MS     3000
+#define INPUT_FOREVER     0xFFFFFFFFUL
+
+// Attach the interrupts (pins already INPUT_PULLUP, active low).  A button
+// that is down already posts its BTN_PRESS now.
+bool inputInit(int bootPin, int pwrPin);
+
+// Next event, or false after `timeoutMs` (INPUT_FOREVER = block)
+bool inputWait(ButtonEvent& ev, uint32_t timeoutMs);
+
+// Block until either button goes down; other events are dropped
+PodButton inputWaitPress();
+
+// Block until `b` is released (returns at once if it's up)
+void inputWaitRelease(PodButton b);
+
+// Debounced level
+bool inputHeld(PodButton b);
+
+// Drop queued events (e.g. presses made while a slow screen was drawing)
+void inputFlush();
+
+#endif
@@ -14,6 +14,7 @@
 #define LIGHT_CONTROL_H
 
 #include <Arduino.h>
+#include "presence_model.h"
 
 // Light output type
 enum LightType {
@@ -41,9 +42,11 @@ const char* lightTypeName(LightType t);
 void loadLightConfig(LightConfig& cfg);
 void saveLightConfig(const LightConfig& cfg);
 
-// Set the light colour from a Teams availability string.
-// Maps: Available→green, Busy/DND→red, Away/BRB→yellow, Offline→off
-void lightSetPresence(const LightConfig& cfg, const char* availability);
+// Set the light for a presence: the WLED preset swarm if there is one,
+// else the availability's colour (presence_model.cpp) on the configured
+// light — Available→green, Busy/DND→red, Away/BRB→yellow, Offline→off
+void lightSetPresence(const LightConfig& cfg, Availability availability,
+                      Activity activity = ACT_NONE);
 
 // Set an arbitrary RGB colour (0–255 each)
 void lightSetColor(const LightConfig& cfg, uint8_t r, uint8_t g, uint8_t b);
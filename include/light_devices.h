@@ -1,8 +1,9 @@
 // ============================================================================
 // Light Devices — discovery, tracking, and provisioning
 //
-// Discovers WLED (mDNS), WiZ (UDP), Hue (bridge API).
-// Maintains a cached device list in /lights.json on SD.
+// Discovers WLED (mDNS), WiZ (UDP), Hue (bridge API) — all three at once.
+// Maintains a cached device list in /lights.json on SD, with a last-seen
+// time per device and a discovery TTL, so routine wakes use the cache.
 // Provisions WLED devices with presence presets on demand.
 // ============================================================================
 
@@ -21,8 +22,15 @@ struct LightDevice {
     String    id;                      // Hue light/group/room ID, or empty
     bool      provisioned = false;     // WLED: presets uploaded?
     bool      responding  = true;      // Last contact succeeded?
+    uint32_t  lastSeen    = 0;         // Epoch of last discovery/verify hit, 0 = unknown
 };
 
+// A full discovery is due once the cache is this old
+#define LIGHT_DISCOVERY_TTL_SEC (24UL * 3600UL)
+
+// A device missing from discovery for this long is dropped from the cache
+#define LIGHT_FORGET_SEC        (14UL * 24UL * 3600UL)
+
 // Get the cached device list (in-memory)
 std::vector<LightDevice>& lightDevicesGet();
 
@@ -47,9 +55,20 @@ int lightDiscoverWiZ();
 // Returns count of items enumerated.
 int lightDiscoverHue(const String& bridgeIp, const String& apiKey);
 
-// Run all applicable discovery based on current light type config.
-// Returns total new devices found.
-int lightDiscoverAll(const LightConfig& cfg);
+// Called on the caller's task each time discovery adds or refreshes a
+// device in lightDevicesGet() (e.g. to redraw the Lights screen)
+typedef void (*LightDiscoveryProgress)(void* ctx);
+
+// Run all applicable discovery based on current light type config.  The
+// scans run concurrently; results are merged as they arrive.  Devices of a
+// scanned type unseen for LIGHT_FORGET_SEC are dropped, then the list is
+// saved.  Returns total new devices found.
+int lightDiscoverAll(const LightConfig& cfg, LightDiscoveryProgress progress = nullptr,
+                     void* ctx = nullptr);
+
+// True when the cache is empty, older than LIGHT_DISCOVERY_TTL_SEC, or of
+// unknown age (no valid clock)
+bool lightDiscoveryDue();
 
 // ---- WLED Preset Control ----
 
@@ -60,9 +79,8 @@ bool wledActivatePreset(const String& ip, int presetId);
 // Activate a WLED preset on ALL tracked WLED devices.
 void wledActivatePresetAll(int presetId);
 
-// Map a presence availability string to a WLED preset ID.
+// Preset IDs for a presence come from presenceWledPreset() (presence_model.h):
 // Available=1, Away=2, Busy=3, DND=4, Call/Meeting=5, Offline=6
-int wledPresetForPresence(const char* availability);
 
 // ---- WLED Provisioning ----
 
@@ -78,7 +96,8 @@ int wledProvisionAll();
 // Check if a known device is still responding (quick HTTP ping).
 bool lightDevicePing(const LightDevice& dev);
 
-// Verify all tracked devices; update `responding` flags.
+// Verify all tracked devices in parallel; update `responding` flags and
+// last-seen times.
 void lightDevicesVerify();
 
 #endif
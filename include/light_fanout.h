@@ -0,0 +1,43 @@
+// ============================================================================
+// Light Fan-out — concurrent, deadline-bounded requests to light devices
+//
+// Queue any number of plain-HTTP requests and UDP datagrams, then run them
+// all at once: non-blocking lwIP sockets multiplexed with select(), a
+// single overall deadline, and no per-device timeouts.  A dead device costs
+// at most the deadline once, not a timeout per device.  HTTP jobs send
+// "Connection: close" and succeed on a 2xx status line; the body is never
+// read.  UDP jobs succeed on send, or on the device's reply if asked to.
+// ============================================================================
+
+#ifndef LIGHT_FANOUT_H
+#define LIGHT_FANOUT_H
+
+#include <Arduino.h>
+
+#define FANOUT_MAX_JOBS          16
+#define FANOUT_MAX_OPEN          6      // TCP sockets in flight at once
+#define LIGHT_FANOUT_DEADLINE_MS 3000   // presence / colour updates
+
+// Drop all queued jobs and results
+void fanoutReset();
+
+// Queue an HTTP request to http://<ip><path>.  `body` (JSON) makes it a
+// request with Content-Type: application/json.  Returns the job index, or
+// -1 if the queue is full or `ip` isn't a dotted-quad address.
+int fanoutHttp(const String& ip, const char* method, const String& path,
+               const char* body = nullptr);
+
+// Queue a UDP datagram.  With `expectReply` the job only succeeds when a
+// datagram comes back from `ip`.
+int fanoutUdp(const String& ip, uint16_t port, const char* payload,
+              bool expectReply = false);
+
+// Run every queued job concurrently until all finish or `deadlineMs`
+// elapses (unfinished jobs fail).  Returns the number that succeeded.
+int fanoutRun(uint32_t deadlineMs);
+
+// Results of the last run
+bool fanoutOk(int job);
+int  fanoutStatus(int job);     // HTTP status; 0 if none was received
+
+#endif
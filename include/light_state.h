@@ -0,0 +1,55 @@
+// ============================================================================
+// Light State — last-applied output and re-probe backoff per light
+//
+// One RTC record per light, keyed by a hash of its IP and Hue target id,
+// survives deep sleep and soft resets.  It holds the last preset or RGB
+// colour the light acknowledged, so an update that wouldn't change what a
+// light shows is skipped, and a failure count with the next retry time, so
+// a dead light is re-probed with exponential backoff (LIGHT_RETRY_BASE_SEC
+// doubling up to LIGHT_RETRY_MAX_SEC) rather than hit on every change or
+// dropped for good.
+//
+// An acknowledged state is trusted for LIGHT_STATE_TTL_SEC, and forgotten
+// when the light answers a probe: one that power-cycled or browned out is
+// back on its default preset, and gets the state again on the next update.
+//
+// Times are RTC-timer seconds: they count through deep sleep and, unlike
+// time(), aren't stepped by the first NTP sync.
+// ============================================================================
+
+#ifndef LIGHT_STATE_H
+#define LIGHT_STATE_H
+
+#include <Arduino.h>
+
+#define LIGHT_STATE_SLOTS     16      // matches FANOUT_MAX_JOBS
+#define LIGHT_RETRY_BASE_SEC  60
+#define LIGHT_RETRY_MAX_SEC   3600
+#define LIGHT_STATE_TTL_SEC   900     // re-send an acknowledged state after this
+
+// Output encodings (0 = unknown)
+uint32_t lightStatePreset(int presetId);
+uint32_t lightStateRGB(uint8_t r, uint8_t g, uint8_t b);
+
+// True if the light acknowledged exactly `state` within LIGHT_STATE_TTL_SEC
+bool lightStateCurrent(const String& ip, const String& id, uint32_t state);
+
+// True if the light isn't backing off (never failed, or its retry is due)
+bool lightStateDue(const String& ip, const String& id);
+
+// Record the outcome of sending `state`.  Success stores it and clears
+// the backoff; failure forgets the output and doubles the retry delay.
+void lightStateRecord(const String& ip, const String& id, uint32_t state, bool ok);
+
+// The light answered a probe (discovery, verify): end its backoff and
+// forget its output — it may have restarted on its default preset
+void lightStateReachable(const String& ip, const String& id);
+
+// Forget every record (e.g. after the light config changed)
+void lightStateClear();
+
+// True if some light has no trusted output (expired, failed or re-probed),
+// so an unchanged poll should re-send the current state
+bool lightStateStale();
+
+#endif
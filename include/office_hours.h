@@ -0,0 +1,23 @@
+// ============================================================================
+// Office Hours — is the pod on duty, and how long until it next is
+//
+// Pure functions of the settings and a local broken-down time, so the
+// schedule can be checked without a clock (and in the host simulation).
+// The days mask is bit0 = Monday … bit6 = Sunday; the window is
+// [start, end) in local minutes and doesn't wrap past midnight.
+// ============================================================================
+
+#ifndef OFFICE_HOURS_H
+#define OFFICE_HOURS_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "settings.h"
+
+// Inside the window on an office day (always true when disabled)
+bool officeHoursActive(const PodSettings& s, const struct tm& local);
+
+// Seconds from `local` to the next window start, or -1 if no day is set
+int  officeHoursSecondsToStart(const PodSettings& s, const struct tm& local);
+
+#endif
@@ -0,0 +1,31 @@
+// ============================================================================
+// Output Pipeline — display, lights and audio for a status change, in parallel
+//
+// A presence change fans out to three FreeRTOS stage tasks, one per
+// independent peripheral: the EPD refresh (SPI + BUSY wait), the light
+// fan-out (WiFi) and the notification sound (I2S).  They run concurrently,
+// so a change costs roughly the slowest stage instead of the sum.
+//
+// While stages are in flight they own the display, the light engine and
+// the codec.  Call outputPipelineJoin() before touching any of them from
+// the main task, and before sleep or WiFi off.
+// ============================================================================
+
+#ifndef OUTPUT_PIPELINE_H
+#define OUTPUT_PIPELINE_H
+
+#include <Arduino.h>
+#include "light_control.h"
+
+// Start the stages for a new status (joins the previous change first).
+// Lights run when `light` has a type, audio when `notify` is set.
+void outputPresenceChanged(Availability availability, Activity activity,
+                           const LightConfig& light, bool notify);
+
+// Wait for every running stage to finish.  Cheap when idle.
+void outputPipelineJoin();
+
+// True while any stage is still running
+bool outputPipelineBusy();
+
+#endif
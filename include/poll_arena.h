@@ -0,0 +1,85 @@
+// ============================================================================
+// Poll Arena — PSRAM scratch memory for a poll cycle's HTTP and JSON work
+//
+// Request URLs, bodies, Authorization headers and JSON documents live only
+// for one request, but on the general heap they are exactly the 1–7 KB
+// short-lived blocks that fragment internal RAM over days of USB uptime
+// until a TLS handshake can't get a contiguous buffer.  They come from one
+// bump-pointer block in PSRAM instead, allocated once at boot:
+//
+//   StrBuf url(160);                       // fixed capacity, from the arena
+//   url.print("https://…/"); url.print(tenant);
+//   ArenaJsonDocument doc(6144);           // ArduinoJson pool, from the arena
+//
+// Freeing a block only drops a live count; the space comes back when
+// pollArenaReset() rewinds the pointer at the end of each poll cycle (or
+// when an allocation finds nothing live).  Two tasks may allocate at once
+// (Teams + Zoom polls).  A block that doesn't fit — or every block, if
+// PSRAM is missing — falls back to the heap and is freed normally.
+//
+// pollArenaDescribe() reports internal-heap headroom and fragmentation for
+// the Device Info screen.
+// ============================================================================
+
+#ifndef POLL_ARENA_H
+#define POLL_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#define POLL_ARENA_SIZE (48 * 1024)
+
+// Allocate the PSRAM block (call once at boot)
+void pollArenaInit();
+
+void*  pollArenaAlloc(size_t size);
+void   pollArenaFree(void* p);
+void*  pollArenaRealloc(void* p, size_t size);
+
+// End of a poll cycle: log the cycle's peak and rewind.  Leaves the arena
+// alone (and says so) if a block is still live.
+void   pollArenaReset();
+
+size_t pollArenaPeak();     // highest use since boot (bytes)
+
+// One short line for the Device Info screen: free internal heap, its low
+// water mark and how fragmented it is
+void pollArenaDescribe(char* line, size_t len);
+
+// ---- ArduinoJson -----------------------------------------------------------
+struct ArenaAllocator {
+    void* allocate(size_t n)              { return pollArenaAlloc(n); }
+    void  deallocate(void* p)             { pollArenaFree(p); }
+    void* reallocate(void* p, size_t n)   { return pollArenaRealloc(p, n); }
+};
+typedef BasicJsonDocument<ArenaAllocator> ArenaJsonDocument;
+
+// ---- Fixed-capacity string builder -----------------------------------------
+// Text that doesn't fit is dropped and overflowed() turns true — size it
+// for the worst case.  Use print() for the pieces: Print::printf() goes
+// through malloc for anything over 64 characters.
+class StrBuf : public Print
+{
+  public:
+    explicit StrBuf(size_t capacity);
+    ~StrBuf();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    using Print::write;
+    // Append what's left of a response body (up to capacity; the rest is
+    // left on the stream)
+    size_t readFrom(Stream& s);
+    void   clear();
+    const char* c_str() const   { return _buf ? _buf : ""; }
+    size_t length() const       { return _len; }
+    bool   overflowed() const   { return _overflow; }
+  private:
+    StrBuf(const StrBuf&);
+    StrBuf& operator=(const StrBuf&);
+    char*  _buf;
+    size_t _cap;            // excluding the NUL
+    size_t _len;
+    bool   _overflow;
+};
+
+#endif
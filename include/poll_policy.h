@@ -0,0 +1,27 @@
+// ============================================================================
+// Poll Policy — adaptive presence poll interval from change history
+//
+// Every observed status change is counted in a 168-bucket hour-of-week
+// histogram (local time), kept in RTC memory and mirrored to NVS.  The next
+// sleep is the base poll interval, backed off geometrically over unchanged
+// polls, then scaled by how busy the current hour has been compared with
+// the weekly average.  A sleep never runs past the start of a busy hour.
+// The result is clamped to PodSettings::pollMinSec..pollMaxSec.
+// ============================================================================
+
+#ifndef POLL_POLICY_H
+#define POLL_POLICY_H
+
+#include <Arduino.h>
+#include "settings.h"
+
+// Seconds until the next poll.  `stableCount` = consecutive unchanged polls.
+int  pollPolicyNextSleep(const PodSettings& s, int stableCount);
+
+// Record a status change at the current time (ignored without a valid clock)
+void pollPolicyRecordChange();
+
+// Write pending histogram changes to NVS (call before power-off)
+void pollPolicyFlush();
+
+#endif
@@ -0,0 +1,61 @@
+// ============================================================================
+// Power Policy — esp_pm frequency scaling with scoped locks
+//
+// The CPU idles at POWER_MIN_MHZ and is raised only while some code holds
+// a lock for it, so no early return can leave the clock up:
+//
+//   PM_LOCK_CPU_MAX  TLS / crypto — an HTTPS request from httpsBegin() to
+//                    httpsEnd() (ESP_PM_CPU_FREQ_MAX, POWER_MAX_MHZ)
+//   PM_LOCK_APB_MAX  EPD SPI transfers and I2S playback
+//                    (ESP_PM_APB_FREQ_MAX — also keeps light sleep out)
+//
+// Battery mode lets the idle task light-sleep whenever every task is
+// blocked; USB mode holds the CPU at full speed with light sleep off (it
+// would stop the USB PHY and drop the CDC console).  Time spent under each
+// lock is totalled here and reported per wake by the wake profiler.
+//
+// Without CONFIG_PM_ENABLE a CPU_MAX hold falls back to setCpuFrequencyMhz().
+// ============================================================================
+
+#ifndef POWER_POLICY_H
+#define POWER_POLICY_H
+
+#include <Arduino.h>
+
+#define POWER_MIN_MHZ 80        // WiFi and the 80 MHz APB both need this much
+#define POWER_MAX_MHZ 240
+
+enum PowerLockKind : uint8_t {
+    PM_LOCK_CPU_MAX = 0,
+    PM_LOCK_APB_MAX,
+    PM_LOCK_COUNT
+};
+
+// Create the locks and configure DFS (battery mode).  Call once, early.
+void powerPolicyInit();
+
+// USB = full speed, no light sleep; battery = DFS + automatic light sleep
+void powerSetUsbMode(bool onUSB);
+
+// Counted: nested and cross-task holds are fine
+void powerLockAcquire(PowerLockKind kind);
+void powerLockRelease(PowerLockKind kind);
+
+// Milliseconds `kind` has been held since boot, including a hold in progress
+uint32_t powerLockHeldMs(PowerLockKind kind);
+
+const char* powerLockName(PowerLockKind kind);
+
+// Holds a lock for a scope
+class PowerLock
+{
+  public:
+    explicit PowerLock(PowerLockKind kind) : _kind(kind) { powerLockAcquire(kind); }
+    ~PowerLock() { powerLockRelease(_kind); }
+  private:
+    PowerLock(const PowerLock&);
+    PowerLock& operator=(const PowerLock&);
+    PowerLockKind _kind;
+};
+
+#endif
@@ -0,0 +1,28 @@
+// ============================================================================
+// Presence Merge — Teams and Zoom polled together (PLATFORM_BOTH)
+//
+// The Graph and Zoom presence requests go out at the same time over their
+// own TLS connections: Zoom on a short-lived task on core 0, Graph on the
+// caller.  A poll costs the slower of the two instead of their sum, in the
+// same radio-on window.  The two states are then reduced to one by the
+// configured MergeRule (settings.h).
+// ============================================================================
+
+#ifndef PRESENCE_MERGE_H
+#define PRESENCE_MERGE_H
+
+#include <Arduino.h>
+#include "teams_presence.h"
+#include "settings.h"
+
+// Fetch both at once.  A null token skips that side; each result's
+// `valid` says whether it arrived.  401 handling is as in getPresence()
+// and getZoomPresence() — the rejected token is dropped.
+void fetchBothPresence(const char* graphToken, const char* zoomToken,
+                       PresenceState& teams, PresenceState& zoom);
+
+// One state from the two.  False if neither is valid.
+bool mergePresence(const PresenceState& teams, const PresenceState& zoom,
+                   MergeRule rule, PresenceState& out);
+
+#endif
@@ -0,0 +1,107 @@
+// ============================================================================
+// Presence Model — availability and activity as one-byte codes
+//
+// Graph and Zoom strings are parsed once, where the JSON is read, into an
+// Availability and an Activity code.  Everything downstream — the status
+// screen, frame cache, team board, lights, merge rules, RTC — works on the
+// codes and reads what it needs from one table row per code, so a poll
+// does no string compares or String copies after the parse.
+//
+// The name → code tables are checked to be sorted at compile time and
+// searched with a binary search.  Adding a state is one enum value and
+// one row in each table it appears in (presence_model.cpp).
+// ============================================================================
+
+#ifndef PRESENCE_MODEL_H
+#define PRESENCE_MODEL_H
+
+#include <Arduino.h>
+
+// Graph availability (Zoom statuses map onto these)
+enum Availability : uint8_t {
+    AV_UNKNOWN = 0,         // PresenceUnknown, or a value we don't know
+    AV_AVAILABLE,
+    AV_AVAILABLE_IDLE,
+    AV_AWAY,
+    AV_BE_RIGHT_BACK,
+    AV_BUSY,
+    AV_BUSY_IDLE,
+    AV_DO_NOT_DISTURB,
+    AV_OFFLINE,
+    AV_COUNT,
+    AV_NONE = 0xFF          // no status yet (before the first poll)
+};
+
+// What the user is doing, when it says more than the availability
+enum Activity : uint8_t {
+    ACT_NONE = 0,           // nothing beyond the availability
+    ACT_IN_A_CALL,
+    ACT_IN_A_CONFERENCE_CALL,
+    ACT_IN_A_MEETING,
+    ACT_PRESENTING,
+    ACT_OUT_OF_OFFICE,
+    ACT_OFF_WORK,
+    ACT_INACTIVE,
+    ACT_URGENT_ONLY,
+    ACT_CALENDAR_EVENT,     // Zoom In_Calendar_Event
+    ACT_COUNT
+};
+
+// Indicator drawn in the status circle / team board dot
+enum PresenceIcon : uint8_t {
+    ICON_NONE = 0,
+    ICON_TICK,              // available
+    ICON_CLOCK,             // away, be right back
+    ICON_CROSS,             // offline
+    ICON_BAR                // do not disturb (on the filled circle)
+};
+
+struct AvailabilityInfo {
+    const char* name;       // Graph value, e.g. "DoNotDisturb"
+    const char* label;      // UI text, e.g. "Do Not Disturb"
+    const char* screen;     // status screen word (upper case)
+    const char* screen2;    // second status line, or nullptr
+    const char* teamLabel;  // team board column
+    uint8_t     r, g, b;    // direct-RGB light colour
+    uint8_t     wledPreset; // preset pack ID (light_devices.h)
+    int8_t      frame;      // StatusFrameSlot, -1 = none
+    uint8_t     icon;       // PresenceIcon
+    bool        inverted;   // black screen / row
+    uint8_t     rank;       // merge precedence, higher = busier
+};
+
+struct ActivityInfo {
+    const char* name;       // Graph value, e.g. "InACall"
+    const char* label;      // detail line under the status word
+    uint8_t     wledPreset; // 0 = the availability's
+    int8_t      frame;      // StatusFrameSlot, -1 = the availability's
+};
+
+const AvailabilityInfo& availabilityInfo(Availability a);   // out of range → unknown
+const ActivityInfo&     activityInfo(Activity a);           // out of range → none
+
+inline const char* availabilityName(Availability a)  { return availabilityInfo(a).name; }
+inline const char* availabilityLabel(Availability a) { return availabilityInfo(a).label; }
+inline const char* activityName(Activity a)          { return activityInfo(a).name; }
+
+// ---- Parsing (the JSON boundary) ----
+
+// Graph availability; unknown values → AV_UNKNOWN
+Availability presenceParseAvailability(const char* graph);
+
+// Graph activity; values that only repeat an availability, and unknown
+// ones, → ACT_NONE
+Activity presenceParseActivity(const char* graph);
+
+// Zoom presence_status.  False (and AV_UNKNOWN / ACT_NONE) if unknown.
+bool presenceParseZoom(const char* status, Availability& avail, Activity& act);
+
+// ---- Derived values ----
+
+// Frame slot: the activity's if it has one, else the availability's
+int presenceFrameSlot(Availability a, Activity act);
+
+// WLED preset: the activity's if it has one, else the availability's
+int presenceWledPreset(Availability a, Activity act);
+
+#endif
@@ -23,6 +23,10 @@ bool sdInit();
 // True if SD card is currently mounted and accessible.
 bool sdMounted();
 
+// Mount now if sdInit() hasn't been tried this boot (the deep-sleep fast
+// path skips it).  The file and asset helpers below call this themselves.
+bool sdEnsureMounted();
+
 // Unmount and de-initialise.
 void sdDeinit();
 
@@ -31,12 +35,25 @@ String sdCardInfo();
 
 // ---- JSON config file (/sdcard/config.json) ----
 
+// Team board member (config.json "team": [{"id": "<object id>", "name": "Ana"}])
+#define SD_TEAM_MAX 8
+
+struct SdTeamMember {
+    String id;      // Entra ID user object id
+    String name;    // short label for the row
+};
+
 struct SdConfig {
-    int    platform       = 0;          // 0=Teams, 1=Zoom
+    int    platform       = 0;          // 0=Teams, 1=Zoom, 2=both
     bool   invertDisplay  = false;
     bool   audioAlerts    = false;
     int    presenceInterval = 120;      // seconds between presence polls
     int    fullRefreshEvery = 10;       // do full refresh every N partial updates
+    int    maxStaleness   = 900;        // longest calendar-gap sleep in seconds
+    int    pollProfile    = 0;          // 0=Responsive, 1=Battery
+    int    pollMinSec     = 30;         // adaptive poll interval bounds (seconds)
+    int    pollMaxSec     = 900;
+    int    mergeRule      = 0;          // Teams+Zoom: 0=busiest, 1=Teams first, 2=Zoom first
     String timezone       = "UTC";
     // Office hours deep-sleep schedule
     bool    officeHoursEnabled = false;
@@ -45,13 +62,18 @@ struct SdConfig {
     int     officeEndHour      = 17;
     int     officeEndMin       = 0;
     uint8_t officeDays         = 0x1F;  // Mon-Fri bitmask (bit0=Mon..bit6=Sun)
+    // Team board (team_board.h) — edited on the card only, never written
+    bool         teamBoard = false;
+    int          teamCount = 0;
+    SdTeamMember team[SD_TEAM_MAX];
 };
 
 // Load config from SD.  Returns true on success; fills `cfg` with values.
 // Missing keys keep their defaults.
 bool sdLoadConfig(SdConfig& cfg);
 
-// Save config to SD.  Returns true on success.
+// Save config to SD.  Returns true on success.  Keys this struct doesn't
+// write (the team list, anything added by hand) are kept.
 bool sdSaveConfig(const SdConfig& cfg);
 
 // ---- Plain text file helpers ----
@@ -59,6 +81,9 @@ bool sdSaveConfig(const SdConfig& cfg);
 // Write a string to a file on SD.  Creates/overwrites.  Returns true on success.
 bool sdWriteText(const char* path, const String& content);
 
+// Append a string to a file on SD (created if missing).  Returns true on success.
+bool sdAppendText(const char* path, const String& content);
+
 // Read entire file as a String.  Returns empty string on failure.
 String sdReadText(const char* path);
 
@@ -70,6 +95,9 @@ bool sdFileExists(const char* path);
 // Get file size in bytes.  Returns -1 if file not found.
 int32_t sdFileSize(const char* path);
 
+// Get last-modified time (FAT timestamp).  Returns 0 if file not found.
+time_t sdFileModified(const char* path);
+
 // Read an entire file into a heap-allocated buffer.
 // Caller must free() the returned pointer.  Sets `outLen` to bytes read.
 // Returns nullptr on failure.
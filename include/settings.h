@@ -11,17 +11,42 @@
 enum Platform {
     PLATFORM_TEAMS = 0,
     PLATFORM_ZOOM  = 1,
-    PLATFORM_COUNT = 2
+    PLATFORM_BOTH  = 2,    // Teams + Zoom fetched together, merged (presence_merge.h)
+    PLATFORM_COUNT = 3
 };
 
 const char* platformName(Platform p);
 
+// Poll policy — how eagerly the learned change history stretches sleeps
+enum PollProfile {
+    POLL_RESPONSIVE = 0,   // shrink hard in busy hours, stretch gently
+    POLL_BATTERY    = 1,   // stretch hard in quiet hours, shrink gently
+    POLL_PROFILE_COUNT = 2
+};
+
+const char* pollProfileName(PollProfile p);
+
+// PLATFORM_BOTH — which status is shown when Teams and Zoom disagree
+enum MergeRule {
+    MERGE_BUSIEST     = 0,   // Busy / DND / in a meeting on either wins
+    MERGE_TEAMS_FIRST = 1,   // Teams, unless it reports Offline / unknown
+    MERGE_ZOOM_FIRST  = 2,   // Zoom, unless it reports Offline / unknown
+    MERGE_RULE_COUNT  = 3
+};
+
+const char* mergeRuleName(MergeRule r);
+
 struct PodSettings {
     Platform platform     = PLATFORM_TEAMS;
     bool invertDisplay    = false;   // false = normal (white bg)
     bool audioAlerts      = false;   // false = silent
     int  presenceInterval = 120;     // seconds between presence polls
     int  fullRefreshEvery = 10;      // full refresh every N partial updates
+    int  maxStaleness     = 900;     // longest calendar-gap sleep (s); ≤ interval = off
+    PollProfile pollProfile = POLL_RESPONSIVE;
+    int  pollMinSec       = 30;      // adaptive poll interval bounds (s)
+    int  pollMaxSec       = 900;
+    MergeRule mergeRule   = MERGE_BUSIEST;
     // Office hours deep-sleep schedule
     String  timezone           = "";
     bool    officeHoursEnabled = false;
@@ -0,0 +1,95 @@
+// ============================================================================
+// Sound Bank — decoded SD clips in PSRAM + a compile-time sine wavetable
+//
+// Each notification clip is decoded from SD once, into PSRAM, as
+// interleaved 32-bit stereo frames at the I2S rate — exactly what
+// i2s_write() takes — so replaying it is a plain DMA copy with no SD
+// access or MP3 decode.  Synthesized tones come from a sine table built
+// at compile time, stepped by a phase accumulator (no sinf() per sample).
+//
+// Not thread-safe: clips are loaded and read on the audio decoder task,
+// or from the main task while the player is idle.
+// ============================================================================
+
+#ifndef SOUND_BANK_H
+#define SOUND_BANK_H
+
+#include <Arduino.h>
+
+enum SoundId : uint8_t {
+    SND_CLICK = 0,      // /audio/click.mp3 — buttons, beep
+    SND_NOTIFY,         // /audio/notify.mp3 — status change
+    SND_ATTENTION,      // /audio/attention.mp3 — errors, low battery
+    SND_COUNT
+};
+
+// A ready-to-DMA clip
+struct SoundClip {
+    const int32_t* frames;  // L, R interleaved; sample in the upper 16 bits
+    size_t         count;   // stereo frames
+};
+
+#define SOUND_BLOCK 512     // frames per sink call (one i2s_write)
+
+// Output rate for decoded clips (the I2S rate).  Call before any load.
+void soundBankInit(int sampleRate);
+
+// SD path of a clip
+const char* soundPath(SoundId id);
+
+// True if the clip is decoded, or its file is on SD (so a get can work)
+bool soundBankAvailable(SoundId id);
+
+// The clip for `id`, decoding it on first use.  nullptr if the file is
+// missing or won't decode — not retried until soundBankFree().
+const SoundClip* soundBankGet(SoundId id);
+
+// Decode every clip now (boot), so even the first click is immediate
+void soundBankLoadAll();
+
+// Release all clips (e.g. after the SD assets were replaced)
+void soundBankFree();
+
+// ---- Resampling ----
+//
+// Linear interpolation in Q16 fixed point: the source step per output
+// frame is computed once per stream, and the interpolation writes the
+// 32-bit slot value directly (a·(1−f) + b·f with f in Q16 is the sample
+// already shifted into the upper 16 bits).  State carries across decoder
+// blocks, so there is no seam or phase jump between MP3 frames.
+
+typedef void (*SoundSink)(const int32_t* frames, int count, void* ctx);
+
+struct SoundResampler {
+    int      srcRate;               // 0 = not primed
+    int      dstRate;
+    uint32_t step;                  // Q16 source frames per output frame
+    uint32_t pos;                   // Q16, 0 = the held frame below
+    int32_t  prevL, prevR;          // last source frame of the previous block
+    int32_t  out[SOUND_BLOCK * 2];  // output block handed to the sink
+};
+
+// Start a new stream at `dstRate`
+void soundResamplerInit(SoundResampler& r, int dstRate);
+
+// Resample one decoded MP3 block (int16, `nChans` interleaved) to 32-bit
+// stereo, handing it to `sink` up to SOUND_BLOCK frames at a time.  A new
+// `srcRate` restarts the stream.
+void soundResample(SoundResampler& r, const int16_t* pcm, size_t len, int nChans,
+                   int srcRate, SoundSink sink, void* ctx);
+
+#ifdef POD_AUDIO_BENCH
+// Cycles per output frame: the old nearest-sample loop vs soundResample()
+void soundResampleBench();
+#endif
+
+// ---- Synthesized tones ----
+
+// Phase increment for a sine of `freqHz` at `sampleRate`
+uint32_t soundToneStep(int freqHz, int sampleRate);
+
+// Fill `count` stereo frames from the wavetable.  `phase` carries over
+// between calls so consecutive blocks join without a click.
+void soundToneFill(uint32_t& phase, uint32_t step, int32_t* frames, int count);
+
+#endif
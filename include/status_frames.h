@@ -0,0 +1,73 @@
+// ============================================================================
+// Status Frames — pre-rendered presence screens, ready to send to the panel
+//
+// Every status screen (one per BMP in /graphics, see statusFrameBmpPath())
+// is rendered once into a packed 200×200 1-bpp frame in the controller's
+// native layout (bit 1 = white, MSB first, 25 bytes per row) and kept in
+// the "frames" flash partition, so a deep-sleep wake only has to read
+// 5000 bytes and push them to the panel.  The set is rebuilt when the
+// manifest (firmware version + BMP sizes/dates) changes.  Without the
+// partition the frames are kept in PSRAM for the current session only.
+//
+// The battery icon is not part of a frame — the caller overlays it.
+// ============================================================================
+
+#ifndef STATUS_FRAMES_H
+#define STATUS_FRAMES_H
+
+#include <Arduino.h>
+#include "presence_model.h"
+
+#define STATUS_FRAME_BYTES  5000        // 200 × 200 / 8
+
+enum StatusFrameSlot {
+    FRAME_CALL = 0,
+    FRAME_PRESENTING,
+    FRAME_AVAILABLE,
+    FRAME_AWAY,
+    FRAME_BRB,
+    FRAME_BUSY,
+    FRAME_DND,
+    FRAME_OFFLINE,
+    FRAME_OOO,
+    FRAME_SLOT_COUNT
+};
+
+// Where a frame's pixels came from
+enum FrameSource : uint8_t {
+    FRAME_NONE  = 0,
+    FRAME_BMP   = 1,    // SD image — valid for any status mapping to the slot
+    FRAME_DRAWN = 2     // programmatic — valid only for the exact pair drawn
+};
+
+// Slot for an availability/activity pair, or -1 if it has none
+inline int statusFrameSlot(Availability availability, Activity activity) {
+    return presenceFrameSlot(availability, activity);
+}
+
+// SD path of the slot's BMP ("/graphics/status_*.bmp")
+const char* statusFrameBmpPath(int slot);
+
+// Representative availability/activity pair to draw when the slot has no BMP
+void statusFrameCanonical(int slot, Availability& availability, Activity& activity);
+
+// Hash of everything a frame depends on (`salt` = firmware version).
+// Reads the BMP sizes and modification dates from SD.
+uint32_t statusFramesManifest(const char* salt);
+
+// True if the stored set was built for `manifest`
+bool statusFramesValid(uint32_t manifest);
+
+// Rebuild: begin (erases the store), put each slot, then commit.  The set
+// is only valid once committed, so an interrupted rebuild is redone.
+bool statusFramesBeginRebuild();
+bool statusFramesPut(int slot, FrameSource src, Availability availability,
+                     Activity activity, const uint8_t* frame);
+bool statusFramesCommit(uint32_t manifest);
+
+// Copy the frame for this pair into `out` (STATUS_FRAME_BYTES).  Returns
+// its source, or FRAME_NONE on a miss (no slot, not built, drawn for a
+// different pair, or checksum mismatch).
+FrameSource statusFramesGet(Availability availability, Activity activity, uint8_t* out);
+
+#endif
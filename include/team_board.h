@@ -0,0 +1,46 @@
+// ============================================================================
+// Team Board — several people's Teams presence on one pod
+//
+// One Graph POST /communications/getPresencesByUserId per wake returns the
+// availability of every configured member (config.json "team" list), so
+// the cost is a single request however many rows are shown.  The member
+// list and each row's last availability live in RTC memory: timer wakes
+// need no SD card, and only rows whose state changed are redrawn.
+//
+// Needs the Presence.Read.All delegated scope (no admin consent), which
+// sign-in requests only while config.json lists members — adding a board
+// to a pod that signed in without one means signing in again.
+// ============================================================================
+
+#ifndef TEAM_BOARD_H
+#define TEAM_BOARD_H
+
+#include <Arduino.h>
+#include "sd_storage.h"
+#include "presence_model.h"
+
+#define TEAM_MAX_MEMBERS SD_TEAM_MAX
+
+// Take the member list from config.json (normal boot).  Rows whose member
+// id is unchanged keep their last state.
+void teamBoardConfigure(const SdConfig& cfg);
+
+// Convenience: read config.json and configure (no-op without SD)
+void teamBoardLoad();
+
+// True when team board mode is enabled and has at least one member
+bool teamBoardActive();
+
+// True once a fetch has filled in every row since the list was configured
+bool teamBoardFetched();
+
+int          teamBoardCount();
+const char*  teamMemberName(int i);
+Availability teamMemberAvailability(int i);
+
+// Fetch every member's presence in one request.  `changed` gets a bit per
+// row whose availability differs from the stored one.  On 401 the cached
+// access token is invalidated, as getPresence() does.
+bool teamFetch(const char* accessToken, uint8_t& changed);
+
+#endif
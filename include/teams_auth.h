@@ -24,13 +24,16 @@ int  pollForToken(const String& clientId, const String& tenantId,
 
 // --- Token management ---
 bool   refreshAccessToken(const String& clientId, const String& tenantId);
-String getAccessToken();
+const char* getAccessToken();     // fixed buffer, "" when none
 bool   hasValidToken();
 bool   hasStoredRefreshToken();
 bool   isTokenExpiringSoon();
 long   getTokenExpirySeconds();   // seconds until token expires (negative = expired)
+void   invalidateAccessToken();   // drop a token the server rejected (401)
 
 // --- NVS persistence ---
+// Loads any cached access token (RTC → NVS); the refresh token (SD → NVS)
+// is read on first use
 void loadAuthFromNVS();
 void saveAuthToNVS();
 void clearAuthNVS();
@@ -2,18 +2,16 @@
 #define TEAMS_PRESENCE_H
 
 #include <Arduino.h>
+#include "presence_model.h"
 
-// Presence state returned by Microsoft Graph /me/presence
+// Presence state returned by Microsoft Graph /me/presence (or Zoom)
 struct PresenceState {
-    String availability;   // Available, Away, BeRightBack, Busy, DoNotDisturb, Offline, PresenceUnknown
-    String activity;       // InACall, InAMeeting, Presenting, etc.
-    bool   valid;
+    Availability availability = AV_UNKNOWN;
+    Activity     activity     = ACT_NONE;
+    bool         valid        = false;
 };
 
 // Fetch current presence from Graph API
-bool getPresence(const String& accessToken, PresenceState& state);
-
-// Human-readable label for the UI
-const char* availabilityLabel(const String& availability);
+bool getPresence(const char* accessToken, PresenceState& state);
 
 #endif
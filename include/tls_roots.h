@@ -0,0 +1,23 @@
+// ============================================================================
+// TLS Roots — pinned root CAs for the hosts the pod talks to
+//
+// PEM strings for WiFiClientSecure::setCACert(); each may hold several
+// certificates back to back (mbedTLS parses them all).  Roots only, so a
+// host rotating its issuing CA keeps working; a move to a different root
+// needs it added here.  The embedded Mozilla bundle (-DPOD_TLS_CA_BUNDLE)
+// replaces these when built in.
+// ============================================================================
+
+#ifndef TLS_ROOTS_H
+#define TLS_ROOTS_H
+
+// graph.microsoft.com, login.microsoftonline.com
+extern const char TLS_ROOTS_MICROSOFT[];
+
+// zoom.us, api.zoom.us
+extern const char TLS_ROOTS_ZOOM[];
+
+// Every root above — for a host outside the known list
+extern const char TLS_ROOTS_ALL[];
+
+#endif
@@ -0,0 +1,37 @@
+// ============================================================================
+// Token Cache — access tokens that survive deep sleep
+//
+// A single RTC-memory slot holds the active platform's access token plus
+// its absolute expiry in time() seconds.  The ESP32 keeps time() running
+// from the RTC timer across deep sleep, so a token fetched on one wake is
+// still usable on the next.  Tokens too large for the RTC slot spill to
+// NVS instead (only honoured once the wall clock has been set by NTP).
+// ============================================================================
+
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include <Arduino.h>
+#include <time.h>
+
+// Which platform owns the cached token
+enum TokenSlot : uint8_t {
+    TOKEN_SLOT_TEAMS = 1,
+    TOKEN_SLOT_ZOOM  = 2
+};
+
+// Store a token with its absolute expiry (time() seconds).
+bool tokenCacheStore(TokenSlot slot, const char* token, time_t expiry);
+
+// Restore a token for `slot`.  Fails if missing, expired or the clock has
+// gone backwards since it was issued (power loss wipes RTC time), or if it
+// doesn't fit in `cap` bytes (including the terminator).
+bool tokenCacheLoad(TokenSlot slot, char* token, size_t cap, time_t& expiry);
+
+// Drop the cached token for `slot` (RTC + NVS)
+void tokenCacheClear(TokenSlot slot);
+
+// True once time() has been set from NTP (vs. seconds since power-on)
+bool tokenClockIsSet(time_t t);
+
+#endif
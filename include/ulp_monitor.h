@@ -0,0 +1,59 @@
+// ============================================================================
+// ULP Monitor — battery watch during deep sleep
+//
+// While the main cores sleep between presence polls, the ULP coprocessor
+// samples the battery ADC every ULP_SAMPLE_SEC and leaves the reading in
+// RTC slow memory.  It wakes the SoC only when the battery falls through
+// the warning or shutdown level, which can't wait for the next poll.  The
+// poll itself stays on the RTC timer and the buttons on ext1, both of
+// which cost nothing while asleep.
+//
+// USB isn't watched: the board routes no VBUS or charger-status line to an
+// RTC GPIO, and with the charger holding the cell near 4.2 V the battery
+// rarely reaches BATTERY_USB_V.  The next poll wake sees USB through
+// batteryOnUSB() instead.
+//
+// A timer wake then takes its battery reading from the ULP instead of
+// sampling the ADC itself.
+//
+// The program is the ULP-FSM one, assembled at run time from the IDF
+// macros, so it needs no separate ULP toolchain.  Its data words and code
+// start at RTC_SLOW_MEM[0] and take under 200 bytes of
+// CONFIG_ESP32S3_ULP_COPROC_RESERVE_MEM (the core's default of 512 is
+// plenty; a static_assert checks it).  Without
+// CONFIG_ESP32S3_ULP_COPROC_ENABLED everything here is a no-op.
+// ============================================================================
+
+#ifndef ULP_MONITOR_H
+#define ULP_MONITOR_H
+
+#include <Arduino.h>
+
+#define ULP_SAMPLE_SEC 10       // ULP timer period
+
+enum UlpWakeReason : uint8_t {
+    ULP_WAKE_NONE = 0,          // the ULP didn't wake us (timer or button)
+    ULP_WAKE_BATT_WARN,
+    ULP_WAKE_BATT_SHUTDOWN,
+};
+
+struct UlpReport {
+    UlpWakeReason reason;
+    float         voltage;      // last ULP sample
+    uint32_t      samples;      // taken during the sleep (wraps at 65536)
+    int           secondsLeft;  // until the poll the sleep was armed for
+};
+
+// Load and start the monitor for a sleep of `sleepSec`, with thresholds for
+// the current charge: the warning level is only armed while above it, so a
+// low pod isn't woken every sample.  Enables the ULP wake source.  Call
+// right before esp_deep_sleep_start().
+bool ulpMonitorStart(int sleepSec, int warnPct, int shutdownPct);
+
+// After a deep-sleep wake: stop the ULP (it shares the ADC) and read what
+// it left.  False if it wasn't running or never sampled.
+bool ulpMonitorCollect(UlpReport& out);
+
+const char* ulpWakeReasonName(UlpWakeReason reason);
+
+#endif
@@ -0,0 +1,74 @@
+// ============================================================================
+// Wake Profiler — where a timer wake's time (and charge) goes
+//
+// Each deep-sleep timer wake gets one record: per-phase milliseconds, total
+// wake time, CPU frequency, WiFi RSSI, battery mV, outcome, the sleep
+// that followed and how long each power_policy lock was held.  Records live in a 16-entry RTC ring buffer and are
+// appended to /user/wakes.csv in batches — only when the SD card is already
+// mounted, so profiling never powers the card up by itself.  Phases
+// recorded outside a timer wake (normal mode) are ignored.
+// ============================================================================
+
+#ifndef WAKE_PROFILER_H
+#define WAKE_PROFILER_H
+
+#include <Arduino.h>
+
+enum WakePhase : uint8_t {
+    WP_BATTERY = 0,     // ADC read + USB check
+    WP_SD_MOUNT,
+    WP_SETTINGS,        // snapshot restore or SD/NVS load
+    WP_WIFI,
+    WP_NTP,             // time spent waiting for the background sync
+    WP_TLS,             // handshakes
+    WP_HTTP,            // request → status line
+    WP_JSON,            // body streaming + parse
+    WP_EPD,             // panel BUSY during refreshes
+    WP_LIGHT,
+    WP_AUDIO,
+    WP_PHASE_COUNT
+};
+
+enum WakeOutcome : uint8_t {
+    WAKE_UNCHANGED = 0,
+    WAKE_CHANGED,       // status changed — display updated, normal mode
+    WAKE_WIFI_FAIL,
+    WAKE_OFF_HOURS,
+    WAKE_LOW_BATTERY,
+    WAKE_OUTCOME_COUNT
+};
+
+// Start a record (timer wake only).  Wake time counts from reset.
+void wakeProfBegin();
+
+// Add time to a phase of the open record
+void wakeProfAdd(WakePhase phase, uint32_t ms);
+
+// Context for the record
+void wakeProfSetBattery(int millivolts);
+void wakeProfSetOutcome(WakeOutcome outcome);
+
+// Close the record into the ring (`sleepSec` = the sleep that follows, 0 if
+// none) and flush a batch to SD if the card is mounted.  No-op if no
+// record is open.
+void wakeProfEnd(int sleepSec);
+
+// Append all unflushed records to /user/wakes.csv (SD must be mounted)
+void wakeProfFlush();
+
+// Two short lines for the Device Info screen: median/p95 wake time and the
+// slowest phase, estimated mAh/day
+void wakeProfDescribe(char* line1, size_t len1, char* line2, size_t len2);
+
+// Times a scope into a phase
+class WakePhaseTimer
+{
+  public:
+    explicit WakePhaseTimer(WakePhase phase) : _phase(phase), _t0(millis()) {}
+    ~WakePhaseTimer() { wakeProfAdd(_phase, millis() - _t0); }
+  private:
+    WakePhase _phase;
+    uint32_t  _t0;
+};
+
+#endif
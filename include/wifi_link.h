@@ -0,0 +1,20 @@
+// ============================================================================
+// WiFi Link — station connect with RTC-cached fast reconnect
+//
+// After a successful association the AP's BSSID and channel (plus the DHCP
+// lease: IP / gateway / mask / DNS) are kept in RTC memory.  The next wake
+// joins that exact AP on that channel with a static config — no scan, no
+// DHCP — and only falls back to a normal scan + DHCP if that fails.
+// The cache is keyed on SSID + password, so re-provisioning invalidates it.
+// ============================================================================
+
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <Arduino.h>
+
+// Connect to `ssid`, fast path first.  Waits on WiFi events (no polling).
+bool wifiConnect(const String& ssid, const String& password,
+                 unsigned long timeoutMs);
+
+#endif
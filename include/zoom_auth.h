@@ -18,9 +18,14 @@ bool zoomFetchToken(const String& accountId,
                     const String& clientSecret);
 
 // --- Token management ---
-String zoomGetAccessToken();
+const char* zoomGetAccessToken();   // fixed buffer, "" when none
 bool   zoomHasValidToken();
 bool   zoomIsTokenExpiringSoon();
 long   zoomGetTokenExpirySeconds();
 
+// Restore the token cached before deep sleep.  Returns true if still valid.
+bool   zoomLoadCachedToken();
+// Drop a token the server rejected (401)
+void   zoomInvalidateToken();
+
 #endif
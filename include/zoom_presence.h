@@ -12,6 +12,6 @@
 
 // Fetch current presence from Zoom API.
 // Maps Zoom status strings to Teams-compatible availability values.
-bool getZoomPresence(const String& accessToken, PresenceState& state);
+bool getZoomPresence(const char* accessToken, PresenceState& state);
 
 #endif
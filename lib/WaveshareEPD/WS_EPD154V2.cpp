@@ -9,6 +9,11 @@
 //   - _setPartialRamArea(): data entry mode 0x01 (X inc, Y dec) + matching window/cursor
 
 #include "WS_EPD154V2.h"
+#if defined(ESP32)
+#include <esp_heap_caps.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#endif
 
 // Custom waveform LUT from Waveshare factory firmware
 // Bytes 0-152: waveform phases  |  153: gate voltage  |  154: source voltage
@@ -73,18 +78,30 @@ void WS_EPD154V2::clearScreen(uint8_t value)
   _writeScreenBuffer(0x24, value); // set current
   refresh(false); // full refresh
   _initial_write = false;
+  if (_shadowReady())
+  {
+    memset(_shadow, value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
+    _shadow_valid = true;
+  }
 }
 
 void WS_EPD154V2::writeScreenBuffer(uint8_t value)
 {
   if (_initial_write) return clearScreen(value);
   _writeScreenBuffer(0x24, value);
+  invalidateShadow();
 }
 
 void WS_EPD154V2::writeScreenBufferAgain(uint8_t value)
 {
   _writeScreenBuffer(0x24, value);
   _writeScreenBuffer(0x26, value);
+  if (_shadowReady())
+  {
+    memset(_shadow, value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
+    _shadow_valid = true;
+    _diff_pending = false;
+  }
 }
 
 void WS_EPD154V2::_writeScreenBuffer(uint8_t command, uint8_t value)
@@ -92,12 +109,12 @@ void WS_EPD154V2::_writeScreenBuffer(uint8_t command, uint8_t value)
   if (!_init_display_done) _InitDisplay();
   _setPartialRamArea(0, 0, WIDTH, HEIGHT);
   _writeCommand(command);
-  _startTransfer();
+  _bulkBegin();
   for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
   {
     _transfer(value);
   }
-  _endTransfer();
+  _bulkEnd();
 }
 
 // ============================================================================
@@ -106,19 +123,83 @@ void WS_EPD154V2::_writeScreenBuffer(uint8_t command, uint8_t value)
 
 void WS_EPD154V2::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
+  _awaitRefresh();  // before _findDirty() reuses the boxes
+  bool pending = _diff_pending;
+  _diff_pending = false;
+  if (!pending && _diffable(x, y, w, h, mirror_y, pgm))
+  {
+    if (!_init_display_done) _InitDisplay();
+    if (_initial_write) writeScreenBuffer();
+    if (_shadow_valid)
+    {
+      uint32_t bytes = 0;
+      uint8_t n = _findDirty(bitmap, x, y, w, h, invert);
+      for (uint8_t i = 0; i < n; i++)
+      {
+        _writeBox(0x24, bitmap, x, y, w, _dirty[i], invert);
+        bytes += uint32_t(_dirty[i].w / 8) * _dirty[i].h;
+      }
+      _diff_pending = true;
+      if (_diag_enabled)
+        Serial.printf("[EPD] diff: %u box(es), %u of %u bytes\n", _dirty_count,
+                      (unsigned)bytes, (unsigned)(uint32_t(w / 8) * h));
+      return;
+    }
+  }
+  if (pending) invalidateShadow();   // unpaired writeImage — RAMs out of step
   _writeImage(0x24, bitmap, x, y, w, h, invert, mirror_y, pgm);
 }
 
 void WS_EPD154V2::writeImageForFullRefresh(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
+  _awaitRefresh();
+  _diff_pending = false;
   _writeImage(0x26, bitmap, x, y, w, h, invert, mirror_y, pgm);
   _writeImage(0x24, bitmap, x, y, w, h, invert, mirror_y, pgm);
+  _noteWritten(bitmap, x, y, w, h, invert, mirror_y, pgm);
 }
 
 void WS_EPD154V2::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
+  if (_refresh_pending && _diffable(x, y, w, h, mirror_y, pgm))
+  {
+    // Panel still refreshing — keep the frame in the shadow, sync 0x26 later
+    bool whole = (x == 0) && (y == 0) && (w == int16_t(WIDTH)) && (h == int16_t(HEIGHT));
+    if (_diff_pending)
+    {
+      _shadowStore(bitmap, x, y, w, h, invert);
+      _diff_pending = false;
+      _again_pending = true;
+      _again_boxes = true;
+      return;
+    }
+    if (_shadow_valid && _shadowMatches(bitmap, x, y, w, h, invert)) return;
+    if (whole)
+    {
+      _shadowStore(bitmap, x, y, w, h, invert);
+      _shadow_valid = false;  // until both RAMs have it
+      _again_pending = true;
+      _again_boxes = false;
+      return;
+    }
+  }
+  _awaitRefresh();
+  if (_diff_pending)
+  {
+    // 0x24 already has the changed bands — bring 0x26 up to date
+    for (uint8_t i = 0; i < _dirty_count; i++)
+      _writeBox(0x26, bitmap, x, y, w, _dirty[i], invert);
+    _shadowStore(bitmap, x, y, w, h, invert);
+    _diff_pending = false;
+    return;
+  }
+  // After writeImageForFullRefresh both RAMs already hold this frame
+  if (_diffable(x, y, w, h, mirror_y, pgm) && _shadow_valid &&
+      _shadowMatches(bitmap, x, y, w, h, invert))
+    return;
   _writeImage(0x26, bitmap, x, y, w, h, invert, mirror_y, pgm);
   _writeImage(0x24, bitmap, x, y, w, h, invert, mirror_y, pgm);
+  _noteWritten(bitmap, x, y, w, h, invert, mirror_y, pgm);
 }
 
 void WS_EPD154V2::_writeImage(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -140,7 +221,7 @@ void WS_EPD154V2::_writeImage(uint8_t command, const uint8_t bitmap[], int16_t x
   if (_initial_write) writeScreenBuffer();
   _setPartialRamArea(x1, y1, w1, h1);
   _writeCommand(command);
-  _startTransfer();
+  _bulkBegin();
   for (int16_t i = 0; i < h1; i++)
   {
     for (int16_t j = 0; j < w1 / 8; j++)
@@ -163,7 +244,7 @@ void WS_EPD154V2::_writeImage(uint8_t command, const uint8_t bitmap[], int16_t x
       _transfer(data);
     }
   }
-  _endTransfer();
+  _bulkEnd();
   delay(1);
 }
 
@@ -183,6 +264,7 @@ void WS_EPD154V2::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, in
 void WS_EPD154V2::_writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                                    int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
+  invalidateShadow();  // part writes aren't tracked by the frame diff
   delay(1);
   if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
   if ((x_part < 0) || (x_part >= w_bitmap)) return;
@@ -206,7 +288,7 @@ void WS_EPD154V2::_writeImagePart(uint8_t command, const uint8_t bitmap[], int16
   if (_initial_write) writeScreenBuffer();
   _setPartialRamArea(x1, y1, w1, h1);
   _writeCommand(command);
-  _startTransfer();
+  _bulkBegin();
   for (int16_t i = 0; i < h1; i++)
   {
     for (int16_t j = 0; j < w1 / 8; j++)
@@ -229,7 +311,7 @@ void WS_EPD154V2::_writeImagePart(uint8_t command, const uint8_t bitmap[], int16
       _transfer(data);
     }
   }
-  _endTransfer();
+  _bulkEnd();
   delay(1);
 }
 
@@ -306,6 +388,24 @@ void WS_EPD154V2::refresh(bool partial_update_mode)
 void WS_EPD154V2::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
 {
   if (_initial_refresh) return refresh(false);
+  if (_diff_pending)
+  {
+    // Only the bounding box of what writeImage() found changed
+    if (_dirty_count == 0) return;
+    int16_t x2 = 0, y2 = 0;
+    x = _dirty[0].x;
+    y = _dirty[0].y;
+    for (uint8_t i = 0; i < _dirty_count; i++)
+    {
+      const DirtyBox& b = _dirty[i];
+      if (b.x < x) x = b.x;
+      if (b.y < y) y = b.y;
+      if (b.x + b.w > x2) x2 = b.x + b.w;
+      if (b.y + b.h > y2) y2 = b.y + b.h;
+    }
+    w = x2 - x;
+    h = y2 - y;
+  }
   if (!_using_partial_mode)
   {
     _LoadLUT(WF_Partial_1IN54);  // switch to partial waveform
@@ -325,6 +425,146 @@ void WS_EPD154V2::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
   _Update_Part();
 }
 
+// ============================================================================
+// Frame diff
+//
+// Invariant: when _shadow_valid, both controller RAMs (0x24 new, 0x26 old)
+// hold exactly _shadow — except between a diffing writeImage() and its
+// writeImageAgain(), when 0x24 additionally holds the dirty boxes.
+// ============================================================================
+
+void WS_EPD154V2::invalidateShadow()
+{
+  _awaitRefresh();
+  _shadow_valid = false;
+  _diff_pending = false;
+  _dirty_count = 0;
+}
+
+bool WS_EPD154V2::_shadowReady()
+{
+  if (!_shadow)
+  {
+    const size_t n = uint32_t(WIDTH) * uint32_t(HEIGHT) / 8;
+#if defined(ESP32)
+    _shadow = (uint8_t*)heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#endif
+    if (!_shadow) _shadow = (uint8_t*)malloc(n);
+  }
+  return _shadow != nullptr;
+}
+
+// Byte-aligned, fully on-screen window from RAM — the case the diff handles
+bool WS_EPD154V2::_diffable(int16_t x, int16_t y, int16_t w, int16_t h, bool mirror_y, bool pgm)
+{
+  if (mirror_y || pgm) return false;
+  if ((x < 0) || (y < 0) || (w <= 0) || (h <= 0)) return false;
+  if ((x % 8) || (w % 8)) return false;
+  if ((x + w > int16_t(WIDTH)) || (y + h > int16_t(HEIGHT))) return false;
+  return _shadowReady();
+}
+
+void WS_EPD154V2::_shadowStore(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert)
+{
+  const int16_t wb = w / 8, sb = WIDTH / 8;
+  for (int16_t i = 0; i < h; i++)
+  {
+    const uint8_t* src = bitmap + i * wb;
+    uint8_t* dst = _shadow + (y + i) * sb + x / 8;
+    for (int16_t j = 0; j < wb; j++) dst[j] = invert ? ~src[j] : src[j];
+  }
+}
+
+bool WS_EPD154V2::_shadowMatches(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert)
+{
+  const int16_t wb = w / 8, sb = WIDTH / 8;
+  for (int16_t i = 0; i < h; i++)
+  {
+    const uint8_t* src = bitmap + i * wb;
+    const uint8_t* old = _shadow + (y + i) * sb + x / 8;
+    for (int16_t j = 0; j < wb; j++)
+    {
+      if (uint8_t(invert ? ~src[j] : src[j]) != old[j]) return false;
+    }
+  }
+  return true;
+}
+
+// Both RAMs were just written with this window the slow way
+void WS_EPD154V2::_noteWritten(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (!_diffable(x, y, w, h, mirror_y, pgm))
+  {
+    invalidateShadow();
+    return;
+  }
+  bool whole = (x == 0) && (y == 0) && (w == int16_t(WIDTH)) && (h == int16_t(HEIGHT));
+  if (!whole && !_shadow_valid) return;  // rest of the frame still unknown
+  _shadowStore(bitmap, x, y, w, h, invert);
+  _shadow_valid = true;
+}
+
+// Changed rows, grouped into bands (gaps up to DIRTY_MERGE_ROWS are joined),
+// each trimmed to the changed byte columns
+uint8_t WS_EPD154V2::_findDirty(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert)
+{
+  const int16_t wb = w / 8, sb = WIDTH / 8;
+  DirtyBox* cur = nullptr;
+  int16_t last_row = 0;
+  _dirty_count = 0;
+  for (int16_t i = 0; i < h; i++)
+  {
+    const uint8_t* src = bitmap + i * wb;
+    const uint8_t* old = _shadow + (y + i) * sb + x / 8;
+    int16_t first = -1, last = -1;
+    for (int16_t j = 0; j < wb; j++)
+    {
+      if (uint8_t(invert ? ~src[j] : src[j]) != old[j])
+      {
+        if (first < 0) first = j;
+        last = j;
+      }
+    }
+    if (first < 0) continue;
+    int16_t row = y + i;
+    int16_t bx1 = x + first * 8, bx2 = x + (last + 1) * 8;
+    if (cur && ((row - last_row <= DIRTY_MERGE_ROWS) || (_dirty_count == MAX_DIRTY_BOXES)))
+    {
+      int16_t x2 = cur->x + cur->w > bx2 ? cur->x + cur->w : bx2;
+      if (bx1 < cur->x) cur->x = bx1;
+      cur->w = x2 - cur->x;
+      cur->h = row - cur->y + 1;
+    }
+    else
+    {
+      cur = &_dirty[_dirty_count++];
+      cur->x = bx1;
+      cur->y = row;
+      cur->w = bx2 - bx1;
+      cur->h = 1;
+    }
+    last_row = row;
+  }
+  return _dirty_count;
+}
+
+void WS_EPD154V2::_writeBox(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, const DirtyBox& b, bool invert)
+{
+  const int16_t wb = w / 8;
+  _setPartialRamArea(b.x, b.y, b.w, b.h);
+  _writeCommand(command);
+  _bulkBegin();
+  for (int16_t i = 0; i < b.h; i++)
+  {
+    const uint8_t* src = bitmap + (b.y - y + i) * wb + (b.x - x) / 8;
+    for (int16_t j = 0; j < b.w / 8; j++)
+    {
+      _transfer(invert ? ~src[j] : src[j]);
+    }
+  }
+  _bulkEnd();
+}
+
 // ============================================================================
 // Power management
 // ============================================================================
@@ -432,8 +672,21 @@ void WS_EPD154V2::_LoadLUT(const uint8_t* lut)
   _writeData(pgm_read_byte(&lut[158]));
 }
 
+void WS_EPD154V2::warmResume(bool partial_lut)
+{
+  _warm = true;
+  _warm_partial_lut = partial_lut;
+  _initial_write = false;
+  _initial_refresh = false;
+}
+
 void WS_EPD154V2::_InitDisplay()
 {
+  // Controller RAM isn't guaranteed across a reset — unless we hibernated it
+  bool warm = _warm;
+  _warm = false;
+  if (!warm) invalidateShadow();
+
   // Full hardware reset (matching Waveshare factory timing)
   if (_rst >= 0)
   {
@@ -464,6 +717,16 @@ void WS_EPD154V2::_InitDisplay()
   _writeCommand(0x18);
   _writeData(0x80);
 
+  if (warm)
+  {
+    // Custom LUT replaces the built-in one anyway — load only the one in use
+    _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+    _LoadLUT(_warm_partial_lut ? WF_Partial_1IN54 : WF_Full_1IN54);
+    _using_partial_mode = _warm_partial_lut;
+    _init_display_done = true;
+    return;
+  }
+
   // Load temperature + built-in waveform first
   _writeCommand(0x22);
   _writeData(0xB1);
@@ -489,8 +752,8 @@ void WS_EPD154V2::_Update_Full()
   _writeCommand(0x22);
   _writeData(0xC7);
   _writeCommand(0x20);
-  _waitWhileBusy("_Update_Full", full_refresh_time);
   _power_is_on = false;
+  _startUpdate("_Update_Full", full_refresh_time);
 }
 
 void WS_EPD154V2::_Update_Part()
@@ -499,6 +762,171 @@ void WS_EPD154V2::_Update_Part()
   _writeCommand(0x22);
   _writeData(0xCF);
   _writeCommand(0x20);
-  _waitWhileBusy("_Update_Part", partial_refresh_time);
   _power_is_on = true;
+  _startUpdate("_Update_Part", partial_refresh_time);
+}
+
+// Sync: wait here.  Async: note the update and return; _awaitRefresh() ends it.
+void WS_EPD154V2::_startUpdate(const char* comment, uint16_t busy_time)
+{
+  uint32_t start = millis();
+#if defined(ESP32)
+  if (_async && _busy >= 0 && _armBusyIrq())
+  {
+    xSemaphoreTake(_busy_sem, 0);  // drop a stale edge
+    _kick_ms = start;
+    _pending_comment = comment;
+    _pending_time = busy_time;
+    _refresh_pending = true;
+    return;
+  }
+#endif
+  _waitWhileBusy(comment, busy_time);
+  _busy_ms += millis() - start;
+}
+
+// ============================================================================
+// Private: BUSY handling
+// ============================================================================
+
+void WS_EPD154V2::_writeCommand(uint8_t c)
+{
+  _awaitRefresh();  // the controller ignores commands mid-update
+  GxEPD2_EPD::_writeCommand(c);
+}
+
+void WS_EPD154V2::_awaitRefresh()
+{
+  if (!_refresh_pending) return;
+  _refresh_pending = false;  // before the RAM sync below issues commands
+  _waitWhileBusy(_pending_comment, _pending_time);
+  uint32_t done = _done_ms;
+  _busy_ms += (int32_t(done - _kick_ms) >= 0 ? done : millis()) - _kick_ms;
+  if (_again_pending)
+  {
+    _again_pending = false;
+    if (_again_boxes)
+    {
+      for (uint8_t i = 0; i < _dirty_count; i++)
+        _writeBox(0x26, _shadow, 0, 0, WIDTH, _dirty[i], false);
+    }
+    else
+    {
+      _writeImage(0x26, _shadow, 0, 0, WIDTH, HEIGHT);
+      _writeImage(0x24, _shadow, 0, 0, WIDTH, HEIGHT);
+    }
+    _shadow_valid = true;
+  }
+}
+
+void WS_EPD154V2::setAsyncRefresh(bool enable)
+{
+  if (!enable) _awaitRefresh();
+  _async = enable;
+}
+
+void WS_EPD154V2::setBusySleepGate(bool (*gate)())
+{
+  _sleep_gate = gate;
+}
+
+void WS_EPD154V2::setTransferHook(void (*hook)(bool active))
+{
+  _xfer_hook = hook;
+}
+
+void WS_EPD154V2::_bulkBegin()
+{
+  if (_xfer_hook) _xfer_hook(true);
+  _startTransfer();
+}
+
+void WS_EPD154V2::_bulkEnd()
+{
+  _endTransfer();
+  if (_xfer_hook) _xfer_hook(false);
+}
+
+void WS_EPD154V2::setRefreshDoneCallback(void (*cb)(void*), void* arg)
+{
+  _done_cb = cb;
+  _done_arg = arg;
+}
+
+bool WS_EPD154V2::refreshBusy()
+{
+  return _refresh_pending && (digitalRead(_busy) == _busy_level);
+}
+
+void WS_EPD154V2::waitRefresh()
+{
+  _awaitRefresh();
+}
+
+#if defined(ESP32)
+void ARDUINO_ISR_ATTR WS_EPD154V2::_busyIsr(void* arg)
+{
+  WS_EPD154V2* self = (WS_EPD154V2*)arg;
+  self->_done_ms = millis();
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(self->_busy_sem, &woken);
+  if (self->_refresh_pending && self->_done_cb) self->_done_cb(self->_done_arg);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+bool WS_EPD154V2::_armBusyIrq()
+{
+  if (_busy_irq) return true;
+  if (!_busy_sem) _busy_sem = xSemaphoreCreateBinary();
+  if (!_busy_sem) return false;
+  attachInterruptArg(digitalPinToInterrupt(_busy), _busyIsr, this, _busy_level == HIGH ? FALLING : RISING);
+  _busy_irq = true;
+  return true;
+}
+
+void WS_EPD154V2::_lightSleepWhileBusy(uint32_t max_ms)
+{
+  gpio_num_t pin = gpio_num_t(_busy);
+  gpio_wakeup_enable(pin, _busy_level == HIGH ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup(uint64_t(max_ms) * 1000ULL);
+  esp_light_sleep_start();
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  gpio_wakeup_disable(pin);  // also cleared the edge interrupt — re-arm it
+  gpio_set_intr_type(pin, _busy_level == HIGH ? GPIO_INTR_NEGEDGE : GPIO_INTR_POSEDGE);
+  gpio_intr_enable(pin);
+}
+#endif
+
+void WS_EPD154V2::_waitWhileBusy(const char* comment, uint16_t busy_time)
+{
+#if defined(ESP32)
+  if (_busy >= 0 && _armBusyIrq())
+  {
+    unsigned long start = micros();
+    delay(1);  // margin for BUSY to go active
+    while (digitalRead(_busy) == _busy_level)
+    {
+      unsigned long elapsed = micros() - start;
+      if (elapsed > _busy_timeout)
+      {
+        Serial.println("Busy Timeout!");
+        break;
+      }
+      uint32_t left_ms = (_busy_timeout - elapsed) / 1000 + 1;
+      if (busy_time >= 200 && _sleep_gate && _sleep_gate())
+        _lightSleepWhileBusy(left_ms);
+      else  // re-check the pin now and then in case an edge was missed
+        xSemaphoreTake(_busy_sem, pdMS_TO_TICKS(left_ms < 100 ? left_ms : 100));
+    }
+    if (comment && _diag_enabled)
+    {
+      Serial.print(comment);
+      Serial.print(" : ");
+      Serial.println(micros() - start);
+    }
+    return;
+  }
+#endif
+  GxEPD2_EPD::_waitWhileBusy(comment, busy_time);
 }
@@ -7,11 +7,32 @@
 //      data entry mode 0x01, border 0x01, custom LUT + voltage loading
 //   2. _Update_Full(): uses 0xC7 (loaded LUT) instead of 0xF7 (built-in LUT)
 //   3. _setPartialRamArea(): uses data entry mode 0x01 (X inc, Y dec)
+//
+// Frame diff: the last frame written to both controller RAMs is shadowed
+// (PSRAM).  Byte-aligned writeImage() calls send only the changed row
+// bands, refresh() updates only their bounding box (or nothing when no
+// pixel changed), and writeImageAgain() copies the same bands to 0x26.
+//
+// BUSY: waits block on a BUSY-edge interrupt instead of polling, and may
+// light-sleep through long waits when the caller's gate allows it.  In
+// async mode refresh() returns once the update has started; the 0x26 sync
+// that writeImageAgain() would do is deferred (from the shadow), and the
+// next driver call waits for the panel first — so GxEPD2's nextPage()
+// flow and every draw*Screen() keep working unchanged.
+//
+// Warm resume: hibernate() keeps both RAMs (deep sleep mode 1).  After an
+// MCU deep sleep, init(initial = false) + warmResume() brings the
+// controller back with just the reset and the LUT that was in use, so the
+// first update can be partial against the retained previous image.
 
 #ifndef _WS_EPD154V2_H_
 #define _WS_EPD154V2_H_
 
 #include <GxEPD2_EPD.h>
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
 
 class WS_EPD154V2 : public GxEPD2_EPD
 {
@@ -55,7 +76,64 @@ class WS_EPD154V2 : public GxEPD2_EPD
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h);
     void powerOff();
     void hibernate();
+    // frame diff
+    void invalidateShadow();           // next write sends the whole window
+    // profiling
+    uint32_t refreshBusyMs() const { return _busy_ms; }  // BUSY time of refreshes since reset
+    // warm resume
+    bool partialLutLoaded() const { return _using_partial_mode; }
+    void warmResume(bool partial_lut);  // panel was hibernated with its RAM intact
+    // async refresh
+    void setAsyncRefresh(bool enable);                     // refresh() returns once the update runs
+    void setBusySleepGate(bool (*gate)());                 // light-sleep long BUSY waits while gate()
+    void setTransferHook(void (*hook)(bool active));       // around each RAM write burst (clock locks)
+    void setRefreshDoneCallback(void (*cb)(void*), void* arg);  // called from the BUSY interrupt
+    bool refreshBusy();                                    // an async update is still running
+    void waitRefresh();                                    // wait for it + write the deferred RAM sync
   private:
+    struct DirtyBox { int16_t x, y, w, h; };
+    static const uint8_t MAX_DIRTY_BOXES = 4;
+    static const int16_t DIRTY_MERGE_ROWS = 8;   // join bands closer than this
+    uint8_t* _shadow = nullptr;
+    bool _shadow_valid = false;
+    bool _diff_pending = false;        // 0x24 holds the dirty boxes, 0x26 doesn't yet
+    DirtyBox _dirty[MAX_DIRTY_BOXES];
+    uint8_t _dirty_count = 0;
+    uint32_t _busy_ms = 0;
+    bool _warm = false;                // next _InitDisplay() is a resume from hibernate
+    bool _warm_partial_lut = false;
+    bool _async = false;
+    volatile bool _refresh_pending = false;
+    bool _again_pending = false;       // writeImageAgain() deferred to the end of the update
+    bool _again_boxes = false;         //   just the dirty boxes to 0x26 (else the whole frame)
+    uint32_t _kick_ms = 0;
+    volatile uint32_t _done_ms = 0;
+    const char* _pending_comment = nullptr;
+    uint16_t _pending_time = 0;
+    bool (*_sleep_gate)() = nullptr;
+    void (*_xfer_hook)(bool) = nullptr;
+    void (*_done_cb)(void*) = nullptr;
+    void* _done_arg = nullptr;
+#if defined(ESP32)
+    SemaphoreHandle_t _busy_sem = nullptr;
+    bool _busy_irq = false;
+    static void _busyIsr(void* arg);
+    bool _armBusyIrq();
+    void _lightSleepWhileBusy(uint32_t max_ms);
+#endif
+    void _waitWhileBusy(const char* comment = 0, uint16_t busy_time = 5000);  // hides the polling one
+    void _writeCommand(uint8_t c);                                            // waits out an async update
+    void _awaitRefresh();
+    void _startUpdate(const char* comment, uint16_t busy_time);
+    bool _shadowReady();
+    bool _diffable(int16_t x, int16_t y, int16_t w, int16_t h, bool mirror_y, bool pgm);
+    void _shadowStore(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert);
+    bool _shadowMatches(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert);
+    void _noteWritten(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm);
+    uint8_t _findDirty(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert);
+    void _writeBox(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, const DirtyBox& b, bool invert);
+    void _bulkBegin();                                                        // _startTransfer() + hook
+    void _bulkEnd();
     void _writeScreenBuffer(uint8_t command, uint8_t value);
     void _writeImage(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void _writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
@@ -0,0 +1,215 @@
+// ============================================================================
+// Host simulation — Arduino core shim
+//
+// Just enough of the ESP32 Arduino core for the firmware modules the
+// native build compiles (platformio.ini [env:native]).  Time is the
+// simulation clock: millis(), delay() and time() all read or advance it,
+// and every advance is charged to the energy model (sim/sim_core.h).
+//
+// RTC_DATA_ATTR variables land in their own section.  The driver keeps a
+// copy of it across deep sleep and restores the link-time image on any
+// other reset — the same retention rules as RTC slow memory.
+// ============================================================================
+
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+
+#define ARDUINO 10819           // ArduinoJson: String / Stream / Print support
+
+#define RTC_DATA_ATTR   __attribute__((section("pod_rtc")))
+#define RTC_NOINIT_ATTR __attribute__((section("pod_rtc_noinit")))
+#define IRAM_ATTR
+
+#define LOW           0x0
+#define HIGH          0x1
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+
+#define DEC 10
+#define HEX 16
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+enum adc_attenuation_t { ADC_0db, ADC_2_5db, ADC_6db, ADC_11db };
+
+using std::min;
+using std::max;
+
+// ---- Time (simulation clock) ----
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void yield();
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+
+// ---- GPIO / ADC ----
+void     pinMode(uint8_t pin, uint8_t mode);
+void     digitalWrite(uint8_t pin, uint8_t val);
+int      digitalRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+void     analogSetAttenuation(adc_attenuation_t atten);
+
+uint32_t getCpuFrequencyMhz();
+bool     psramFound();
+
+// ============================================================================
+// String
+// ============================================================================
+class String
+{
+  public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(int v, unsigned char base = 10)           { _num(v, base); }
+    explicit String(unsigned int v, unsigned char base = 10)  { _num(v, base); }
+    explicit String(long v, unsigned char base = 10)          { _num(v, base); }
+    explicit String(unsigned long v, unsigned char base = 10) { _num((long)v, base); }
+    explicit String(double v, unsigned int decimals = 2);
+
+    const char* c_str() const      { return _s.c_str(); }
+    unsigned int length() const    { return (unsigned int)_s.size(); }
+    bool isEmpty() const           { return _s.empty(); }
+    bool reserve(unsigned int n)   { _s.reserve(n); return true; }
+    long toInt() const             { return strtol(_s.c_str(), nullptr, 10); }
+    float toFloat() const          { return strtof(_s.c_str(), nullptr); }
+    void trim();
+
+    bool concat(const String& s)   { _s += s._s; return true; }
+    bool concat(const char* s)     { if (s) _s += s; return true; }
+    bool concat(const char* s, unsigned int n) { if (s) _s.append(s, n); return true; }
+    bool concat(char c)            { _s += c; return true; }
+    bool concat(int v)             { return concat(String(v)); }
+    bool concat(unsigned int v)    { return concat(String(v)); }
+    bool concat(long v)            { return concat(String(v)); }
+    bool concat(unsigned long v)   { return concat(String(v)); }
+
+    String& operator+=(const String& s) { concat(s); return *this; }
+    String& operator+=(const char* s)   { concat(s); return *this; }
+    String& operator+=(char c)          { concat(c); return *this; }
+    String& operator+=(int v)           { concat(v); return *this; }
+    String& operator+=(unsigned int v)  { concat(v); return *this; }
+    String& operator+=(long v)          { concat(v); return *this; }
+    String& operator+=(unsigned long v) { concat(v); return *this; }
+
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator==(const char* o) const   { return _s == (o ? o : ""); }
+    bool operator!=(const String& o) const { return !(*this == o); }
+    bool operator!=(const char* o) const   { return !(*this == o); }
+    bool operator<(const String& o) const  { return _s < o._s; }
+    char operator[](unsigned int i) const  { return i < _s.size() ? _s[i] : '\0'; }
+    char& operator[](unsigned int i)       { return _s[i]; }
+
+    bool equals(const String& o) const     { return *this == o; }
+    bool equalsIgnoreCase(const String& o) const;
+    bool startsWith(const String& p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+    bool endsWith(const String& p) const;
+    int  indexOf(char c, unsigned int from = 0) const;
+    int  indexOf(const String& s, unsigned int from = 0) const;
+    int  lastIndexOf(char c) const;
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const;
+    void remove(unsigned int index)        { if (index < _s.size()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+    void replace(const String& from, const String& to);
+    void toLowerCase();
+    void toUpperCase();
+
+  private:
+    void _num(long v, unsigned char base);
+    std::string _s;
+};
+
+String operator+(const String& a, const String& b);
+String operator+(const String& a, const char* b);
+String operator+(const char* a, const String& b);
+String operator+(const String& a, char b);
+
+// ============================================================================
+// Print / Stream
+// ============================================================================
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* data, size_t len);
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+    size_t write(const char* s, size_t len) { return write((const uint8_t*)s, len); }
+    virtual void flush() {}
+
+    size_t print(const char* s)     { return write(s); }
+    size_t print(const String& s)   { return write(s.c_str(), s.length()); }
+    size_t print(char c)            { return write((uint8_t)c); }
+    size_t print(int v, int base = DEC)           { return print(String(v, (unsigned char)base)); }
+    size_t print(unsigned int v, int base = DEC)  { return print(String(v, (unsigned char)base)); }
+    size_t print(long v, int base = DEC)          { return print(String(v, (unsigned char)base)); }
+    size_t print(unsigned long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+    size_t print(double v, int decimals = 2)      { return print(String(v, decimals)); }
+
+    size_t println()                  { return write("\n"); }
+    template <typename T>
+    size_t println(const T& v)        { size_t n = print(v); return n + println(); }
+
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+    void setTimeout(unsigned long ms) { _timeout = ms; }
+  protected:
+    unsigned long _timeout = 1000;
+};
+
+// Serial goes to the run's serial.log (whatever begin()/end() say — the
+// log is the point of a simulation)
+class HardwareSerial : public Stream
+{
+  public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    int  available() override { return 0; }
+    int  read() override      { return -1; }
+    int  peek() override      { return -1; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    using Print::write;
+    void flush() override;
+    operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+// ============================================================================
+// ESP
+// ============================================================================
+class EspClass
+{
+  public:
+    void     restart();
+    uint32_t getPsramSize()  { return 8 * 1024 * 1024; }
+    uint32_t getFreeHeap()   { return 200 * 1024; }
+    uint32_t getFreePsram()  { return 7 * 1024 * 1024; }
+};
+extern EspClass ESP;
+
+#endif
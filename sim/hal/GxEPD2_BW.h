@@ -0,0 +1,17 @@
+// Host simulation — GxEPD2_BW shim (only what main.cpp touches)
+#ifndef SIM_GXEPD2_BW_H
+#define SIM_GXEPD2_BW_H
+
+#include <Arduino.h>
+
+template <typename Driver, const uint16_t page_height>
+class GxEPD2_BW
+{
+  public:
+    explicit GxEPD2_BW(Driver driver) : epd2(driver) {}
+    int16_t width() const  { return Driver::WIDTH; }
+    int16_t height() const { return Driver::HEIGHT; }
+    Driver epd2;
+};
+
+#endif
@@ -0,0 +1,36 @@
+// Host simulation — HTTPClient shim
+//
+// Holds one request for the scripted server (sim/sim_server.cpp): the
+// URL httpsBegin() was given, the Authorization header, then the status
+// and body httpsSend() got back.
+#ifndef SIM_HTTPCLIENT_H
+#define SIM_HTTPCLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_CONNECTION_LOST    (-5)
+#define HTTPC_ERROR_READ_TIMEOUT       (-11)
+
+class HTTPClient
+{
+  public:
+    void addHeader(const String& name, const String& value,
+                   bool first = false, bool replace = true) {
+        (void)first; (void)replace;
+        if (name == "Authorization") auth = value;
+    }
+    void        end()                     { body.stop(); }
+    void        setReuse(bool reuse)      { (void)reuse; }
+    void        setTimeout(uint16_t ms)   { (void)ms; }
+    WiFiClient* getStreamPtr()            { return &body; }
+    int         getSize()                 { return body.available(); }
+
+    String     url;
+    String     auth;
+    int        code = 0;
+    WiFiClient body;
+};
+
+#endif
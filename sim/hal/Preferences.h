@@ -0,0 +1,47 @@
+// Host simulation — Preferences (NVS) shim
+//
+// One file per key under <run>/nvs/<namespace>/, so values outlive the
+// simulated resets.  Numbers are stored as text; the type a key was
+// written with isn't checked.
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences
+{
+  public:
+    bool   begin(const char* name, bool readOnly = false);
+    void   end();
+    bool   clear();
+    bool   remove(const char* key);
+    bool   isKey(const char* key);
+
+    size_t putBool(const char* key, bool v)        { return putInt(key, v ? 1 : 0); }
+    size_t putUChar(const char* key, uint8_t v)    { return putLong64(key, v); }
+    size_t putInt(const char* key, int32_t v)      { return putLong64(key, v); }
+    size_t putUInt(const char* key, uint32_t v)    { return putLong64(key, v); }
+    size_t putLong64(const char* key, int64_t v);
+    size_t putString(const char* key, const char* v);
+    size_t putString(const char* key, const String& v) { return putString(key, v.c_str()); }
+    size_t putBytes(const char* key, const void* v, size_t len);
+
+    bool     getBool(const char* key, bool def = false)      { return getLong64(key, def) != 0; }
+    uint8_t  getUChar(const char* key, uint8_t def = 0)      { return (uint8_t)getLong64(key, def); }
+    int32_t  getInt(const char* key, int32_t def = 0)        { return (int32_t)getLong64(key, def); }
+    uint32_t getUInt(const char* key, uint32_t def = 0)      { return (uint32_t)getLong64(key, def); }
+    int64_t  getLong64(const char* key, int64_t def = 0);
+    String   getString(const char* key, const String& def = String());
+    size_t   getString(const char* key, char* buf, size_t maxLen);   // length + NUL
+    size_t   getBytesLength(const char* key);
+    size_t   getBytes(const char* key, void* buf, size_t maxLen);
+
+  private:
+    bool read(const char* key, std::string& out);
+    bool write(const char* key, const void* data, size_t len);
+    std::string _dir;
+    bool        _open = false;
+    bool        _readOnly = false;
+};
+
+#endif
@@ -0,0 +1,28 @@
+// Host simulation — WS_EPD154V2 shim
+//
+// Refresh timing lives in the display_ui stand-in (sim/sim_stubs.cpp);
+// this only carries the hooks main.cpp installs and the BUSY total the
+// wake profiler reads.
+#ifndef SIM_WS_EPD154V2_H
+#define SIM_WS_EPD154V2_H
+
+#include <Arduino.h>
+
+uint32_t simEpdBusyMs();        // panel BUSY time since reset
+
+class WS_EPD154V2
+{
+  public:
+    static const uint16_t WIDTH  = 200;
+    static const uint16_t HEIGHT = 200;
+
+    WS_EPD154V2(int16_t cs, int16_t dc, int16_t rst, int16_t busy) {
+        (void)cs; (void)dc; (void)rst; (void)busy;
+    }
+    uint32_t refreshBusyMs() const                  { return simEpdBusyMs(); }
+    void setAsyncRefresh(bool enable)               { (void)enable; }
+    void setBusySleepGate(bool (*gate)())           { (void)gate; }
+    void setTransferHook(void (*hook)(bool active)) { (void)hook; }
+};
+
+#endif
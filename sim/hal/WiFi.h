@@ -0,0 +1,66 @@
+// Host simulation — WiFi shim
+//
+// The radio is a load in the energy model: it draws from wifiConnect()
+// (sim/sim_stubs.cpp) until WiFi.mode(WIFI_OFF) or disconnect(true).
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS   = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED     = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED  = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA,
+    WIFI_AP,
+    WIFI_AP_STA
+} wifi_mode_t;
+
+class IPAddress
+{
+  public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) {
+        _b[0] = a; _b[1] = b; _b[2] = c; _b[3] = d;
+    }
+    String toString() const;
+  private:
+    uint8_t _b[4];
+};
+
+class WiFiClass
+{
+  public:
+    wl_status_t status();
+    bool        mode(wifi_mode_t m);
+    wifi_mode_t getMode();
+    bool        disconnect(bool wifiOff = false, bool eraseAp = false);
+    IPAddress   localIP();
+    int8_t      RSSI();
+};
+extern WiFiClass WiFi;
+
+// A response body: the scripted server writes it, HttpsBody reads it
+class WiFiClient : public Stream
+{
+  public:
+    void   load(const std::string& body) { _body = body; _pos = 0; }
+    int    available() override { return (int)(_body.size() - _pos); }
+    int    read() override      { return _pos < _body.size() ? (uint8_t)_body[_pos++] : -1; }
+    int    peek() override      { return _pos < _body.size() ? (uint8_t)_body[_pos] : -1; }
+    size_t readBytes(char* buffer, size_t length) override;
+    size_t write(uint8_t c) override { (void)c; return 1; }
+    using Print::write;
+    bool   connected() const    { return _pos < _body.size(); }
+    void   stop()               { _body.clear(); _pos = 0; }
+  private:
+    std::string _body;
+    size_t      _pos = 0;
+};
+
+#endif
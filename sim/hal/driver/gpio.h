@@ -0,0 +1,19 @@
+// Host simulation — GPIO holds are no-ops
+#ifndef SIM_DRIVER_GPIO_H
+#define SIM_DRIVER_GPIO_H
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+typedef enum {
+    GPIO_NUM_0 = 0, GPIO_NUM_3 = 3, GPIO_NUM_4 = 4, GPIO_NUM_17 = 17, GPIO_NUM_18 = 18,
+    GPIO_NUM_MAX = 49
+} gpio_num_t;
+
+inline esp_err_t gpio_hold_en(gpio_num_t pin)   { (void)pin; return ESP_OK; }
+inline esp_err_t gpio_hold_dis(gpio_num_t pin)  { (void)pin; return ESP_OK; }
+inline esp_err_t gpio_reset_pin(gpio_num_t pin) { (void)pin; return ESP_OK; }
+inline void      gpio_deep_sleep_hold_en()      {}
+inline void      gpio_deep_sleep_hold_dis()     {}
+
+#endif
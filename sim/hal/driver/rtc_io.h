@@ -0,0 +1,7 @@
+// Host simulation — RTC IO (nothing used beyond driver/gpio.h)
+#ifndef SIM_DRIVER_RTC_IO_H
+#define SIM_DRIVER_RTC_IO_H
+
+#include <driver/gpio.h>
+
+#endif
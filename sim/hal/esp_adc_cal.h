@@ -0,0 +1,27 @@
+// Host simulation — ADC calibration as an ideal 12-bit, 0–3.1 V converter
+#ifndef SIM_ESP_ADC_CAL_H
+#define SIM_ESP_ADC_CAL_H
+
+#include <stdint.h>
+
+typedef enum { ADC_UNIT_1 = 1, ADC_UNIT_2 = 2 } adc_unit_t;
+typedef enum { ADC_ATTEN_DB_0 = 0, ADC_ATTEN_DB_11 = 3 } adc_atten_t;
+typedef enum { ADC_WIDTH_BIT_12 = 3 } adc_bits_width_t;
+
+typedef struct {
+    uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+inline int esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                    uint32_t vref, esp_adc_cal_characteristics_t* chars) {
+    (void)unit; (void)atten; (void)width;
+    chars->vref = vref;
+    return 0;
+}
+
+inline uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars) {
+    (void)chars;
+    return raw * 3100 / 4095;
+}
+
+#endif
@@ -0,0 +1,19 @@
+// Host simulation — heap_caps on the host heap
+#ifndef SIM_ESP_HEAP_CAPS_H
+#define SIM_ESP_HEAP_CAPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+
+inline void*  heap_caps_malloc(size_t size, uint32_t caps)  { (void)caps; return malloc(size); }
+inline size_t heap_caps_get_free_size(uint32_t caps)         { (void)caps; return 200 * 1024; }
+inline size_t heap_caps_get_minimum_free_size(uint32_t caps) { (void)caps; return 160 * 1024; }
+inline size_t heap_caps_get_largest_free_block(uint32_t caps){ (void)caps; return 110 * 1024; }
+
+#endif
@@ -0,0 +1,9 @@
+// Host simulation — ROM CRC32 (little-endian, reflected 0xEDB88320)
+#ifndef SIM_ESP_ROM_CRC_H
+#define SIM_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif
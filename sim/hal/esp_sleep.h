@@ -0,0 +1,38 @@
+// Host simulation — sleep shim
+//
+// Light sleep advances the clock to the timer at light-sleep current.
+// Deep sleep ends this boot: the driver charges the sleep, keeps RTC
+// memory and starts the next boot with a timer wake.
+#ifndef SIM_ESP_SLEEP_H
+#define SIM_ESP_SLEEP_H
+
+#include <stdint.h>
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART,
+} esp_sleep_source_t;
+typedef esp_sleep_source_t esp_sleep_wakeup_cause_t;
+
+typedef enum {
+    ESP_EXT1_WAKEUP_ALL_LOW = 0,
+    ESP_EXT1_WAKEUP_ANY_HIGH = 1,
+    ESP_EXT1_WAKEUP_ANY_LOW = 2,
+} esp_sleep_ext1_wakeup_mode_t;
+
+int  esp_sleep_enable_timer_wakeup(uint64_t timeUs);
+int  esp_sleep_enable_ext1_wakeup(uint64_t mask, esp_sleep_ext1_wakeup_mode_t mode);
+int  esp_sleep_enable_gpio_wakeup();
+int  esp_sleep_disable_wakeup_source(esp_sleep_source_t source);
+int  esp_light_sleep_start();
+void esp_deep_sleep_start() __attribute__((noreturn));
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+
+#endif
@@ -0,0 +1,4 @@
+// Host simulation — nothing from esp_wifi is called outside wifi_link
+#ifndef SIM_ESP_WIFI_H
+#define SIM_ESP_WIFI_H
+#endif
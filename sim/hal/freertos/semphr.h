@@ -0,0 +1,23 @@
+// Host simulation — binary semaphores as counters
+#ifndef SIM_FREERTOS_SEMPHR_H
+#define SIM_FREERTOS_SEMPHR_H
+
+#include <freertos/FreeRTOS.h>
+
+typedef int* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary()   { return new int(0); }
+inline void vSemaphoreDelete(SemaphoreHandle_t s)   { delete s; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+    if (*s) return pdFALSE;
+    *s = 1;
+    return pdTRUE;
+}
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t wait) {
+    (void)wait;                 // nothing else runs — it's given or never will be
+    if (!*s) return pdFALSE;
+    *s = 0;
+    return pdTRUE;
+}
+
+#endif
@@ -0,0 +1,24 @@
+// Host simulation — tasks run to completion inside xTaskCreatePinnedToCore()
+//
+// Work the firmware overlaps on two cores (Teams + Zoom polls) is timed
+// back to back, so PLATFORM_BOTH wakes come out a little long.
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include <freertos/FreeRTOS.h>
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack,
+                                          void* arg, UBaseType_t prio, TaskHandle_t* handle,
+                                          BaseType_t core) {
+    (void)name; (void)stack; (void)prio; (void)core;
+    if (handle) *handle = nullptr;
+    fn(arg);
+    return pdPASS;
+}
+
+inline void vTaskDelete(TaskHandle_t task) { (void)task; }
+
+#endif
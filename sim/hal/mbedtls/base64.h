@@ -0,0 +1,12 @@
+// Host simulation — mbedTLS base64 encoder
+#ifndef SIM_MBEDTLS_BASE64_H
+#define SIM_MBEDTLS_BASE64_H
+
+#include <stddef.h>
+
+#define MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL (-0x002A)
+
+int mbedtls_base64_encode(unsigned char* dst, size_t dlen, size_t* olen,
+                          const unsigned char* src, size_t slen);
+
+#endif
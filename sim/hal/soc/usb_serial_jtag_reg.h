@@ -0,0 +1,12 @@
+// Host simulation — USB SOF frame counter (moves only while on USB)
+#ifndef SIM_USB_SERIAL_JTAG_REG_H
+#define SIM_USB_SERIAL_JTAG_REG_H
+
+#include <stdint.h>
+
+uint32_t simUsbFrameNumber();
+
+#define USB_SERIAL_JTAG_FRAM_NUM_REG 0
+#define REG_READ(reg) ((void)(reg), simUsbFrameNumber())
+
+#endif
@@ -0,0 +1,201 @@
+// ============================================================================
+// Host simulation — clock, energy model and the state that outlives a boot
+// ============================================================================
+
+#include "sim_core.h"
+#include "battery.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if !defined(__linux__)
+#error "The simulator snapshots RTC memory through ELF section symbols — Linux only"
+#endif
+
+SimShared*  g_sim = nullptr;
+SimCurrents g_simCurrents;
+SimCosts    g_simCosts;
+float       g_simBatteryMah      = 0;
+int         g_simBatteryStartPct = 90;
+char        g_simDir[256]        = "sim_out";
+
+// Start / end of the RTC sections, from the linker
+extern char __start_pod_rtc[] __attribute__((weak));
+extern char __stop_pod_rtc[] __attribute__((weak));
+extern char __start_pod_rtc_noinit[] __attribute__((weak));
+extern char __stop_pod_rtc_noinit[] __attribute__((weak));
+
+static uint8_t s_rtcImage[SIM_RTC_MAX];     // link-time RTC_DATA_ATTR values
+
+// ---- Per boot (a fresh child each time) ----
+static bool    s_radio        = false;
+static int64_t s_epdBusyUntil = 0;
+static int64_t s_epdBusyTotal = 0;          // ms since reset
+static FILE*   s_log          = nullptr;
+static bool    s_lineStart    = true;
+
+// ----------------------------------------------------------------------------
+static size_t rtcSize()    { return (size_t)(__stop_pod_rtc - __start_pod_rtc); }
+static size_t noinitSize() { return (size_t)(__stop_pod_rtc_noinit - __start_pod_rtc_noinit); }
+
+// Charge for [t0, t1) at the awake current plus whatever loads are on
+static void chargeAwake(int64_t t0, int64_t t1) {
+    double sec = (t1 - t0) / 1000.0;
+    g_sim->mAs[CHG_AWAKE] += g_simCurrents.awake * sec;
+    if (s_radio) g_sim->mAs[CHG_RADIO] += g_simCurrents.radio * sec;
+    g_sim->awakeMs += (double)(t1 - t0);
+}
+
+static void chargeEpd(int64_t t0, int64_t t1) {
+    int64_t busyEnd = s_epdBusyUntil < t1 ? s_epdBusyUntil : t1;
+    if (busyEnd > t0) g_sim->mAs[CHG_EPD] += g_simCurrents.epd * (busyEnd - t0) / 1000.0;
+}
+
+// ============================================================================
+// Clock
+// ============================================================================
+
+int64_t simNowMs() {
+    return g_sim->nowMs;
+}
+
+void simAdvance(uint32_t ms) {
+    if (ms == 0) return;
+    int64_t t0 = g_sim->nowMs;
+    int64_t t1 = t0 + ms;
+    if (t1 > g_sim->endMs) t1 = g_sim->endMs;
+    chargeAwake(t0, t1);
+    chargeEpd(t0, t1);
+    g_sim->nowMs = t1;
+    if (t1 >= g_sim->endMs) simExit(EXIT_END);
+}
+
+void simLightSleep(int64_t ms) {
+    int64_t t0 = g_sim->nowMs;
+    int64_t t1 = t0 + (ms > 0 ? ms : 0);
+    if (t1 > g_sim->endMs) t1 = g_sim->endMs;
+    g_sim->mAs[CHG_LIGHT_SLEEP] += g_simCurrents.lightSleep * (t1 - t0) / 1000.0;
+    chargeEpd(t0, t1);
+    g_sim->nowMs = t1;
+    g_sim->lightSleeps++;
+    if (t1 >= g_sim->endMs) simExit(EXIT_END);
+}
+
+// ============================================================================
+// Loads
+// ============================================================================
+
+void simRadio(bool on) {
+    s_radio = on;
+}
+
+bool simRadioOn() {
+    return s_radio;
+}
+
+void simEpdRefresh(bool full) {
+    uint32_t ms = full ? g_simCosts.epdFull : g_simCosts.epdPartial;
+    if (full) g_sim->epdFull++;
+    else      g_sim->epdPartial++;
+    // A new refresh queues behind one still running
+    int64_t start = s_epdBusyUntil > g_sim->nowMs ? s_epdBusyUntil : g_sim->nowMs;
+    s_epdBusyUntil = start + ms;
+    s_epdBusyTotal += ms;
+}
+
+void simEpdWait() {
+    if (s_epdBusyUntil > g_sim->nowMs) simAdvance((uint32_t)(s_epdBusyUntil - g_sim->nowMs));
+}
+
+uint32_t simEpdBusyMs() {
+    return (uint32_t)s_epdBusyTotal;
+}
+
+// ============================================================================
+// Boot boundary
+// ============================================================================
+
+void simExit(SimExit kind) {
+    simRtcSave();
+    g_sim->exitKind = kind;
+    simLogFlush();
+    if (s_log) fclose(s_log);
+    _exit(0);
+}
+
+void simRtcInit() {
+    size_t n = rtcSize();
+    if (n + noinitSize() > SIM_RTC_MAX) {
+        fprintf(stderr, "sim: RTC sections (%u bytes) exceed SIM_RTC_MAX\n",
+                (unsigned)(n + noinitSize()));
+        _exit(2);
+    }
+    if (n) memcpy(s_rtcImage, __start_pod_rtc, n);
+}
+
+void simRtcSave() {
+    size_t n = rtcSize(), k = noinitSize();
+    if (n) memcpy(g_sim->rtc, __start_pod_rtc, n);
+    if (k) memcpy(g_sim->rtc + n, __start_pod_rtc_noinit, k);
+    g_sim->rtcLen = (uint32_t)(n + k);
+}
+
+void simRtcRestore(bool deepSleepWake) {
+    size_t n = rtcSize(), k = noinitSize();
+    if (g_sim->rtcLen != n + k) return;         // nothing saved yet
+    if (n) memcpy(__start_pod_rtc, deepSleepWake ? g_sim->rtc : s_rtcImage, n);
+    if (k) memcpy(__start_pod_rtc_noinit, g_sim->rtc + n, k);
+}
+
+// ============================================================================
+// Observations
+// ============================================================================
+
+void simShowStatus(uint8_t avail) {
+    if (g_sim->shownCount >= SIM_MAX_SHOWN) return;
+    SimShown& s = g_sim->shown[g_sim->shownCount++];
+    s.t     = g_sim->nowMs;
+    s.avail = avail;
+}
+
+float simBatteryVoltage() {
+    if (g_sim->onUsb) return 4.30f;             // charge IC overshoot (battery.h)
+    float pct = (float)g_simBatteryStartPct;
+    if (g_simBatteryMah > 0) {
+        double used = 0;
+        for (int i = 0; i < CHG_COUNT; i++) used += g_sim->mAs[i];
+        pct -= (float)(used / 3600.0 / g_simBatteryMah * 100.0);
+    }
+    return batteryVoltageAtPercent(pct < 0 ? 0 : (int)(pct + 0.5f));
+}
+
+// ============================================================================
+// Serial log — each line stamped with the simulated local time
+// ============================================================================
+
+void simLogOpen(const char* path) {
+    s_log = fopen(path, "a");
+    s_lineStart = true;
+}
+
+void simLog(const char* data, size_t len) {
+    if (!s_log) return;
+    for (size_t i = 0; i < len; i++) {
+        if (s_lineStart) {
+            time_t t = (time_t)(g_sim->nowMs / 1000);
+            struct tm l;
+            localtime_r(&t, &l);
+            char stamp[24];
+            strftime(stamp, sizeof(stamp), "%a %H:%M:%S ", &l);
+            fputs(stamp, s_log);
+            s_lineStart = false;
+        }
+        if (data[i] == '\r') continue;
+        fputc(data[i], s_log);
+        if (data[i] == '\n') s_lineStart = true;
+    }
+}
+
+void simLogFlush() {
+    if (s_log) fflush(s_log);
+}
@@ -0,0 +1,145 @@
+// ============================================================================
+// Host simulation — clock, energy model and the state that outlives a boot
+//
+// Every boot runs in a forked child of the driver (sim_main.cpp), so the
+// firmware's ordinary statics start fresh on each reset exactly as they
+// do on the chip.  What has to survive — the clock, the charge counters,
+// RTC memory across deep sleep, what the panel showed — lives in one
+// SimShared block mapped shared between the driver and its children.
+//
+// Time only moves when the firmware waits for something: delay(), a
+// modelled operation (WiFi join, TLS handshake, request, panel BUSY), a
+// button wait, or a sleep.  Each advance is charged as
+//   awake (CPU + PSRAM) + radio while WiFi is up + panel while BUSY
+// and sleeps at their own currents.
+// ============================================================================
+
+#ifndef SIM_CORE_H
+#define SIM_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+// Where the charge went (report rows)
+enum SimCharge : uint8_t {
+    CHG_AWAKE = 0,
+    CHG_RADIO,
+    CHG_EPD,
+    CHG_LIGHT_SLEEP,
+    CHG_DEEP_SLEEP,
+    CHG_COUNT
+};
+
+// How a boot ended
+enum SimExit : uint8_t {
+    EXIT_NONE = 0,
+    EXIT_DEEP_SLEEP,        // timer armed — the driver wakes it
+    EXIT_RESTART,           // ESP.restart()
+    EXIT_POWER_OFF,         // deep sleep with no wake source (power latch released)
+    EXIT_END,               // the simulated period is over
+    EXIT_STALLED,           // loop() kept running without time passing
+};
+
+// Currents (mA, whole board); defaults match wake_profiler.cpp's model
+struct SimCurrents {
+    float awake      = 45.0f;
+    float radio      = 75.0f;   // on top of awake
+    float epd        = 5.0f;    // on top of awake, while BUSY
+    float lightSleep = 2.0f;
+    float deepSleep  = 0.15f;
+};
+
+// Durations of the modelled operations (ms)
+struct SimCosts {
+    uint32_t boot       = 300;     // ROM + bootloader before setup()
+    uint32_t wifi       = 1200;    // association + DHCP
+    uint32_t discovery  = 3000;    // light discovery window
+    uint32_t ntp        = 150;
+    uint32_t tls        = 900;     // handshake, per host, until WiFi goes off
+    uint32_t request    = 250;     // request → status line
+    uint32_t epdPartial = 420;     // panel BUSY
+    uint32_t epdFull    = 1800;
+};
+
+#define SIM_MAX_SHOWN   16384
+#define SIM_RTC_MAX     (32 * 1024)
+
+struct SimShown {
+    int64_t t;              // sim ms
+    uint8_t avail;          // Availability
+};
+
+struct SimShared {
+    int64_t  nowMs;         // wall clock, epoch ms
+    int64_t  endMs;
+    int64_t  bootAtMs;      // this boot's reset
+    int      resetReason;   // esp_reset_reason_t of this boot
+    int      wakeCause;     // esp_sleep_wakeup_cause_t
+    bool     onUsb;
+
+    // Set by the boot as it ends
+    uint8_t  exitKind;      // SimExit
+    int64_t  sleepMs;
+
+    // Counters
+    double   mAs[CHG_COUNT];
+    double   awakeMs;
+    uint32_t boots;
+    uint32_t timerWakes;
+    uint32_t lightSleeps;
+    uint32_t wifiJoins;
+    uint32_t requests;
+    uint32_t handshakes;
+    uint32_t epdFull;
+    uint32_t epdPartial;
+
+    // Panel history (status screens only)
+    uint32_t shownCount;
+    SimShown shown[SIM_MAX_SHOWN];
+
+    // RTC memory image at the last deep sleep
+    uint32_t rtcLen;
+    uint8_t  rtc[SIM_RTC_MAX];
+};
+
+extern SimShared*  g_sim;
+extern SimCurrents g_simCurrents;
+extern SimCosts    g_simCosts;
+extern float       g_simBatteryMah;         // capacity (0 = never drains)
+extern int         g_simBatteryStartPct;
+extern char        g_simDir[256];           // run output: serial.log, nvs/, sd/
+
+// ---- Clock ----
+int64_t simNowMs();
+void    simAdvance(uint32_t ms);            // awake time passes (may end the run)
+void    simLightSleep(int64_t ms);
+
+// ---- Loads ----
+void    simRadio(bool on);
+bool    simRadioOn();
+void    simEpdRefresh(bool full);           // starts BUSY; CPU carries on
+void    simEpdWait();                       // block until BUSY ends
+
+// ---- Boot boundary ----
+void    simExit(SimExit kind) __attribute__((noreturn));
+void    simRtcInit();                       // remember the link-time image
+void    simRtcSave();                       // sections → g_sim->rtc
+// Before the next boot: a deep-sleep wake keeps RTC_DATA_ATTR, any other
+// reset reloads its link-time image.  RTC_NOINIT_ATTR is always kept.
+void    simRtcRestore(bool deepSleepWake);
+
+// ---- Network ----
+void    simWifiJoined();                    // wifiConnect() succeeded (sim_hal.cpp)
+void    simNetDown();                       // WiFi off: every TLS session is gone (sim_server.cpp)
+
+// ---- Observations ----
+void    simShowStatus(uint8_t avail);
+float   simBatteryVoltage();
+
+// ---- Serial log ----
+void    simLogOpen(const char* path);
+void    simLog(const char* data, size_t len);
+void    simLogFlush();
+
+#endif
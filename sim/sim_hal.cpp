@@ -0,0 +1,496 @@
+// ============================================================================
+// Host simulation — Arduino core / ESP-IDF shims (the declarations live in
+// sim/hal/) on the simulation clock
+// ============================================================================
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_system.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <esp_rom_crc.h>
+#include <mbedtls/base64.h>
+#include <soc/usb_serial_jtag_reg.h>
+#include "sim_core.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+EspClass       ESP;
+SPIClass       SPI;
+WiFiClass      WiFi;
+
+// ============================================================================
+// Time
+// ============================================================================
+
+unsigned long millis() {
+    return (unsigned long)(g_sim->nowMs - g_sim->bootAtMs);
+}
+
+unsigned long micros() {
+    return millis() * 1000UL;
+}
+
+int64_t esp_timer_get_time() {
+    return (g_sim->nowMs - g_sim->bootAtMs) * 1000LL;
+}
+
+void delay(uint32_t ms) {
+    simAdvance(ms);
+}
+
+void yield() {
+}
+
+// The RTC keeps counting through deep sleep and resets, so the wall clock
+// is simply the simulation clock
+extern "C" time_t time(time_t* out) __THROW {
+    time_t t = (time_t)(g_sim->nowMs / 1000);
+    if (out) *out = t;
+    return t;
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    (void)ms;
+    time_t now = time(nullptr);
+    localtime_r(&now, info);
+    return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return 240;
+}
+
+bool psramFound() {
+    return true;
+}
+
+// ============================================================================
+// GPIO / ADC — buttons idle high, the battery pin reads through the divider
+// ============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode)     { (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t val) { (void)pin; (void)val; }
+int  digitalRead(uint8_t pin)               { (void)pin; return HIGH; }
+void analogSetAttenuation(adc_attenuation_t atten) { (void)atten; }
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+    if (pin != 4) return 0;
+    return (uint32_t)(simBatteryVoltage() * 1000.0f / 2.0f + 0.5f);
+}
+
+uint32_t simUsbFrameNumber() {
+    // SOF every millisecond while enumerated; frozen on battery
+    return g_sim->onUsb ? (uint32_t)millis() : 0;
+}
+
+// ============================================================================
+// Reset / sleep
+// ============================================================================
+
+esp_reset_reason_t esp_reset_reason() {
+    return (esp_reset_reason_t)g_sim->resetReason;
+}
+
+void EspClass::restart() {
+    simExit(EXIT_RESTART);
+}
+
+static uint64_t                 s_timerUs    = 0;
+static bool                     s_anyWake    = false;   // ext1 / GPIO armed
+static esp_sleep_wakeup_cause_t s_lightCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+int esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+    s_timerUs = timeUs;
+    return 0;
+}
+
+int esp_sleep_enable_ext1_wakeup(uint64_t mask, esp_sleep_ext1_wakeup_mode_t mode) {
+    (void)mask; (void)mode;
+    s_anyWake = true;
+    return 0;
+}
+
+int esp_sleep_enable_gpio_wakeup() {
+    s_anyWake = true;
+    return 0;
+}
+
+int esp_sleep_disable_wakeup_source(esp_sleep_source_t source) {
+    if (source == ESP_SLEEP_WAKEUP_ALL || source == ESP_SLEEP_WAKEUP_TIMER) s_timerUs = 0;
+    if (source == ESP_SLEEP_WAKEUP_ALL) s_anyWake = false;
+    return 0;
+}
+
+int esp_light_sleep_start() {
+    // Nobody presses a button during a simulated light sleep
+    simLightSleep((int64_t)(s_timerUs / 1000ULL));
+    s_lightCause = ESP_SLEEP_WAKEUP_TIMER;
+    return 0;
+}
+
+void esp_deep_sleep_start() {
+    if (s_timerUs == 0) simExit(EXIT_POWER_OFF);
+    g_sim->sleepMs = (int64_t)(s_timerUs / 1000ULL);
+    simExit(EXIT_DEEP_SLEEP);
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+    if (s_lightCause != ESP_SLEEP_WAKEUP_UNDEFINED) return s_lightCause;
+    return (esp_sleep_wakeup_cause_t)g_sim->wakeCause;
+}
+
+// ============================================================================
+// String
+// ============================================================================
+
+String::String(double v, unsigned int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    _s = buf;
+}
+
+void String::_num(long v, unsigned char base) {
+    char buf[40];
+    if (base == 16)      snprintf(buf, sizeof(buf), "%lx", (unsigned long)v);
+    else if (base == 10) snprintf(buf, sizeof(buf), "%ld", v);
+    else {
+        // Other bases are rare enough to build by hand
+        unsigned long u = (unsigned long)v;
+        char* p = buf + sizeof(buf) - 1;
+        *p = '\0';
+        do { *--p = "0123456789abcdefghijklmnopqrstuvwxyz"[u % base]; u /= base; } while (u);
+        _s = p;
+        return;
+    }
+    _s = buf;
+}
+
+void String::trim() {
+    size_t b = 0, e = _s.size();
+    while (b < e && isspace((unsigned char)_s[b])) b++;
+    while (e > b && isspace((unsigned char)_s[e - 1])) e--;
+    _s = _s.substr(b, e - b);
+}
+
+bool String::equalsIgnoreCase(const String& o) const {
+    return strcasecmp(_s.c_str(), o._s.c_str()) == 0;
+}
+
+bool String::endsWith(const String& p) const {
+    return _s.size() >= p._s.size() &&
+           _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t i = _s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::indexOf(const String& s, unsigned int from) const {
+    size_t i = _s.find(s._s, from);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t i = _s.rfind(c);
+    return i == std::string::npos ? -1 : (int)i;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= _s.size()) return String();
+    return String(_s.substr(from, to - from));
+}
+
+void String::replace(const String& from, const String& to) {
+    if (from._s.empty()) return;
+    size_t i = 0;
+    while ((i = _s.find(from._s, i)) != std::string::npos) {
+        _s.replace(i, from._s.size(), to._s);
+        i += to._s.size();
+    }
+}
+
+void String::toLowerCase() {
+    for (char& c : _s) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+    for (char& c : _s) c = (char)toupper((unsigned char)c);
+}
+
+String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+String operator+(const String& a, const char* b)   { String r(a); r += b; return r; }
+String operator+(const char* a, const String& b)   { String r(a); r += b; return r; }
+String operator+(const String& a, char b)          { String r(a); r += b; return r; }
+
+// ============================================================================
+// Print / Stream / Serial
+// ============================================================================
+
+size_t Print::write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    while (len--) n += write(*data++);
+    return n;
+}
+
+size_t Print::printf(const char* fmt, ...) {
+    char small[128];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(small, sizeof(small), fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    if ((size_t)n < sizeof(small)) return write((const uint8_t*)small, n);
+
+    std::string big(n + 1, '\0');
+    va_start(ap, fmt);
+    vsnprintf(&big[0], big.size(), fmt, ap);
+    va_end(ap);
+    return write((const uint8_t*)big.data(), n);
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+        int c = read();
+        if (c < 0) break;
+        buffer[n++] = (char)c;
+    }
+    return n;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    char ch = (char)c;
+    simLog(&ch, 1);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t len) {
+    simLog((const char*)data, len);
+    return len;
+}
+
+void HardwareSerial::flush() {
+    simLogFlush();
+}
+
+// ============================================================================
+// WiFi — up from wifiConnect() until the radio is turned off
+// ============================================================================
+
+static wifi_mode_t s_wifiMode = WIFI_OFF;
+static bool        s_wifiUp   = false;
+
+void simWifiJoined() {
+    s_wifiUp = true;
+}
+
+static void wifiDown(bool radioOff) {
+    s_wifiUp = false;
+    simNetDown();
+    if (radioOff) {
+        s_wifiMode = WIFI_OFF;
+        simRadio(false);
+    }
+}
+
+String IPAddress::toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _b[0], _b[1], _b[2], _b[3]);
+    return String(buf);
+}
+
+wl_status_t WiFiClass::status() {
+    return s_wifiUp ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+bool WiFiClass::mode(wifi_mode_t m) {
+    if (m == WIFI_OFF) wifiDown(true);
+    else {
+        s_wifiMode = m;
+        simRadio(true);
+    }
+    return true;
+}
+
+wifi_mode_t WiFiClass::getMode() {
+    return s_wifiMode;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp) {
+    (void)eraseAp;
+    wifiDown(wifiOff);
+    return true;
+}
+
+IPAddress WiFiClass::localIP() {
+    return s_wifiUp ? IPAddress(192, 168, 1, 42) : IPAddress();
+}
+
+int8_t WiFiClass::RSSI() {
+    return s_wifiUp ? -58 : 0;
+}
+
+size_t WiFiClient::readBytes(char* buffer, size_t length) {
+    size_t n = _body.size() - _pos;
+    if (n > length) n = length;
+    memcpy(buffer, _body.data() + _pos, n);
+    _pos += n;
+    return n;
+}
+
+// ============================================================================
+// Preferences — <run>/nvs/<namespace>/<key>
+// ============================================================================
+
+static bool makeDirs(const std::string& path) {
+    for (size_t i = 1; i <= path.size(); i++) {
+        if (i < path.size() && path[i] != '/') continue;
+        std::string part = path.substr(0, i);
+        if (mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    }
+    return true;
+}
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    _dir = std::string(g_simDir) + "/nvs/" + name;
+    _readOnly = readOnly;
+    struct stat st;
+    // A namespace nothing was ever written to can't be opened read-only
+    _open = readOnly ? stat(_dir.c_str(), &st) == 0 : makeDirs(_dir);
+    return _open;
+}
+
+void Preferences::end() {
+    _open = false;
+}
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) return false;
+    DIR* d = opendir(_dir.c_str());
+    if (!d) return false;
+    while (struct dirent* e = readdir(d)) {
+        if (e->d_name[0] == '.') continue;
+        unlink((_dir + "/" + e->d_name).c_str());
+    }
+    closedir(d);
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_open || _readOnly) return false;
+    return unlink((_dir + "/" + key).c_str()) == 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    std::string v;
+    return read(key, v);
+}
+
+bool Preferences::read(const char* key, std::string& out) {
+    if (!_open) return false;
+    FILE* f = fopen((_dir + "/" + key).c_str(), "rb");
+    if (!f) return false;
+    out.clear();
+    char buf[256];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+bool Preferences::write(const char* key, const void* data, size_t len) {
+    if (!_open || _readOnly) return false;
+    FILE* f = fopen((_dir + "/" + key).c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(data, 1, len, f) == len;
+    fclose(f);
+    return ok;
+}
+
+size_t Preferences::putLong64(const char* key, int64_t v) {
+    char buf[24];
+    int n = snprintf(buf, sizeof(buf), "%lld", (long long)v);
+    return write(key, buf, n) ? 8 : 0;
+}
+
+size_t Preferences::putString(const char* key, const char* v) {
+    size_t len = strlen(v);
+    return write(key, v, len) ? len : 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* v, size_t len) {
+    return write(key, v, len) ? len : 0;
+}
+
+int64_t Preferences::getLong64(const char* key, int64_t def) {
+    std::string v;
+    if (!read(key, v)) return def;
+    return strtoll(v.c_str(), nullptr, 10);
+}
+
+String Preferences::getString(const char* key, const String& def) {
+    std::string v;
+    return read(key, v) ? String(v) : def;
+}
+
+size_t Preferences::getString(const char* key, char* buf, size_t maxLen) {
+    std::string v;
+    if (!read(key, v) || v.size() + 1 > maxLen) return 0;
+    memcpy(buf, v.c_str(), v.size() + 1);
+    return v.size() + 1;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    std::string v;
+    return read(key, v) ? v.size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    std::string v;
+    if (!read(key, v) || v.size() > maxLen) return 0;
+    memcpy(buf, v.data(), v.size());
+    return v.size();
+}
+
+// ============================================================================
+// ROM CRC / base64
+// ============================================================================
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+int mbedtls_base64_encode(unsigned char* dst, size_t dlen, size_t* olen,
+                          const unsigned char* src, size_t slen) {
+    static const char* tbl = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t need = 4 * ((slen + 2) / 3) + 1;
+    *olen = need;
+    if (!dst || dlen < need) return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+    size_t o = 0;
+    for (size_t i = 0; i < slen; i += 3) {
+        uint32_t v = (uint32_t)src[i] << 16;
+        if (i + 1 < slen) v |= (uint32_t)src[i + 1] << 8;
+        if (i + 2 < slen) v |= src[i + 2];
+        dst[o++] = tbl[(v >> 18) & 63];
+        dst[o++] = tbl[(v >> 12) & 63];
+        dst[o++] = i + 1 < slen ? tbl[(v >> 6) & 63] : '=';
+        dst[o++] = i + 2 < slen ? tbl[v & 63] : '=';
+    }
+    dst[o] = '\0';
+    *olen = o;
+    return 0;
+}
@@ -0,0 +1,359 @@
+// ============================================================================
+// Host simulation — driver
+//
+//   program <scenario.txt> [--out DIR] [--days N] [--quiet]
+//
+// Runs the real setup()/loop() from main.cpp against the scenario, one
+// forked child per boot, and carries the clock across deep sleeps and
+// resets.  Writes DIR (default sim_out/<name>):
+//   serial.log    everything the firmware printed, stamped with sim time
+//   changes.csv   each presence change: when, what, when the panel showed it
+//   report.txt    energy by load, wakes, refreshes, latency, battery life
+// ============================================================================
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_system.h>
+#include <esp_sleep.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ble_setup.h"
+#include "office_hours.h"
+#include "presence_merge.h"
+#include "settings.h"
+#include "sim_core.h"
+#include "sim_scenario.h"
+
+void setup();
+void loop();
+
+static const uint32_t STALL_LOOPS = 100000;     // loop() passes with no time passing
+
+// ============================================================================
+// One boot
+// ============================================================================
+
+static void runBoot() {
+    simRtcRestore(g_sim->resetReason == ESP_RST_DEEPSLEEP);
+    simLogOpen((std::string(g_simDir) + "/serial.log").c_str());
+    simAdvance(g_simCosts.boot);
+
+    setup();
+    uint32_t still = 0;
+    for (;;) {
+        int64_t t = simNowMs();
+        loop();
+        still = simNowMs() == t ? still + 1 : 0;
+        if (still >= STALL_LOOPS) {
+            Serial.println("[Sim] loop() isn't waiting for anything — stopping");
+            simExit(EXIT_STALLED);
+        }
+    }
+}
+
+// ============================================================================
+// Setup of the run directory
+// ============================================================================
+
+static void run(const std::string& cmd) {
+    if (system(cmd.c_str()) != 0) fprintf(stderr, "sim: \"%s\" failed\n", cmd.c_str());
+}
+
+static void seedNvs() {
+    bool tzSet = false;
+    for (const SimNvsKey& k : g_scenario.nvs) {
+        Preferences p;
+        p.begin(k.ns.c_str(), false);
+        p.putString(k.key.c_str(), k.value.c_str());
+        p.end();
+        if (k.ns == "pod_settings" && k.key == "timezone") tzSet = true;
+    }
+    if (!tzSet) {
+        Preferences p;
+        p.begin("pod_settings", false);
+        p.putString("timezone", g_scenario.tz.c_str());
+        p.end();
+    }
+}
+
+// ============================================================================
+// Expected presence — what the panel should show, from the timelines
+// ============================================================================
+
+struct Change {
+    int64_t      t;
+    Availability avail;
+};
+
+static PresenceState teamsAt(int64_t ms) {
+    PresenceState st;
+    const SimStep* s = simTeamsAt(ms);
+    if (s) {
+        st.availability = presenceParseAvailability(s->value.c_str());
+        st.activity     = presenceParseActivity(s->activity.c_str());
+        st.valid        = true;
+    }
+    return st;
+}
+
+static PresenceState zoomAt(int64_t ms) {
+    PresenceState st;
+    const SimStep* s = simZoomAt(ms);
+    st.valid = presenceParseZoom(s ? s->value.c_str() : "Offline", st.availability, st.activity);
+    return st;
+}
+
+static Availability expectedAt(int64_t ms, const PodSettings& settings) {
+    PresenceState out;
+    switch (settings.platform) {
+        case PLATFORM_ZOOM:
+            out = zoomAt(ms);
+            break;
+        case PLATFORM_BOTH:
+            if (!mergePresence(teamsAt(ms), zoomAt(ms), settings.mergeRule, out))
+                out.availability = AV_UNKNOWN;
+            break;
+        default:
+            out = teamsAt(ms);
+            break;
+    }
+    return out.availability;
+}
+
+static std::vector<Change> expectedChanges(const PodSettings& settings) {
+    std::vector<int64_t> ts;
+    const std::vector<SimStep>* lines[2] = { &g_scenario.teams, &g_scenario.zoom };
+    for (const std::vector<SimStep>* v : lines)
+        for (const SimStep& s : *v)
+            if (s.t >= g_scenario.startMs && s.t < g_sim->endMs) ts.push_back(s.t);
+    std::sort(ts.begin(), ts.end());
+
+    std::vector<Change> out;
+    Availability last = expectedAt(g_scenario.startMs, settings);
+    for (int64_t t : ts) {
+        Availability a = expectedAt(t, settings);
+        if (a == last) continue;
+        out.push_back(Change{ t, a });
+        last = a;
+    }
+    return out;
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+static std::string localTime(int64_t ms) {
+    time_t t = (time_t)(ms / 1000);
+    struct tm l;
+    localtime_r(&t, &l);
+    char buf[32];
+    strftime(buf, sizeof(buf), "%Y-%m-%d %a %H:%M:%S", &l);
+    return buf;
+}
+
+static bool inOfficeHours(const PodSettings& settings, int64_t ms) {
+    time_t t = (time_t)(ms / 1000);
+    struct tm l;
+    localtime_r(&t, &l);
+    return officeHoursActive(settings, l);
+}
+
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)(p * (v.size() - 1) + 0.5);
+    return v[i];
+}
+
+static void report(FILE* out, const PodSettings& settings, const char* ended) {
+    const std::vector<Change> changes = expectedChanges(settings);
+    FILE* csv = fopen((std::string(g_simDir) + "/changes.csv").c_str(), "w");
+    if (csv) fprintf(csv, "changed,availability,shown,latency_s,office_hours\n");
+
+    // A change counts as shown by the first status frame with its
+    // availability before the next change; otherwise it was missed
+    std::vector<double> lat;
+    int missed = 0, offHours = 0;
+    uint32_t j = 0;
+    for (size_t i = 0; i < changes.size(); i++) {
+        const Change& c = changes[i];
+        int64_t until = i + 1 < changes.size() ? changes[i + 1].t : g_sim->endMs;
+        while (j < g_sim->shownCount && g_sim->shown[j].t < c.t) j++;
+        int64_t shownAt = -1;
+        for (uint32_t k = j; k < g_sim->shownCount && g_sim->shown[k].t < until; k++) {
+            if (g_sim->shown[k].avail == c.avail) {
+                shownAt = g_sim->shown[k].t;
+                break;
+            }
+        }
+        bool office = !settings.officeHoursEnabled || inOfficeHours(settings, c.t);
+        if (!office)           offHours++;
+        else if (shownAt < 0)  missed++;
+        else                   lat.push_back((shownAt - c.t) / 1000.0);
+
+        if (csv) {
+            fprintf(csv, "%s,%s,%s,", localTime(c.t).c_str(), availabilityName(c.avail),
+                    shownAt < 0 ? "" : localTime(shownAt).c_str());
+            if (shownAt < 0) fprintf(csv, ",");
+            else             fprintf(csv, "%.1f,", (shownAt - c.t) / 1000.0);
+            fprintf(csv, "%d\n", office ? 1 : 0);
+        }
+    }
+    if (csv) fclose(csv);
+
+    double hours = (g_sim->nowMs - g_scenario.startMs) / 3600000.0;
+    double total = 0;
+    for (int i = 0; i < CHG_COUNT; i++) total += g_sim->mAs[i];
+    double mAh = total / 3600.0;
+    double avgMa = hours > 0 ? mAh / hours : 0;
+    static const char* LOADS[CHG_COUNT] = { "awake", "radio", "panel", "light sleep", "deep sleep" };
+
+    fprintf(out, "Scenario   %s (%s)\n", g_scenario.name.c_str(), platformName(settings.platform));
+    fprintf(out, "Period     %s → %s (%.1f h), %s\n", localTime(g_scenario.startMs).c_str(),
+            localTime(g_sim->nowMs).c_str(), hours, ended);
+    fprintf(out, "Power      %s\n\n", g_scenario.battery ? "battery" : "USB");
+
+    fprintf(out, "Energy     %.1f mAh, %.2f mA average\n", mAh, avgMa);
+    for (int i = 0; i < CHG_COUNT; i++)
+        fprintf(out, "  %-12s %8.1f mAh  %5.1f%%\n", LOADS[i], g_sim->mAs[i] / 3600.0,
+                total > 0 ? g_sim->mAs[i] * 100.0 / total : 0);
+    fprintf(out, "  awake time   %8.1f min  %5.1f%%\n", g_sim->awakeMs / 60000.0,
+            hours > 0 ? g_sim->awakeMs / (hours * 36000.0) : 0);
+    if (g_scenario.battery && avgMa > 0)
+        fprintf(out, "  battery life %8.1f days on %.0f mAh\n", g_simBatteryMah / avgMa / 24.0,
+                g_simBatteryMah);
+    fprintf(out, "\n");
+
+    fprintf(out, "Activity   %u boots (%u timer wakes), %u light sleeps\n",
+            (unsigned)g_sim->boots, (unsigned)g_sim->timerWakes, (unsigned)g_sim->lightSleeps);
+    fprintf(out, "           %u WiFi joins, %u TLS handshakes, %u requests\n",
+            (unsigned)g_sim->wifiJoins, (unsigned)g_sim->handshakes, (unsigned)g_sim->requests);
+    fprintf(out, "           %u full + %u partial refreshes\n\n",
+            (unsigned)g_sim->epdFull, (unsigned)g_sim->epdPartial);
+
+    fprintf(out, "Latency    %u changes: %u shown, %d missed, %d outside office hours\n",
+            (unsigned)changes.size(), (unsigned)lat.size(), missed, offHours);
+    if (!lat.empty())
+        fprintf(out, "           median %.0f s, p95 %.0f s, max %.0f s\n", percentile(lat, 0.5),
+                percentile(lat, 0.95), percentile(lat, 1.0));
+}
+
+// ============================================================================
+// main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    const char* outDir = nullptr;
+    int  days  = 0;
+    bool quiet = false;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--out" && i + 1 < argc)       outDir = argv[++i];
+        else if (a == "--days" && i + 1 < argc) days = atoi(argv[++i]);
+        else if (a == "--quiet")                quiet = true;
+        else if (a[0] != '-' && !path)          path = argv[i];
+        else {
+            fprintf(stderr, "usage: %s <scenario.txt> [--out DIR] [--days N] [--quiet]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s <scenario.txt> [--out DIR] [--days N] [--quiet]\n", argv[0]);
+        return 2;
+    }
+
+    std::string err;
+    if (!simScenarioLoad(path, days, err)) {
+        fprintf(stderr, "sim: %s: %s\n", path, err.c_str());
+        return 2;
+    }
+    snprintf(g_simDir, sizeof(g_simDir), "%s",
+             outDir ? outDir : ("sim_out/" + g_scenario.name).c_str());
+
+    // Fresh run directory: flash erased, card formatted
+    run("mkdir -p '" + std::string(g_simDir) + "'");
+    run("rm -rf '" + std::string(g_simDir) + "/nvs' '" + std::string(g_simDir) + "/sd' '" +
+        std::string(g_simDir) + "/serial.log'");
+    if (g_scenario.sd) run("mkdir -p '" + std::string(g_simDir) + "/sd'");
+
+    g_sim = (SimShared*)mmap(nullptr, sizeof(SimShared), PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (g_sim == MAP_FAILED) {
+        perror("sim: mmap");
+        return 1;
+    }
+    memset(g_sim, 0, sizeof(SimShared));
+    g_sim->nowMs       = g_scenario.startMs;
+    g_sim->endMs       = g_scenario.startMs + g_scenario.days * 86400000LL;
+    g_sim->resetReason = ESP_RST_POWERON;
+    g_sim->wakeCause   = ESP_SLEEP_WAKEUP_UNDEFINED;
+    g_sim->onUsb       = !g_scenario.battery;
+    simRtcInit();
+    seedNvs();
+
+    const char* ended = "end of scenario";
+    while (g_sim->nowMs < g_sim->endMs) {
+        g_sim->boots++;
+        g_sim->bootAtMs = g_sim->nowMs;
+        g_sim->exitKind = EXIT_NONE;
+        fflush(stdout);
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("sim: fork");
+            return 1;
+        }
+        if (pid == 0) runBoot();
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || g_sim->exitKind == EXIT_NONE) {
+            fprintf(stderr, "sim: boot %u crashed (status 0x%x) at %s — see %s/serial.log\n",
+                    (unsigned)g_sim->boots, status, localTime(g_sim->nowMs).c_str(), g_simDir);
+            ended = "firmware crashed";
+            break;
+        }
+
+        if (g_sim->exitKind == EXIT_DEEP_SLEEP) {
+            int64_t wake = g_sim->nowMs + g_sim->sleepMs;
+            if (wake > g_sim->endMs) wake = g_sim->endMs;
+            g_sim->mAs[CHG_DEEP_SLEEP] += g_simCurrents.deepSleep * (wake - g_sim->nowMs) / 1000.0;
+            g_sim->nowMs       = wake;
+            g_sim->timerWakes++;
+            g_sim->resetReason = ESP_RST_DEEPSLEEP;
+            g_sim->wakeCause   = ESP_SLEEP_WAKEUP_TIMER;
+        } else if (g_sim->exitKind == EXIT_RESTART) {
+            g_sim->resetReason = ESP_RST_SW;
+            g_sim->wakeCause   = ESP_SLEEP_WAKEUP_UNDEFINED;
+        } else {
+            if (g_sim->exitKind == EXIT_POWER_OFF) ended = "powered off";
+            if (g_sim->exitKind == EXIT_STALLED)   ended = "stalled";
+            break;
+        }
+    }
+
+    // The settings the firmware ran with (it may have migrated them)
+    PodSettings settings;
+    loadSettings(settings);
+    Preferences creds;
+    if (creds.begin(NVS_NAMESPACE, true)) {
+        settings.platform = (Platform)creds.getString("platform_s", "0").toInt();
+        creds.end();
+    }
+
+    FILE* rep = fopen((std::string(g_simDir) + "/report.txt").c_str(), "w");
+    if (rep) {
+        report(rep, settings, ended);
+        fclose(rep);
+    }
+    if (!quiet) report(stdout, settings, ended);
+    return strcmp(ended, "firmware crashed") == 0 || strcmp(ended, "stalled") == 0 ? 1 : 0;
+}
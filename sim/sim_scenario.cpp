@@ -0,0 +1,279 @@
+// ============================================================================
+// Host simulation — scenario parser
+// ============================================================================
+
+#include "sim_scenario.h"
+#include "sim_core.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+SimScenario g_scenario;
+
+// A timeline line, kept until the time zone and start are known
+struct Pending {
+    int                      line;
+    std::string              kind;
+    std::vector<std::string> args;
+};
+
+static const char* DAY_NAMES[7] = { "sun", "mon", "tue", "wed", "thu", "fri", "sat" };
+
+static int dayIndex(const std::string& s) {
+    for (int i = 0; i < 7; i++)
+        if (strcasecmp(s.c_str(), DAY_NAMES[i]) == 0) return i;
+    return -1;
+}
+
+static bool parseDate(const std::string& s, int& y, int& m, int& d) {
+    return sscanf(s.c_str(), "%d-%d-%d", &y, &m, &d) == 3;
+}
+
+static bool parseClock(const std::string& s, int& h, int& m) {
+    return sscanf(s.c_str(), "%d:%d", &h, &m) == 2 && h >= 0 && h <= 24 && m >= 0 && m < 60;
+}
+
+static int64_t localMs(int y, int mon, int d, int h, int m) {
+    struct tm t = {};
+    t.tm_year  = y - 1900;
+    t.tm_mon   = mon - 1;
+    t.tm_mday  = d;
+    t.tm_hour  = h;
+    t.tm_min   = m;
+    t.tm_isdst = -1;
+    return (int64_t)mktime(&t) * 1000;
+}
+
+// Does `spec` select the day (date y-m-d, weekday wday)?
+static bool dayMatches(const std::string& spec, int y, int m, int d, int wday) {
+    int sy, sm, sd;
+    if (parseDate(spec, sy, sm, sd)) return sy == y && sm == m && sd == d;
+
+    std::stringstream ss(spec);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part == "daily")    return true;
+        if (part == "weekdays") { if (wday >= 1 && wday <= 5) return true; continue; }
+        if (part == "weekend")  { if (wday == 0 || wday == 6) return true; continue; }
+        size_t dash = part.find('-');
+        if (dash != std::string::npos) {
+            int a = dayIndex(part.substr(0, dash));
+            int b = dayIndex(part.substr(dash + 1));
+            if (a < 0 || b < 0) return false;
+            for (int i = a; ; i = (i + 1) % 7) {
+                if (i == wday) return true;
+                if (i == b) break;
+            }
+            continue;
+        }
+        if (dayIndex(part) == wday) return true;
+    }
+    return false;
+}
+
+static bool validDaySpec(const std::string& spec) {
+    int y, m, d;
+    if (parseDate(spec, y, m, d)) return true;
+    std::stringstream ss(spec);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part == "daily" || part == "weekdays" || part == "weekend") continue;
+        size_t dash = part.find('-');
+        if (dash != std::string::npos) {
+            if (dayIndex(part.substr(0, dash)) < 0 || dayIndex(part.substr(dash + 1)) < 0)
+                return false;
+        } else if (dayIndex(part) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool setModel(const std::string& kind, const std::string& field, float v) {
+    SimCurrents& c = g_simCurrents;
+    SimCosts&    k = g_simCosts;
+    if (kind == "current") {
+        if      (field == "awake")       c.awake      = v;
+        else if (field == "radio")       c.radio      = v;
+        else if (field == "epd")         c.epd        = v;
+        else if (field == "light_sleep") c.lightSleep = v;
+        else if (field == "deep_sleep")  c.deepSleep  = v;
+        else return false;
+        return true;
+    }
+    uint32_t ms = (uint32_t)v;
+    if      (field == "boot")        k.boot       = ms;
+    else if (field == "wifi")        k.wifi       = ms;
+    else if (field == "discovery")   k.discovery  = ms;
+    else if (field == "ntp")         k.ntp        = ms;
+    else if (field == "tls")         k.tls        = ms;
+    else if (field == "request")     k.request    = ms;
+    else if (field == "epd_partial") k.epdPartial = ms;
+    else if (field == "epd_full")    k.epdFull    = ms;
+    else return false;
+    return true;
+}
+
+static bool byTime(const SimStep& a, const SimStep& b) {
+    return a.t < b.t;
+}
+
+// ============================================================================
+// Load
+// ============================================================================
+
+bool simScenarioLoad(const char* path, int days, std::string& err) {
+    std::ifstream in(path);
+    if (!in) {
+        err = std::string("can't open ") + path;
+        return false;
+    }
+
+    SimScenario& s = g_scenario;
+    s = SimScenario();
+    std::vector<Pending> timeline;
+    int sy = 0, sm = 0, sd = 0, sh = 0, smin = 0;
+
+    std::string raw;
+    int lineNo = 0;
+    while (std::getline(in, raw)) {
+        lineNo++;
+        size_t hash = raw.find('#');
+        if (hash != std::string::npos) raw.erase(hash);
+
+        std::stringstream ls(raw);
+        std::vector<std::string> w;
+        std::string tok;
+        while (ls >> tok) w.push_back(tok);
+        if (w.empty()) continue;
+
+        char where[32];
+        snprintf(where, sizeof(where), "line %d: ", lineNo);
+        const std::string& k = w[0];
+        size_t n = w.size();
+
+        if (k == "name" && n >= 2) {
+            s.name = w[1];
+        } else if (k == "start" && n >= 3) {
+            if (!parseDate(w[1], sy, sm, sd) || !parseClock(w[2], sh, smin)) {
+                err = std::string(where) + "start wants YYYY-MM-DD HH:MM";
+                return false;
+            }
+        } else if (k == "days" && n >= 2) {
+            s.days = atoi(w[1].c_str());
+        } else if (k == "tz" && n >= 2) {
+            s.tz = w[1];
+        } else if (k == "battery" && n >= 2) {
+            s.battery = true;
+            g_simBatteryMah = (float)atof(w[1].c_str());
+            if (n >= 3) g_simBatteryStartPct = atoi(w[2].c_str());
+        } else if (k == "sd" && n >= 2) {
+            s.sd = atoi(w[1].c_str()) != 0;
+        } else if (k == "calendar" && n >= 2) {
+            s.calendar = atoi(w[1].c_str()) != 0;
+        } else if (k == "nvs" && n >= 4) {
+            // The value is the rest of the line (time zones have no spaces,
+            // but names might)
+            std::string v = w[3];
+            for (size_t i = 4; i < n; i++) v += " " + w[i];
+            s.nvs.push_back(SimNvsKey{ w[1], w[2], v });
+        } else if ((k == "current" || k == "cost") && n >= 3) {
+            if (!setModel(k, w[1], (float)atof(w[2].c_str()))) {
+                err = std::string(where) + "unknown " + k + " \"" + w[1] + "\"";
+                return false;
+            }
+        } else if ((k == "teams" || k == "zoom") && n >= 4) {
+            timeline.push_back(Pending{ lineNo, k, w });
+        } else if ((k == "meeting" || k == "outage") && n >= 4) {
+            timeline.push_back(Pending{ lineNo, k, w });
+        } else {
+            err = std::string(where) + "can't read \"" + k + "\"";
+            return false;
+        }
+    }
+
+    if (sy == 0) {
+        err = "no start line";
+        return false;
+    }
+    if (days > 0) s.days = days;
+    if (s.name.empty()) s.name = "scenario";
+
+    setenv("TZ", s.tz.c_str(), 1);
+    tzset();
+    s.startMs = localMs(sy, sm, sd, sh, smin);
+
+    // Expand every timeline line over the simulated days
+    for (const Pending& p : timeline) {
+        char where[32];
+        snprintf(where, sizeof(where), "line %d: ", p.line);
+        const std::vector<std::string>& w = p.args;
+        if (!validDaySpec(w[1])) {
+            err = std::string(where) + "bad day spec \"" + w[1] + "\"";
+            return false;
+        }
+        int h1, m1, h2 = 0, m2 = 0;
+        bool span = p.kind == "meeting" || p.kind == "outage";
+        if (!parseClock(w[2], h1, m1) || (span && !parseClock(w[3], h2, m2))) {
+            err = std::string(where) + "bad time";
+            return false;
+        }
+
+        for (int d = 0; d <= s.days; d++) {
+            // Noon of the day, so a DST change can't slip to the next date
+            struct tm day = {};
+            day.tm_year  = sy - 1900;
+            day.tm_mon   = sm - 1;
+            day.tm_mday  = sd + d;
+            day.tm_hour  = 12;
+            day.tm_isdst = -1;
+            mktime(&day);
+            int y = day.tm_year + 1900, m = day.tm_mon + 1, dd = day.tm_mday;
+            if (!dayMatches(w[1], y, m, dd, day.tm_wday)) continue;
+
+            int64_t t1 = localMs(y, m, dd, h1, m1);
+            if (span) {
+                int64_t t2 = localMs(y, m, dd, h2, m2);
+                if (t2 <= t1) t2 += 24LL * 3600 * 1000;     // over midnight
+                SimSpan sp{ t1, t2, p.kind == "meeting" && w.size() >= 5 ? w[4] : "busy" };
+                (p.kind == "meeting" ? s.meetings : s.outages).push_back(sp);
+            } else {
+                SimStep st{ t1, w[3], w.size() >= 5 ? w[4] : "" };
+                (p.kind == "teams" ? s.teams : s.zoom).push_back(st);
+            }
+        }
+    }
+
+    std::stable_sort(s.teams.begin(), s.teams.end(), byTime);
+    std::stable_sort(s.zoom.begin(), s.zoom.end(), byTime);
+    return true;
+}
+
+// ============================================================================
+// Lookups
+// ============================================================================
+
+static const SimStep* stepAt(const std::vector<SimStep>& v, int64_t ms) {
+    // Last step at or before `ms`
+    auto it = std::upper_bound(v.begin(), v.end(), ms,
+                               [](int64_t t, const SimStep& s) { return t < s.t; });
+    return it == v.begin() ? nullptr : &*(it - 1);
+}
+
+const SimStep* simTeamsAt(int64_t ms) {
+    return stepAt(g_scenario.teams, ms);
+}
+
+const SimStep* simZoomAt(int64_t ms) {
+    return stepAt(g_scenario.zoom, ms);
+}
+
+bool simOutageAt(int64_t ms) {
+    for (const SimSpan& o : g_scenario.outages)
+        if (ms >= o.start && ms < o.end) return true;
+    return false;
+}
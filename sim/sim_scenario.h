@@ -0,0 +1,80 @@
+// ============================================================================
+// Host simulation — scenario files (sim/scenarios/*.txt)
+//
+// One directive per line, '#' starts a comment.  Times are local to the
+// scenario's time zone; a timeline line repeats on every simulated day
+// its day spec matches.
+//
+//   name     office_week
+//   start    2026-10-19 07:00          first boot (power on)
+//   days     7
+//   tz       GMT0BST,M3.5.0/1,M10.5.0  POSIX TZ (also seeds pod_settings)
+//   battery  1000 90                   mAh, starting %   (omit = on USB)
+//   sd       0|1                       card present
+//   calendar 0|1                       Calendars.Read consented
+//   nvs      pod_settings interval 60  any NVS key, stored as given
+//
+//   teams    weekdays 09:00 Busy InAMeeting    Graph availability [activity]
+//   zoom     mon-fri  09:00 In_A_Zoom_Meeting  Zoom presence_status
+//   meeting  mon,wed  10:00 10:30 busy         calendarView event [showAs]
+//   outage   2026-10-21 13:00 14:00            no WiFi / no server
+//
+//   current  awake 45        cost wifi 1200    model overrides (sim_core.h)
+//
+// A day spec is mon..sun, daily, weekdays, weekend, a range (mon-thu), a
+// comma list of those, or one date (YYYY-MM-DD).
+// ============================================================================
+
+#ifndef SIM_SCENARIO_H
+#define SIM_SCENARIO_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct SimStep {
+    int64_t     t;          // epoch ms
+    std::string value;      // teams: availability, zoom: status
+    std::string activity;   // teams only
+};
+
+struct SimSpan {
+    int64_t     start;
+    int64_t     end;
+    std::string showAs;
+};
+
+struct SimNvsKey {
+    std::string ns;
+    std::string key;
+    std::string value;
+};
+
+struct SimScenario {
+    std::string            name;
+    std::string            tz       = "UTC0";
+    int64_t                startMs  = 0;
+    int                    days     = 7;
+    bool                   battery  = false;    // false = on USB throughout
+    bool                   sd       = false;
+    bool                   calendar = true;
+    std::vector<SimStep>   teams;               // sorted by t
+    std::vector<SimStep>   zoom;
+    std::vector<SimSpan>   meetings;
+    std::vector<SimSpan>   outages;
+    std::vector<SimNvsKey> nvs;
+};
+
+extern SimScenario g_scenario;
+
+// Parse `path` into g_scenario (also sets TZ and the model overrides).
+// `days` > 0 overrides the file.  False with a message on a bad line.
+bool simScenarioLoad(const char* path, int days, std::string& err);
+
+// The step in effect at `ms` (nullptr before the first)
+const SimStep* simTeamsAt(int64_t ms);
+const SimStep* simZoomAt(int64_t ms);
+
+bool simOutageAt(int64_t ms);
+
+#endif
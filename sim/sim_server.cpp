@@ -0,0 +1,299 @@
+// ============================================================================
+// Host simulation — https_conn.h over a scripted Graph / login / Zoom server
+//
+// Takes the place of src/https_conn.cpp.  Sessions follow the real
+// connection manager: a host's first request after WiFi comes up pays a
+// TLS handshake, later ones reuse it until the radio goes off.  Answers
+// come from the scenario timelines (sim_scenario.h); access tokens carry
+// their expiry so an expired one gets the 401 a real server would send.
+// ============================================================================
+
+#include "https_conn.h"
+#include "wake_profiler.h"
+#include "sim_core.h"
+#include "sim_scenario.h"
+#include <WiFi.h>
+#include <set>
+#include <string>
+
+static std::set<std::string> s_open;        // hosts with a live TLS session
+static uint32_t              s_handshakes = 0;
+static uint32_t              s_reused     = 0;
+
+static std::string urlHost(const std::string& url) {
+    size_t p = url.find("://");
+    p = p == std::string::npos ? 0 : p + 3;
+    size_t e = url.find_first_of(":/?", p);
+    return url.substr(p, e == std::string::npos ? std::string::npos : e - p);
+}
+
+static std::string urlPath(const std::string& url) {
+    size_t p = url.find("://");
+    p = url.find('/', p == std::string::npos ? 0 : p + 3);
+    return p == std::string::npos ? "/" : url.substr(p);
+}
+
+static time_t nowSec() {
+    return (time_t)(simNowMs() / 1000);
+}
+
+void simNetDown() {
+    s_open.clear();
+}
+
+// ============================================================================
+// Tokens — "sim-<kind>-<expiry epoch>"
+// ============================================================================
+
+static std::string issueToken(const char* kind, int ttlSec) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "sim-%s-%ld", kind, (long)(nowSec() + ttlSec));
+    return buf;
+}
+
+static bool bearerValid(const String& auth, const char* kind) {
+    char prefix[24];
+    snprintf(prefix, sizeof(prefix), "Bearer sim-%s-", kind);
+    size_t n = strlen(prefix);
+    if (strncmp(auth.c_str(), prefix, n) != 0) return false;
+    return atol(auth.c_str() + n) > (long)nowSec();
+}
+
+static std::string tokenResponse(const char* kind, bool withRefresh) {
+    std::string j = "{\"token_type\":\"Bearer\",\"expires_in\":3600,\"access_token\":\"";
+    j += issueToken(kind, 3600);
+    j += "\"";
+    if (withRefresh) j += ",\"refresh_token\":\"sim-refresh\"";
+    return j + "}";
+}
+
+// ============================================================================
+// Routes
+// ============================================================================
+
+static void formatGraphUtc(int64_t ms, char* buf, size_t len) {
+    time_t t = (time_t)(ms / 1000);
+    struct tm g;
+    gmtime_r(&t, &g);
+    strftime(buf, len, "%Y-%m-%dT%H:%M:%S.0000000", &g);
+}
+
+static int64_t queryUtcMs(const std::string& url, const char* name) {
+    size_t p = url.find(name);
+    if (p == std::string::npos) return 0;
+    struct tm g = {};
+    if (sscanf(url.c_str() + p + strlen(name), "%4d-%2d-%2dT%2d:%2d:%2d", &g.tm_year, &g.tm_mon,
+               &g.tm_mday, &g.tm_hour, &g.tm_min, &g.tm_sec) != 6)
+        return 0;
+    g.tm_year -= 1900;
+    g.tm_mon  -= 1;
+    return (int64_t)timegm(&g) * 1000;
+}
+
+static int routeCalendar(const std::string& url, std::string& out) {
+    if (!g_scenario.calendar) {
+        out = "{\"error\":{\"code\":\"ErrorAccessDenied\"}}";
+        return 403;
+    }
+    int64_t from = queryUtcMs(url, "startDateTime=");
+    int64_t to   = queryUtcMs(url, "endDateTime=");
+
+    out = "{\"value\":[";
+    int n = 0;
+    for (const SimSpan& m : g_scenario.meetings) {
+        if (m.end <= from || m.start >= to || n >= 40) continue;
+        char s[32], e[32];
+        formatGraphUtc(m.start, s, sizeof(s));
+        formatGraphUtc(m.end, e, sizeof(e));
+        if (n++) out += ",";
+        out += "{\"start\":{\"dateTime\":\"" + std::string(s) + "\",\"timeZone\":\"UTC\"},"
+               "\"end\":{\"dateTime\":\"" + std::string(e) + "\",\"timeZone\":\"UTC\"},"
+               "\"showAs\":\"" + m.showAs + "\",\"isCancelled\":false,\"isAllDay\":false}";
+    }
+    out += "]}";
+    return 200;
+}
+
+static int route(HTTPClient& http, const char* method, const std::string& body,
+                 std::string& out) {
+    std::string url  = http.url.c_str();
+    std::string host = urlHost(url);
+    std::string path = urlPath(url);
+    static const char* UNAUTHORISED = "{\"error\":{\"code\":\"InvalidAuthenticationToken\"}}";
+
+    if (host == "login.microsoftonline.com") {
+        if (path.find("/devicecode") != std::string::npos) {
+            out = "{\"device_code\":\"sim-device-code\",\"user_code\":\"SIMCODE1\","
+                  "\"verification_uri\":\"https://microsoft.com/devicelogin\","
+                  "\"expires_in\":900,\"interval\":5}";
+            return 200;
+        }
+        if (body.find("grant_type=refresh_token") != std::string::npos) {
+            out = tokenResponse("graph", true);
+            return 200;
+        }
+        // Device-code grant: nobody signs in during a simulation
+        out = "{\"error\":\"authorization_pending\","
+              "\"error_description\":\"AADSTS70016: pending\"}";
+        return 400;
+    }
+
+    if (host == "graph.microsoft.com") {
+        if (!bearerValid(http.auth, "graph")) {
+            out = UNAUTHORISED;
+            return 401;
+        }
+        if (path == "/v1.0/me/presence") {
+            const SimStep* s = simTeamsAt(simNowMs());
+            out = "{\"availability\":\"" + (s ? s->value : std::string("PresenceUnknown")) +
+                  "\",\"activity\":\"" + (s ? s->activity : std::string("")) + "\"}";
+            return 200;
+        }
+        if (path.find("/me/calendarView") != std::string::npos) return routeCalendar(url, out);
+        out = "{\"error\":{\"code\":\"NotFound\"}}";     // team board isn't modelled
+        return 404;
+    }
+
+    if (host == "zoom.us" && path.compare(0, 12, "/oauth/token") == 0) {
+        out = tokenResponse("zoom", false);
+        return 200;
+    }
+
+    if (host == "api.zoom.us") {
+        if (!bearerValid(http.auth, "zoom")) {
+            out = "{\"code\":124,\"message\":\"Invalid access token.\"}";
+            return 401;
+        }
+        const SimStep* s = simZoomAt(simNowMs());
+        out = "{\"status\":\"" + (s ? s->value : std::string("Offline")) + "\"}";
+        return 200;
+    }
+
+    (void)method;
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+}
+
+// ============================================================================
+// https_conn.h
+// ============================================================================
+
+bool httpsBegin(HTTPClient& http, const String& url) {
+    std::string host = urlHost(url.c_str());
+    http.url  = url;
+    http.auth = "";
+    http.body.stop();
+
+    if (WiFi.status() != WL_CONNECTED) {
+        Serial.printf("[HTTPS] %s: connect failed (no WiFi)\n", host.c_str());
+        return false;
+    }
+    if (s_open.count(host)) {
+        s_reused++;
+        Serial.printf("[HTTPS] %s: reusing connection\n", host.c_str());
+        return true;
+    }
+
+    unsigned long t0 = millis();
+    simAdvance(g_simCosts.tls);
+    if (simOutageAt(simNowMs())) {
+        Serial.printf("[HTTPS] %s: connect failed after %lums\n", host.c_str(), millis() - t0);
+        return false;
+    }
+    uint32_t dt = millis() - t0;
+    wakeProfAdd(WP_TLS, dt);
+    s_open.insert(host);
+    s_handshakes++;
+    g_sim->handshakes++;
+    Serial.printf("[HTTPS] %s: handshake %ums (#%u)\n", host.c_str(), (unsigned)dt,
+                  (unsigned)s_handshakes);
+    return true;
+}
+
+int httpsSend(HTTPClient& http, const char* method, const String& body) {
+    return httpsSend(http, method, body.c_str(), body.length());
+}
+
+int httpsSend(HTTPClient& http, const char* method, const char* body, size_t len) {
+    unsigned long t0 = millis();
+    g_sim->requests++;
+    simAdvance(g_simCosts.request);
+    wakeProfAdd(WP_HTTP, millis() - t0);
+
+    if (simOutageAt(simNowMs())) {
+        s_open.erase(urlHost(http.url.c_str()));
+        return HTTPC_ERROR_CONNECTION_LOST;
+    }
+    std::string out;
+    http.code = route(http, method, std::string(body ? body : "", len), out);
+    http.body.load(out);
+    return http.code;
+}
+
+void httpsAddBearer(HTTPClient& http, const char* token) {
+    StrBuf auth(7 + strlen(token));
+    auth.print("Bearer ");
+    auth.print(token);
+    http.addHeader("Authorization", auth.c_str());
+}
+
+void httpsReadError(HTTPClient& http, StrBuf& out) {
+    HttpsBody body(http);
+    out.readFrom(body);
+    body.drain();
+}
+
+void httpsEnd(HTTPClient& http) {
+    http.end();
+}
+
+void httpsCloseAll() {
+    s_open.clear();
+}
+
+void httpsLogTlsMode() {
+    Serial.println("[HTTPS] Simulated server — no certificates");
+}
+
+void httpsLogStats() {
+    Serial.printf("[HTTPS] %u handshakes (avg %ums, max %ums), %u reused\n",
+                  (unsigned)s_handshakes, (unsigned)(s_handshakes ? g_simCosts.tls : 0),
+                  (unsigned)(s_handshakes ? g_simCosts.tls : 0), (unsigned)s_reused);
+}
+
+// ============================================================================
+// HttpsBody — the scripted body is already whole; no chunking to undo
+// ============================================================================
+
+HttpsBody::HttpsBody(HTTPClient& http, unsigned long timeoutMs)
+    : _client(http.getStreamPtr()), _chunked(false), _left(http.getSize()),
+      _eof(_client == nullptr), _pos(0), _len(0), _total(0), _start(millis())
+{
+    setTimeout(timeoutMs);
+}
+
+int HttpsBody::available() {
+    return _eof ? 0 : _client->available();
+}
+
+int HttpsBody::read() {
+    int c = _eof ? -1 : _client->read();
+    if (c >= 0) _total++;
+    return c;
+}
+
+int HttpsBody::peek() {
+    return _eof ? -1 : _client->peek();
+}
+
+size_t HttpsBody::readBytes(char* buffer, size_t length) {
+    if (_eof) return 0;
+    size_t n = _client->readBytes(buffer, length);
+    _total += n;
+    return n;
+}
+
+void HttpsBody::drain() {
+    char sink[64];
+    while (readBytes(sink, sizeof(sink)) > 0) {}
+    wakeProfAdd(WP_JSON, millis() - _start);
+}
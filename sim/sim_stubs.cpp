@@ -0,0 +1,459 @@
+// ============================================================================
+// Host simulation — stand-ins for the modules that drive hardware
+//
+// Each keeps the real module's header (include/) and its interface
+// behaviour, and replaces the driver work with its cost on the simulation
+// clock: a panel refresh is BUSY time, a WiFi join is association time,
+// light discovery is its listen window.  Peripherals the energy model
+// doesn't cover (audio, lights, BLE) are no-ops.
+// ============================================================================
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_system.h>
+#include <sys/stat.h>
+
+#include "audio.h"
+#include "ble_setup.h"
+#include "clock_sync.h"
+#include "display_ui.h"
+#include "input.h"
+#include "light_control.h"
+#include "light_state.h"
+#include "light_devices.h"
+#include "output_pipeline.h"
+#include "power_policy.h"
+#include "sd_storage.h"
+#include "ulp_monitor.h"
+#include "wake_profiler.h"
+#include "wifi_link.h"
+#include "wled_provision.h"
+#include "sim_core.h"
+#include "sim_scenario.h"
+
+// ============================================================================
+// display_ui — status screens are partial refreshes, promoted to full on a
+// background flip or every fullRefreshEvery-th time, as in display_ui.cpp
+// ============================================================================
+
+struct RtcSimPanel {
+    int16_t partialCount;
+    int8_t  lastBg;         // -1 unknown, 0 white, 1 black, 2 other screen
+};
+RTC_DATA_ATTR static RtcSimPanel rtc_simPanel = { 0, -1 };
+static int s_fullEvery = 10;
+
+static void refresh(bool partial, int8_t bg) {
+    if (bg != rtc_simPanel.lastBg) partial = false;
+    if (partial && s_fullEvery > 0 && rtc_simPanel.partialCount >= s_fullEvery) partial = false;
+    rtc_simPanel.partialCount = partial ? rtc_simPanel.partialCount + 1 : 0;
+    rtc_simPanel.lastBg = bg;
+    simEpdWait();               // the panel takes one frame at a time
+    simEpdRefresh(!partial);
+}
+
+static void screen(const char* name, bool partial = false) {
+    Serial.printf("[UI] %s\n", name);
+    refresh(partial, 2);
+}
+
+void displaySetFullRefreshEvery(int n) { s_fullEvery = n; }
+void displayBegin()                    {}
+void displayWarmSleep()                { simEpdWait(); }
+void displayWaitIdle()                 { simEpdWait(); }
+void displayPrepareStatusFrames()      {}
+
+void drawStatusScreen(Availability availability, Activity activity) {
+    refresh(true, availabilityInfo(availability).inverted ? 1 : 0);
+    simShowStatus(availability);
+    Serial.printf("[UI] Status: %s (%s)\n", availabilityName(availability),
+                  activityName(activity));
+}
+
+void drawSplashScreen(const char* platformLabel)             { (void)platformLabel; screen("Splash"); }
+void drawSetupScreen()                                       { screen("Setup"); }
+void drawQRAuthScreen(const char* userCode, const char* qr)  { (void)userCode; (void)qr; screen("QR auth"); }
+void drawAuthCodeScreen(const char* userCode)                { (void)userCode; screen("Auth code"); }
+void drawTeamBoard(uint8_t changedRows)                      { (void)changedRows; screen("Team board", true); }
+void drawErrorScreen(const char* title, const char* detail)  {
+    Serial.printf("[UI] Error: %s — %s\n", title, detail);
+    refresh(false, 2);
+}
+void drawShutdownScreen()                                    { screen("Shutdown"); }
+void drawLowBatteryScreen(int percent, bool critical)        { (void)percent; (void)critical; screen("Low battery"); }
+void drawMenuScreen(int s, const PodSettings& p, const LightConfig& l, bool partial)     { (void)s; (void)p; (void)l; screen("Menu", partial); }
+void drawSettingsScreen(int s, const PodSettings& p, const LightConfig& l, bool partial) { (void)s; (void)p; (void)l; screen("Settings", partial); }
+void drawDeviceInfoScreen(const char*, const char*, const char*, const char*, float, int, bool,
+                          const char*, const char*, const char*, bool partial) { screen("Device info", partial); }
+void drawAuthInfoScreen(bool, long, const char*, const char*, const char*, bool partial) { screen("Auth info", partial); }
+void drawProvisioningScreen(const char* step, const char* detail) { (void)step; (void)detail; screen("Provisioning"); }
+void drawProvisioningResult(bool success, const char* message)    { (void)success; (void)message; screen("Provisioning result"); }
+void drawLightsScreen(int, const std::vector<LightDevice>&, int, bool partial) { screen("Lights", partial); }
+void drawLightActionScreen(const LightDevice&, int, bool partial)              { screen("Light action", partial); }
+
+// ============================================================================
+// output_pipeline — the panel stage only (lights and sound aren't modelled)
+// ============================================================================
+
+void outputPresenceChanged(Availability availability, Activity activity,
+                           const LightConfig& light, bool notify) {
+    (void)light; (void)notify;
+    drawStatusScreen(availability, activity);
+}
+void outputPipelineJoin() {}
+bool outputPipelineBusy() { return false; }
+
+// ============================================================================
+// audio
+// ============================================================================
+
+void audioInit(bool playTestTone)               { (void)playTestTone; }
+void audioEnable()                              {}
+void audioDisable()                             {}
+void audioShutdown()                            {}
+void audioSuspend()                             {}
+void audioResume()                              {}
+void audioTone(int freqHz, int durationMs)      { (void)freqHz; (void)durationMs; }
+void audioClick()                               {}
+void audioBeep()                                {}
+void audioConfirm()                             {}
+void audioError()                               {}
+void audioNotify()                              {}
+void audioAttention(int repeats)                { (void)repeats; }
+void audioPreload()                             {}
+bool audioStart(const char* path, int repeats)  { (void)path; (void)repeats; return false; }
+void audioStop()                                {}
+bool audioIsPlaying()                           { return false; }
+bool audioWaitIdle(uint32_t timeoutMs)          { (void)timeoutMs; return true; }
+bool audioPlayMP3(const char* path)             { (void)path; return false; }
+
+// ============================================================================
+// Lights — no devices answer; a discovery still costs its listen window
+// ============================================================================
+
+const char* lightTypeName(LightType t) {
+    static const char* NAMES[] = { "None", "WLED", "Bulb", "Hue", "WiZ" };
+    return t < LIGHT_TYPE_COUNT ? NAMES[t] : "?";
+}
+void loadLightConfig(LightConfig& cfg)          { cfg = LightConfig(); }
+void saveLightConfig(const LightConfig& cfg)    { (void)cfg; }
+void lightSetPresence(const LightConfig& cfg, Availability a, Activity act) { (void)cfg; (void)a; (void)act; }
+void lightSetColor(const LightConfig& cfg, uint8_t r, uint8_t g, uint8_t b) { (void)cfg; (void)r; (void)g; (void)b; }
+void lightOff(const LightConfig& cfg)           { (void)cfg; }
+void lightTest(const LightConfig& cfg)          { (void)cfg; }
+bool lightStateStale()                          { return false; }
+
+static std::vector<LightDevice> s_devices;
+
+std::vector<LightDevice>& lightDevicesGet()     { return s_devices; }
+bool lightDevicesSave()                         { return true; }
+bool lightDevicesLoad()                         { return true; }
+int  lightDiscoverWLED()                        { return 0; }
+int  lightDiscoverWiZ()                         { return 0; }
+int  lightDiscoverHue(const String& ip, const String& key) { (void)ip; (void)key; return 0; }
+int  lightDiscoverAll(const LightConfig& cfg, LightDiscoveryProgress progress, void* ctx) {
+    (void)cfg; (void)progress; (void)ctx;
+    Serial.println("[Lights] Discovery — no devices");
+    delay(g_simCosts.discovery);
+    return 0;
+}
+bool lightDiscoveryDue()                        { return false; }
+bool wledActivatePreset(const String& ip, int presetId) { (void)ip; (void)presetId; return false; }
+void wledActivatePresetAll(int presetId)        { (void)presetId; }
+bool wledProvisionDevice(const String& ip)      { (void)ip; return false; }
+int  wledProvisionAll()                         { return 0; }
+bool lightDevicePing(const LightDevice& dev)    { (void)dev; return false; }
+void lightDevicesVerify()                       {}
+
+WledProvResult wledZeroConfig(const String& ssid, const String& password) {
+    (void)ssid; (void)password;
+    return WLED_PROV_AP_FAIL;
+}
+
+// ============================================================================
+// ble_setup — credentials come from the NVS the scenario seeded
+// ============================================================================
+
+String g_ssid = "";
+String g_password = "";
+String g_client_id = "";
+String g_tenant_id = "";
+String g_light_type = "0";
+String g_light_ip = "";
+String g_light_key = "";
+String g_light_aux = "1";
+String g_client_secret = "";
+String g_platform = "0";
+String g_timezone = "";
+String g_office_hours = "";
+String g_wled_new = "";
+String g_zoom_account = "";
+String g_zoom_client_id = "";
+
+static const uint32_t BLE_SETUP_MAGIC = 0x53454C42;   // "BLES"
+RTC_NOINIT_ATTR static uint32_t rtc_bleSetup;
+
+void initializeBLE()        { Serial.println("[BLE] Not modelled — waiting for nothing"); }
+void deinitBLE()            {}
+void startBLEAdvertising()  {}
+void stopBLEAdvertising()   {}
+void bleSetupService()      {}
+
+void bleRequestSetup() {
+    rtc_bleSetup = BLE_SETUP_MAGIC;
+    ESP.restart();
+}
+
+bool bleSetupRequested() {
+    bool req = esp_reset_reason() == ESP_RST_SW && rtc_bleSetup == BLE_SETUP_MAGIC;
+    rtc_bleSetup = 0;
+    return req;
+}
+
+bool hasStoredCredentials() {
+    Preferences p;
+    if (!p.begin(NVS_NAMESPACE, true)) return false;
+    bool has = !p.getString(NVS_KEY_SSID, "").isEmpty();
+    p.end();
+    return has;
+}
+
+void loadCredentialsFromNVS() {
+    Preferences p;
+    p.begin(NVS_NAMESPACE, true);
+    g_ssid           = p.getString(NVS_KEY_SSID, "");
+    g_password       = p.getString(NVS_KEY_PASSWORD, "");
+    g_client_id      = p.getString(NVS_KEY_CLIENT_ID, "");
+    g_tenant_id      = p.getString(NVS_KEY_TENANT_ID, "");
+    g_light_type     = p.getString("light_type", "0");
+    g_light_ip       = p.getString("light_ip", "");
+    g_client_secret  = p.getString("client_sec", "");
+    g_platform       = p.getString("platform_s", "0");
+    g_zoom_account   = p.getString("zoom_acct", "");
+    g_zoom_client_id = p.getString("zoom_cid", "");
+    p.end();
+
+    Preferences sp;
+    if (sp.begin("pod_settings", true)) {
+        g_timezone = sp.getString("timezone", "");
+        sp.end();
+    }
+}
+
+void saveCredentialsToNVS() {
+    Preferences p;
+    p.begin(NVS_NAMESPACE, false);
+    p.putString(NVS_KEY_SSID, g_ssid);
+    p.putString(NVS_KEY_PASSWORD, g_password);
+    p.putString(NVS_KEY_CLIENT_ID, g_client_id);
+    p.putString(NVS_KEY_TENANT_ID, g_tenant_id);
+    p.putString("platform_s", g_platform);
+    p.end();
+}
+
+void clearStoredCredentials() {
+    Preferences p;
+    p.begin(NVS_NAMESPACE, false);
+    p.clear();
+    p.end();
+    g_ssid = g_password = g_client_id = g_tenant_id = "";
+}
+
+// ============================================================================
+// sd_storage — <run>/sd/ when the scenario has a card.  The SD config file
+// isn't modelled: settings come from NVS.
+// ============================================================================
+
+static bool s_sdMounted = false;
+
+static std::string sdPath(const char* path) {
+    return std::string(g_simDir) + "/sd" + path;
+}
+
+bool   sdInit()          { s_sdMounted = g_scenario.sd; return s_sdMounted; }
+bool   sdMounted()       { return s_sdMounted; }
+bool   sdEnsureMounted() { return s_sdMounted || sdInit(); }
+void   sdDeinit()        { s_sdMounted = false; }
+String sdCardInfo()      { return String("SDHC 8 GB (sim)"); }
+
+bool sdLoadConfig(SdConfig& cfg)       { (void)cfg; return false; }
+bool sdSaveConfig(const SdConfig& cfg) { (void)cfg; return false; }
+
+static bool sdPut(const char* path, const String& content, const char* mode) {
+    if (!s_sdMounted) return false;
+    FILE* f = fopen(sdPath(path).c_str(), mode);
+    if (!f) return false;
+    fwrite(content.c_str(), 1, content.length(), f);
+    fclose(f);
+    return true;
+}
+
+bool sdWriteText(const char* path, const String& content)  { return sdPut(path, content, "w"); }
+bool sdAppendText(const char* path, const String& content) { return sdPut(path, content, "a"); }
+
+uint8_t* sdReadFile(const char* path, size_t& outLen) {
+    outLen = 0;
+    if (!s_sdMounted) return nullptr;
+    FILE* f = fopen(sdPath(path).c_str(), "rb");
+    if (!f) return nullptr;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* buf = (uint8_t*)malloc(n + 1);
+    if (buf) {
+        outLen = fread(buf, 1, n, f);
+        buf[outLen] = 0;
+    }
+    fclose(f);
+    return buf;
+}
+
+String sdReadText(const char* path) {
+    size_t n;
+    uint8_t* buf = sdReadFile(path, n);
+    if (!buf) return String();
+    String s((const char*)buf);
+    free(buf);
+    return s;
+}
+
+bool sdFileExists(const char* path) {
+    struct stat st;
+    return s_sdMounted && stat(sdPath(path).c_str(), &st) == 0;
+}
+
+int32_t sdFileSize(const char* path) {
+    struct stat st;
+    return s_sdMounted && stat(sdPath(path).c_str(), &st) == 0 ? (int32_t)st.st_size : -1;
+}
+
+time_t sdFileModified(const char* path) {
+    struct stat st;
+    return s_sdMounted && stat(sdPath(path).c_str(), &st) == 0 ? st.st_mtime : 0;
+}
+
+bool sdLoadBitmap(const char* path, uint8_t* buf, size_t bufLen) { (void)path; (void)buf; (void)bufLen; return false; }
+bool sdLoadBMP(const char* path, uint8_t* buf, size_t bufLen)    { (void)path; (void)buf; (void)bufLen; return false; }
+
+// ============================================================================
+// input — nobody touches the pod, except to get past the boot splash
+// ============================================================================
+
+enum SplashPress : uint8_t { PRESS_IDLE, PRESS_DOWN, PRESS_DONE };
+static uint8_t s_splash = PRESS_IDLE;
+
+bool inputInit(int bootPin, int pwrPin) { (void)bootPin; (void)pwrPin; return true; }
+
+bool inputWait(ButtonEvent& ev, uint32_t timeoutMs) {
+    if (timeoutMs == INPUT_FOREVER) {
+        // Only the splash gate waits forever: a short BOOT press
+        ev.button = BTN_BOOT;
+        if (s_splash == PRESS_DOWN) {
+            delay(150);
+            ev.action = BTN_RELEASE;
+            ev.heldMs = 150;
+            s_splash  = PRESS_DONE;
+        } else {
+            delay(2000);
+            ev.action = BTN_PRESS;
+            ev.heldMs = 0;
+            s_splash  = PRESS_DOWN;
+        }
+        return true;
+    }
+    delay(timeoutMs);
+    return false;
+}
+
+PodButton inputWaitPress() {
+    delay(2000);
+    return BTN_BOOT;
+}
+
+void inputWaitRelease(PodButton b) { (void)b; delay(150); }
+bool inputHeld(PodButton b)        { (void)b; return false; }
+void inputFlush()                  {}
+
+// ============================================================================
+// power_policy — the energy model has one awake current
+// ============================================================================
+
+static const char* LOCK_NAMES[PM_LOCK_COUNT] = { "cpu_max", "apb_max" };
+
+void powerPolicyInit()                        {}
+void powerSetUsbMode(bool onUSB)              { (void)onUSB; }
+void powerLockAcquire(PowerLockKind kind)     { (void)kind; }
+void powerLockRelease(PowerLockKind kind)     { (void)kind; }
+uint32_t powerLockHeldMs(PowerLockKind kind)  { (void)kind; return 0; }
+const char* powerLockName(PowerLockKind kind) { return kind < PM_LOCK_COUNT ? LOCK_NAMES[kind] : "?"; }
+
+// ============================================================================
+// ulp_monitor — not modelled (the battery only drains while awake/asleep)
+// ============================================================================
+
+bool ulpMonitorStart(int sleepSec, int warnPct, int shutdownPct) {
+    (void)sleepSec; (void)warnPct; (void)shutdownPct;
+    return false;
+}
+bool ulpMonitorCollect(UlpReport& out) { (void)out; return false; }
+const char* ulpWakeReasonName(UlpWakeReason reason) {
+    static const char* NAMES[] = { "none", "USB", "battery warning", "battery shutdown" };
+    return reason <= ULP_WAKE_BATT_SHUTDOWN ? NAMES[reason] : "?";
+}
+
+// ============================================================================
+// wifi_link — a join takes `cost wifi` ms; it times out during an outage
+// ============================================================================
+
+bool wifiConnect(const String& ssid, const String& password, unsigned long timeoutMs) {
+    (void)password;
+    WiFi.mode(WIFI_STA);
+    if (simOutageAt(simNowMs())) {
+        Serial.printf("[WiFi] %s: no AP — timed out\n", ssid.c_str());
+        delay(timeoutMs);
+        return false;
+    }
+    delay(g_simCosts.wifi);
+    g_sim->wifiJoins++;
+    simWifiJoined();
+    Serial.printf("[WiFi] ✓ IP %s in %ums\n", WiFi.localIP().toString().c_str(),
+                  (unsigned)g_simCosts.wifi);
+    return true;
+}
+
+// ============================================================================
+// clock_sync — the RTC never drifts; NTP runs every 12 h as in clock_sync.cpp
+// ============================================================================
+
+static const long NTP_RESYNC_SEC = 12 * 3600L;
+RTC_DATA_ATTR static time_t rtc_lastSyncEpoch = 0;
+static int64_t s_syncStartMs = -1;
+
+void clockInit(const String& timezone) {
+    setenv("TZ", timezone.length() ? timezone.c_str() : "UTC0", 1);
+    tzset();
+}
+
+bool clockIsValid()            { return true; }
+long clockEstimatedErrorSec()  { return 0; }
+
+bool clockNeedsSync() {
+    return rtc_lastSyncEpoch == 0 || time(nullptr) - rtc_lastSyncEpoch >= NTP_RESYNC_SEC;
+}
+
+void clockStartSync() {
+    if (s_syncStartMs < 0) s_syncStartMs = simNowMs();
+}
+
+bool clockFinishSync(unsigned long timeoutMs) {
+    (void)timeoutMs;
+    if (s_syncStartMs >= 0) {
+        int64_t spent = simNowMs() - s_syncStartMs;
+        if (spent < g_simCosts.ntp) delay((uint32_t)(g_simCosts.ntp - spent));
+        rtc_lastSyncEpoch = time(nullptr);
+        s_syncStartMs = -1;
+        Serial.println("[NTP] Synced");
+    }
+    return true;
+}
@@ -12,15 +12,31 @@
 // clock state machine between tones.
 //
 // Register sequence derived from Espressif's official esp-adf ES8311 driver.
+//
+// MP3s stream: a reader task copies the file from SD into a PSRAM ring and
+// a decoder task drains it through Helix into I2S, so playback never
+// blocks the caller and clip length isn't limited by RAM.  The canned
+// effects play from the sound bank (sound_bank.h) instead — decoded once,
+// then just copied to DMA.
 // ============================================================================
 
 #include "audio.h"
+#include "sd_storage.h"
+#include "sound_bank.h"
+#include "power_policy.h"
 #include <Wire.h>
 #include <driver/i2s.h>
-#include <math.h>
 #include <FS.h>
 #include <SD_MMC.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/stream_buffer.h>
+#include <freertos/event_groups.h>
 #include "MP3DecoderHelix.h"
+#ifdef POD_BENCH
+#include "bench.h"
+#endif
 
 using namespace libhelix;
 
@@ -43,12 +59,39 @@ using namespace libhelix;
 #define SAMPLE_RATE       16000
 #define DMA_BUF_COUNT     4
 #define DMA_BUF_LEN       256      // samples per DMA buffer
-#define TONE_AMPLITUDE    24000    // ~73% of int16 max — loud enough for tiny speaker
+
+// ---- Streaming player ----
+#define STREAM_CHUNK      2048              // SD read size
+#define STREAM_RING_BYTES (32 * 1024)       // compressed data in flight (PSRAM)
+#define STREAM_RING_MIN   (4 * 1024)        // internal-RAM fallback
+#define DECODE_CHUNK      1024              // ring → Helix per write()
+#define CLIP_CHUNK        1024              // bank clip frames per i2s_write()
+#define PCM_CACHE_MAX     (256 * 1024)      // first pass kept for repeats (4 s)
+#define REPEAT_GAP_MS     300
+
+#define PLAY_IDLE         BIT0
+#define READ_DONE         BIT1
 
 static bool g_audioInitialized = false;
 static bool g_audioEnabled     = false;
 static bool g_audioSuspended   = false;
 
+static TaskHandle_t         s_reader   = nullptr;
+static TaskHandle_t         s_decoder  = nullptr;
+static StreamBufferHandle_t s_ring     = nullptr;
+static StaticStreamBuffer_t s_ringDef;
+static EventGroupHandle_t   s_playEvt  = nullptr;
+static char                 s_playPath[64];
+static int                  s_playSound   = -1;    // SoundId, or -1 to stream s_playPath
+static int                  s_playRepeats = 1;
+static volatile bool        s_stopReq  = false;
+
+static int16_t* s_pcm       = nullptr;  // stereo int16 at SAMPLE_RATE
+static size_t   s_pcmFrames = 0;
+static bool     s_pcmFull   = true;     // not caching (single pass, or it overflowed)
+
+static bool playerStart();
+
 // ---- ES8311 I2C helpers ----
 
 static bool es8311_write(uint8_t reg, uint8_t val) {
@@ -258,6 +301,11 @@ void audioInit(bool playTestTone) {
 
     g_audioInitialized = true;
     Serial.println("[Audio] Initialized (I2S + ES8311)");
+    soundBankInit(SAMPLE_RATE);
+    playerStart();
+#ifdef POD_AUDIO_BENCH
+    soundResampleBench();
+#endif
 
     if (playTestTone) {
         // ---- Startup test tone (unconditional — bypasses audioAlerts setting) ----
@@ -289,12 +337,15 @@ void audioDisable() {
 
 void audioTone(int freqHz, int durationMs) {
     if (!g_audioInitialized) return;
+    audioWaitIdle();  // the player owns I2S until its clip ends
     if (g_audioSuspended) audioResume();
 
+    PowerLock apb(PM_LOCK_APB_MAX);  // I2S clocks derive from APB
     audioEnable();
 
     const int totalSamples = (SAMPLE_RATE * durationMs) / 1000;
-    const float omega = 2.0f * M_PI * freqHz / SAMPLE_RATE;
+    const uint32_t step = soundToneStep(freqHz, SAMPLE_RATE);
+    uint32_t phase = 0;
 
     // Generate in small blocks (32-bit samples for ES8311 32-bit slot width)
     const int blockSize = 128;
@@ -302,16 +353,10 @@ void audioTone(int freqHz, int durationMs) {
     size_t written;
     int samplesLeft = totalSamples;
 
-    for (int offset = 0; samplesLeft > 0; ) {
+    while (samplesLeft > 0) {
         int count = min(blockSize, samplesLeft);
-        for (int i = 0; i < count; i++) {
-            int16_t raw = (int16_t)(sinf(omega * (offset + i)) * TONE_AMPLITUDE);
-            int32_t sample = (int32_t)raw << 16;  // 16-bit data in MSB of 32-bit slot
-            buf[i * 2]     = sample;  // left
-            buf[i * 2 + 1] = sample;  // right
-        }
+        soundToneFill(phase, step, buf, count);  // wavetable, no sinf()
         i2s_write(I2S_PORT, buf, count * 8, &written, 200);  // 8 bytes per stereo frame
-        offset += count;
         samplesLeft -= count;
     }
 
@@ -330,104 +375,256 @@ static void audioAutoSuspend() {
 
 // ---- MP3 playback (Helix decoder → I2S resampler) ----
 //
-// Decodes MP3 from SD, resamples to 16 kHz, converts to 32-bit stereo
-// and writes through the existing I2S pipeline.
+// Decodes MP3 from the ring, resamples to 16 kHz, converts to 32-bit
+// stereo and writes through the existing I2S pipeline.  Runs on the
+// decoder task.
+
+// Keep the pass for the repeats, as int16 stereo
+static void cachePcm(const int32_t* frames, int count) {
+    if (s_pcmFull) return;
+    if ((s_pcmFrames + count) * 4 > PCM_CACHE_MAX) {
+        s_pcmFull = true;  // too long to keep — repeats stream again
+        return;
+    }
+    for (int j = 0; j < count * 2; j++)
+        s_pcm[s_pcmFrames * 2 + j] = (int16_t)(frames[j] >> 16);
+    s_pcmFrames += count;
+}
+
+static void streamSink(const int32_t* frames, int count, void*) {
+    size_t written;
+    i2s_write(I2S_PORT, frames, count * 8, &written, 200);
+    cachePcm(frames, count);
+}
+
+static SoundResampler s_resampler;
 
 static void mp3DataCallback(MP3FrameInfo &info, int16_t *pcm, size_t len, void*) {
-    if (len == 0 || info.nChans == 0) return;
+    if (s_stopReq) return;
+    soundResample(s_resampler, pcm, len, info.nChans, info.samprate, streamSink, nullptr);
+}
 
-    int srcRate   = info.samprate;
-    int nChans    = info.nChans;
-    int srcFrames = (int)(len / nChans);   // samples per channel
+static MP3DecoderHelix s_mp3(mp3DataCallback);
+
+// Reader task: one pass over the file into the ring per notification
+static void readerTask(void*) {
+    static uint8_t chunk[STREAM_CHUNK];
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        File f = SD_MMC.open(s_playPath, FILE_READ);
+        if (!f) Serial.printf("[Audio] MP3 open failed: %s\n", s_playPath);
+        while (f && !s_stopReq) {
+            int n = f.read(chunk, sizeof(chunk));
+            if (n <= 0) break;
+            size_t off = 0;
+            while (off < (size_t)n && !s_stopReq)
+                off += xStreamBufferSend(s_ring, chunk + off, n - off, pdMS_TO_TICKS(50));
+        }
+        if (f) f.close();
+        xEventGroupSetBits(s_playEvt, READ_DONE);
+    }
+}
 
-    // Output frames at our I2S sample rate
-    int dstFrames = (srcRate == SAMPLE_RATE)
-                        ? srcFrames
-                        : (int)((int64_t)srcFrames * SAMPLE_RATE / srcRate);
-    if (dstFrames <= 0) return;
+// Decode one streamed pass of the file
+static void streamPass() {
+    static uint8_t buf[DECODE_CHUNK];
+    xStreamBufferReset(s_ring);
+    xEventGroupClearBits(s_playEvt, READ_DONE);
+    xTaskNotifyGive(s_reader);
+
+    soundResamplerInit(s_resampler, SAMPLE_RATE);
+    s_mp3.begin();
+    while (!s_stopReq) {
+        size_t n = xStreamBufferReceive(s_ring, buf, sizeof(buf), pdMS_TO_TICKS(20));
+        if (n > 0) {
+            s_mp3.write(buf, n);
+        } else if ((xEventGroupGetBits(s_playEvt) & READ_DONE) &&
+                   xStreamBufferIsEmpty(s_ring)) {
+            break;
+        }
+    }
+    s_mp3.end();
+    xEventGroupWaitBits(s_playEvt, READ_DONE, pdFALSE, pdTRUE, portMAX_DELAY);
+}
 
+// Replay the PCM kept from the first pass
+static void playCached() {
     const int BLOCK = 128;
-    int32_t outBuf[BLOCK * 2];  // stereo 32-bit
+    int32_t outBuf[BLOCK * 2];
     size_t  written;
+    for (size_t i = 0; i < s_pcmFrames && !s_stopReq; ) {
+        int count = (s_pcmFrames - i < (size_t)BLOCK) ? (int)(s_pcmFrames - i) : BLOCK;
+        for (int j = 0; j < count * 2; j++)
+            outBuf[j] = (int32_t)s_pcm[i * 2 + j] << 16;
+        i2s_write(I2S_PORT, outBuf, count * 8, &written, 200);
+        i += count;
+    }
+}
 
-    for (int i = 0; i < dstFrames; ) {
-        int count = (dstFrames - i < BLOCK) ? dstFrames - i : BLOCK;
-        for (int j = 0; j < count; j++) {
-            int srcIdx;
-            if (srcRate == SAMPLE_RATE) {
-                srcIdx = i + j;
-            } else {
-                srcIdx = (int)((int64_t)(i + j) * srcRate / SAMPLE_RATE);
-                if (srcIdx >= srcFrames) srcIdx = srcFrames - 1;
+// A bank clip is already in the I2S format — straight to DMA
+static void playClip(const SoundClip* clip) {
+    size_t written;
+    for (size_t i = 0; i < clip->count && !s_stopReq; i += CLIP_CHUNK) {
+        size_t count = (clip->count - i < CLIP_CHUNK) ? clip->count - i : CLIP_CHUNK;
+        i2s_write(I2S_PORT, clip->frames + i * 2, count * 8, &written, portMAX_DELAY);
+    }
+}
+
+static void playSilence(int ms) {
+    int32_t silence[DMA_BUF_LEN * 2] = {0};
+    size_t written;
+    for (int left = (SAMPLE_RATE * ms) / 1000; left > 0 && !s_stopReq; left -= DMA_BUF_LEN) {
+        int count = left < DMA_BUF_LEN ? left : DMA_BUF_LEN;
+        i2s_write(I2S_PORT, silence, count * 8, &written, 200);
+    }
+}
+
+// Decoder task: one audioStart() job per notification
+static void decoderTask(void*) {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        unsigned long t0 = millis();
+        const SoundClip* clip = nullptr;
+        if (s_playSound >= 0) {
+            clip = soundBankGet((SoundId)s_playSound);  // decodes on first use
+            if (!clip) Serial.printf("[Audio] %s didn't decode — streaming it\n", s_playPath);
+        }
+        if (g_audioSuspended) audioResume();
+
+        int passes = 0;
+        {
+            PowerLock apb(PM_LOCK_APB_MAX);  // no auto light sleep mid-clip
+            audioEnable();
+
+            // Keep the first streamed pass for the repeats, if it fits
+            s_pcmFrames = 0;
+            s_pcmFull   = true;
+            if (!clip && s_playRepeats > 1) {
+                s_pcm = (int16_t*)heap_caps_malloc(PCM_CACHE_MAX, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+                s_pcmFull = (s_pcm == nullptr);
             }
 
-            int16_t sL, sR;
-            if (nChans >= 2) {
-                sL = pcm[srcIdx * 2];
-                sR = pcm[srcIdx * 2 + 1];
-            } else {
-                sL = sR = pcm[srcIdx];
+            for (; passes < s_playRepeats && !s_stopReq; passes++) {
+                if (passes > 0) playSilence(REPEAT_GAP_MS);
+                if (clip)                          playClip(clip);
+                else if (passes == 0 || s_pcmFull) streamPass();
+                else                               playCached();
             }
 
-            outBuf[j * 2]     = (int32_t)sL << 16;   // MSB of 32-bit slot
-            outBuf[j * 2 + 1] = (int32_t)sR << 16;
+            if (s_pcm) {
+                heap_caps_free(s_pcm);
+                s_pcm = nullptr;
+            }
+            i2s_flush_dma();
+            audioDisable();
         }
-        i2s_write(I2S_PORT, outBuf, count * 8, &written, 200);
-        i += count;
+        Serial.printf("[Audio] %s: %d pass%s in %lums%s\n", s_playPath, passes,
+                      passes == 1 ? "" : "es", millis() - t0, s_stopReq ? " (stopped)" : "");
+        audioAutoSuspend();
+        xEventGroupSetBits(s_playEvt, PLAY_IDLE);
     }
 }
 
-bool audioPlayMP3(const char* path) {
-    if (!g_audioInitialized) return false;
-    if (g_audioSuspended) audioResume();
-
-    File f = SD_MMC.open(path, FILE_READ);
-    if (!f) {
-        Serial.printf("[Audio] MP3 not found: %s\n", path);
-        return false;
+static bool playerStart() {
+    if (s_decoder) return true;
+    size_t ringBytes = STREAM_RING_BYTES;
+    uint8_t* storage = (uint8_t*)heap_caps_malloc(ringBytes + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!storage) {
+        ringBytes = STREAM_RING_MIN;
+        storage = (uint8_t*)malloc(ringBytes + 1);
     }
-
-    size_t fileSize = f.size();
-    if (fileSize == 0 || fileSize > 16384) {
-        Serial.printf("[Audio] MP3 bad size (%u): %s\n", fileSize, path);
-        f.close();
+    if (!storage) return false;
+    s_ring    = xStreamBufferCreateStatic(ringBytes, 1, storage, &s_ringDef);
+    s_playEvt = xEventGroupCreate();
+    if (!s_ring || !s_playEvt) return false;
+    xEventGroupSetBits(s_playEvt, PLAY_IDLE | READ_DONE);
+
+    if (xTaskCreatePinnedToCore(readerTask, "audio_sd", 4096, nullptr, 2, &s_reader, 0) != pdPASS ||
+        xTaskCreatePinnedToCore(decoderTask, "audio_dec", 10240, nullptr, 3, &s_decoder, 1) != pdPASS) {
+        Serial.println("[Audio] Player tasks failed — MP3 disabled");
+        s_decoder = nullptr;
         return false;
     }
+    Serial.printf("[Audio] Player ready (%u KB ring)\n", (unsigned)(ringBytes / 1024));
+    return true;
+}
+
+static void startJob(const char* path, int sound, int repeats) {
+    audioStop();
+    strncpy(s_playPath, path, sizeof(s_playPath) - 1);
+    s_playPath[sizeof(s_playPath) - 1] = '\0';
+    s_playSound   = sound;
+    s_playRepeats = repeats < 1 ? 1 : repeats;
+    s_stopReq     = false;
+    xEventGroupClearBits(s_playEvt, PLAY_IDLE);
+    xTaskNotifyGive(s_decoder);
+}
 
-    uint8_t* buf = (uint8_t*)malloc(fileSize);
-    if (!buf) {
-        Serial.println("[Audio] MP3 malloc failed");
-        f.close();
+bool audioStart(const char* path, int repeats) {
+    if (!g_audioInitialized || !s_decoder) return false;
+    if (!sdEnsureMounted()) return false;
+    if (!sdFileExists(path)) {
+        Serial.printf("[Audio] MP3 not found: %s\n", path);
         return false;
     }
-    f.read(buf, fileSize);
-    f.close();
+    startJob(path, -1, repeats);
+    Serial.printf("[Audio] Streaming MP3: %s x%d\n", path, s_playRepeats);
+    return true;
+}
 
-    Serial.printf("[Audio] Playing MP3: %s (%u bytes)\n", path, fileSize);
-    audioEnable();
+// Canned effect from the bank; false if its clip isn't on SD
+static bool startSound(SoundId id, int repeats = 1) {
+    if (!g_audioInitialized || !s_decoder) return false;
+    if (!soundBankAvailable(id)) return false;
+    startJob(soundPath(id), id, repeats);
+    return true;
+}
 
-    MP3DecoderHelix mp3(mp3DataCallback);
-    mp3.begin();
-    mp3.write(buf, fileSize);
-    mp3.end();
+void audioPreload() {
+    if (!g_audioInitialized) return;
+    audioWaitIdle();
+    unsigned long t0 = millis();
+    soundBankLoadAll();
+    Serial.printf("[Audio] Sound bank loaded in %lums\n", millis() - t0);
+}
 
-    free(buf);
+void audioStop() {
+    if (!audioIsPlaying()) return;
+    s_stopReq = true;
+    audioWaitIdle();
+}
 
-    i2s_flush_dma();
-    audioDisable();
+bool audioIsPlaying() {
+    return s_playEvt && !(xEventGroupGetBits(s_playEvt) & PLAY_IDLE);
+}
+
+bool audioWaitIdle(uint32_t timeoutMs) {
+    if (!s_playEvt || xTaskGetCurrentTaskHandle() == s_decoder) return true;
+    TickType_t ticks = timeoutMs ? pdMS_TO_TICKS(timeoutMs) : portMAX_DELAY;
+    return xEventGroupWaitBits(s_playEvt, PLAY_IDLE, pdFALSE, pdTRUE, ticks) & PLAY_IDLE;
+}
+
+bool audioPlayMP3(const char* path) {
+    if (!audioStart(path)) return false;
+    audioWaitIdle();
     return true;
 }
 
 // ---- Canned effects ----
 
+// A click or beep over a running clip is skipped: starting it would stop
+// the clip, and the fallback tone would wait for it to end
+
 void audioClick() {
-    if (audioPlayMP3("/audio/click.mp3")) { audioAutoSuspend(); return; }
+    if (audioIsPlaying()) return;
+    if (startSound(SND_CLICK)) return;
     audioTone(1000, 200);   // fallback synthesized tone
     audioAutoSuspend();
 }
 
 void audioBeep() {
-    if (audioPlayMP3("/audio/click.mp3")) { audioAutoSuspend(); return; }
+    if (audioIsPlaying()) return;
+    if (startSound(SND_CLICK)) return;
     audioTone(1000, 200);
     audioAutoSuspend();
 }
@@ -445,7 +642,7 @@ void audioError() {
 }
 
 void audioNotify() {
-    if (audioPlayMP3("/audio/notify.mp3")) { audioAutoSuspend(); return; }
+    if (startSound(SND_NOTIFY)) { audioWaitIdle(); return; }
     // Fallback: two ascending tones (same as confirm)
     audioTone(1800, 120);
     delay(40);
@@ -454,17 +651,17 @@ void audioNotify() {
 }
 
 void audioAttention(int repeats) {
+    if (startSound(SND_ATTENTION, repeats)) return;
     for (int i = 0; i < repeats; i++) {
-        if (!audioPlayMP3("/audio/attention.mp3")) {
-            audioTone(1000, 200);   // fallback synthesized tone
-        }
-        if (i < repeats - 1) delay(300);  // gap between bursts
+        audioTone(1000, 200);   // fallback synthesized tone
+        if (i < repeats - 1) delay(REPEAT_GAP_MS);  // gap between bursts
     }
     audioAutoSuspend();
 }
 
 void audioShutdown() {
     if (!g_audioInitialized) return;
+    audioStop();
     audioDisable();
     i2s_stop(I2S_PORT);
     i2s_driver_uninstall(I2S_PORT);
@@ -482,6 +679,7 @@ void audioShutdown() {
 
 void audioSuspend() {
     if (!g_audioInitialized || g_audioSuspended) return;
+    audioWaitIdle();             // let a streaming clip finish first
     audioDisable();              // PA off
     i2s_stop(I2S_PORT);          // stop I2S clocks
     digitalWrite(AUDIO_PWR_PIN, HIGH);  // power off codec rail
@@ -499,3 +697,68 @@ void audioResume() {
     g_audioSuspended = false;
     Serial.println("[Audio] Resumed");
 }
+
+#ifdef POD_BENCH
+// ---- Bench (bench/bench.h) ----
+//
+// mp3DataCallback()'s CPU work — resampling one decoded MP3 frame plus
+// the repeat-cache copy — with the I2S write left out (it blocks at the
+// playback rate).  audioTone() is timed both ways: the wavetable fill
+// alone, and the whole call through I2S.
+
+static void benchCacheSink(const int32_t* frames, int count, void*) {
+    cachePcm(frames, count);
+}
+
+void audioBench() {
+    if (!g_audioInitialized) {
+        Serial.println("[Bench] Audio not initialised — audio cases skipped");
+        return;
+    }
+    audioWaitIdle();  // the cache and its buffer belong to the player otherwise
+
+    static const int FRAMES = 1152;         // one MPEG-1 layer III frame
+    static int16_t pcm[FRAMES * 2];
+    uint32_t phase = 0, step = soundToneStep(440, 44100);
+    for (int i = 0; i < FRAMES; i++) {
+        int32_t f[2];
+        soundToneFill(phase, step, f, 1);
+        pcm[i * 2] = pcm[i * 2 + 1] = (int16_t)(f[0] >> 16);
+    }
+
+    s_pcm = (int16_t*)heap_caps_malloc(PCM_CACHE_MAX, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (s_pcm) {
+        static SoundResampler rs;
+        const struct { const char* name; int rate; int chans; } CASES[] = {
+            { "mp3_cb_44100_stereo", 44100, 2 },
+            { "mp3_cb_44100_mono",   44100, 1 },
+            { "mp3_cb_22050_stereo", 22050, 2 },
+        };
+        for (const auto& c : CASES) {
+            soundResamplerInit(rs, SAMPLE_RATE);
+            benchRun(c.name, 64, [&] {
+                s_pcmFrames = 0;
+                s_pcmFull   = false;
+                soundResample(rs, pcm, FRAMES * c.chans, c.chans, c.rate, benchCacheSink, nullptr);
+            }, (uint32_t)((int64_t)FRAMES * SAMPLE_RATE / c.rate), "frame");
+        }
+        heap_caps_free(s_pcm);
+    } else {
+        Serial.println("[Bench] No PSRAM for the PCM cache — mp3 cases skipped");
+    }
+    s_pcm       = nullptr;
+    s_pcmFrames = 0;
+    s_pcmFull   = true;
+
+    // A 200 ms tone: just the samples, then the real call
+    const int toneFrames = SAMPLE_RATE / 5;
+    static int32_t block[128 * 2];
+    benchRun("tone_fill_200ms", 20, [&] {
+        uint32_t ph = 0, st = soundToneStep(1000, SAMPLE_RATE);
+        for (int left = toneFrames; left > 0; left -= 128)
+            soundToneFill(ph, st, block, left < 128 ? left : 128);
+    }, toneFrames, "frame");
+    benchRun("audio_tone_200ms", 3, [] { audioTone(1000, 200); });
+    audioSuspend();
+}
+#endif
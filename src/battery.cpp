@@ -8,6 +8,7 @@
 #include "battery.h"
 #include "soc/usb_serial_jtag_reg.h"
 #include <driver/gpio.h>
+#include <esp_adc_cal.h>
 
 // ---------------------------------------------------------------------------
 // Board-specific constants
@@ -51,10 +52,17 @@ int batteryPercent(float voltage) {
     return (int)(((voltage - BATT_EMPTY_V) / (BATT_FULL_V - BATT_EMPTY_V)) * 100.0f);
 }
 
+// ---------------------------------------------------------------------------
+float batteryVoltageAtPercent(int pct) {
+    if (pct <= 0)   return BATT_EMPTY_V;
+    if (pct >= 100) return BATT_FULL_V;
+    return BATT_EMPTY_V + (BATT_FULL_V - BATT_EMPTY_V) * pct / 100.0f;
+}
+
 // ---------------------------------------------------------------------------
 bool batteryOnUSB(float voltage) {
     // Primary: voltage >= 4.25V (charge IC overshoot)
-    if (voltage >= 4.25f) return true;
+    if (voltage >= BATTERY_USB_V) return true;
 
     // Secondary: USB SOF frame counter — the USB host sends Start-of-Frame
     // packets every 1ms.  If the counter changes across two reads, USB is
@@ -71,3 +79,33 @@ bool batteryOnUSB(float voltage) {
 void batteryUpdateChargeLED(bool usbConnected) {
     digitalWrite(CHARGE_LED_PIN, usbConnected ? HIGH : LOW);
 }
+
+// ---------------------------------------------------------------------------
+// Raw ADC — the same eFuse characterization analogReadMilliVolts() uses
+// ---------------------------------------------------------------------------
+static const esp_adc_cal_characteristics_t* adcChars() {
+    static esp_adc_cal_characteristics_t chars;
+    static bool ready = false;
+    if (!ready) {
+        esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &chars);
+        ready = true;
+    }
+    return &chars;
+}
+
+float batteryVoltageFromRaw(uint16_t raw) {
+    uint32_t mV = esp_adc_cal_raw_to_voltage(raw, adcChars());
+    return (mV / 1000.0f) * DIVIDER_RATIO;
+}
+
+uint16_t batteryRawForVoltage(float voltage) {
+    // The calibration curve is monotonic — binary search it
+    uint16_t lo = 0, hi = 4095;
+    if (batteryVoltageFromRaw(hi) < voltage) return 4095;
+    while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (batteryVoltageFromRaw(mid) >= voltage) hi = mid;
+        else                                       lo = mid + 1;
+    }
+    return lo;
+}
@@ -1,7 +1,11 @@
 #include "ble_setup.h"
 #include "light_control.h"
+#include "config_snapshot.h"
 #include <NimBLEDevice.h>
 #include <Preferences.h>
+#include <ArduinoJson.h>
+#include <esp_bt.h>
+#include <esp_system.h>
 
 // Global credential storage
 String g_ssid = "";
@@ -17,141 +21,164 @@ String g_platform = "0";
 String g_timezone = "";
 String g_office_hours = "";
 String g_wled_new = "";
+String g_zoom_account = "";
+String g_zoom_client_id = "";
 
 // BLE objects
 static NimBLEServer *pServer = nullptr;
 static NimBLEService *pService = nullptr;
 static Preferences nvs_prefs;
+static bool s_bleUp = false;         // NimBLE initialised
+static bool s_bleReleased = false;   // controller memory handed to the heap
+
+// Settings → BLE Setup reboot flag (survives esp_restart, not power-off)
+static const uint32_t BLE_SETUP_MAGIC = 0x50555342;  // "BSUP"
+RTC_NOINIT_ATTR static uint32_t rtc_bleSetup;
+
+// ---- Provisioning blob ----------------------------------------------------
+struct ConfigField {
+  const char *key;
+  String *value;
+  bool readable;      // returned by a read (everything but the WiFi password)
+};
+static const ConfigField FIELDS[] = {
+  { "ssid",  &g_ssid,           true  },
+  { "pass",  &g_password,       false },
+  { "cid",   &g_client_id,      true  },
+  { "tid",   &g_tenant_id,      true  },
+  { "sec",   &g_client_secret,  true  },
+  { "plat",  &g_platform,       true  },   // "0"=Teams, "1"=Zoom, "2"=Teams+Zoom
+  { "lt",    &g_light_type,     true  },   // LightType
+  { "lip",   &g_light_ip,       true  },
+  { "lkey",  &g_light_key,      true  },   // Hue bridge API key
+  { "laux",  &g_light_aux,      true  },   // Hue target (L/G/R + id)
+  { "tz",    &g_timezone,       true  },   // POSIX timezone
+  { "oh",    &g_office_hours,   true  },   // "enabled,HH:MM,HH:MM,daymask"
+  { "wnew",  &g_wled_new,       true  },   // "1" = new WLED needs zero-config
+  { "zacct", &g_zoom_account,   true  },   // Teams+Zoom: Zoom S2S ids
+  { "zcid",  &g_zoom_client_id, true  },
+};
+static const int FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
 
-// Forward declarations
-class CharacteristicCallback;
+static std::string s_blob;          // JSON received so far
+static size_t s_blobWant = 0;       // announced length, 0 = between blobs
+static volatile bool s_configReady = false;  // applied, waiting for bleSetupService()
+
+/**
+ * Store everything a provisioning blob set, then reboot.
+ * One session per NVS namespace (credentials, settings); the light config
+ * goes to the SD card via saveLightConfig().
+ */
+static void saveProvisioning() {
+  Serial.println("  → Storing provisioning...");
+  saveCredentialsToNVS();
+  {
+    Preferences sp;
+    sp.begin("pod_settings", false);
+    sp.putInt("platform", g_platform.toInt());
+    sp.putString("timezone", g_timezone);
+    // Parse office hours: "enabled,HH:MM,HH:MM,daymask"
+    if (g_office_hours.length() > 0) {
+      int en = 0, sh = 8, sm = 0, eh = 17, em = 0, dm = 0x1F;
+      sscanf(g_office_hours.c_str(), "%d,%d:%d,%d:%d,%d",
+             &en, &sh, &sm, &eh, &em, &dm);
+      sp.putBool("oh_enabled", en != 0);
+      sp.putInt("oh_start_h", sh);
+      sp.putInt("oh_start_m", sm);
+      sp.putInt("oh_end_h", eh);
+      sp.putInt("oh_end_m", em);
+      sp.putInt("oh_days", dm);
+    }
+    // WLED new-device flag, if set
+    if (g_wled_new == "1") sp.putBool("wled_new", true);
+    sp.end();
+  }
+  LightConfig lc;
+  lc.type = (LightType)g_light_type.toInt();
+  lc.ip = g_light_ip;
+  lc.brightness = 128;
+  lc.key = g_light_key;
+  lc.aux = g_light_aux;
+  saveLightConfig(lc);
+  // Settings were rewritten behind the snapshot — rebuilt from the stores at boot
+  configSnapshotInvalidate();
+  Serial.println("  → Saved. Rebooting in 2s...");
+  delay(2000);
+  Serial.println("  → Rebooting now!");
+  Serial.flush();
+  ESP.restart();
+}
 
 /**
- * Callback class for BLE characteristic writes
+ * A complete blob: apply the fields it has.  False if it isn't a JSON object.
  */
-class CharacteristicCallback : public NimBLECharacteristicCallbacks {
+static bool applyProvisioning(const std::string &json) {
+  DynamicJsonDocument doc(BLE_CONFIG_MAX + 512);
+  DeserializationError err = deserializeJson(doc, json.data(), json.size());
+  if (err || !doc.is<JsonObject>()) {
+    Serial.printf("[BLE] Config JSON rejected: %s\n", err ? err.c_str() : "not an object");
+    return false;
+  }
+  for (int i = 0; i < FIELD_COUNT; i++) {
+    JsonVariant v = doc[FIELDS[i].key];
+    if (v.isNull()) continue;
+    if (!v.is<const char *>()) {
+      Serial.printf("  -> %s is not a string — skipped\n", FIELDS[i].key);
+      continue;
+    }
+    *FIELDS[i].value = v.as<const char *>();
+    if (FIELDS[i].readable)
+      Serial.printf("  -> %s = %s\n", FIELDS[i].key, FIELDS[i].value->c_str());
+    else
+      Serial.printf("  -> %s set (length: %d)\n", FIELDS[i].key, FIELDS[i].value->length());
+  }
+  return true;
+}
+
+/**
+ * Callback for the provisioning characteristic
+ */
+class ConfigCallback : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *pCharacteristic) override {
-    std::string uuid = pCharacteristic->getUUID().toString();
     std::string value = pCharacteristic->getValue();
 
-    Serial.printf("[BLE] Write to %s: \"%s\"\n", uuid.c_str(), value.c_str());
-
-    // Route to appropriate handler
-    if (uuid == BLE_CHAR_SSID) {
-      g_ssid = String(value.c_str());
-      Serial.printf("  -> SSID set to: %s\n", g_ssid.c_str());
-    } else if (uuid == BLE_CHAR_PASSWORD) {
-      g_password = String(value.c_str());
-      Serial.printf("  -> PASSWORD set (length: %d)\n", g_password.length());
-    } else if (uuid == BLE_CHAR_CLIENT_ID) {
-      g_client_id = String(value.c_str());
-      Serial.printf("  -> CLIENT_ID set to: %s\n", g_client_id.c_str());
-    } else if (uuid == BLE_CHAR_TENANT_ID) {
-      g_tenant_id = String(value.c_str());
-      Serial.printf("  -> TENANT_ID set to: %s\n", g_tenant_id.c_str());
-    } else if (uuid == BLE_CHAR_SAVE) {
-      Serial.println("  → SAVE triggered! Storing credentials to NVS...");
-      saveCredentialsToNVS();
-      // Sync platform + schedule to pod_settings
-      {
-        Preferences sp;
-        sp.begin("pod_settings", false);
-        sp.putInt("platform", g_platform.toInt());
-        // Save timezone
-        sp.putString("timezone", g_timezone);
-        // Parse office hours: "enabled,HH:MM,HH:MM,daymask"
-        if (g_office_hours.length() > 0) {
-          int en = 0, sh = 8, sm = 0, eh = 17, em = 0, dm = 0x1F;
-          sscanf(g_office_hours.c_str(), "%d,%d:%d,%d:%d,%d",
-                 &en, &sh, &sm, &eh, &em, &dm);
-          sp.putBool("oh_enabled", en != 0);
-          sp.putInt("oh_start_h", sh);
-          sp.putInt("oh_start_m", sm);
-          sp.putInt("oh_end_h", eh);
-          sp.putInt("oh_end_m", em);
-          sp.putInt("oh_days", dm);
-        }
-        sp.end();
+    if (s_blobWant == 0) {
+      // First write of a blob: uint16 length, then the start of the JSON
+      if (value.size() < 2) {
+        Serial.println("[BLE] Config write too short — ignored");
+        return;
       }
-      // Save WLED new-device flag if set
-      if (g_wled_new == "1") {
-        Preferences wp;
-        wp.begin("pod_settings", false);
-        wp.putBool("wled_new", true);
-        wp.end();
-        Serial.println("  → WLED new-device flag stored");
+      s_blobWant = (uint8_t)value[0] | ((size_t)(uint8_t)value[1] << 8);
+      if (s_blobWant == 0 || s_blobWant > BLE_CONFIG_MAX) {
+        Serial.printf("[BLE] Config length %u refused\n", (unsigned)s_blobWant);
+        s_blobWant = 0;
+        return;
       }
-      // Also sync light config to pod_light namespace
-      LightConfig lc;
-      lc.type = (LightType)g_light_type.toInt();
-      lc.ip = g_light_ip;
-      lc.brightness = 128;
-      lc.key = g_light_key;
-      lc.aux = g_light_aux;
-      saveLightConfig(lc);
-      Serial.println("  → Credentials saved. Rebooting in 2s...");
-      delay(2000);
-      Serial.println("  → Rebooting now!");
-      Serial.flush();
-      ESP.restart();
-    } else if (uuid == BLE_CHAR_LIGHT_TYPE) {
-      g_light_type = String(value.c_str());
-      Serial.printf("  -> LIGHT_TYPE set to: %s\n", g_light_type.c_str());
-    } else if (uuid == BLE_CHAR_LIGHT_IP) {
-      g_light_ip = String(value.c_str());
-      Serial.printf("  -> LIGHT_IP set to: %s\n", g_light_ip.c_str());
-    } else if (uuid == BLE_CHAR_LIGHT_KEY) {
-      g_light_key = String(value.c_str());
-      Serial.printf("  -> LIGHT_KEY set (length: %d)\n", g_light_key.length());
-    } else if (uuid == BLE_CHAR_LIGHT_AUX) {
-      g_light_aux = String(value.c_str());
-      Serial.printf("  -> LIGHT_AUX set to: %s\n", g_light_aux.c_str());
-    } else if (uuid == BLE_CHAR_CLIENT_SECRET) {
-      g_client_secret = String(value.c_str());
-      Serial.printf("  -> CLIENT_SECRET set (length: %d)\n",
-                    g_client_secret.length());
-    } else if (uuid == BLE_CHAR_PLATFORM) {
-      g_platform = String(value.c_str());
-      Serial.printf("  -> PLATFORM set to: %s\n", g_platform.c_str());
-    } else if (uuid == BLE_CHAR_TIMEZONE) {
-      g_timezone = String(value.c_str());
-      Serial.printf("  -> TIMEZONE set to: %s\n", g_timezone.c_str());
-    } else if (uuid == BLE_CHAR_OFFICE_HOURS) {
-      g_office_hours = String(value.c_str());
-      Serial.printf("  -> OFFICE_HOURS set to: %s\n", g_office_hours.c_str());
-    } else if (uuid == BLE_CHAR_WLED_NEW) {
-      g_wled_new = String(value.c_str());
-      Serial.printf("  -> WLED_NEW set to: %s\n", g_wled_new.c_str());
+      s_blob.assign(value, 2, std::string::npos);
+      s_blob.reserve(s_blobWant);
+    } else {
+      s_blob.append(value);
     }
+    Serial.printf("[BLE] Config %u/%u bytes\n", (unsigned)s_blob.size(), (unsigned)s_blobWant);
+
+    if (s_blob.size() < s_blobWant) return;
+    bool ok = s_blob.size() == s_blobWant && applyProvisioning(s_blob);
+    if (!ok) Serial.println("[BLE] Config blob dropped");
+    s_blob.clear();
+    s_blobWant = 0;
+    // Stored from the main loop, so the write is acknowledged before the reboot
+    if (ok) s_configReady = true;
   }
 
   void onRead(NimBLECharacteristic *pCharacteristic) override {
-    std::string uuid = pCharacteristic->getUUID().toString();
-    Serial.printf("[BLE] Read from %s\n", uuid.c_str());
-
-    if (uuid == BLE_CHAR_CLIENT_ID) {
-      pCharacteristic->setValue(std::string(g_client_id.c_str()));
-    } else if (uuid == BLE_CHAR_TENANT_ID) {
-      pCharacteristic->setValue(std::string(g_tenant_id.c_str()));
-    } else if (uuid == BLE_CHAR_LIGHT_TYPE) {
-      pCharacteristic->setValue(std::string(g_light_type.c_str()));
-    } else if (uuid == BLE_CHAR_LIGHT_IP) {
-      pCharacteristic->setValue(std::string(g_light_ip.c_str()));
-    } else if (uuid == BLE_CHAR_LIGHT_KEY) {
-      pCharacteristic->setValue(std::string(g_light_key.c_str()));
-    } else if (uuid == BLE_CHAR_LIGHT_AUX) {
-      pCharacteristic->setValue(std::string(g_light_aux.c_str()));
-    } else if (uuid == BLE_CHAR_CLIENT_SECRET) {
-      pCharacteristic->setValue(std::string(g_client_secret.c_str()));
-    } else if (uuid == BLE_CHAR_PLATFORM) {
-      pCharacteristic->setValue(std::string(g_platform.c_str()));
-    } else if (uuid == BLE_CHAR_TIMEZONE) {
-      pCharacteristic->setValue(std::string(g_timezone.c_str()));
-    } else if (uuid == BLE_CHAR_OFFICE_HOURS) {
-      pCharacteristic->setValue(std::string(g_office_hours.c_str()));
-    } else if (uuid == BLE_CHAR_WLED_NEW) {
-      pCharacteristic->setValue(std::string(g_wled_new.c_str()));
+    Serial.println("[BLE] Config read");
+    DynamicJsonDocument doc(BLE_CONFIG_MAX);
+    for (int i = 0; i < FIELD_COUNT; i++) {
+      if (FIELDS[i].readable) doc[FIELDS[i].key] = FIELDS[i].value->c_str();
     }
+    std::string out;
+    serializeJson(doc, out);
+    pCharacteristic->setValue(out);
   }
 };
 
@@ -162,12 +189,20 @@ class ServerCallback : public NimBLEServerCallbacks {
   void onConnect(NimBLEServer *pServer, ble_gap_conn_desc *desc) override {
     Serial.printf("[BLE] Client connected (addr: %s)\n",
                   NimBLEAddress(desc->peer_ota_addr).toString().c_str());
+    s_blob.clear();          // a half-sent blob from an earlier client
+    s_blobWant = 0;
   }
 
   void onDisconnect(NimBLEServer *pServer) override {
     Serial.println("[BLE] Client disconnected. Resuming advertising...");
+    s_blob.clear();
+    s_blobWant = 0;
     NimBLEDevice::startAdvertising();
   }
+
+  void onMTUChange(uint16_t MTU, ble_gap_conn_desc *desc) override {
+    Serial.printf("[BLE] MTU %u\n", MTU);
+  }
 };
 
 /**
@@ -200,6 +235,8 @@ void loadCredentialsFromNVS() {
   g_light_ip = nvs_prefs.getString("light_ip", "");
   g_client_secret = nvs_prefs.getString("client_sec", "");
   g_platform = nvs_prefs.getString("platform_s", "0");
+  g_zoom_account = nvs_prefs.getString("zoom_acct", "");
+  g_zoom_client_id = nvs_prefs.getString("zoom_cid", "");
   nvs_prefs.end();
 
   // Load schedule from pod_settings namespace
@@ -243,6 +280,8 @@ void saveCredentialsToNVS() {
   nvs_prefs.putString("light_ip", g_light_ip);
   nvs_prefs.putString("client_sec", g_client_secret);
   nvs_prefs.putString("platform_s", g_platform);
+  nvs_prefs.putString("zoom_acct", g_zoom_account);
+  nvs_prefs.putString("zoom_cid", g_zoom_client_id);
   nvs_prefs.end();
   Serial.println("[NVS] ✓ Credentials saved");
 }
@@ -271,8 +310,13 @@ void initializeBLE() {
   initializeNVS();
 
   // Create BLE device
+  if (s_bleReleased) {
+    Serial.println("[BLE] ✗ Controller memory released — reboot needed");
+    return;
+  }
   NimBLEDevice::init("Status-Pod");
   NimBLEDevice::setPower(ESP_PWR_LVL_P9);
+  NimBLEDevice::setMTU(BLE_MTU);      // whole config in one write
 
   // Create BLE server
   pServer = NimBLEDevice::createServer();
@@ -283,99 +327,18 @@ void initializeBLE() {
   // Create service
   pService = pServer->createService(NimBLEUUID((uint16_t)BLE_SERVICE_UUID));
 
-  // Create characteristics with callbacks.
-  // Use static instances — avoids a heap leak on each initializeBLE() call
-  // (NimBLEDevice::deinit() destroys the server/service but does NOT free
-  //  heap-allocated callbacks; static instances are never freed and thus safe).
-  static CharacteristicCallback charCallback;
-  CharacteristicCallback *pCharCallback = &charCallback;
-
-  // SSID (Write only)
-  NimBLECharacteristic *pSSID = pService->createCharacteristic(
-      BLE_CHAR_SSID, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR);
-  pSSID->setCallbacks(pCharCallback);
-
-  // PASSWORD (Write only)
-  NimBLECharacteristic *pPassword = pService->createCharacteristic(
-      BLE_CHAR_PASSWORD, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR);
-  pPassword->setCallbacks(pCharCallback);
-
-  // CLIENT_ID (Write + Read)
-  NimBLECharacteristic *pClientID = pService->createCharacteristic(
-      BLE_CHAR_CLIENT_ID, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                              NIMBLE_PROPERTY::READ);
-  pClientID->setCallbacks(pCharCallback);
-
-  // TENANT_ID (Write + Read)
-  NimBLECharacteristic *pTenantID = pService->createCharacteristic(
-      BLE_CHAR_TENANT_ID, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                              NIMBLE_PROPERTY::READ);
-  pTenantID->setCallbacks(pCharCallback);
-
-  // SAVE (Write only - triggers reboot)
-  NimBLECharacteristic *pSave =
-      pService->createCharacteristic(BLE_CHAR_SAVE, NIMBLE_PROPERTY::WRITE);
-  pSave->setCallbacks(pCharCallback);
-
-  // LIGHT_TYPE (Write + Read): "0"=None, "1"=WLED, "2"=Smart Bulb
-  NimBLECharacteristic *pLightType = pService->createCharacteristic(
-      BLE_CHAR_LIGHT_TYPE, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                               NIMBLE_PROPERTY::READ);
-  pLightType->setCallbacks(pCharCallback);
-
-  // LIGHT_IP (Write + Read): IP address of the light device
-  NimBLECharacteristic *pLightIP = pService->createCharacteristic(
-      BLE_CHAR_LIGHT_IP, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                             NIMBLE_PROPERTY::READ);
-  pLightIP->setCallbacks(pCharCallback);
-
-  // LIGHT_KEY (Write + Read): API key (Hue bridge)
-  NimBLECharacteristic *pLightKey = pService->createCharacteristic(
-      BLE_CHAR_LIGHT_KEY, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                              NIMBLE_PROPERTY::READ);
-  pLightKey->setCallbacks(pCharCallback);
-
-  // LIGHT_AUX (Write + Read): Aux field (Hue light ID)
-  NimBLECharacteristic *pLightAux = pService->createCharacteristic(
-      BLE_CHAR_LIGHT_AUX, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                              NIMBLE_PROPERTY::READ);
-  pLightAux->setCallbacks(pCharCallback);
-
-  // CLIENT_SECRET (Write + Read): Zoom client secret
-  NimBLECharacteristic *pClientSecret = pService->createCharacteristic(
-      BLE_CHAR_CLIENT_SECRET, NIMBLE_PROPERTY::WRITE |
-                                  NIMBLE_PROPERTY::WRITE_NR |
-                                  NIMBLE_PROPERTY::READ);
-  pClientSecret->setCallbacks(pCharCallback);
-
-  // PLATFORM (Write + Read): "0"=Teams, "1"=Zoom
-  NimBLECharacteristic *pPlatform = pService->createCharacteristic(
-      BLE_CHAR_PLATFORM, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                             NIMBLE_PROPERTY::READ);
-  pPlatform->setCallbacks(pCharCallback);
-
-  // TIMEZONE (Write + Read): POSIX timezone string
-  NimBLECharacteristic *pTimezone = pService->createCharacteristic(
-      BLE_CHAR_TIMEZONE, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                             NIMBLE_PROPERTY::READ);
-  pTimezone->setCallbacks(pCharCallback);
-
-  // OFFICE_HOURS (Write + Read): "enabled,HH:MM,HH:MM,daymask"
-  NimBLECharacteristic *pOfficeHours = pService->createCharacteristic(
-      BLE_CHAR_OFFICE_HOURS, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                                 NIMBLE_PROPERTY::READ);
-  pOfficeHours->setCallbacks(pCharCallback);
-
-  // WLED_NEW (Write + Read): "1" = new device needs zero-config
-  NimBLECharacteristic *pWledNew = pService->createCharacteristic(
-      BLE_CHAR_WLED_NEW, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::WRITE_NR |
-                             NIMBLE_PROPERTY::READ);
-  pWledNew->setCallbacks(pCharCallback);
+  // Static callback — NimBLEDevice::deinit() destroys the characteristic
+  // but not its callbacks
+  static ConfigCallback configCallback;
+  NimBLECharacteristic *pConfig = pService->createCharacteristic(
+      BLE_CHAR_CONFIG, NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::READ);
+  pConfig->setCallbacks(&configCallback);
 
   // Start service
   pService->start();
+  s_bleUp = true;
 
-  Serial.println("[BLE] \u2713 Service created with 15 characteristics");
+  Serial.println("[BLE] \u2713 Provisioning service ready");
 }
 
 /**
@@ -413,19 +376,46 @@ void stopBLEAdvertising() {
 }
 
 /**
- * Fully deinitialize BLE stack to save power (~15mA).
- * Call initializeBLE() again if BLE is needed later (e.g. Settings → BLE
- * Setup).
+ * Fully deinitialize BLE and give its memory to the heap (TLS buffers,
+ * framebuffers).  Call initializeBLE() again only after a reboot — see
+ * bleRequestSetup().
  */
 void deinitBLE() {
-  Serial.println("[BLE] Deinitializing to save power...");
-  // false = don't clearAll; avoids 'delete' on static callback objects
-  // which would assert (they're not heap-allocated).  The BLE host/
-  // controller memory (~60 KB) is still freed.
-  NimBLEDevice::deinit(false);
-  pServer = nullptr;
-  pService = nullptr;
-  Serial.println("[BLE] ✓ BLE stack released");
+  if (s_bleUp) {
+    Serial.println("[BLE] Deinitializing...");
+    // false = don't clearAll; avoids 'delete' on static callback objects
+    // which would assert (they're not heap-allocated)
+    NimBLEDevice::deinit(false);
+    pServer = nullptr;
+    pService = nullptr;
+    s_bleUp = false;
+  }
+  if (s_bleReleased) return;
+  size_t before = ESP.getFreeHeap();
+  esp_err_t err = esp_bt_mem_release(ESP_BT_MODE_BTDM);
+  s_bleReleased = true;
+  if (err == ESP_OK)
+    Serial.printf("[BLE] ✓ Host + controller memory released (%+d bytes heap)\n",
+                  (int)(ESP.getFreeHeap() - before));
+  else
+    Serial.printf("[BLE] Memory release: %s\n", esp_err_to_name(err));
+}
+
+void bleSetupService() {
+  if (s_configReady) saveProvisioning();
+}
+
+void bleRequestSetup() {
+  Serial.println("[BLE] Rebooting into setup mode");
+  rtc_bleSetup = BLE_SETUP_MAGIC;
+  Serial.flush();
+  ESP.restart();
+}
+
+bool bleSetupRequested() {
+  bool req = esp_reset_reason() == ESP_RST_SW && rtc_bleSetup == BLE_SETUP_MAGIC;
+  rtc_bleSetup = 0;
+  return req;
 }
 
 /**
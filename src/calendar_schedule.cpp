@@ -0,0 +1,312 @@
+// ============================================================================
+// Calendar Schedule — sleep until the next likely presence transition
+//
+// GET /v1.0/me/calendarView?startDateTime=..&endDateTime=..
+//     Prefer: outlook.timezone="UTC"
+//
+// Needs the Calendars.Read delegated permission.  Pods authorised before
+// it was added to the device-code scope get 403 until re-auth, and simply
+// keep the fixed poll interval.
+// ============================================================================
+
+#include "calendar_schedule.h"
+#include "https_conn.h"
+#include "poll_arena.h"
+#include "teams_auth.h"
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include <time.h>
+
+#define CAL_MAX_BOUNDARIES  32
+#define CAL_MAGIC           0x43414C31UL   // "CAL1"
+#define CAL_TOP             40             // $top — events per fetch
+#define CAL_EVENT_BYTES     224            // one filtered event: 3 objects, 2 dates, showAs
+#define CAL_DOC_BYTES       (JSON_OBJECT_SIZE(1) + JSON_ARRAY_SIZE(CAL_TOP) + CAL_TOP * CAL_EVENT_BYTES)
+
+static const time_t CAL_HORIZON_SEC   = 24 * 3600;   // window fetched
+static const time_t CAL_REFRESH_SEC   = 6 * 3600;    // refetch to catch edits
+static const time_t CAL_BACKOFF_SEC   = 24 * 3600;   // after 403 / no consent
+static const time_t CAL_RETRY_SEC     = 30 * 60;     // after transient errors / 401
+static const time_t LEAD_SEC          = 120;   // start tight polling before a boundary
+static const time_t TRAIL_SEC         = 600;   // …and keep it up after (late joiners)
+static const time_t CLOCK_VALID_EPOCH = 1704067200;
+
+enum SleepReason : uint8_t {
+    REASON_NONE = 0,
+    REASON_NO_CALENDAR,     // fixed interval
+    REASON_NEAR_BOUNDARY,   // tight cadence
+    REASON_GAP,             // sleeping to just before the next boundary
+    REASON_CAPPED,          // gap longer than maxStaleness
+};
+
+// ---- RTC state (survives deep sleep) ---------------------------------------
+struct RtcCalendar {
+    uint32_t magic;
+    time_t   fetchedAt;         // 0 = never
+    time_t   retryAt;           // don't refetch before this (errors / 403)
+    int16_t  lastHttp;          // last HTTP status, for the info screen
+    bool     stale;             // presence moved off-schedule
+    uint8_t  count;
+    uint8_t  events;
+    uint8_t  lastReason;
+    int32_t  lastSleep;
+    uint32_t boundary[CAL_MAX_BOUNDARIES];   // sorted epoch seconds (UTC)
+};
+RTC_DATA_ATTR static RtcCalendar rtc_cal = {};
+
+// ----------------------------------------------------------------------------
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant)
+static long daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const long era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (long)doe - 719468;
+}
+
+// "2026-02-18T14:30:00.0000000" (UTC) → epoch seconds, 0 on error
+static time_t parseGraphUtc(const char* s) {
+    int y, mo, d, h, mi, se;
+    if (!s || sscanf(s, "%4d-%2d-%2dT%2d:%2d:%2d", &y, &mo, &d, &h, &mi, &se) != 6)
+        return 0;
+    return (time_t)daysFromCivil(y, mo, d) * 86400 + h * 3600 + mi * 60 + se;
+}
+
+static void formatUtcIso(time_t t, char* buf, size_t len) {
+    struct tm g;
+    gmtime_r(&t, &g);
+    strftime(buf, len, "%Y-%m-%dT%H:%M:%SZ", &g);
+}
+
+static void formatLocalHM(time_t t, char* buf, size_t len) {
+    struct tm l;
+    localtime_r(&t, &l);
+    snprintf(buf, len, "%02d:%02d", l.tm_hour, l.tm_min);
+}
+
+static void addBoundary(uint32_t* list, uint8_t& n, uint32_t t) {
+    // Insert sorted; drop near-duplicates (back-to-back meetings)
+    int i = 0;
+    while (i < n && list[i] < t) i++;
+    if (i < n && list[i] - t < 60) return;
+    if (i > 0 && t - list[i - 1] < 60) return;
+    if (n >= CAL_MAX_BOUNDARIES) return;
+    memmove(&list[i + 1], &list[i], (n - i) * sizeof(uint32_t));
+    list[i] = t;
+    n++;
+}
+
+// ============================================================================
+// Refresh
+// ============================================================================
+
+bool calendarNeedsRefresh() {
+    time_t now = time(nullptr);
+    if (now < CLOCK_VALID_EPOCH) return false;           // can't build a window
+    if (rtc_cal.magic != CAL_MAGIC) return true;
+    if (now < rtc_cal.retryAt) return false;
+    if (rtc_cal.stale || rtc_cal.fetchedAt == 0) return true;
+    if (now - rtc_cal.fetchedAt >= CAL_REFRESH_SEC) return true;
+
+    struct tm a, b;
+    localtime_r(&rtc_cal.fetchedAt, &a);
+    localtime_r(&now, &b);
+    return a.tm_yday != b.tm_yday;                       // new day
+}
+
+bool calendarRefresh(const char* accessToken) {
+    time_t now = time(nullptr);
+    if (now < CLOCK_VALID_EPOCH) return false;
+    if (rtc_cal.magic != CAL_MAGIC) {
+        memset(&rtc_cal, 0, sizeof(rtc_cal));
+        rtc_cal.magic = CAL_MAGIC;
+    }
+
+    char from[24], to[24];
+    formatUtcIso(now - 3600, from, sizeof(from));      // include a meeting in progress
+    formatUtcIso(now + CAL_HORIZON_SEC, to, sizeof(to));
+    StrBuf url(224);
+    url.print("https://graph.microsoft.com/v1.0/me/calendarView?startDateTime=");
+    url.print(from);
+    url.print("&endDateTime=");
+    url.print(to);
+    url.print("&$select=start,end,showAs,isCancelled,isAllDay"
+              "&$orderby=start/dateTime&$top=");
+    url.print(CAL_TOP);
+
+    HTTPClient http;
+    if (!httpsBegin(http, url.c_str())) return false;
+    httpsAddBearer(http, accessToken);
+    http.addHeader("Prefer", "outlook.timezone=\"UTC\"");
+    int httpCode = httpsSend(http, "GET");
+
+    Serial.printf("[Calendar] HTTP %d\n", httpCode);
+    rtc_cal.lastHttp = httpCode;
+    if (httpCode != 200) {
+        HttpsBody(http).drain();        // keep the Graph socket usable
+        httpsEnd(http);
+    }
+
+    if (httpCode == 401) {
+        // Expired or rejected token, not missing consent — the next poll
+        // refreshes it; keep the schedule we have until then
+        Serial.println("[Calendar] 401 — token expired");
+        invalidateAccessToken();
+        rtc_cal.retryAt = now + CAL_RETRY_SEC;
+        return false;
+    }
+    if (httpCode == 403) {
+        // No Calendars.Read consent on this token — stop asking for a day
+        Serial.println("[Calendar] No calendar access — fixed interval");
+        rtc_cal.count     = 0;
+        rtc_cal.fetchedAt = 0;
+        rtc_cal.retryAt   = now + CAL_BACKOFF_SEC;
+        return false;
+    }
+    if (httpCode != 200) {
+        rtc_cal.retryAt = now + CAL_RETRY_SEC;
+        return false;
+    }
+
+    // Keep only what the scheduler uses — event ids and etags are large
+    StaticJsonDocument<256> filter;
+    JsonObject f = filter["value"].createNestedObject();
+    f["start"]["dateTime"] = true;
+    f["end"]["dateTime"]   = true;
+    f["showAs"]            = true;
+    f["isCancelled"]       = true;
+    f["isAllDay"]          = true;
+
+    ArenaJsonDocument doc(CAL_DOC_BYTES);
+    HttpsBody body(http);
+    DeserializationError err = deserializeJson(doc, body,
+                                               DeserializationOption::Filter(filter));
+    body.drain();
+    httpsEnd(http);
+    Serial.printf("[Calendar] %u bytes\n", (unsigned)body.bytesRead());
+    if (err == DeserializationError::NoMemory) {
+        // Events come sorted by start, so what fit are the nearest ones
+        Serial.println("[Calendar] Document full — using the events that fit");
+    } else if (err) {
+        Serial.printf("[Calendar] JSON error: %s\n", err.c_str());
+        rtc_cal.retryAt = now + CAL_RETRY_SEC;
+        return false;
+    }
+
+    uint32_t list[CAL_MAX_BOUNDARIES];
+    uint8_t  n = 0, events = 0;
+    for (JsonObject ev : doc["value"].as<JsonArray>()) {
+        if (ev["isCancelled"] | false) continue;
+        if (ev["isAllDay"]    | false) continue;            // no transition
+        const char* showAs = ev["showAs"] | "busy";
+        if (strcmp(showAs, "free") == 0) continue;
+        time_t s = parseGraphUtc(ev["start"]["dateTime"]);
+        time_t e = parseGraphUtc(ev["end"]["dateTime"]);
+        if (!s || !e) continue;
+        events++;
+        if (s >= now - (time_t)TRAIL_SEC) addBoundary(list, n, (uint32_t)s);
+        if (e >= now - (time_t)TRAIL_SEC) addBoundary(list, n, (uint32_t)e);
+    }
+
+    memcpy(rtc_cal.boundary, list, n * sizeof(uint32_t));
+    rtc_cal.count     = n;
+    rtc_cal.events    = events;
+    rtc_cal.fetchedAt = now;
+    rtc_cal.retryAt   = 0;
+    rtc_cal.stale     = false;
+    Serial.printf("[Calendar] %u events → %u boundaries\n", events, n);
+    return true;
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+bool calendarHasSchedule() {
+    return rtc_cal.magic == CAL_MAGIC && rtc_cal.fetchedAt != 0 &&
+           time(nullptr) >= CLOCK_VALID_EPOCH;
+}
+
+int calendarNextSleep(int baseSec, int maxSec) {
+    time_t now = time(nullptr);
+    int sleepSec = baseSec;
+    uint8_t reason = REASON_NO_CALENDAR;
+
+    if (rtc_cal.magic == CAL_MAGIC && rtc_cal.fetchedAt != 0 &&
+        now >= CLOCK_VALID_EPOCH && maxSec > baseSec) {
+        reason = REASON_CAPPED;
+        sleepSec = maxSec;
+        for (uint8_t i = 0; i < rtc_cal.count; i++) {
+            time_t b = rtc_cal.boundary[i];
+            if (now + LEAD_SEC >= b && now <= b + TRAIL_SEC) {
+                reason   = REASON_NEAR_BOUNDARY;
+                sleepSec = baseSec;
+                break;
+            }
+            if (b - LEAD_SEC > now) {
+                long gap = (long)(b - LEAD_SEC - now);
+                if (gap < maxSec) { sleepSec = (int)gap; reason = REASON_GAP; }
+                break;
+            }
+        }
+        // Never sleep past the end of what we fetched
+        long horizon = (long)(rtc_cal.fetchedAt + CAL_HORIZON_SEC - now);
+        if (horizon < sleepSec) sleepSec = (int)horizon;
+        if (sleepSec < baseSec) sleepSec = baseSec;
+    }
+
+    if (rtc_cal.magic == CAL_MAGIC) {
+        rtc_cal.lastReason = reason;
+        rtc_cal.lastSleep  = sleepSec;
+    }
+    if (reason != REASON_NO_CALENDAR)
+        Serial.printf("[Calendar] Next poll in %ds (%s)\n", sleepSec,
+                      reason == REASON_NEAR_BOUNDARY ? "near boundary" :
+                      reason == REASON_GAP ? "gap" : "max staleness");
+    return sleepSec;
+}
+
+void calendarNotePresenceChange() {
+    if (rtc_cal.magic != CAL_MAGIC || rtc_cal.fetchedAt == 0) return;
+    time_t now = time(nullptr);
+    for (uint8_t i = 0; i < rtc_cal.count; i++) {
+        time_t b = rtc_cal.boundary[i];
+        if (now + LEAD_SEC >= b && now <= b + TRAIL_SEC) return;   // expected
+    }
+    Serial.println("[Calendar] Change off-schedule — refetch next wake");
+    rtc_cal.stale = true;
+}
+
+void calendarDescribe(char* line1, size_t len1, char* line2, size_t len2) {
+    if (rtc_cal.magic != CAL_MAGIC) {
+        snprintf(line1, len1, "Cal: not fetched");
+        snprintf(line2, len2, "Sleep: fixed interval");
+        return;
+    }
+    if (rtc_cal.fetchedAt == 0) {
+        snprintf(line1, len1, "Cal: unavailable (HTTP %d)", rtc_cal.lastHttp);
+    } else {
+        time_t now = time(nullptr);
+        char next[8] = "--:--";
+        for (uint8_t i = 0; i < rtc_cal.count; i++) {
+            if ((time_t)rtc_cal.boundary[i] >= now) {
+                formatLocalHM(rtc_cal.boundary[i], next, sizeof(next));
+                break;
+            }
+        }
+        snprintf(line1, len1, "Cal: %u mtgs, next %s", rtc_cal.events, next);
+    }
+
+    const char* why = "fixed";
+    switch (rtc_cal.lastReason) {
+        case REASON_NEAR_BOUNDARY: why = "near mtg"; break;
+        case REASON_GAP:           why = "gap";      break;
+        case REASON_CAPPED:        why = "max stale"; break;
+        default: break;
+    }
+    if (rtc_cal.lastSleep >= 60)
+        snprintf(line2, len2, "Sleep: %ldm (%s)", (long)rtc_cal.lastSleep / 60, why);
+    else
+        snprintf(line2, len2, "Sleep: %lds (%s)", (long)rtc_cal.lastSleep, why);
+}
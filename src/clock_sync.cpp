@@ -0,0 +1,119 @@
+// ============================================================================
+// Clock Sync — wall-clock time kept by the RTC, NTP only when due
+// ============================================================================
+
+#include "clock_sync.h"
+#include <time.h>
+#include <climits>
+#include <sys/time.h>
+#include <esp_sntp.h>
+
+static const time_t CLOCK_VALID_EPOCH = 1704067200;   // 2024-01-01
+
+static const long NTP_RESYNC_HOURS  = 12;     // upper bound between syncs
+static const long NTP_MAX_ERROR_SEC = 30;     // resync earlier if drifted this far
+static const long DEFAULT_DRIFT_PPM = 1000;   // assumed until measured (0.1 %)
+
+// ---- RTC state (survives deep sleep) ---------------------------------------
+RTC_DATA_ATTR static time_t  rtc_lastSyncEpoch = 0;
+RTC_DATA_ATTR static int32_t rtc_driftPpm      = 0;     // measured, signed
+RTC_DATA_ATTR static uint8_t rtc_driftSamples  = 0;
+
+// ---- In-flight sync ----
+static volatile bool s_syncDone    = false;
+static bool          s_syncStarted = false;
+static struct timeval s_preSyncTime;          // clock just before the request
+static unsigned long s_preSyncMs   = 0;
+static String        s_tz;
+
+// Runs in the SNTP task after settimeofday()
+static void onTimeSync(struct timeval* tv) {
+    if (!s_syncStarted || s_syncDone) {
+        // SNTP's own periodic resync (long USB sessions) — no baseline
+        rtc_lastSyncEpoch = tv->tv_sec;
+        return;
+    }
+    // What our RTC would have said at this instant
+    double expected = s_preSyncTime.tv_sec + s_preSyncTime.tv_usec / 1e6 +
+                      (millis() - s_preSyncMs) / 1000.0;
+    double actual   = tv->tv_sec + tv->tv_usec / 1e6;
+    double errSec   = actual - expected;
+
+    if (rtc_lastSyncEpoch >= CLOCK_VALID_EPOCH &&
+        s_preSyncTime.tv_sec >= CLOCK_VALID_EPOCH) {
+        double elapsed = (double)(s_preSyncTime.tv_sec - rtc_lastSyncEpoch);
+        if (elapsed > 600) {
+            int32_t ppm = (int32_t)(errSec / elapsed * 1e6);
+            // Light smoothing once we have a first sample
+            rtc_driftPpm = (rtc_driftSamples == 0) ? ppm
+                         : (int32_t)((3LL * rtc_driftPpm + ppm) / 4);
+            if (rtc_driftSamples < 255) rtc_driftSamples++;
+        }
+    }
+    rtc_lastSyncEpoch = tv->tv_sec;
+    s_syncDone = true;
+    Serial.printf("[NTP] Synced — RTC was off by %+.2fs, drift %ldppm\n",
+                  errSec, (long)rtc_driftPpm);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void clockInit(const String& timezone) {
+    s_tz = timezone.length() ? timezone : String("UTC0");
+    setenv("TZ", s_tz.c_str(), 1);
+    tzset();
+}
+
+bool clockIsValid() {
+    return time(nullptr) >= CLOCK_VALID_EPOCH;
+}
+
+long clockEstimatedErrorSec() {
+    if (rtc_lastSyncEpoch < CLOCK_VALID_EPOCH || !clockIsValid()) return LONG_MAX;
+    long elapsed = (long)(time(nullptr) - rtc_lastSyncEpoch);
+    if (elapsed < 0) return LONG_MAX;
+    long ppm = rtc_driftSamples ? labs(rtc_driftPpm) : DEFAULT_DRIFT_PPM;
+    return (long)((int64_t)elapsed * ppm / 1000000LL);
+}
+
+bool clockNeedsSync() {
+    if (!clockIsValid() || rtc_lastSyncEpoch < CLOCK_VALID_EPOCH) return true;
+    long elapsed = (long)(time(nullptr) - rtc_lastSyncEpoch);
+    if (elapsed < 0 || elapsed >= NTP_RESYNC_HOURS * 3600L) return true;
+    return clockEstimatedErrorSec() >= NTP_MAX_ERROR_SEC;
+}
+
+void clockStartSync() {
+    if (s_syncStarted && !s_syncDone) return;   // already in flight
+    Serial.printf("[NTP] Background sync (TZ %s, est. error %lds)\n",
+                  s_tz.c_str(),
+                  clockEstimatedErrorSec() == LONG_MAX ? -1L : clockEstimatedErrorSec());
+    s_syncDone    = false;
+    s_syncStarted = true;
+    gettimeofday(&s_preSyncTime, nullptr);
+    s_preSyncMs = millis();
+    sntp_set_time_sync_notification_cb(onTimeSync);
+    configTzTime(s_tz.c_str(), "pool.ntp.org", "time.nist.gov");
+}
+
+bool clockFinishSync(unsigned long timeoutMs) {
+    if (s_syncStarted && !s_syncDone) {
+        unsigned long t0 = millis();
+        while (!s_syncDone && millis() - t0 < timeoutMs) delay(20);
+        if (!s_syncDone) {
+            Serial.printf("[NTP] No reply within %lums — keeping RTC time\n", timeoutMs);
+        }
+    }
+    if (clockIsValid()) {
+        struct tm t;
+        time_t now = time(nullptr);
+        localtime_r(&now, &t);
+        Serial.printf("[NTP] Time: %04d-%02d-%02d %02d:%02d:%02d (wday=%d)\n",
+                      t.tm_year+1900, t.tm_mon+1, t.tm_mday,
+                      t.tm_hour, t.tm_min, t.tm_sec, t.tm_wday);
+        return true;
+    }
+    return false;
+}
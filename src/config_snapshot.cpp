@@ -0,0 +1,268 @@
+// ============================================================================
+// Config Snapshot — everything a timer wake needs, without the SD card
+// ============================================================================
+
+#include "config_snapshot.h"
+#include "ble_setup.h"
+#include <Preferences.h>
+#include <esp_rom_crc.h>
+
+#define SNAP_MAGIC      0x43464731UL   // "CFG1"
+#define SNAP_VERSION    2               // bump when SnapData changes
+
+static const char* SNAP_NS = "cfg_snap";
+
+// ---- Record (fixed layout, zero-padded strings) ----------------------------
+struct SnapData {
+    // PodSettings
+    int32_t presenceInterval;
+    int32_t fullRefreshEvery;
+    int32_t maxStaleness;
+    int32_t pollMinSec;
+    int32_t pollMaxSec;
+    uint8_t platform;
+    uint8_t invertDisplay;
+    uint8_t audioAlerts;
+    uint8_t pollProfile;
+    uint8_t mergeRule;
+    uint8_t officeHoursEnabled;
+    uint8_t officeStartHour, officeStartMin;
+    uint8_t officeEndHour,   officeEndMin;
+    uint8_t officeDays;
+    char    timezone[64];
+    // LightConfig
+    uint8_t lightType;
+    int16_t brightness;
+    char    lightIp[40];
+    char    lightKey[64];
+    char    lightAux[16];
+    // Credentials (ble_setup.h globals)
+    char    ssid[33];
+    char    password[65];
+    char    clientId[64];
+    char    tenantId[64];
+    char    clientSecret[96];
+    char    zoomAccount[64];
+    char    zoomClientId[64];
+};
+
+struct SnapRecord {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t crc;
+    SnapData d;
+};
+
+// ---- RTC copy (survives deep sleep) ----------------------------------------
+RTC_DATA_ATTR static SnapRecord rtc_snap = {};
+
+// ----------------------------------------------------------------------------
+static uint32_t crcOf(const SnapData& d) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&d, sizeof(d));
+}
+
+static bool recordValid(const SnapRecord& r) {
+    return r.magic == SNAP_MAGIC && r.version == SNAP_VERSION &&
+           r.size == sizeof(SnapData) && r.crc == crcOf(r.d);
+}
+
+static bool putStr(char* dst, size_t cap, const String& src, const char* what) {
+    if (src.length() >= cap) {
+        Serial.printf("[Snap] %s too long (%u) — no snapshot\n", what, src.length());
+        return false;
+    }
+    memcpy(dst, src.c_str(), src.length() + 1);
+    return true;
+}
+
+static bool packSettings(SnapData& d, const PodSettings& s) {
+    d.presenceInterval   = s.presenceInterval;
+    d.fullRefreshEvery   = s.fullRefreshEvery;
+    d.maxStaleness       = s.maxStaleness;
+    d.pollMinSec         = s.pollMinSec;
+    d.pollMaxSec         = s.pollMaxSec;
+    d.platform           = (uint8_t)s.platform;
+    d.invertDisplay      = s.invertDisplay;
+    d.audioAlerts        = s.audioAlerts;
+    d.pollProfile        = (uint8_t)s.pollProfile;
+    d.mergeRule          = (uint8_t)s.mergeRule;
+    d.officeHoursEnabled = s.officeHoursEnabled;
+    d.officeStartHour    = s.officeStartHour;
+    d.officeStartMin     = s.officeStartMin;
+    d.officeEndHour      = s.officeEndHour;
+    d.officeEndMin       = s.officeEndMin;
+    d.officeDays         = s.officeDays;
+    memset(d.timezone, 0, sizeof(d.timezone));
+    return putStr(d.timezone, sizeof(d.timezone), s.timezone, "timezone");
+}
+
+static bool packLight(SnapData& d, const LightConfig& l) {
+    d.lightType  = (uint8_t)l.type;
+    d.brightness = (int16_t)l.brightness;
+    memset(d.lightIp,  0, sizeof(d.lightIp));
+    memset(d.lightKey, 0, sizeof(d.lightKey));
+    memset(d.lightAux, 0, sizeof(d.lightAux));
+    return putStr(d.lightIp,  sizeof(d.lightIp),  l.ip,  "light ip") &&
+           putStr(d.lightKey, sizeof(d.lightKey), l.key, "light key") &&
+           putStr(d.lightAux, sizeof(d.lightAux), l.aux, "light aux");
+}
+
+static bool packCredentials(SnapData& d) {
+    memset(d.ssid,         0, sizeof(d.ssid));
+    memset(d.password,     0, sizeof(d.password));
+    memset(d.clientId,     0, sizeof(d.clientId));
+    memset(d.tenantId,     0, sizeof(d.tenantId));
+    memset(d.clientSecret, 0, sizeof(d.clientSecret));
+    memset(d.zoomAccount,  0, sizeof(d.zoomAccount));
+    memset(d.zoomClientId, 0, sizeof(d.zoomClientId));
+    return putStr(d.ssid,         sizeof(d.ssid),         g_ssid,          "ssid") &&
+           putStr(d.password,     sizeof(d.password),     g_password,      "password") &&
+           putStr(d.clientId,     sizeof(d.clientId),     g_client_id,     "client id") &&
+           putStr(d.tenantId,     sizeof(d.tenantId),     g_tenant_id,     "tenant id") &&
+           putStr(d.clientSecret, sizeof(d.clientSecret), g_client_secret, "client secret") &&
+           putStr(d.zoomAccount,  sizeof(d.zoomAccount),  g_zoom_account,  "zoom account") &&
+           putStr(d.zoomClientId, sizeof(d.zoomClientId), g_zoom_client_id, "zoom client id");
+}
+
+// RTC copy valid, or restored from NVS after RTC memory was lost
+static bool ensureLoaded() {
+    if (recordValid(rtc_snap)) return true;
+    Preferences prefs;
+    if (!prefs.begin(SNAP_NS, true)) return false;
+    bool ok = false;
+    if (prefs.getBytesLength("snap") == sizeof(SnapRecord)) {
+        SnapRecord r;
+        prefs.getBytes("snap", &r, sizeof(r));
+        if (recordValid(r)) {
+            rtc_snap = r;
+            ok = true;
+        }
+    }
+    prefs.end();
+    if (ok) Serial.println("[Snap] Restored from NVS");
+    return ok;
+}
+
+// Seal `d` into the RTC record; NVS only when the contents changed
+static void commit(const SnapData& d) {
+    uint32_t crc = crcOf(d);
+    if (recordValid(rtc_snap) && rtc_snap.crc == crc) return;
+
+    rtc_snap.magic   = SNAP_MAGIC;
+    rtc_snap.version = SNAP_VERSION;
+    rtc_snap.size    = sizeof(SnapData);
+    memcpy(&rtc_snap.d, &d, sizeof(d));
+    rtc_snap.crc     = crc;
+
+    Preferences prefs;
+    if (prefs.begin(SNAP_NS, false)) {
+        if (prefs.getUInt("crc", 0) != crc ||
+            prefs.getBytesLength("snap") != sizeof(SnapRecord)) {
+            prefs.putBytes("snap", &rtc_snap, sizeof(rtc_snap));
+            prefs.putUInt("crc", crc);
+            Serial.printf("[Snap] Saved (%u bytes, crc %08x)\n",
+                          (unsigned)sizeof(SnapRecord), (unsigned)crc);
+        }
+        prefs.end();
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool configSnapshotCapture(const PodSettings& s, const LightConfig& light) {
+    SnapData d;
+    memset(&d, 0, sizeof(d));
+    if (!packSettings(d, s) || !packLight(d, light) || !packCredentials(d)) {
+        configSnapshotInvalidate();
+        return false;
+    }
+    commit(d);
+    return true;
+}
+
+bool configSnapshotRestore(PodSettings& s, LightConfig& light) {
+    if (!ensureLoaded()) return false;
+    const SnapData& d = rtc_snap.d;
+
+    s.presenceInterval   = d.presenceInterval;
+    s.fullRefreshEvery   = d.fullRefreshEvery;
+    s.maxStaleness       = d.maxStaleness;
+    s.pollMinSec         = d.pollMinSec;
+    s.pollMaxSec         = d.pollMaxSec;
+    s.platform           = (Platform)d.platform;
+    s.invertDisplay      = d.invertDisplay;
+    s.audioAlerts        = d.audioAlerts;
+    s.pollProfile        = (PollProfile)d.pollProfile;
+    s.mergeRule          = (MergeRule)d.mergeRule;
+    s.officeHoursEnabled = d.officeHoursEnabled;
+    s.officeStartHour    = d.officeStartHour;
+    s.officeStartMin     = d.officeStartMin;
+    s.officeEndHour      = d.officeEndHour;
+    s.officeEndMin       = d.officeEndMin;
+    s.officeDays         = d.officeDays;
+    s.timezone           = d.timezone;
+
+    light.type       = (LightType)d.lightType;
+    light.brightness = d.brightness;
+    light.ip         = d.lightIp;
+    light.key        = d.lightKey;
+    light.aux        = d.lightAux;
+
+    g_ssid          = d.ssid;
+    g_password      = d.password;
+    g_client_id     = d.clientId;
+    g_tenant_id     = d.tenantId;
+    g_client_secret = d.clientSecret;
+    g_zoom_account  = d.zoomAccount;
+    g_zoom_client_id = d.zoomClientId;
+    g_platform      = String((int)d.platform);
+    g_timezone      = d.timezone;
+    g_light_type    = String((int)d.lightType);
+    g_light_ip      = d.lightIp;
+    g_light_key     = d.lightKey;
+    g_light_aux     = d.lightAux;
+
+    Serial.printf("[Snap] Config from snapshot: platform=%s interval=%d light=%s\n",
+                  platformName(s.platform), s.presenceInterval, lightTypeName(light.type));
+    return true;
+}
+
+void configSnapshotUpdateSettings(const PodSettings& s) {
+    if (!ensureLoaded()) return;
+    SnapData d;
+    memcpy(&d, &rtc_snap.d, sizeof(d));
+    if (!packSettings(d, s)) {
+        configSnapshotInvalidate();
+        return;
+    }
+    commit(d);
+}
+
+void configSnapshotUpdateLight(const LightConfig& light) {
+    if (!ensureLoaded()) return;
+    SnapData d;
+    memcpy(&d, &rtc_snap.d, sizeof(d));
+    if (!packLight(d, light)) {
+        configSnapshotInvalidate();
+        return;
+    }
+    commit(d);
+}
+
+void configSnapshotInvalidate() {
+    bool had = (rtc_snap.magic == SNAP_MAGIC);
+    memset(&rtc_snap, 0, sizeof(rtc_snap));
+    Preferences prefs;
+    if (prefs.begin(SNAP_NS, false)) {
+        if (prefs.isKey("snap")) {
+            prefs.remove("snap");
+            prefs.remove("crc");
+            had = true;
+        }
+        prefs.end();
+    }
+    if (had) Serial.println("[Snap] Invalidated");
+}
@@ -5,7 +5,13 @@
 #include "display_ui.h"
 #include "battery.h"
 #include "sd_storage.h"
+#include "status_frames.h"
+#include "team_board.h"
 #include <qrcode.h>
+#include <esp_rom_crc.h>
+#ifdef POD_BENCH
+#include "bench.h"
+#endif
 
 // Adafruit-GFX FreeFont headers (bundled with GxEPD2's dependency)
 #include <Fonts/FreeSansBold9pt7b.h>
@@ -22,6 +28,83 @@ static const char* SETUP_URL = "https://thefoeyouknow.github.io/Teams-Pod/web/se
 // helpers
 // ---------------------------------------------------------------------------
 
+// Refresh bookkeeping.  Partial updates are cheap — the driver diffs each
+// frame against the last one and only drives the changed area — but they
+// accumulate ghosting, so every s_fullEvery-th one is promoted to a full
+// refresh.  A background flip (e.g. Available → Busy) drives every pixel
+// anyway and is always done as a clean full refresh.
+enum FrameBg : int8_t { BG_UNKNOWN = -1, BG_WHITE = 0, BG_BLACK = 1, BG_IMAGE = 2, BG_BOARD = 3 };
+
+static int      s_fullEvery    = 10;
+static int      s_partialCount = 0;
+static int8_t   s_lastBg       = BG_UNKNOWN;
+static uint32_t s_frameCrc     = 0;      // status frame on the glass; 0 = another screen
+static bool     s_begun        = false;  // display initialised this boot
+
+// Warm resume: the panel hibernates with its RAM intact, so this is all
+// the next boot needs to carry on with partial updates (one-shot).
+struct RtcPanel {
+    uint32_t magic;
+    uint32_t frameCrc;
+    int16_t  partialCount;
+    int8_t   lastBg;
+    uint8_t  partialLut;
+};
+static const uint32_t PANEL_MAGIC = 0x31575045;  // "EPW1"
+RTC_DATA_ATTR static RtcPanel rtc_panel = {};
+
+// Decide whether the next frame may be a partial update, and account for it
+static bool nextRefreshPartial(bool partial, int8_t bg) {
+    if (bg != s_lastBg) partial = false;
+    if (partial && s_fullEvery > 0 && s_partialCount >= s_fullEvery) partial = false;
+    s_partialCount = partial ? s_partialCount + 1 : 0;
+    s_lastBg = bg;
+    return partial;
+}
+
+static void beginWindow(bool partial, int8_t bg = BG_WHITE) {
+    s_frameCrc = 0;
+    if (nextRefreshPartial(partial, bg))
+        display.setPartialWindow(0, 0, 200, 200);
+    else
+        display.setFullWindow();
+}
+
+void displayBegin() {
+    bool warm = (rtc_panel.magic == PANEL_MAGIC);
+    rtc_panel.magic = 0;  // a crash or restart from here on cold-inits
+    display.init(115200, !warm, 20, false, SPI,
+                 SPISettings(10000000, MSBFIRST, SPI_MODE0));
+    if (warm) {
+        display.epd2.warmResume(rtc_panel.partialLut);
+        s_partialCount = rtc_panel.partialCount;
+        s_lastBg       = rtc_panel.lastBg;
+        s_frameCrc     = rtc_panel.frameCrc;
+        Serial.printf("[UI] Warm resume: %s LUT, %d partials since full\n",
+                      rtc_panel.partialLut ? "partial" : "full", s_partialCount);
+    }
+    s_begun = true;
+}
+
+void displayWarmSleep() {
+    if (!s_begun) return;  // panel untouched this boot — saved state still holds
+    display.epd2.waitRefresh();
+    rtc_panel.frameCrc     = s_frameCrc;
+    rtc_panel.partialCount = s_partialCount;
+    rtc_panel.lastBg       = s_lastBg;
+    rtc_panel.partialLut   = display.epd2.partialLutLoaded();  // hibernate clears it
+    display.hibernate();
+    rtc_panel.magic = PANEL_MAGIC;
+}
+
+void displayWaitIdle() {
+    display.epd2.waitRefresh();
+}
+
+void displaySetFullRefreshEvery(int n) {
+    s_fullEvery = n;
+}
+
 // Centre a string horizontally at the given baseline-y
 static void centerText(const char* text, int y) {
     int16_t x1, y1;
@@ -45,17 +128,22 @@ static int selectQRVersion(int len, int ecLevel = 3) {
     return 10;
 }
 
-// "Busy" and "DoNotDisturb" get an inverted (black-fill) screen.
-static bool isInvertedStatus(const char* avail) {
-    return (strcmp(avail, "Busy") == 0 ||
-            strcmp(avail, "DoNotDisturb") == 0);
+// One black square per dark module, `scale` px each, from (ox, oy)
+static void drawQRModules(QRCode& qrcode, int ox, int oy, int scale) {
+    for (int y = 0; y < qrcode.size; y++) {
+        for (int x = 0; x < qrcode.size; x++) {
+            if (qrcode_getModule(&qrcode, x, y))
+                display.fillRect(ox + x * scale, oy + y * scale, scale, scale, GxEPD_BLACK);
+        }
+    }
 }
 
 // ============================================================================
 // Battery Icon — lower-right corner
 //
 //   Draws a small battery outline with proportional fill and optional
-//   voltage text.  Works on both white and black backgrounds.
+//   voltage text.  Works on both white and black backgrounds.  Draws on
+//   `g` (default: the display) with its origin at screen (ox, oy).
 //
 //   Layout (26×12 px):
 //   ┌──────────────────┐
@@ -63,7 +151,8 @@ static bool isInvertedStatus(const char* avail) {
 //   └──────────────────┘
 //
 // ============================================================================
-static void drawBatteryIcon(uint16_t fg, uint16_t bg, bool large = false) {
+static void drawBatteryIcon(uint16_t fg, uint16_t bg, bool large = false,
+                            Adafruit_GFX& g = display, int16_t ox = 0, int16_t oy = 0) {
     float voltage = batteryReadVoltage();
     int   pct     = batteryPercent(voltage);
     bool  usb     = batteryOnUSB(voltage);
@@ -78,48 +167,48 @@ static void drawBatteryIcon(uint16_t fg, uint16_t bg, bool large = false) {
         //   └──────────┘
         const int bw = 18, bh = 36;          // body (vertical)
         const int tipW = 8, tipH = 5;        // tip (horizontal nub on top)
-        const int ix = 200 - bw - 6;         // x (lower-right, 6px margin)
-        const int iy = 200 - bh - tipH - 6;  // y (leave room for tip above)
+        const int ix = 200 - bw - 6 - ox;         // x (lower-right, 6px margin)
+        const int iy = 200 - bh - tipH - 6 - oy;  // y (leave room for tip above)
 
         // Tip (centred on top)
         int tipX = ix + (bw - tipW) / 2;
         int tipY = iy;
-        display.fillRect(tipX, tipY, tipW, tipH, fg);
+        g.fillRect(tipX, tipY, tipW, tipH, fg);
 
         // Body outline (2px border, below tip)
         int bodyY = iy + tipH;
-        display.drawRect(ix, bodyY, bw, bh, fg);
-        display.drawRect(ix + 1, bodyY + 1, bw - 2, bh - 2, fg);
+        g.drawRect(ix, bodyY, bw, bh, fg);
+        g.drawRect(ix + 1, bodyY + 1, bw - 2, bh - 2, fg);
 
         // Fill level (inside body, 2px inset, fills from bottom)
         int innerW = bw - 4;
         int innerH = bh - 4;
         int fillH  = (innerH * pct) / 100;
         if (fillH > 0)
-            display.fillRect(ix + 2, bodyY + 2 + (innerH - fillH), innerW, fillH, fg);
+            g.fillRect(ix + 2, bodyY + 2 + (innerH - fillH), innerW, fillH, fg);
     } else {
         // --- Compact vertical battery icon for menu screens ---
         const int bw = 11, bh = 22;
         const int tipW = 5, tipH = 3;
-        const int ix = 200 - bw - 4;
-        const int iy = 200 - bh - tipH - 4;
+        const int ix = 200 - bw - 4 - ox;
+        const int iy = 200 - bh - tipH - 4 - oy;
 
         // Tip (centred on top)
         int tipX = ix + (bw - tipW) / 2;
         int tipY = iy;
-        display.fillRect(tipX, tipY, tipW, tipH, fg);
+        g.fillRect(tipX, tipY, tipW, tipH, fg);
 
         // Body outline
         int bodyY = iy + tipH;
-        display.drawRect(ix, bodyY, bw, bh, fg);
-        display.drawRect(ix + 1, bodyY + 1, bw - 2, bh - 2, fg);
+        g.drawRect(ix, bodyY, bw, bh, fg);
+        g.drawRect(ix + 1, bodyY + 1, bw - 2, bh - 2, fg);
 
         // Fill level (from bottom)
         int innerW = bw - 4;
         int innerH = bh - 4;
         int fillH  = (innerH * pct) / 100;
         if (fillH > 0)
-            display.fillRect(ix + 2, bodyY + 2 + (innerH - fillH), innerW, fillH, fg);
+            g.fillRect(ix + 2, bodyY + 2 + (innerH - fillH), innerW, fillH, fg);
     }
 
     Serial.printf("[Batt] %.2fV  %d%%  %s\n", voltage, pct, usb ? "USB" : "BATT");
@@ -161,7 +250,7 @@ void drawSplashScreen(const char* platformLabel) {
     if (splashPath && sdMounted() && sdFileExists(splashPath)) {
         static uint8_t bmpBuf[5000];
         if (sdLoadBMP(splashPath, bmpBuf, sizeof(bmpBuf))) {
-            display.setFullWindow();
+            beginWindow(false, BG_IMAGE);
             display.firstPage();
             do {
                 display.fillScreen(GxEPD_WHITE);
@@ -195,7 +284,7 @@ void drawSplashScreen(const char* platformLabel) {
     char verStr[16];
     snprintf(verStr, sizeof(verStr), "v%s", FW_VERSION);
 
-    display.setFullWindow();
+    beginWindow(false);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -283,7 +372,7 @@ void drawSetupScreen() {
     int topY    = 24;
     int offsetY = topY + (availH - totalPx) / 2;
 
-    display.setFullWindow();
+    beginWindow(false);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -295,15 +384,7 @@ void drawSetupScreen() {
         centerText("Scan to Setup", 17);
 
         // QR code
-        for (int y = 0; y < modules; y++) {
-            for (int x = 0; x < modules; x++) {
-                if (qrcode_getModule(&qrcode, x, y)) {
-                    display.fillRect(offsetX + x * scale,
-                                     offsetY + y * scale,
-                                     scale, scale, GxEPD_BLACK);
-                }
-            }
-        }
+        drawQRModules(qrcode, offsetX, offsetY, scale);
 
         // Bottom hint
         display.setFont(NULL);
@@ -353,22 +434,14 @@ void drawQRAuthScreen(const char* userCode, const char* qrUrl) {
     Serial.printf("[QR] scale=%d totalPx=%d offset=(%d,%d) qrBottom=%d\n",
                   scale, totalPx, offsetX, offsetY, qrBottom);
 
-    display.setFullWindow();
+    beginWindow(false);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
         display.setTextSize(1);
 
         // --- QR modules ---
-        for (int y = 0; y < modules; y++) {
-            for (int x = 0; x < modules; x++) {
-                if (qrcode_getModule(&qrcode, x, y)) {
-                    display.fillRect(offsetX + x * scale,
-                                     offsetY + y * scale,
-                                     scale, scale, GxEPD_BLACK);
-                }
-            }
-        }
+        drawQRModules(qrcode, offsetX, offsetY, scale);
 
         // --- Auth code + gear hint below QR ---
         int textSpace = 200 - qrBottom;  // ~33px for V3@scale5
@@ -403,7 +476,7 @@ void drawQRAuthScreen(const char* userCode, const char* qrUrl) {
 // ============================================================================
 
 void drawAuthCodeScreen(const char* userCode) {
-    display.setFullWindow();
+    beginWindow(false);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -450,148 +523,297 @@ void drawAuthCodeScreen(const char* userCode) {
     Serial.printf("[UI] Auth code screen: %s\n", userCode);
 }
 
-// Map availability/activity to BMP filename on SD card.
-static const char* statusToBmpPath(const char* availability, const char* activity) {
-    // Activity-specific overrides
-    if (activity && strlen(activity) > 0) {
-        if (strcmp(activity, "InACall") == 0 || strcmp(activity, "InAMeeting") == 0)
-            return "/graphics/status_call.bmp";
-        if (strcmp(activity, "Presenting") == 0)
-            return "/graphics/status_presenting.bmp";
-    }
-    if (strcmp(availability, "Available") == 0)     return "/graphics/status_available.bmp";
-    if (strcmp(availability, "Away") == 0)          return "/graphics/status_away.bmp";
-    if (strcmp(availability, "BeRightBack") == 0)   return "/graphics/status_brb.bmp";
-    if (strcmp(availability, "Busy") == 0)          return "/graphics/status_busy.bmp";
-    if (strcmp(availability, "DoNotDisturb") == 0)  return "/graphics/status_dnd.bmp";
-    if (strcmp(availability, "Offline") == 0)       return "/graphics/status_offline.bmp";
-    if (strcmp(availability, "OutOfOffice") == 0)   return "/graphics/status_OoO.bmp";
-    return nullptr;
-}
-
 // ============================================================================
 // Presence-Status Screen
 //   Available / Away / BeRightBack  →  white background, black text
 //   Busy / DoNotDisturb             →  black background, white text
+//
+//   Each screen is a whole frame (SD BMP or drawn) without the battery icon,
+//   normally pre-rendered by displayPrepareStatusFrames().  The icon is
+//   overlaid on a copy and the frame goes straight to the controller — no
+//   GxEPD2 page loop; the driver's frame diff still trims what is sent.
 // ============================================================================
 
-void drawStatusScreen(const char* availability, const char* activity) {
-    // --- Try BMP image from SD card first ---
-    const char* bmpPath = statusToBmpPath(availability, activity);
-    if (bmpPath && sdMounted() && sdFileExists(bmpPath)) {
-        static uint8_t bmpBuf[5000];  // 200×200 / 8
-        if (sdLoadBMP(bmpPath, bmpBuf, sizeof(bmpBuf))) {
-            display.setFullWindow();
-            display.firstPage();
-            do {
-                display.fillScreen(GxEPD_WHITE);
-                // bit 1 = white pixel, bit 0 = black pixel (normalised by sdLoadBMP)
-                display.drawBitmap(0, 0, bmpBuf, 200, 200, GxEPD_WHITE, GxEPD_BLACK);
-                // Battery icon overlay in clear bottom-right area
-                drawBatteryIcon(GxEPD_BLACK, GxEPD_WHITE, true);
-            } while (display.nextPage());
-            Serial.printf("[UI] BMP Status: %s (%s) -> %s\n",
-                          availability, activity ? activity : "", bmpPath);
-            return;
-        }
-    }
+// Battery icon area (large icon), byte-aligned for the frame overlay
+static const int16_t BATT_BOX_X = 176, BATT_BOX_Y = 152;
+static const int16_t BATT_BOX_W = 24,  BATT_BOX_H = 48;
+
+static uint8_t s_frame[STATUS_FRAME_BYTES];
 
-    // --- Fallback: programmatic rendering ---
-    bool inverted = isInvertedStatus(availability);
+// Programmatic status screen (no battery icon)
+static void drawStatusBody(Adafruit_GFX& g, Availability availability, Activity activity) {
+    const AvailabilityInfo& info = availabilityInfo(availability);
+    bool inverted = info.inverted;
     uint16_t bg = inverted ? GxEPD_BLACK : GxEPD_WHITE;
     uint16_t fg = inverted ? GxEPD_WHITE : GxEPD_BLACK;
 
     // pick font that fits the word (one step smaller across the board)
     const GFXfont* statusFont = &FreeSansBold18pt7b;
-    if (strlen(availability) > 7)  statusFont = &FreeSansBold12pt7b;
-    if (strlen(availability) > 12) statusFont = &FreeSansBold9pt7b;
+    if (strlen(info.screen) > 7)  statusFont = &FreeSansBold12pt7b;
+    if (strlen(info.screen) > 12) statusFont = &FreeSansBold9pt7b;
+
+    g.fillScreen(bg);
+    g.setTextSize(1);
+
+    // --- indicator circle (top-centre) ---
+    const int cx = 100, cy = 55, cr = 30;
+    if (inverted) {
+        g.fillCircle(cx, cy, cr, fg);
+        if (info.icon == ICON_BAR) {
+            // minus bar
+            g.fillRect(cx - 15, cy - 3, 30, 6, bg);
+        }
+    } else {
+        g.drawCircle(cx, cy, cr,     fg);
+        g.drawCircle(cx, cy, cr - 1, fg);
+        if (info.icon == ICON_TICK) {
+            // tick
+            g.drawLine(cx-10, cy,   cx-3, cy+8,  fg);
+            g.drawLine(cx-3,  cy+8, cx+12,cy-10, fg);
+            g.drawLine(cx-10, cy+1, cx-3, cy+9,  fg);
+            g.drawLine(cx-3,  cy+9, cx+12,cy-9,  fg);
+        } else if (info.icon == ICON_CLOCK) {
+            // clock hands
+            g.drawLine(cx, cy, cx,    cy-15, fg);
+            g.drawLine(cx, cy, cx+10, cy+5,  fg);
+        } else if (info.icon == ICON_CROSS) {
+            // X
+            g.drawLine(cx-10,cy-10, cx+10,cy+10, fg);
+            g.drawLine(cx+10,cy-10, cx-10,cy+10, fg);
+        }
+    }
 
-    display.setFullWindow();
-    display.firstPage();
-    do {
-        display.fillScreen(bg);
-        display.setTextSize(1);
+    // --- primary label ---
+    g.setFont(statusFont);
+    g.setTextColor(fg);
 
-        // --- indicator circle (top-centre) ---
-        const int cx = 100, cy = 55, cr = 30;
-        if (inverted) {
-            display.fillCircle(cx, cy, cr, fg);
-            if (strcmp(availability, "DoNotDisturb") == 0) {
-                // minus bar
-                display.fillRect(cx - 15, cy - 3, 30, 6, bg);
-            }
-        } else {
-            display.drawCircle(cx, cy, cr,     fg);
-            display.drawCircle(cx, cy, cr - 1, fg);
-            if (strcmp(availability, "Available") == 0) {
-                // tick
-                display.drawLine(cx-10, cy,   cx-3, cy+8,  fg);
-                display.drawLine(cx-3,  cy+8, cx+12,cy-10, fg);
-                display.drawLine(cx-10, cy+1, cx-3, cy+9,  fg);
-                display.drawLine(cx-3,  cy+9, cx+12,cy-9,  fg);
-            } else if (strcmp(availability, "Away") == 0 ||
-                       strcmp(availability, "BeRightBack") == 0) {
-                // clock hands
-                display.drawLine(cx, cy, cx,    cy-15, fg);
-                display.drawLine(cx, cy, cx+10, cy+5,  fg);
-            } else if (strcmp(availability, "Offline") == 0) {
-                // X
-                display.drawLine(cx-10,cy-10, cx+10,cy+10, fg);
-                display.drawLine(cx+10,cy-10, cx-10,cy+10, fg);
-            }
+    int16_t x1, y1;
+    uint16_t w, h;
+    g.getTextBounds(info.screen, 0, 0, &x1, &y1, &w, &h);
+    g.setCursor((200 - w) / 2 - x1, 120);
+    g.print(info.screen);
+
+    // second line ("DISTURB" for DND)
+    if (info.screen2) {
+        g.getTextBounds(info.screen2, 0, 0, &x1, &y1, &w, &h);
+        g.setCursor((200 - w) / 2 - x1, 155);
+        g.print(info.screen2);
+    }
+
+    // --- activity detail ---
+    const char* act = activityInfo(activity).label;
+    if (*act) {
+        g.setFont(&FreeSansBold12pt7b);
+        g.getTextBounds(act, 0, 0, &x1, &y1, &w, &h);
+        // Fall back to 9pt bold if too wide
+        if (w > 190) {
+            g.setFont(&FreeSansBold9pt7b);
+            g.getTextBounds(act, 0, 0, &x1, &y1, &w, &h);
         }
+        g.setCursor((200 - w) / 2 - x1, 168);
+        g.print(act);
+    }
 
-        // --- primary label ---
-        const char* label = availability;
-        if (strcmp(availability, "DoNotDisturb")    == 0) label = "DO NOT";
-        else if (strcmp(availability, "BeRightBack")== 0) label = "BRB";
-        else if (strcmp(availability, "PresenceUnknown")==0) label = "UNKNOWN";
+    // border on light screens
+    if (!inverted)
+        g.drawRect(0, 0, 200, 200, fg);
+}
 
-        display.setFont(statusFont);
-        display.setTextColor(fg);
+// Frame for a status: SD BMP for its slot if there is one, else drawn.
+// GFXcanvas1 stores bit 1 = white, row-major, MSB first — the panel's
+// native layout, same as sdLoadBMP() output.
+static FrameSource renderStatusFrame(Availability availability, Activity activity,
+                                     uint8_t* frame) {
+    const char* bmpPath = statusFrameBmpPath(statusFrameSlot(availability, activity));
+    if (bmpPath && sdFileExists(bmpPath) &&
+        sdLoadBMP(bmpPath, frame, STATUS_FRAME_BYTES))
+        return FRAME_BMP;
+
+    GFXcanvas1 canvas(200, 200);
+    if (!canvas.getBuffer()) return FRAME_NONE;
+    drawStatusBody(canvas, availability, activity);
+    memcpy(frame, canvas.getBuffer(), STATUS_FRAME_BYTES);
+    return FRAME_DRAWN;
+}
 
-        String upper = String(label);
-        upper.toUpperCase();
+// Draw the large battery icon into the frame's battery box
+static void overlayBattery(uint8_t* frame, uint16_t fg, uint16_t bg) {
+    const int16_t stride = 200 / 8, bx = BATT_BOX_X / 8, bw = BATT_BOX_W / 8;
+    GFXcanvas1 box(BATT_BOX_W, BATT_BOX_H);
+    uint8_t* buf = box.getBuffer();
+    if (!buf) return;
+    for (int16_t r = 0; r < BATT_BOX_H; r++)
+        memcpy(buf + r * bw, frame + (BATT_BOX_Y + r) * stride + bx, bw);
+    drawBatteryIcon(fg, bg, true, box, BATT_BOX_X, BATT_BOX_Y);
+    for (int16_t r = 0; r < BATT_BOX_H; r++)
+        memcpy(frame + (BATT_BOX_Y + r) * stride + bx, buf + r * bw, bw);
+}
 
-        int16_t x1, y1;
-        uint16_t w, h;
-        display.getTextBounds(upper.c_str(), 0, 0, &x1, &y1, &w, &h);
-        display.setCursor((200 - w) / 2 - x1, 120);
-        display.print(upper);
-
-        // second line for "DISTURB" when DND
-        if (strcmp(availability, "DoNotDisturb") == 0) {
-            display.getTextBounds("DISTURB", 0, 0, &x1, &y1, &w, &h);
-            display.setCursor((200 - w) / 2 - x1, 155);
-            display.print("DISTURB");
-        }
+// Same controller sequence as GxEPD2_BW's full-buffer page loop.  A
+// partial update may be limited to the rows [y, y + h) when the caller
+// knows nothing outside them differs from the glass.
+static void pushFrame(const uint8_t* frame, int8_t bg, int16_t y = 0, int16_t h = 200) {
+    // After a warm resume the driver has no shadow to diff against yet
+    uint32_t crc = esp_rom_crc32_le(0, frame, STATUS_FRAME_BYTES);
+    if (crc == s_frameCrc && bg == s_lastBg) {
+        Serial.println("[UI] Frame already on panel");
+        return;
+    }
+    s_frameCrc = crc;
+    if (nextRefreshPartial(true, bg)) {
+        const uint8_t* band = frame + y * (200 / 8);
+        display.epd2.writeImage(band, 0, y, 200, h);
+        display.epd2.refresh(0, y, 200, h);
+        display.epd2.writeImageAgain(band, 0, y, 200, h);
+    } else {
+        display.epd2.writeImageForFullRefresh(frame, 0, 0, 200, 200);
+        display.epd2.refresh(false);
+        display.epd2.writeImageAgain(frame, 0, 0, 200, 200);
+    }
+}
 
-        // --- activity detail ---
-        if (activity && strlen(activity) > 0 &&
-            strcmp(activity, availability) != 0) {
-            display.setFont(&FreeSansBold12pt7b);
-            String act(activity);
-            display.getTextBounds(act.c_str(), 0, 0, &x1, &y1, &w, &h);
-            // Fall back to 9pt bold if too wide
-            if (w > 190) {
-                display.setFont(&FreeSansBold9pt7b);
-                display.getTextBounds(act.c_str(), 0, 0, &x1, &y1, &w, &h);
-            }
-            display.setCursor((200 - w) / 2 - x1, 168);
-            display.print(act);
+void displayPrepareStatusFrames() {
+    uint32_t manifest = statusFramesManifest(FW_VERSION " " __DATE__ " " __TIME__);
+    if (statusFramesValid(manifest)) return;
+
+    unsigned long t0 = millis();
+    if (!statusFramesBeginRebuild()) return;
+    int bmps = 0;
+    for (int slot = 0; slot < FRAME_SLOT_COUNT; slot++) {
+        Availability avail;
+        Activity     act;
+        statusFrameCanonical(slot, avail, act);
+        FrameSource src = renderStatusFrame(avail, act, s_frame);
+        if (src == FRAME_BMP) bmps++;
+        if (src != FRAME_NONE) statusFramesPut(slot, src, avail, act, s_frame);
+    }
+    statusFramesCommit(manifest);
+    Serial.printf("[UI] Status frames rebuilt (%d BMP, %d drawn) in %lums\n",
+                  bmps, FRAME_SLOT_COUNT - bmps, millis() - t0);
+}
+
+void drawStatusScreen(Availability availability, Activity activity) {
+    FrameSource src = statusFramesGet(availability, activity, s_frame);
+    bool cached = (src != FRAME_NONE);
+    if (!cached) src = renderStatusFrame(availability, activity, s_frame);
+    if (src == FRAME_NONE) {
+        Serial.println("[UI] Status: no frame buffer");
+        return;
+    }
+
+    // BMPs get a black-on-white icon in their clear bottom-right area
+    bool inverted = (src == FRAME_DRAWN) && availabilityInfo(availability).inverted;
+    overlayBattery(s_frame, inverted ? GxEPD_WHITE : GxEPD_BLACK,
+                            inverted ? GxEPD_BLACK : GxEPD_WHITE);
+    pushFrame(s_frame, src == FRAME_BMP ? BG_IMAGE : inverted ? BG_BLACK : BG_WHITE);
+
+    if (src == FRAME_BMP)
+        Serial.printf("[UI] BMP Status: %s (%s) -> %s%s\n",
+                      availabilityName(availability), activityName(activity),
+                      statusFrameBmpPath(statusFrameSlot(availability, activity)),
+                      cached ? " [cached]" : "");
+    else
+        Serial.printf("[UI] Status: %s (%s)%s\n",
+                      availabilityName(availability), activityName(activity),
+                      cached ? " [cached]" : "");
+}
+
+// ============================================================================
+// Team Board — one row per member (team_board.h)
+//
+//   Busy / Do Not Disturb rows are inverted like the single-user screen.
+//   The whole board is rendered, but while it is already on the glass only
+//   the band from the first to the last changed row is sent and refreshed.
+// ============================================================================
+
+static int16_t teamRowHeight(int count) {
+    int16_t h = (count > 0) ? 200 / count : 200;
+    return (h > 50) ? 50 : h;
+}
+
+static void drawTeamRow(Adafruit_GFX& g, int row, int16_t rowH) {
+    const AvailabilityInfo& info = availabilityInfo(teamMemberAvailability(row));
+    bool inverted = info.inverted;
+    uint16_t bg = inverted ? GxEPD_BLACK : GxEPD_WHITE;
+    uint16_t fg = inverted ? GxEPD_WHITE : GxEPD_BLACK;
+    const int16_t y = row * rowH, cy = y + rowH / 2;
+
+    g.fillRect(0, y, 200, rowH, bg);
+    if (row > 0) g.drawFastHLine(0, y, 200, GxEPD_BLACK);   // row separator
+
+    // --- indicator dot ---
+    const int16_t cx = 13, cr = 7;
+    if (inverted || info.icon == ICON_TICK) {
+        g.fillCircle(cx, cy, cr, fg);
+        if (info.icon == ICON_BAR) g.fillRect(cx - 4, cy - 1, 9, 3, bg);
+    } else {
+        g.drawCircle(cx, cy, cr, fg);
+        if (info.icon == ICON_CLOCK) {
+            g.drawLine(cx, cy, cx,     cy - 4, fg);
+            g.drawLine(cx, cy, cx + 3, cy + 2, fg);
+        } else if (info.icon == ICON_CROSS) {
+            g.drawLine(cx - 3, cy - 3, cx + 3, cy + 3, fg);
+            g.drawLine(cx + 3, cy - 3, cx - 3, cy + 3, fg);
         }
+    }
 
-        // Battery icon (lower-right, large on status screen)
-        drawBatteryIcon(fg, bg, true);
+    int16_t x1, y1;
+    uint16_t w, h;
+    g.setTextColor(fg);
+
+    // --- status, right-aligned ---
+    const char* label = info.teamLabel;
+    g.setFont(&FreeSansBold9pt7b);
+    g.getTextBounds(label, 0, 0, &x1, &y1, &w, &h);
+    const int16_t labelX = 196 - w - x1;
+    g.setCursor(labelX, cy + 6);
+    g.print(label);
+
+    // --- name, cut to the space left ---
+    char name[16];
+    strncpy(name, teamMemberName(row), sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    g.setFont(&FreeSans9pt7b);
+    for (size_t n = strlen(name); n > 0; name[--n] = '\0') {
+        g.getTextBounds(name, 0, 0, &x1, &y1, &w, &h);
+        if (28 + x1 + (int16_t)w <= labelX - 6) break;
+    }
+    g.setCursor(28, cy + 6);
+    g.print(name);
+}
 
-        // border on light screens
-        if (!inverted)
-            display.drawRect(0, 0, 200, 200, fg);
+void drawTeamBoard(uint8_t changedRows) {
+    int count = teamBoardCount();
+    if (count == 0) return;
+    const int16_t rowH = teamRowHeight(count);
+    changedRows &= (uint8_t)((1u << count) - 1);
 
-    } while (display.nextPage());
+    GFXcanvas1 canvas(200, 200);
+    if (!canvas.getBuffer()) {
+        Serial.println("[UI] Team board: no frame buffer");
+        return;
+    }
+    canvas.fillScreen(GxEPD_WHITE);
+    canvas.setTextSize(1);
+    for (int i = 0; i < count; i++) drawTeamRow(canvas, i, rowH);
+    memcpy(s_frame, canvas.getBuffer(), STATUS_FRAME_BYTES);
+
+    // Another screen on the glass: send the whole board
+    if (s_lastBg != BG_BOARD || s_frameCrc == 0) {
+        pushFrame(s_frame, BG_BOARD);
+        Serial.printf("[UI] Team board: %d rows (full)\n", count);
+        return;
+    }
+    if (!changedRows) {
+        Serial.println("[UI] Team board unchanged");
+        return;
+    }
 
-    Serial.printf("[UI] Status: %s (%s)\n",
-                  availability, activity ? activity : "");
+    int first = 0, last = count - 1;
+    while (first < count && !(changedRows & (1u << first))) first++;
+    while (last > first && !(changedRows & (1u << last))) last--;
+    pushFrame(s_frame, BG_BOARD, first * rowH, (last - first + 1) * rowH);
+    Serial.printf("[UI] Team board: rows %d-%d of %d\n", first, last, count);
 }
 
 // ============================================================================
@@ -599,7 +821,7 @@ void drawStatusScreen(const char* availability, const char* activity) {
 // ============================================================================
 
 void drawErrorScreen(const char* title, const char* detail) {
-    display.setFullWindow();
+    beginWindow(false);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -642,7 +864,7 @@ void drawErrorScreen(const char* title, const char* detail) {
 // ============================================================================
 
 void drawShutdownScreen() {
-    display.setFullWindow();
+    beginWindow(false);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -673,7 +895,7 @@ void drawShutdownScreen() {
 // ============================================================================
 
 void drawLowBatteryScreen(int percent, bool critical) {
-    display.setFullWindow();
+    beginWindow(false);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -725,10 +947,7 @@ void drawMenuScreen(int selected, const PodSettings& settings,
     labels[MENU_REFRESH]    = "Refresh Now";
     labels[MENU_EXIT]       = "< Exit";
 
-    if (partial)
-        display.setPartialWindow(0, 0, 200, 200);
-    else
-        display.setFullWindow();
+    beginWindow(partial);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -783,21 +1002,22 @@ void drawSettingsScreen(int selected, const PodSettings& settings,
     const char* labels[SET_COUNT];
     static char lightLabel[24];
     static char pollLabel[24];
+    static char profileLabel[24];
     snprintf(lightLabel, sizeof(lightLabel), "Light: %s", lightTypeName(light.type));
     snprintf(pollLabel, sizeof(pollLabel), "Poll: %ds", settings.presenceInterval);
+    snprintf(profileLabel, sizeof(profileLabel), "Mode: %s",
+             pollProfileName(settings.pollProfile));
 
     labels[SET_LIGHT_TYPE]    = lightLabel;
     labels[SET_LIGHT_TEST]    = "Test Light";
     labels[SET_INVERT]        = settings.invertDisplay ? "Invert: ON"  : "Invert: OFF";
     labels[SET_AUDIO]         = settings.audioAlerts   ? "Audio: ON"   : "Audio: OFF";
     labels[SET_POLL_INTERVAL] = pollLabel;
+    labels[SET_POLL_PROFILE]  = profileLabel;
     labels[SET_BLE_SETUP]     = "BLE Setup";
     labels[SET_BACK]          = "< Back";
 
-    if (partial)
-        display.setPartialWindow(0, 0, 200, 200);
-    else
-        display.setFullWindow();
+    beginWindow(partial);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -812,12 +1032,12 @@ void drawSettingsScreen(int selected, const PodSettings& settings,
         // Separator
         display.drawLine(10, 32, 190, 32, GxEPD_BLACK);
 
-        // Settings items — 20px spacing to fit all items
+        // Settings items — 17px spacing to fit all items
         display.setFont(&FreeSansBold9pt7b);
         for (int i = 0; i < SET_COUNT; i++) {
-            int y = 52 + i * 20;
+            int y = 50 + i * 17;
             if (i == selected) {
-                display.fillRect(5, y - 13, 190, 18, GxEPD_BLACK);
+                display.fillRect(5, y - 13, 190, 17, GxEPD_BLACK);
                 display.setTextColor(GxEPD_WHITE);
             } else {
                 display.setTextColor(GxEPD_BLACK);
@@ -850,7 +1070,9 @@ void drawSettingsScreen(int selected, const PodSettings& settings,
 void drawDeviceInfoScreen(const char* ssid, const char* ip,
                           const char* clientId, const char* tenantId,
                           float battV, int battPct,
-                          bool outsideOfficeHours, bool partial)
+                          bool outsideOfficeHours,
+                          const char* profLine1, const char* profLine2,
+                          const char* heapLine, bool partial)
 {
     // Truncate long IDs
     char clientShort[20], tenantShort[20];
@@ -870,10 +1092,7 @@ void drawDeviceInfoScreen(const char* ssid, const char* ip,
         snprintf(timeBuf, sizeof(timeBuf), "No sync");
     }
 
-    if (partial)
-        display.setPartialWindow(0, 0, 200, 200);
-    else
-        display.setFullWindow();
+    beginWindow(partial);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -886,12 +1105,14 @@ void drawDeviceInfoScreen(const char* ssid, const char* ip,
         centerText("DEVICE INFO", 25);
         display.drawLine(10, 32, 190, 32, GxEPD_BLACK);
 
-        // Info rows (7 rows, size 2, 19px spacing)
+        // Info rows (7 rows, size 2, 19px spacing — 17px when the last row
+        // carries three small lines)
+        bool small = (profLine1 && profLine1[0]) || (heapLine && heapLine[0]);
         display.setFont(NULL);
         display.setTextSize(2);
         display.setTextColor(GxEPD_BLACK);
         int y = 42;
-        const int lineH = 19;
+        const int lineH = small ? 17 : 19;
 
         display.setCursor(6, y); display.printf("SSID:%s", ssid);
         y += lineH;
@@ -915,7 +1136,18 @@ void drawDeviceInfoScreen(const char* ssid, const char* ip,
 
         char verBuf[16];
         snprintf(verBuf, sizeof(verBuf), "v%s", FW_VERSION);
-        display.setCursor(6, y); display.printf("FW:%s", verBuf);
+        if (small) {
+            // Last row split into small lines: FW + wake profile, heap
+            display.setTextSize(1);
+            display.setCursor(6, y - 1);
+            display.printf("FW:%s %s", verBuf, profLine1 ? profLine1 : "");
+            display.setCursor(6, y + 8);
+            display.print(profLine2 ? profLine2 : "");
+            display.setCursor(6, y + 17);
+            display.print(heapLine ? heapLine : "");
+        } else {
+            display.setCursor(6, y); display.printf("FW:%s", verBuf);
+        }
 
         // Footer
         display.drawLine(10, 172, 190, 172, GxEPD_BLACK);
@@ -934,7 +1166,9 @@ void drawDeviceInfoScreen(const char* ssid, const char* ip,
 // ============================================================================
 
 void drawAuthInfoScreen(bool tokenValid, long expirySeconds,
-                        const char* lastStatus, bool partial)
+                        const char* lastStatus,
+                        const char* calLine, const char* sleepLine,
+                        bool partial)
 {
     char expiryBuf[32];
     if (!tokenValid) {
@@ -948,10 +1182,7 @@ void drawAuthInfoScreen(bool tokenValid, long expirySeconds,
         snprintf(expiryBuf, sizeof(expiryBuf), "%ld sec", expirySeconds);
     }
 
-    if (partial)
-        display.setPartialWindow(0, 0, 200, 200);
-    else
-        display.setFullWindow();
+    beginWindow(partial);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -982,6 +1213,17 @@ void drawAuthInfoScreen(bool tokenValid, long expirySeconds,
         display.setCursor(6, y);
         display.printf("Status:%s", lastStatus ? lastStatus : "Unknown");
 
+        // Calendar schedule (size 1, below the info rows)
+        display.setTextSize(1);
+        if (calLine) {
+            display.setCursor(6, 130);
+            display.print(calLine);
+        }
+        if (sleepLine) {
+            display.setCursor(6, 142);
+            display.print(sleepLine);
+        }
+
         // Footer
         display.drawLine(10, 160, 190, 160, GxEPD_BLACK);
         display.setTextSize(2);
@@ -1009,10 +1251,7 @@ void drawLightsScreen(int selected, const std::vector<LightDevice>& devs,
     const int itemH = 20;       // pixels per row
     const int startY = 50;      // first item baseline y
 
-    if (partial)
-        display.setPartialWindow(0, 0, 200, 200);
-    else
-        display.setFullWindow();
+    beginWindow(partial);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -1108,10 +1347,7 @@ void drawLightsScreen(int selected, const std::vector<LightDevice>& devs,
 void drawLightActionScreen(const LightDevice& dev, int selected, bool partial) {
     const char* labels[LACT_COUNT] = { "Test", "Provision", "< Back" };
 
-    if (partial)
-        display.setPartialWindow(0, 0, 200, 200);
-    else
-        display.setFullWindow();
+    beginWindow(partial);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -1174,7 +1410,7 @@ void drawLightActionScreen(const LightDevice& dev, int selected, bool partial) {
 // ============================================================================
 
 void drawProvisioningScreen(const char* step, const char* detail) {
-    display.setPartialWindow(0, 0, 200, 200);
+    beginWindow(true);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -1225,7 +1461,7 @@ void drawProvisioningScreen(const char* step, const char* detail) {
 // ============================================================================
 
 void drawProvisioningResult(bool success, const char* message) {
-    display.setPartialWindow(0, 0, 200, 200);
+    beginWindow(true);
     display.firstPage();
     do {
         display.fillScreen(GxEPD_WHITE);
@@ -1278,3 +1514,94 @@ void drawProvisioningResult(bool success, const char* message) {
     Serial.printf("[UI] Provisioning result: %s — %s\n",
                   success ? "OK" : "FAIL", message);
 }
+
+#ifdef POD_BENCH
+// ============================================================================
+// Bench (bench/bench.h) — status render, QR, and panel refresh timings
+//
+// The panel cases run with async refresh off, so a call covers the RAM
+// transfer and the whole BUSY wait; the driver's BUSY total is recorded
+// beside it.  Two white-background frames alternate so each partial
+// update has a real diff to send.
+// ============================================================================
+
+static const int BENCH_PANEL_ITERS = 4;
+
+void displayBench() {
+    GFXcanvas1 canvas(200, 200);
+    if (!canvas.getBuffer()) {
+        Serial.println("[Bench] No canvas — display cases skipped");
+        return;
+    }
+
+    // ---- Status screen: the drawing, the frame cache, the SD/drawn frame ----
+    benchRun("status_draw_available", 20,
+             [&] { drawStatusBody(canvas, AV_AVAILABLE, ACT_NONE); });
+    benchRun("status_draw_busy", 20,
+             [&] { drawStatusBody(canvas, AV_BUSY, ACT_IN_A_MEETING); });
+    benchRun("status_draw_dnd", 20,
+             [&] { drawStatusBody(canvas, AV_DO_NOT_DISTURB, ACT_PRESENTING); });
+    FrameSource got = FRAME_NONE;
+    benchRun("status_frame_cached", 50,
+             [&] { got = statusFramesGet(AV_BUSY, ACT_IN_A_MEETING, s_frame); },
+             STATUS_FRAME_BYTES, "byte");
+    if (got == FRAME_NONE) Serial.println("[Bench] status_frame_cached: miss (no frame store)");
+    benchRun("status_frame_render", 5,
+             [&] { got = renderStatusFrame(AV_BUSY, ACT_IN_A_MEETING, s_frame); });
+    Serial.printf("[Bench] status_frame_render: %s\n", got == FRAME_BMP ? "SD BMP" : "drawn");
+
+    // ---- QR: encode, then the module squares into the page buffer ----
+    uint8_t qrData[qrcode_getBufferSize(10)];
+    QRCode  qr;
+    int setupVer = selectQRVersion(strlen(SETUP_URL), 1);
+    benchRun("qr_encode_setup", 20,
+             [&] { qrcode_initText(&qr, qrData, setupVer, ECC_MEDIUM, SETUP_URL); });
+    int scale = (200 - 24 - 24) / qr.size;
+    display.setFullWindow();
+    benchRun("qr_draw_setup", 20, [&] {
+        display.fillScreen(GxEPD_WHITE);
+        drawQRModules(qr, (200 - qr.size * scale) / 2, 24, scale);
+    }, (uint32_t)(qr.size * qr.size), "module");
+
+    const char* authUrl = "https://microsoft.com/devicelogin";   // DeviceCodeResponse::qr_url
+    int authVer = selectQRVersion(strlen(authUrl), 0);
+    benchRun("qr_encode_auth", 20,
+             [&] { qrcode_initText(&qr, qrData, authVer, ECC_LOW, authUrl); });
+    scale = max(2, 200 / (qr.size + 8));
+    benchRun("qr_draw_auth", 20, [&] {
+        display.fillScreen(GxEPD_WHITE);
+        drawQRModules(qr, (200 - qr.size * scale) / 2, scale * 4, scale);
+    }, (uint32_t)(qr.size * qr.size), "module");
+
+    // ---- Panel: full vs partial refresh ----
+    static uint8_t alt[STATUS_FRAME_BYTES];
+    renderStatusFrame(AV_AVAILABLE, ACT_NONE, s_frame);
+    renderStatusFrame(AV_AWAY, ACT_NONE, alt);
+    WS_EPD154V2& epd = display.epd2;
+    epd.setAsyncRefresh(false);
+    int n = 0;
+
+    uint32_t busy0 = epd.refreshBusyMs();
+    benchRun("epd_full", BENCH_PANEL_ITERS, [&] {
+        const uint8_t* f = (n++ & 1) ? alt : s_frame;
+        epd.writeImageForFullRefresh(f, 0, 0, 200, 200);
+        epd.refresh(false);
+        epd.writeImageAgain(f, 0, 0, 200, 200);
+    });
+    benchRecordMs("epd_full_busy", BENCH_PANEL_ITERS, epd.refreshBusyMs() - busy0);
+
+    busy0 = epd.refreshBusyMs();
+    benchRun("epd_partial", BENCH_PANEL_ITERS, [&] {
+        const uint8_t* f = (n++ & 1) ? alt : s_frame;
+        epd.writeImage(f, 0, 0, 200, 200);
+        epd.refresh(0, 0, 200, 200);
+        epd.writeImageAgain(f, 0, 0, 200, 200);
+    });
+    benchRecordMs("epd_partial_busy", BENCH_PANEL_ITERS, epd.refreshBusyMs() - busy0);
+
+    // The glass no longer matches the bookkeeping — next screen is full
+    s_frameCrc     = 0;
+    s_lastBg       = BG_UNKNOWN;
+    s_partialCount = 0;
+}
+#endif
@@ -0,0 +1,430 @@
+// ============================================================================
+// HTTPS Connection Manager — shared TLS clients for Graph, login and Zoom
+//
+// Arduino-ESP32 2.0's ssl_client does the whole handshake inside connect()
+// with no hook for restoring a saved mbedTLS session, so tickets can't be
+// carried across deep sleep.  What we can do is keep sockets alive within
+// a wake and across USB-mode polls, and log every full handshake so the
+// remaining cost is visible.
+// ============================================================================
+
+#include "https_conn.h"
+#include "wake_profiler.h"
+#include "power_policy.h"
+#include "tls_roots.h"
+#include <WiFiClientSecure.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#ifdef POD_TLS_CA_BUNDLE
+// Mozilla CA bundle embedded via board_build.embed_files
+extern const uint8_t x509_crt_bundle_start[] asm("_binary_data_cert_x509_crt_bundle_bin_start");
+#endif
+
+// ---- Known hosts — one keep-alive client each ------------------------------
+struct KnownHost {
+    const char* name;
+    const char* roots;      // pinned root CAs (tls_roots.h)
+};
+static const KnownHost HOSTS[] = {
+    { "graph.microsoft.com",       TLS_ROOTS_MICROSOFT },
+    { "login.microsoftonline.com", TLS_ROOTS_MICROSOFT },
+    { "api.zoom.us",               TLS_ROOTS_ZOOM },
+    { "zoom.us",                   TLS_ROOTS_ZOOM },
+};
+static const int HOST_COUNT = sizeof(HOSTS) / sizeof(HOSTS[0]);
+static const int SLOT_OTHER = HOST_COUNT;     // any other host, not kept
+
+// Each open TLS session holds ~40 KB of mbedTLS buffers — cap them
+static const int MAX_OPEN           = 2;
+static const int HANDSHAKE_TIMEOUT  = 10;     // seconds
+
+static WiFiClientSecure s_clients[HOST_COUNT + 1];
+static bool             s_configured[HOST_COUNT + 1] = {};
+static unsigned long    s_lastUsed[HOST_COUNT + 1]   = {};
+static String           s_otherHost;
+
+// Requests in flight, keyed by the caller's HTTPClient (set by httpsBegin,
+// used by httpsSend).  Teams+Zoom polls two hosts from two tasks at once;
+// one request per host at a time.
+struct ActiveReq {
+    const HTTPClient* http;
+    int  slot;
+    bool reused;
+};
+static const int MAX_ACTIVE = 2;
+static ActiveReq s_active[MAX_ACTIVE] = {};
+
+// Guards the slot table and stats (never held across a handshake)
+static SemaphoreHandle_t connMutex() {
+    static SemaphoreHandle_t m = nullptr;
+    static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+    if (!m) {
+        SemaphoreHandle_t n = xSemaphoreCreateMutex();
+        portENTER_CRITICAL(&mux);
+        if (!m) { m = n; n = nullptr; }
+        portEXIT_CRITICAL(&mux);
+        if (n) vSemaphoreDelete(n);
+    }
+    return m;
+}
+
+class ConnLock
+{
+  public:
+    ConnLock()  { xSemaphoreTake(connMutex(), portMAX_DELAY); }
+    ~ConnLock() { xSemaphoreGive(connMutex()); }
+};
+
+static ActiveReq* findActive(const HTTPClient* http) {
+    for (int i = 0; i < MAX_ACTIVE; i++)
+        if (s_active[i].http == http) return &s_active[i];
+    return nullptr;
+}
+
+// A request holds the CPU at full speed from httpsBegin() to httpsEnd():
+// handshake, record encryption and body decryption all run under it
+static void claimReq(ActiveReq* r, const HTTPClient* http) {
+    r->http = http;
+    powerLockAcquire(PM_LOCK_CPU_MAX);
+}
+
+static void releaseReq(ActiveReq* r) {
+    if (!r || !r->http) return;
+    r->http = nullptr;
+    powerLockRelease(PM_LOCK_CPU_MAX);
+}
+
+static bool slotBusy(int slot) {
+    for (int i = 0; i < MAX_ACTIVE; i++)
+        if (s_active[i].http && s_active[i].slot == slot) return true;
+    return false;
+}
+
+// ---- Stats ----
+static uint32_t s_handshakes  = 0;
+static uint32_t s_handshakeMs = 0;
+static uint32_t s_handshakeMax = 0;
+static uint32_t s_reused      = 0;
+
+// ----------------------------------------------------------------------------
+static String urlHost(const String& url) {
+    int start = url.indexOf("://");
+    start = (start < 0) ? 0 : start + 3;
+    int end = url.indexOf('/', start);
+    if (end < 0) end = url.length();
+    return url.substring(start, end);
+}
+
+static const char* slotHost(int slot) {
+    return (slot == SLOT_OTHER) ? s_otherHost.c_str() : HOSTS[slot].name;
+}
+
+static void configureSlot(int slot) {
+    if (s_configured[slot]) return;
+    WiFiClientSecure& c = s_clients[slot];
+#if defined(POD_TLS_INSECURE)
+    c.setInsecure();            // debugging only — see platformio.ini
+#elif defined(POD_TLS_CA_BUNDLE)
+    c.setCACertBundle(x509_crt_bundle_start);
+#else
+    c.setCACert(slot == SLOT_OTHER ? TLS_ROOTS_ALL : HOSTS[slot].roots);
+#endif
+    c.setHandshakeTimeout(HANDSHAKE_TIMEOUT);
+    s_configured[slot] = true;
+}
+
+// Close the least recently used idle connection when too many are open
+static void enforceOpenLimit(int keep) {
+    int open = 0, lru = -1;
+    for (int i = 0; i <= HOST_COUNT; i++) {
+        if (i == keep || !s_clients[i].connected()) continue;
+        open++;
+        if (slotBusy(i)) continue;      // another task's request
+        if (lru < 0 || s_lastUsed[i] < s_lastUsed[lru]) lru = i;
+    }
+    if (open >= MAX_OPEN && lru >= 0) {
+        Serial.printf("[HTTPS] Closing idle %s\n", slotHost(lru));
+        s_clients[lru].stop();
+    }
+}
+
+static bool connectSlot(int slot) {
+    {
+        ConnLock lock;
+        enforceOpenLimit(slot);
+        configureSlot(slot);
+    }
+
+    const char* host = slotHost(slot);
+    unsigned long t0 = millis();
+    if (!s_clients[slot].connect(host, 443)) {
+        Serial.printf("[HTTPS] %s: connect failed after %lums\n",
+                      host, millis() - t0);
+        return false;
+    }
+    uint32_t dt = millis() - t0;
+    wakeProfAdd(WP_TLS, dt);
+    uint32_t n;
+    {
+        ConnLock lock;
+        n = ++s_handshakes;
+        s_handshakeMs += dt;
+        if (dt > s_handshakeMax) s_handshakeMax = dt;
+    }
+    Serial.printf("[HTTPS] %s: handshake %ums (#%u)\n",
+                  host, (unsigned)dt, (unsigned)n);
+    return true;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool httpsBegin(HTTPClient& http, const String& url) {
+    String host = urlHost(url);
+    int slot = SLOT_OTHER;
+    for (int i = 0; i < HOST_COUNT; i++) {
+        if (host.equalsIgnoreCase(HOSTS[i].name)) { slot = i; break; }
+    }
+
+    ActiveReq* req = nullptr;
+    {
+        ConnLock lock;
+        releaseReq(findActive(&http));    // begun again without httpsEnd()
+        if (slotBusy(slot)) {
+            Serial.printf("[HTTPS] %s: request already in flight\n", host.c_str());
+            return false;
+        }
+        if (slot == SLOT_OTHER && !host.equalsIgnoreCase(s_otherHost)) {
+            s_clients[SLOT_OTHER].stop();
+            s_otherHost = host;
+        }
+        req = findActive(nullptr);
+        if (!req) {
+            Serial.printf("[HTTPS] %s: too many requests in flight\n", host.c_str());
+            return false;
+        }
+        claimReq(req, &http);
+        req->slot   = slot;
+        req->reused = s_clients[slot].connected();
+        if (req->reused) s_reused++;
+    }
+    if (req->reused) {
+        Serial.printf("[HTTPS] %s: reusing connection\n", host.c_str());
+    } else if (!connectSlot(slot)) {
+        ConnLock lock;
+        releaseReq(req);
+        return false;
+    }
+    s_lastUsed[slot] = millis();
+
+    // HttpsBody needs to know whether the response is chunked
+    static const char* bodyHeaders[] = { "Transfer-Encoding" };
+    http.setReuse(true);
+    if (!http.begin(s_clients[slot], url)) {
+        ConnLock lock;
+        releaseReq(req);
+        return false;
+    }
+    http.collectHeaders(bodyHeaders, 1);
+    return true;
+}
+
+int httpsSend(HTTPClient& http, const char* method, const String& body) {
+    return httpsSend(http, method, body.c_str(), body.length());
+}
+
+int httpsSend(HTTPClient& http, const char* method, const char* body, size_t len) {
+    uint8_t* payload = (uint8_t*)body;
+    unsigned long t0 = millis();
+    int code = http.sendRequest(method, payload, len);
+    wakeProfAdd(WP_HTTP, millis() - t0);
+    ActiveReq* req;
+    {
+        ConnLock lock;
+        req = findActive(&http);
+    }
+    if (code < 0 && req && req->reused) {
+        // Server dropped the idle keep-alive socket — one fresh attempt
+        Serial.printf("[HTTPS] %s: stale connection (%d) — reconnecting\n",
+                      slotHost(req->slot), code);
+        s_clients[req->slot].stop();
+        req->reused = false;
+        if (connectSlot(req->slot)) {
+            t0 = millis();
+            code = http.sendRequest(method, payload, len);
+            wakeProfAdd(WP_HTTP, millis() - t0);
+        }
+    }
+    return code;
+}
+
+void httpsAddBearer(HTTPClient& http, const char* token) {
+    StrBuf auth(7 + strlen(token));
+    auth.print("Bearer ");
+    auth.print(token);
+    http.addHeader("Authorization", auth.c_str());
+}
+
+void httpsReadError(HTTPClient& http, StrBuf& out) {
+    HttpsBody body(http);
+    out.readFrom(body);
+    body.drain();
+}
+
+void httpsEnd(HTTPClient& http) {
+    http.end();
+    ConnLock lock;
+    ActiveReq* req = findActive(&http);
+    if (!req) return;
+    s_lastUsed[req->slot] = millis();
+    releaseReq(req);
+}
+
+void httpsCloseAll() {
+    for (int i = 0; i <= HOST_COUNT; i++) {
+        if (s_clients[i].connected()) s_clients[i].stop();
+    }
+}
+
+void httpsLogTlsMode() {
+#if defined(POD_TLS_INSECURE)
+    Serial.println("[HTTPS] WARNING: insecure build — certificates are NOT verified "
+                   "(-DPOD_TLS_INSECURE)");
+#elif defined(POD_TLS_CA_BUNDLE)
+    Serial.println("[HTTPS] Certificates verified against the embedded CA bundle");
+#else
+    Serial.println("[HTTPS] Certificates verified against the pinned roots");
+#endif
+}
+
+void httpsLogStats() {
+    Serial.printf("[HTTPS] %u handshakes (avg %ums, max %ums), %u reused\n",
+                  (unsigned)s_handshakes,
+                  (unsigned)(s_handshakes ? s_handshakeMs / s_handshakes : 0),
+                  (unsigned)s_handshakeMax, (unsigned)s_reused);
+}
+
+// ============================================================================
+// HttpsBody
+// ============================================================================
+
+HttpsBody::HttpsBody(HTTPClient& http, unsigned long timeoutMs)
+    : _client(http.getStreamPtr()),
+      _chunked(http.header("Transfer-Encoding").equalsIgnoreCase("chunked")),
+      _left(_chunked ? 0 : http.getSize()),
+      _eof(_client == nullptr || (!_chunked && _left == 0)),
+      _pos(0), _len(0), _total(0), _start(millis())
+{
+    setTimeout(timeoutMs);
+}
+
+// One byte off the socket, waiting up to the stream timeout
+int HttpsBody::_rawRead() {
+    unsigned long t0 = millis();
+    do {
+        int c = _client->read();
+        if (c >= 0) return c;
+        if (!_client->connected() && !_client->available()) return -1;
+        delay(1);
+    } while (millis() - t0 < _timeout);
+    return -1;
+}
+
+// Parse "<hex>[;ext]\r\n" (after the CRLF that ends the previous chunk)
+bool HttpsBody::_nextChunk() {
+    long size = 0;
+    bool digits = false, ext = false;
+    while (true) {
+        int c = _rawRead();
+        if (c < 0) return false;
+        if (c == '\n') {
+            if (!digits) continue;               // CRLF after previous chunk data
+            break;
+        }
+        if (c == '\r' || ext) continue;
+        if (c == ';') { ext = true; continue; }
+        int v = (c >= '0' && c <= '9') ? c - '0'
+              : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+              : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (v < 0) return false;
+        size = size * 16 + v;
+        digits = true;
+    }
+    if (size == 0) {
+        // Last chunk — consume the (empty) trailer line
+        int prev = 0, c;
+        while ((c = _rawRead()) >= 0) {
+            if (c == '\n' && prev == '\r') break;
+            prev = c;
+        }
+        return false;
+    }
+    _left = size;
+    return true;
+}
+
+bool HttpsBody::_fill() {
+    if (_pos < _len) return true;
+    if (_eof) return false;
+    if (_chunked && _left == 0 && !_nextChunk()) { _eof = true; return false; }
+
+    size_t want = sizeof(_buf);
+    if (_left >= 0 && (size_t)_left < want) want = (size_t)_left;
+
+    unsigned long t0 = millis();
+    int n = 0;
+    while (true) {
+        n = _client->read(_buf, want);
+        if (n > 0) break;
+        if ((!_client->connected() && !_client->available()) ||
+            millis() - t0 >= _timeout) {
+            _eof = true;
+            return false;
+        }
+        delay(1);
+    }
+    _pos = 0;
+    _len = n;
+    _total += n;
+    if (_left >= 0) {
+        _left -= n;
+        if (!_chunked && _left == 0) _eof = true;
+    }
+    return true;
+}
+
+int HttpsBody::available() {
+    if (_pos < _len) return _len - _pos;
+    if (_eof) return 0;
+    int a = _client->available();
+    if (_left >= 0 && a > _left) a = _left;
+    return a;
+}
+
+int HttpsBody::read() {
+    return _fill() ? _buf[_pos++] : -1;
+}
+
+int HttpsBody::peek() {
+    return _fill() ? _buf[_pos] : -1;
+}
+
+size_t HttpsBody::readBytes(char* buffer, size_t length) {
+    size_t done = 0;
+    while (done < length && _fill()) {
+        size_t n = _len - _pos;
+        if (n > length - done) n = length - done;
+        memcpy(buffer + done, _buf + _pos, n);
+        _pos  += n;
+        done  += n;
+    }
+    return done;
+}
+
+void HttpsBody::drain() {
+    _pos = _len;
+    while (_fill()) _pos = _len;
+    wakeProfAdd(WP_JSON, millis() - _start);   // streaming + parse
+}
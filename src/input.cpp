@@ -0,0 +1,160 @@
+// ============================================================================
+// Input — debounced button events from GPIO interrupts
+// ============================================================================
+
+#include "input.h"
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/timers.h>
+
+#define INPUT_QUEUE_LEN 8
+
+struct ButtonState {
+    gpio_num_t    pin;
+    TimerHandle_t debounce;
+    TimerHandle_t longPress;
+    volatile bool held;         // debounced, written by the timer task only
+    TickType_t    pressedAt;
+};
+
+static ButtonState   s_btn[BTN_COUNT] = {};
+static QueueHandle_t s_events = nullptr;
+
+static uint32_t sincePress(const ButtonState& s) {
+    return (uint32_t)((xTaskGetTickCount() - s.pressedAt) * portTICK_PERIOD_MS);
+}
+
+static void post(PodButton b, ButtonAction a, uint32_t heldMs) {
+    ButtonEvent ev = { b, a, heldMs };
+    // Full means nobody is reading — dropping the newest is harmless
+    xQueueSend(s_events, &ev, 0);
+}
+
+// Arm the pin for the level it isn't at (buttons are active low)
+static void arm(ButtonState& s) {
+    gpio_int_type_t level = s.held ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL;
+    gpio_set_intr_type(s.pin, level);
+    gpio_wakeup_enable(s.pin, level);
+    gpio_intr_enable(s.pin);
+}
+
+static void IRAM_ATTR buttonIsr(void* arg) {
+    ButtonState* s = (ButtonState*)arg;
+    // Level-triggered: mask until the debounce timer has looked at the pin
+    gpio_intr_disable(s->pin);
+    BaseType_t woken = pdFALSE;
+    xTimerResetFromISR(s->debounce, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+// ---- Timer task callbacks ----
+
+static void debounceTimer(TimerHandle_t t) {
+    PodButton    b = (PodButton)(intptr_t)pvTimerGetTimerID(t);
+    ButtonState& s = s_btn[b];
+
+    bool down = gpio_get_level(s.pin) == 0;
+    if (down != s.held) {
+        s.held = down;
+        if (down) {
+            s.pressedAt = xTaskGetTickCount();
+            xTimerReset(s.longPress, 0);
+            post(b, BTN_PRESS, 0);
+        } else {
+            xTimerStop(s.longPress, 0);
+            post(b, BTN_RELEASE, sincePress(s));
+        }
+    }
+    arm(s);
+}
+
+static void longPressTimer(TimerHandle_t t) {
+    PodButton b = (PodButton)(intptr_t)pvTimerGetTimerID(t);
+    if (s_btn[b].held) post(b, BTN_LONG, sincePress(s_btn[b]));
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool inputInit(int bootPin, int pwrPin) {
+    if (s_events) return true;
+
+    s_events = xQueueCreate(INPUT_QUEUE_LEN, sizeof(ButtonEvent));
+    if (!s_events) {
+        Serial.println("[Input] Queue alloc failed");
+        return false;
+    }
+
+    // Already installed is fine (another driver got there first)
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        Serial.printf("[Input] ISR service failed: %d\n", (int)err);
+        return false;
+    }
+
+    const int pins[BTN_COUNT] = { bootPin, pwrPin };
+    for (int b = 0; b < BTN_COUNT; b++) {
+        ButtonState& s = s_btn[b];
+        s.pin       = (gpio_num_t)pins[b];
+        s.debounce  = xTimerCreate("btn_db", pdMS_TO_TICKS(INPUT_DEBOUNCE_MS), pdFALSE,
+                                   (void*)(intptr_t)b, debounceTimer);
+        s.longPress = xTimerCreate("btn_long", pdMS_TO_TICKS(INPUT_LONG_MS), pdFALSE,
+                                   (void*)(intptr_t)b, longPressTimer);
+        if (!s.debounce || !s.longPress) {
+            Serial.println("[Input] Timer alloc failed");
+            return false;
+        }
+
+        s.held      = gpio_get_level(s.pin) == 0;
+        s.pressedAt = xTaskGetTickCount();
+        if (s.held) {
+            // Held through boot (e.g. the press that woke us) counts as a press
+            xTimerStart(s.longPress, 0);
+            post((PodButton)b, BTN_PRESS, 0);
+        }
+
+        gpio_isr_handler_add(s.pin, buttonIsr, &s);
+        arm(s);
+    }
+
+    esp_sleep_enable_gpio_wakeup();
+    Serial.printf("[Input] Buttons on GPIO %d / %d (interrupt + %d ms debounce)\n",
+                  bootPin, pwrPin, INPUT_DEBOUNCE_MS);
+    return true;
+}
+
+bool inputWait(ButtonEvent& ev, uint32_t timeoutMs) {
+    if (!s_events) {
+        delay(timeoutMs == INPUT_FOREVER ? 100 : timeoutMs);
+        return false;
+    }
+    TickType_t ticks = (timeoutMs == INPUT_FOREVER) ? portMAX_DELAY
+                                                    : pdMS_TO_TICKS(timeoutMs);
+    return xQueueReceive(s_events, &ev, ticks) == pdTRUE;
+}
+
+PodButton inputWaitPress() {
+    ButtonEvent ev;
+    while (true) {
+        if (inputWait(ev, INPUT_FOREVER) && ev.action == BTN_PRESS) return ev.button;
+    }
+}
+
+void inputWaitRelease(PodButton b) {
+    ButtonEvent ev;
+    while (inputHeld(b)) {
+        if (inputWait(ev, INPUT_FOREVER) && ev.button == b && ev.action == BTN_RELEASE)
+            return;
+    }
+}
+
+bool inputHeld(PodButton b) {
+    return b < BTN_COUNT && s_btn[b].held;
+}
+
+void inputFlush() {
+    if (s_events) xQueueReset(s_events);
+}
@@ -1,12 +1,18 @@
 // ============================================================================
 // Light Control — WLED, Tasmota, Philips Hue, WiZ Connected
+//
+// Each backend queues its request on the fan-out engine (light_fanout.h);
+// lightSetColor() runs it with the shared deadline and records the result
+// in light_state.h, so presence updates skip a light already showing the
+// colour and back off from one that isn't answering.
 // ============================================================================
 
 #include "light_control.h"
 #include "light_devices.h"
 #include "sd_storage.h"
-#include <HTTPClient.h>
-#include <WiFiUdp.h>
+#include "config_snapshot.h"
+#include "light_fanout.h"
+#include "light_state.h"
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include <WiFi.h>
@@ -86,91 +92,42 @@ void saveLightConfig(const LightConfig& cfg) {
     } else {
         Serial.println("[Light] WARNING: SD not mounted, light config not saved");
     }
+    configSnapshotUpdateLight(cfg);
+    lightStateClear();   // brightness or target may differ — resend next time
     Serial.printf("[Light] Saved: type=%s ip=%s bright=%d\n",
                   lightTypeName(cfg.type), cfg.ip.c_str(), cfg.brightness);
 }
 
-// ============================================================================
-// Presence → RGB colour mapping
-// ============================================================================
-
-static void presenceToRGB(const char* availability, uint8_t& r, uint8_t& g, uint8_t& b) {
-    if (strcmp(availability, "Available") == 0) {
-        r = 0; g = 255; b = 0;         // green
-    } else if (strcmp(availability, "Busy") == 0) {
-        r = 255; g = 0; b = 0;         // red
-    } else if (strcmp(availability, "DoNotDisturb") == 0) {
-        r = 255; g = 0; b = 0;         // red
-    } else if (strcmp(availability, "Away") == 0 ||
-               strcmp(availability, "BeRightBack") == 0) {
-        r = 255; g = 191; b = 0;       // amber/yellow
-    } else if (strcmp(availability, "Offline") == 0) {
-        r = 0; g = 0; b = 0;           // off
-    } else {
-        r = 80; g = 80; b = 80;        // dim white for unknown
-    }
-}
-
 // ============================================================================
 // WLED — JSON API (http://<ip>/json/state)
 // ============================================================================
 
-static bool wled_setColor(const char* ip, uint8_t r, uint8_t g, uint8_t b, int brightness) {
-    if (WiFi.status() != WL_CONNECTED) return false;
-
-    HTTPClient http;
-    String url = String("http://") + ip + "/json/state";
-    http.begin(url);
-    http.addHeader("Content-Type", "application/json");
-    http.setTimeout(3000);
-
+static int wled_queueColor(const char* ip, uint8_t r, uint8_t g, uint8_t b, int brightness) {
     char payload[128];
     bool on = (r > 0 || g > 0 || b > 0);
     snprintf(payload, sizeof(payload),
              "{\"on\":%s,\"bri\":%d,\"seg\":[{\"col\":[[%d,%d,%d]]}]}",
              on ? "true" : "false", brightness, r, g, b);
 
-    Serial.printf("[WLED] POST %s  %s\n", url.c_str(), payload);
-    int code = http.POST(payload);
-    http.end();
-
-    if (code == 200) {
-        Serial.println("[WLED] OK");
-        return true;
-    }
-    Serial.printf("[WLED] Failed: HTTP %d\n", code);
-    return false;
+    Serial.printf("[WLED] POST http://%s/json/state  %s\n", ip, payload);
+    return fanoutHttp(ip, "POST", "/json/state", payload);
 }
 
 // ============================================================================
 // Smart Bulb — Tasmota HTTP colour API
 // ============================================================================
 
-static bool bulb_setColor(const char* ip, uint8_t r, uint8_t g, uint8_t b) {
-    if (WiFi.status() != WL_CONNECTED) return false;
-
-    HTTPClient http;
-    char url[128];
+static int bulb_queueColor(const char* ip, uint8_t r, uint8_t g, uint8_t b) {
+    char path[64];
 
     if (r == 0 && g == 0 && b == 0) {
-        snprintf(url, sizeof(url), "http://%s/cm?cmnd=Power%%20Off", ip);
+        snprintf(path, sizeof(path), "/cm?cmnd=Power%%20Off");
     } else {
-        snprintf(url, sizeof(url), "http://%s/cm?cmnd=Color%%20%02X%02X%02X", ip, r, g, b);
+        snprintf(path, sizeof(path), "/cm?cmnd=Color%%20%02X%02X%02X", r, g, b);
     }
 
-    http.begin(url);
-    http.setTimeout(3000);
-
-    Serial.printf("[Bulb] GET %s\n", url);
-    int code = http.GET();
-    http.end();
-
-    if (code == 200) {
-        Serial.println("[Bulb] OK");
-        return true;
-    }
-    Serial.printf("[Bulb] Failed: HTTP %d\n", code);
-    return false;
+    Serial.printf("[Bulb] GET http://%s%s\n", ip, path);
+    return fanoutHttp(ip, "GET", path);
 }
 
 // ============================================================================
@@ -207,16 +164,10 @@ static void rgbToHueXY(uint8_t r8, uint8_t g8, uint8_t b8,
     if (bri < 1 && (r8 > 0 || g8 > 0 || b8 > 0)) bri = 1;
 }
 
-static bool hue_setColor(const char* ip, const char* apiKey, const char* lightId,
-                         uint8_t r, uint8_t g, uint8_t b) {
-    if (WiFi.status() != WL_CONNECTED) return false;
-
-    HTTPClient http;
-    char url[192];
-    snprintf(url, sizeof(url), "http://%s/api/%s/lights/%s/state", ip, apiKey, lightId);
-    http.begin(url);
-    http.addHeader("Content-Type", "application/json");
-    http.setTimeout(3000);
+static int hue_queueColor(const char* ip, const char* apiKey, const char* lightId,
+                          uint8_t r, uint8_t g, uint8_t b) {
+    char path[160];
+    snprintf(path, sizeof(path), "/api/%s/lights/%s/state", apiKey, lightId);
 
     char payload[96];
     if (r == 0 && g == 0 && b == 0) {
@@ -229,16 +180,8 @@ static bool hue_setColor(const char* ip, const char* apiKey, const char* lightId
                  "{\"on\":true,\"bri\":%d,\"xy\":[%.4f,%.4f]}", bri, x, y);
     }
 
-    Serial.printf("[Hue] PUT %s  %s\n", url, payload);
-    int code = http.PUT(payload);
-    http.end();
-
-    if (code == 200) {
-        Serial.println("[Hue] OK");
-        return true;
-    }
-    Serial.printf("[Hue] Failed: HTTP %d\n", code);
-    return false;
+    Serial.printf("[Hue] PUT http://%s%s  %s\n", ip, path, payload);
+    return fanoutHttp(ip, "PUT", path, payload);
 }
 
 // ============================================================================
@@ -248,11 +191,7 @@ static bool hue_setColor(const char* ip, const char* apiKey, const char* lightId
 // {"method":"setPilot","params":{"r":R,"g":G,"b":B,"dimming":D}}
 // ============================================================================
 
-static WiFiUDP wizUdp;
-
-static bool wiz_setColor(const char* ip, uint8_t r, uint8_t g, uint8_t b, int brightness) {
-    if (WiFi.status() != WL_CONNECTED) return false;
-
+static int wiz_queueColor(const char* ip, uint8_t r, uint8_t g, uint8_t b, int brightness) {
     char payload[128];
     if (r == 0 && g == 0 && b == 0) {
         snprintf(payload, sizeof(payload),
@@ -265,26 +204,20 @@ static bool wiz_setColor(const char* ip, uint8_t r, uint8_t g, uint8_t b, int br
     }
 
     Serial.printf("[WiZ] UDP %s:38899  %s\n", ip, payload);
+    return fanoutUdp(ip, 38899, payload);
+}
 
-    IPAddress addr;
-    if (!addr.fromString(ip)) {
-        Serial.println("[WiZ] Invalid IP");
-        return false;
-    }
-
-    wizUdp.beginPacket(addr, 38899);
-    wizUdp.print(payload);
-    bool ok = wizUdp.endPacket();
-
-    Serial.printf("[WiZ] %s\n", ok ? "OK" : "Send failed");
-    return ok;
+// State-cache key for the configured single device (Hue: which light)
+static String configTargetId(const LightConfig& cfg) {
+    if (cfg.type != LIGHT_HUE) return String();
+    return cfg.aux.isEmpty() ? String("1") : cfg.aux;
 }
 
 // ============================================================================
 // Public API
 // ============================================================================
 
-void lightSetPresence(const LightConfig& cfg, const char* availability) {
+void lightSetPresence(const LightConfig& cfg, Availability availability, Activity activity) {
     if (cfg.type == LIGHT_NONE) return;
 
     // WLED: use preset swarm if any WLED devices are in the device list
@@ -295,7 +228,7 @@ void lightSetPresence(const LightConfig& cfg, const char* availability) {
             if (d.type == LIGHT_WLED) { hasSwarm = true; break; }
         }
         if (hasSwarm) {
-            int preset = wledPresetForPresence(availability);
+            int preset = presenceWledPreset(availability, activity);
             wledActivatePresetAll(preset);
             return;
         }
@@ -303,31 +236,50 @@ void lightSetPresence(const LightConfig& cfg, const char* availability) {
 
     // Legacy path: direct RGB for configured single device
     if (cfg.ip.isEmpty()) return;
-    uint8_t r, g, b;
-    presenceToRGB(availability, r, g, b);
+    const AvailabilityInfo& info = availabilityInfo(availability);
+    uint8_t r = info.r, g = info.g, b = info.b;
+
+    String id = configTargetId(cfg);
+    if (lightStateCurrent(cfg.ip, id, lightStateRGB(r, g, b))) {
+        Serial.printf("[%s] Already showing %s\n", lightTypeName(cfg.type), info.name);
+        return;
+    }
+    if (!lightStateDue(cfg.ip, id)) {
+        Serial.printf("[%s] Not responding — skipped until retry\n", lightTypeName(cfg.type));
+        return;
+    }
     lightSetColor(cfg, r, g, b);
 }
 
 void lightSetColor(const LightConfig& cfg, uint8_t r, uint8_t g, uint8_t b) {
     if (cfg.type == LIGHT_NONE || cfg.ip.isEmpty()) return;
+    if (WiFi.status() != WL_CONNECTED) return;
 
+    fanoutReset();
+    int job = -1;
     switch (cfg.type) {
         case LIGHT_WLED:
-            wled_setColor(cfg.ip.c_str(), r, g, b, cfg.brightness);
+            job = wled_queueColor(cfg.ip.c_str(), r, g, b, cfg.brightness);
             break;
         case LIGHT_BULB:
-            bulb_setColor(cfg.ip.c_str(), r, g, b);
+            job = bulb_queueColor(cfg.ip.c_str(), r, g, b);
             break;
         case LIGHT_HUE:
-            hue_setColor(cfg.ip.c_str(), cfg.key.c_str(),
-                         cfg.aux.isEmpty() ? "1" : cfg.aux.c_str(), r, g, b);
+            job = hue_queueColor(cfg.ip.c_str(), cfg.key.c_str(),
+                                 cfg.aux.isEmpty() ? "1" : cfg.aux.c_str(), r, g, b);
             break;
         case LIGHT_WIZ:
-            wiz_setColor(cfg.ip.c_str(), r, g, b, cfg.brightness);
+            job = wiz_queueColor(cfg.ip.c_str(), r, g, b, cfg.brightness);
             break;
         default:
             break;
     }
+    if (job < 0) return;
+
+    fanoutRun(LIGHT_FANOUT_DEADLINE_MS);
+    lightStateRecord(cfg.ip, configTargetId(cfg), lightStateRGB(r, g, b), fanoutOk(job));
+    if (fanoutOk(job)) Serial.printf("[%s] OK\n", lightTypeName(cfg.type));
+    else Serial.printf("[%s] Failed: HTTP %d\n", lightTypeName(cfg.type), fanoutStatus(job));
 }
 
 void lightOff(const LightConfig& cfg) {
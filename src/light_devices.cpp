@@ -4,11 +4,18 @@
 
 #include "light_devices.h"
 #include "sd_storage.h"
+#include "light_fanout.h"
+#include "light_state.h"
+#include "clock_sync.h"
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <WiFiUdp.h>
 #include <ESPmDNS.h>
 #include <ArduinoJson.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
 
 // ============================================================================
 // In-memory device list
@@ -23,10 +30,16 @@ std::vector<LightDevice>& lightDevicesGet() { return g_devices; }
 // ============================================================================
 
 static const char* LIGHTS_PATH = "/lights.json";
+static const size_t LIGHTS_DOC_SIZE = 6144;
 
+static uint32_t s_discoveredAt = 0;  // epoch of the last full discovery, 0 = never
+
+// {"discovered": <epoch>, "devices": [ {...}, ... ]}.  Older files are a
+// bare device array and load as "never discovered".
 bool lightDevicesSave() {
-    DynamicJsonDocument doc(4096);
-    JsonArray arr = doc.to<JsonArray>();
+    DynamicJsonDocument doc(LIGHTS_DOC_SIZE);
+    doc["discovered"] = s_discoveredAt;
+    JsonArray arr = doc.createNestedArray("devices");
 
     for (auto& d : g_devices) {
         JsonObject obj = arr.createNestedObject();
@@ -35,6 +48,7 @@ bool lightDevicesSave() {
         obj["ip"]          = d.ip;
         obj["id"]          = d.id;
         obj["provisioned"] = d.provisioned;
+        obj["seen"]        = d.lastSeen;
     }
 
     String json;
@@ -46,14 +60,21 @@ bool lightDevicesLoad() {
     String json = sdReadText(LIGHTS_PATH);
     if (json.isEmpty()) return false;
 
-    DynamicJsonDocument doc(4096);
+    DynamicJsonDocument doc(LIGHTS_DOC_SIZE);
     if (deserializeJson(doc, json)) {
         Serial.println("[Lights] Failed to parse lights.json");
         return false;
     }
 
     g_devices.clear();
-    JsonArray arr = doc.as<JsonArray>();
+    JsonArray arr;
+    if (doc.is<JsonArray>()) {
+        arr = doc.as<JsonArray>();
+        s_discoveredAt = 0;
+    } else {
+        arr = doc["devices"].as<JsonArray>();
+        s_discoveredAt = doc["discovered"] | (uint32_t)0;
+    }
     for (JsonObject obj : arr) {
         LightDevice d;
         d.name        = obj["name"]        | "Unknown";
@@ -61,6 +82,7 @@ bool lightDevicesLoad() {
         d.ip          = obj["ip"]          | "";
         d.id          = obj["id"]          | "";
         d.provisioned = obj["provisioned"] | false;
+        d.lastSeen    = obj["seen"]        | (uint32_t)0;
         d.responding  = true;  // assume responding until verified
         g_devices.push_back(d);
     }
@@ -70,9 +92,38 @@ bool lightDevicesLoad() {
 }
 
 // ============================================================================
-// Helper: find existing device by IP to avoid duplicates
+// Discovery results
+//
+// Scanners hand each hit to a sink as a fixed-size record; the merge into
+// g_devices always runs on the caller's task, so the list (and whatever
+// the UI is drawing from it) is never touched from a scanner task.
 // ============================================================================
 
+struct FoundLight {
+    LightType type;          // LIGHT_NONE marks the end of a scan
+    char      name[64];
+    char      ip[16];
+    char      id[8];         // Hue target ("L3", "G1", "R2"), else empty
+};
+
+typedef void (*FoundSink)(const FoundLight& f);
+
+static int s_added = 0;      // new devices in the current merge run
+
+static void foundReport(FoundSink sink, LightType type, const String& name,
+                        const String& ip, const String& id = String()) {
+    FoundLight f = {};
+    f.type = type;
+    strncpy(f.name, name.c_str(), sizeof(f.name) - 1);
+    strncpy(f.ip,   ip.c_str(),   sizeof(f.ip) - 1);
+    strncpy(f.id,   id.c_str(),   sizeof(f.id) - 1);
+    sink(f);
+}
+
+static uint32_t nowEpoch() {
+    return clockIsValid() ? (uint32_t)time(nullptr) : 0;
+}
+
 static LightDevice* findByIP(const String& ip) {
     for (auto& d : g_devices) {
         if (d.ip == ip) return &d;
@@ -80,11 +131,44 @@ static LightDevice* findByIP(const String& ip) {
     return nullptr;
 }
 
+static void mergeFound(const FoundLight& f) {
+    // Hue targets all sit behind the bridge IP, so they're told apart by id
+    LightDevice* existing = nullptr;
+    if (f.type == LIGHT_HUE) {
+        for (auto& d : g_devices) {
+            if (d.type == LIGHT_HUE && d.id == f.id) { existing = &d; break; }
+        }
+    } else {
+        existing = findByIP(f.ip);
+    }
+
+    uint32_t now = nowEpoch();
+    if (existing) {
+        existing->name       = f.name;
+        existing->type       = f.type;
+        existing->responding = true;
+        if (now) existing->lastSeen = now;
+        lightStateReachable(existing->ip, existing->id);
+        return;
+    }
+
+    LightDevice d;
+    d.name        = f.name;
+    d.type        = f.type;
+    d.ip          = f.ip;
+    d.id          = f.id;
+    d.provisioned = (f.type != LIGHT_WLED);  // only WLED takes a preset pack
+    d.responding  = true;
+    d.lastSeen    = now;
+    g_devices.push_back(d);
+    s_added++;
+}
+
 // ============================================================================
 // mDNS WLED Discovery — _wled._tcp
 // ============================================================================
 
-int lightDiscoverWLED() {
+static int scanWLED(FoundSink sink) {
     Serial.println("[Lights] mDNS: scanning for WLED devices...");
 
     if (!MDNS.begin("statuspod")) {
@@ -93,8 +177,6 @@ int lightDiscoverWLED() {
     }
 
     int n = MDNS.queryService("wled", "tcp");
-    int added = 0;
-
     Serial.printf("[Lights] mDNS: found %d WLED service(s)\n", n);
 
     for (int i = 0; i < n; i++) {
@@ -103,34 +185,18 @@ int lightDiscoverWLED() {
         if (name.isEmpty()) name = "WLED-" + ip;
 
         Serial.printf("[Lights]   %s @ %s\n", name.c_str(), ip.c_str());
-
-        LightDevice* existing = findByIP(ip);
-        if (existing) {
-            existing->name = name;
-            existing->type = LIGHT_WLED;
-            existing->responding = true;
-        } else {
-            LightDevice d;
-            d.name        = name;
-            d.type        = LIGHT_WLED;
-            d.ip          = ip;
-            d.provisioned = false;
-            d.responding  = true;
-            g_devices.push_back(d);
-            added++;
-        }
+        foundReport(sink, LIGHT_WLED, name, ip);
     }
 
     MDNS.end();
-    Serial.printf("[Lights] WLED discovery: %d new device(s)\n", added);
-    return added;
+    return n;
 }
 
 // ============================================================================
 // WiZ UDP Discovery — broadcast on port 38899
 // ============================================================================
 
-int lightDiscoverWiZ() {
+static int scanWiZ(FoundSink sink) {
     Serial.println("[Lights] UDP: scanning for WiZ devices...");
 
     WiFiUDP udp;
@@ -148,7 +214,7 @@ int lightDiscoverWiZ() {
     udp.print(probe);
     udp.endPacket();
 
-    int added = 0;
+    int found = 0;
     unsigned long start = millis();
 
     // Listen for 2 seconds for responses
@@ -170,41 +236,26 @@ int lightDiscoverWiZ() {
             }
 
             Serial.printf("[Lights]   WiZ: %s @ %s\n", devName.c_str(), ip.c_str());
-
-            LightDevice* existing = findByIP(ip);
-            if (existing) {
-                existing->name = devName;
-                existing->type = LIGHT_WIZ;
-                existing->responding = true;
-            } else {
-                LightDevice d;
-                d.name        = devName;
-                d.type        = LIGHT_WIZ;
-                d.ip          = ip;
-                d.provisioned = true;  // WiZ needs no provisioning
-                d.responding  = true;
-                g_devices.push_back(d);
-                added++;
-            }
+            foundReport(sink, LIGHT_WIZ, devName, ip);
+            found++;
         }
         delay(10);
     }
 
     udp.stop();
-    Serial.printf("[Lights] WiZ discovery: %d new device(s)\n", added);
-    return added;
+    return found;
 }
 
 // ============================================================================
 // Hue Bridge Enumeration — lights, groups, rooms
 // ============================================================================
 
-int lightDiscoverHue(const String& bridgeIp, const String& apiKey) {
+static int scanHue(const String& bridgeIp, const String& apiKey, FoundSink sink) {
     if (bridgeIp.isEmpty() || apiKey.isEmpty()) return 0;
     Serial.printf("[Lights] Querying Hue bridge at %s...\n", bridgeIp.c_str());
 
     HTTPClient http;
-    int added = 0;
+    int found = 0;
 
     // --- Lights ---
     {
@@ -220,30 +271,10 @@ int lightDiscoverHue(const String& bridgeIp, const String& apiKey) {
                     String lightId = kv.key().c_str();
                     const char* name = kv.value()["name"] | "Hue Light";
                     String dispName = String(name) + " (L" + lightId + ")";
-                    String devIp = bridgeIp;  // all go through bridge
-
-                    // Check if we already track this Hue target
                     String targetId = "L" + lightId;
-                    bool found = false;
-                    for (auto& d : g_devices) {
-                        if (d.type == LIGHT_HUE && d.id == targetId) {
-                            d.name = dispName;
-                            d.responding = true;
-                            found = true;
-                            break;
-                        }
-                    }
-                    if (!found) {
-                        LightDevice d;
-                        d.name        = dispName;
-                        d.type        = LIGHT_HUE;
-                        d.ip          = devIp;
-                        d.id          = targetId;
-                        d.provisioned = true;  // Hue needs no provisioning
-                        d.responding  = true;
-                        g_devices.push_back(d);
-                        added++;
-                    }
+
+                    foundReport(sink, LIGHT_HUE, dispName, bridgeIp, targetId);
+                    found++;
                     Serial.printf("[Lights]   Hue light: %s [%s]\n",
                                   dispName.c_str(), targetId.c_str());
                 }
@@ -273,26 +304,8 @@ int lightDiscoverHue(const String& bridgeIp, const String& apiKey) {
                     String label = (strcmp(gtype, "Room") == 0) ? "Room" : "Group";
                     String dispName = String(name) + " (" + label + " " + groupId + ")";
 
-                    bool found = false;
-                    for (auto& d : g_devices) {
-                        if (d.type == LIGHT_HUE && d.id == targetId) {
-                            d.name = dispName;
-                            d.responding = true;
-                            found = true;
-                            break;
-                        }
-                    }
-                    if (!found) {
-                        LightDevice d;
-                        d.name        = dispName;
-                        d.type        = LIGHT_HUE;
-                        d.ip          = bridgeIp;
-                        d.id          = targetId;
-                        d.provisioned = true;
-                        d.responding  = true;
-                        g_devices.push_back(d);
-                        added++;
-                    }
+                    foundReport(sink, LIGHT_HUE, dispName, bridgeIp, targetId);
+                    found++;
                     Serial.printf("[Lights]   Hue %s: %s [%s]\n",
                                   label.c_str(), dispName.c_str(), targetId.c_str());
                 }
@@ -301,61 +314,167 @@ int lightDiscoverHue(const String& bridgeIp, const String& apiKey) {
         http.end();
     }
 
-    Serial.printf("[Lights] Hue enumeration: %d new target(s)\n", added);
-    return added;
+    return found;
+}
+
+// ============================================================================
+// Single-protocol discovery (runs on the caller)
+// ============================================================================
+
+int lightDiscoverWLED() {
+    s_added = 0;
+    scanWLED(mergeFound);
+    Serial.printf("[Lights] WLED discovery: %d new device(s)\n", s_added);
+    return s_added;
+}
+
+int lightDiscoverWiZ() {
+    s_added = 0;
+    scanWiZ(mergeFound);
+    Serial.printf("[Lights] WiZ discovery: %d new device(s)\n", s_added);
+    return s_added;
+}
+
+int lightDiscoverHue(const String& bridgeIp, const String& apiKey) {
+    s_added = 0;
+    scanHue(bridgeIp, apiKey, mergeFound);
+    Serial.printf("[Lights] Hue enumeration: %d new target(s)\n", s_added);
+    return s_added;
 }
 
 // ============================================================================
-// Discover all — runs appropriate discovery per configured light type
+// Discover all — every applicable protocol at once
+//
+// Each scan runs on its own short-lived task next to the WiFi stack on
+// core 0 and posts hits to a queue; the caller merges them as they arrive,
+// so the whole pass takes as long as the slowest scan (the Hue GETs or the
+// 3 s mDNS query) instead of their sum.
 // ============================================================================
 
-int lightDiscoverAll(const LightConfig& cfg) {
-    int total = 0;
+enum ScanKind { SCAN_WLED = 0, SCAN_WIZ, SCAN_HUE, SCAN_KINDS };
+
+struct ScanDef {
+    const char* name;
+    LightType   type;
+    uint32_t    stack;
+};
+
+static const ScanDef SCANS[SCAN_KINDS] = {
+    { "scan_wled", LIGHT_WLED, 4096 },
+    { "scan_wiz",  LIGHT_WIZ,  6144 },
+    { "scan_hue",  LIGHT_HUE,  8192 },
+};
+
+#define FOUND_QUEUE_LEN 16
+
+static QueueHandle_t s_foundQ = nullptr;
+static String        s_hueIp, s_hueKey;   // written before the Hue task starts
+
+static void runScan(int kind, FoundSink sink) {
+    switch (kind) {
+    case SCAN_WLED: scanWLED(sink); break;
+    case SCAN_WIZ:  scanWiZ(sink);  break;
+    case SCAN_HUE:  scanHue(s_hueIp, s_hueKey, sink); break;
+    }
+}
+
+static void queueSink(const FoundLight& f) {
+    xQueueSend(s_foundQ, &f, portMAX_DELAY);
+}
+
+static void scanTask(void* arg) {
+    runScan((int)(intptr_t)arg, queueSink);
+    FoundLight done = {};
+    done.type = LIGHT_NONE;
+    xQueueSend(s_foundQ, &done, portMAX_DELAY);
+    vTaskDelete(nullptr);
+}
+
+// Drop devices of a scanned protocol that haven't answered for too long
+static void pruneUnseen(const bool scanned[SCAN_KINDS]) {
+    uint32_t now = nowEpoch();
+    if (!now) return;
+    for (size_t i = g_devices.size(); i-- > 0;) {
+        const LightDevice& d = g_devices[i];
+        bool wasScanned = false;
+        for (int k = 0; k < SCAN_KINDS; k++)
+            if (scanned[k] && SCANS[k].type == d.type) wasScanned = true;
+        if (!wasScanned || d.lastSeen == 0 || now - d.lastSeen <= LIGHT_FORGET_SEC)
+            continue;
+        Serial.printf("[Lights] Forgetting %s @ %s (unseen %lu days)\n",
+                      d.name.c_str(), d.ip.c_str(),
+                      (unsigned long)((now - d.lastSeen) / 86400));
+        g_devices.erase(g_devices.begin() + i);
+    }
+}
+
+int lightDiscoverAll(const LightConfig& cfg, LightDiscoveryProgress progress, void* ctx) {
+    unsigned long t0 = millis();
+    bool want[SCAN_KINDS] = {};
 
     // Always scan for WLED (mDNS is cheap)
-    total += lightDiscoverWLED();
+    want[SCAN_WLED] = true;
 
     // WiZ discovery if WiZ is configured or any WiZ devices exist
-    if (cfg.type == LIGHT_WIZ) {
-        total += lightDiscoverWiZ();
-    } else {
-        // Also discover if we have existing WiZ devices
-        for (auto& d : g_devices) {
-            if (d.type == LIGHT_WIZ) {
-                total += lightDiscoverWiZ();
-                break;
-            }
-        }
+    want[SCAN_WIZ] = (cfg.type == LIGHT_WIZ);
+    for (auto& d : g_devices) {
+        if (d.type == LIGHT_WIZ) want[SCAN_WIZ] = true;
     }
 
     // Hue enumeration if bridge IP and key are configured
-    if (cfg.type == LIGHT_HUE && !cfg.ip.isEmpty() && !cfg.key.isEmpty()) {
-        total += lightDiscoverHue(cfg.ip, cfg.key);
+    want[SCAN_HUE] = (cfg.type == LIGHT_HUE && !cfg.ip.isEmpty() && !cfg.key.isEmpty());
+    s_hueIp  = cfg.ip;
+    s_hueKey = cfg.key;
+
+    if (!s_foundQ) s_foundQ = xQueueCreate(FOUND_QUEUE_LEN, sizeof(FoundLight));
+
+    s_added = 0;
+    int running = 0;
+    for (int k = 0; k < SCAN_KINDS; k++) {
+        if (!want[k]) continue;
+        if (s_foundQ &&
+            xTaskCreatePinnedToCore(scanTask, SCANS[k].name, SCANS[k].stack,
+                                    (void*)(intptr_t)k, 1, nullptr, 0) == pdPASS) {
+            running++;
+        } else {
+            // Tasks already started just queue up behind this one
+            Serial.printf("[Lights] Can't start %s — scanning inline\n", SCANS[k].name);
+            runScan(k, mergeFound);
+        }
+    }
+
+    // Every scan has its own timeout, so each one always posts its marker
+    FoundLight f;
+    while (running > 0 && xQueueReceive(s_foundQ, &f, portMAX_DELAY) == pdTRUE) {
+        if (f.type == LIGHT_NONE) {
+            running--;
+            continue;
+        }
+        mergeFound(f);
+        if (progress) progress(ctx);
     }
 
+    pruneUnseen(want);
+    s_discoveredAt = nowEpoch();
+    Serial.printf("[Lights] Discovery: %d new, %d tracked (%lums)\n",
+                  s_added, (int)g_devices.size(), millis() - t0);
+
     lightDevicesSave();
-    return total;
+    return s_added;
+}
+
+bool lightDiscoveryDue() {
+    if (g_devices.empty()) return true;
+    // Without a clock the cache's age is unknown — rediscover to be safe
+    uint32_t now = nowEpoch();
+    if (!now || s_discoveredAt == 0) return true;
+    return now - s_discoveredAt > LIGHT_DISCOVERY_TTL_SEC;
 }
 
 // ============================================================================
 // WLED Preset Control
 // ============================================================================
 
-int wledPresetForPresence(const char* availability) {
-    if (strcmp(availability, "Available") == 0)       return 1;
-    if (strcmp(availability, "Away") == 0)            return 2;
-    if (strcmp(availability, "BeRightBack") == 0)     return 2;
-    if (strcmp(availability, "Busy") == 0)            return 3;
-    if (strcmp(availability, "DoNotDisturb") == 0)    return 4;
-    if (strcmp(availability, "InACall") == 0)         return 5;
-    if (strcmp(availability, "InAMeeting") == 0)      return 5;
-    if (strcmp(availability, "Presenting") == 0)      return 5;
-    if (strcmp(availability, "InAConferenceCall") == 0) return 5;
-    if (strcmp(availability, "Offline") == 0)         return 6;
-    if (strcmp(availability, "PresenceUnknown") == 0) return 6;
-    return 6;  // default to offline/off
-}
-
 bool wledActivatePreset(const String& ip, int presetId) {
     if (WiFi.status() != WL_CONNECTED) return false;
 
@@ -376,16 +495,60 @@ bool wledActivatePreset(const String& ip, int presetId) {
     return false;
 }
 
-void wledActivatePresetAll(int presetId) {
-    for (auto& d : g_devices) {
-        if (d.type == LIGHT_WLED && d.responding) {
-            if (!wledActivatePreset(d.ip, presetId)) {
-                d.responding = false;
-            }
+// ============================================================================
+// Helper: record fan-out results into the `responding` flags (and the
+// last-seen stamps) in one pass
+// ============================================================================
+
+static void applyResults(const std::vector<int>& jobs) {
+    uint32_t now = nowEpoch();
+    for (size_t i = 0; i < g_devices.size(); i++) {
+        if (jobs[i] < 0) continue;
+        LightDevice& d = g_devices[i];
+        bool was = d.responding;
+        d.responding = fanoutOk(jobs[i]);
+        if (d.responding) {
+            if (now) d.lastSeen = now;
+            lightStateReachable(d.ip, d.id);
+        }
+        if (was != d.responding) {
+            Serial.printf("[Lights] %s @ %s: %s → %s\n",
+                          d.name.c_str(), d.ip.c_str(),
+                          was ? "OK" : "DOWN",
+                          d.responding ? "OK" : "DOWN");
         }
     }
 }
 
+void wledActivatePresetAll(int presetId) {
+    if (WiFi.status() != WL_CONNECTED) return;
+
+    // All strips at once — bounded by the slowest one, not the sum.  A
+    // strip already on this preset is left alone; a dead one is retried
+    // once its backoff runs out (light_state.h), which is also how it
+    // comes back without a manual Verify.
+    uint32_t state = lightStatePreset(presetId);
+    String path = "/win&PL=" + String(presetId);
+    std::vector<int> jobs(g_devices.size(), -1);
+    int current = 0, waiting = 0;
+    fanoutReset();
+    for (size_t i = 0; i < g_devices.size(); i++) {
+        const LightDevice& d = g_devices[i];
+        if (d.type != LIGHT_WLED) continue;
+        if (lightStateCurrent(d.ip, d.id, state)) { current++; continue; }
+        if (!lightStateDue(d.ip, d.id))           { waiting++; continue; }
+        jobs[i] = fanoutHttp(d.ip, "GET", path);
+    }
+    int ok = fanoutRun(LIGHT_FANOUT_DEADLINE_MS);
+    applyResults(jobs);     // before the records: a reachable light's output is reset
+    for (size_t i = 0; i < g_devices.size(); i++) {
+        if (jobs[i] >= 0)
+            lightStateRecord(g_devices[i].ip, g_devices[i].id, state, fanoutOk(jobs[i]));
+    }
+    Serial.printf("[WLED] Preset %d activated on %d device(s), %d already on it, %d backing off\n",
+                  presetId, ok, current, waiting);
+}
+
 // ============================================================================
 // WLED Provisioning — upload 6 presets (presence statuses)
 //
@@ -521,14 +684,28 @@ bool lightDevicePing(const LightDevice& dev) {
 
 void lightDevicesVerify() {
     Serial.println("[Lights] Verifying device connectivity...");
-    for (auto& d : g_devices) {
-        bool was = d.responding;
-        d.responding = lightDevicePing(d);
-        if (was != d.responding) {
-            Serial.printf("[Lights] %s @ %s: %s → %s\n",
-                          d.name.c_str(), d.ip.c_str(),
-                          was ? "OK" : "DOWN",
-                          d.responding ? "OK" : "DOWN");
+    if (WiFi.status() != WL_CONNECTED) return;
+
+    // Same probes as lightDevicePing(), all in flight together
+    std::vector<int> jobs(g_devices.size(), -1);
+    fanoutReset();
+    for (size_t i = 0; i < g_devices.size(); i++) {
+        const LightDevice& d = g_devices[i];
+        if (d.ip.isEmpty()) continue;
+        switch (d.type) {
+        case LIGHT_WLED:
+            jobs[i] = fanoutHttp(d.ip, "GET", "/json/info");
+            break;
+        case LIGHT_HUE:
+            jobs[i] = fanoutHttp(d.ip, "GET", "/api/config");
+            break;
+        case LIGHT_WIZ:
+            jobs[i] = fanoutUdp(d.ip, 38899, "{\"method\":\"getPilot\",\"params\":{}}", true);
+            break;
+        default:
+            break;
         }
     }
+    fanoutRun(2000);
+    applyResults(jobs);
 }
@@ -0,0 +1,314 @@
+// ============================================================================
+// Light Fan-out — concurrent, deadline-bounded requests to light devices
+// ============================================================================
+
+#include "light_fanout.h"
+#include <lwip/sockets.h>
+#include <errno.h>
+
+enum JobState : uint8_t {
+    JOB_PENDING = 0,
+    JOB_CONNECTING,
+    JOB_SENDING,
+    JOB_READING,            // TCP: status line; UDP: waiting for the reply
+    JOB_OK,
+    JOB_FAILED
+};
+
+struct FanoutJob {
+    IPAddress ip;
+    uint16_t  port;
+    bool      udp;
+    bool      expectReply;
+    String    request;      // whole HTTP request, or the UDP payload
+    int       fd;
+    JobState  state;
+    size_t    sent;
+    char      line[16];     // start of the status line ("HTTP/1.1 200")
+    uint8_t   lineLen;
+    int       status;
+};
+
+static FanoutJob s_jobs[FANOUT_MAX_JOBS];
+static int       s_count = 0;
+static int       s_udpFd = -1;  // shared by all UDP jobs of a run
+
+// ----------------------------------------------------------------------------
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) >= 0;
+}
+
+static sockaddr_in sockAddr(const IPAddress& ip, uint16_t port) {
+    sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family      = AF_INET;
+    a.sin_port        = htons(port);
+    a.sin_addr.s_addr = (uint32_t)ip;
+    return a;
+}
+
+static void finish(FanoutJob& j, bool ok) {
+    if (j.fd >= 0) {
+        close(j.fd);
+        j.fd = -1;
+    }
+    j.state = ok ? JOB_OK : JOB_FAILED;
+}
+
+static bool isDone(const FanoutJob& j) {
+    return j.state == JOB_OK || j.state == JOB_FAILED;
+}
+
+static bool isOpenTcp(const FanoutJob& j) {
+    return !j.udp && (j.state == JOB_CONNECTING || j.state == JOB_SENDING ||
+                      j.state == JOB_READING);
+}
+
+static int queue(const String& ip, uint16_t port, bool udp) {
+    if (s_count >= FANOUT_MAX_JOBS) {
+        Serial.println("[Fanout] Queue full");
+        return -1;
+    }
+    FanoutJob& j = s_jobs[s_count];
+    if (!j.ip.fromString(ip)) {
+        Serial.printf("[Fanout] Invalid IP '%s'\n", ip.c_str());
+        return -1;
+    }
+    j.port        = port;
+    j.udp         = udp;
+    j.expectReply = false;
+    j.request     = "";
+    j.fd          = -1;
+    j.state       = JOB_PENDING;
+    j.sent        = 0;
+    j.lineLen     = 0;
+    j.status      = 0;
+    return s_count++;
+}
+
+// ---- Job steps -------------------------------------------------------------
+
+static void startTcp(FanoutJob& j) {
+    j.fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (j.fd < 0 || !setNonBlocking(j.fd)) { finish(j, false); return; }
+    sockaddr_in a = sockAddr(j.ip, j.port);
+    if (connect(j.fd, (sockaddr*)&a, sizeof(a)) == 0) {
+        j.state = JOB_SENDING;
+    } else if (errno == EINPROGRESS) {
+        j.state = JOB_CONNECTING;
+    } else {
+        finish(j, false);
+    }
+}
+
+static void startUdp(FanoutJob& j) {
+    sockaddr_in a = sockAddr(j.ip, j.port);
+    int n = sendto(s_udpFd, j.request.c_str(), j.request.length(), 0,
+                   (sockaddr*)&a, sizeof(a));
+    if (n != (int)j.request.length()) { finish(j, false); return; }
+    if (j.expectReply) j.state = JOB_READING;
+    else               finish(j, true);
+}
+
+static void onWritable(FanoutJob& j) {
+    if (j.state == JOB_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(j.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0) { finish(j, false); return; }
+        j.state = JOB_SENDING;
+    }
+    int n = send(j.fd, j.request.c_str() + j.sent, j.request.length() - j.sent, 0);
+    if (n > 0) {
+        j.sent += n;
+        if (j.sent == j.request.length()) j.state = JOB_READING;
+    } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        finish(j, false);
+    }
+}
+
+static void onReadable(FanoutJob& j) {
+    char buf[64];
+    int n = recv(j.fd, buf, sizeof(buf), 0);
+    if (n == 0) { finish(j, false); return; }           // closed before a status
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) finish(j, false);
+        return;
+    }
+    for (int i = 0; i < n && j.lineLen < sizeof(j.line) - 1; i++) {
+        if (buf[i] == '\r' || buf[i] == '\n') break;
+        j.line[j.lineLen++] = buf[i];
+    }
+    j.line[j.lineLen] = '\0';
+    const char* sp = strchr(j.line, ' ');
+    if (strncmp(j.line, "HTTP/", 5) != 0) {
+        if (j.lineLen >= 5) finish(j, false);
+        return;
+    }
+    if (!sp || strlen(sp + 1) < 3) return;              // need all 3 digits
+    j.status = atoi(sp + 1);
+    finish(j, j.status >= 200 && j.status < 300);
+}
+
+static void onUdpReadable() {
+    char buf[256];
+    while (true) {
+        sockaddr_in from;
+        socklen_t len = sizeof(from);
+        int n = recvfrom(s_udpFd, buf, sizeof(buf), 0, (sockaddr*)&from, &len);
+        if (n < 0) return;
+        for (int i = 0; i < s_count; i++) {
+            FanoutJob& j = s_jobs[i];
+            if (j.udp && j.state == JOB_READING &&
+                (uint32_t)j.ip == from.sin_addr.s_addr) {
+                finish(j, true);
+                break;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void fanoutReset() {
+    for (int i = 0; i < s_count; i++) {
+        if (s_jobs[i].fd >= 0) close(s_jobs[i].fd);
+        s_jobs[i].fd = -1;
+        s_jobs[i].request = "";
+    }
+    s_count = 0;
+}
+
+int fanoutHttp(const String& ip, const char* method, const String& path,
+               const char* body) {
+    int idx = queue(ip, 80, false);
+    if (idx < 0) return -1;
+    String& r = s_jobs[idx].request;
+    r.reserve(96 + path.length() + (body ? strlen(body) : 0));
+    r  = method;
+    r += ' ';
+    r += path;
+    r += " HTTP/1.1\r\nHost: ";
+    r += ip;
+    r += "\r\nConnection: close\r\n";
+    if (body) {
+        r += "Content-Type: application/json\r\nContent-Length: ";
+        r += String((unsigned)strlen(body));
+        r += "\r\n\r\n";
+        r += body;
+    } else {
+        r += "\r\n";
+    }
+    return idx;
+}
+
+int fanoutUdp(const String& ip, uint16_t port, const char* payload, bool expectReply) {
+    int idx = queue(ip, port, true);
+    if (idx < 0) return -1;
+    s_jobs[idx].request     = payload;
+    s_jobs[idx].expectReply = expectReply;
+    return idx;
+}
+
+int fanoutRun(uint32_t deadlineMs) {
+    if (s_count == 0) return 0;
+    unsigned long t0 = millis();
+
+    for (int i = 0; i < s_count; i++) {
+        if (s_jobs[i].udp) {
+            s_udpFd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            if (s_udpFd >= 0 && !setNonBlocking(s_udpFd)) {
+                close(s_udpFd);
+                s_udpFd = -1;
+            }
+            break;
+        }
+    }
+
+    while (true) {
+        // Start queued jobs while there are sockets to spare
+        int open = 0;
+        for (int i = 0; i < s_count; i++) if (isOpenTcp(s_jobs[i])) open++;
+        for (int i = 0; i < s_count; i++) {
+            FanoutJob& j = s_jobs[i];
+            if (j.state != JOB_PENDING) continue;
+            if (j.udp) {
+                if (s_udpFd < 0) finish(j, false);
+                else             startUdp(j);
+            } else if (open < FANOUT_MAX_OPEN) {
+                startTcp(j);
+                if (isOpenTcp(j)) open++;
+            }
+        }
+
+        uint32_t elapsed = millis() - t0;
+        bool pending = false;
+        for (int i = 0; i < s_count; i++) if (!isDone(s_jobs[i])) { pending = true; break; }
+        if (!pending || elapsed >= deadlineMs) break;
+
+        fd_set rd, wr;
+        FD_ZERO(&rd);
+        FD_ZERO(&wr);
+        int maxFd = -1;
+        bool udpWaiting = false;
+        for (int i = 0; i < s_count; i++) {
+            const FanoutJob& j = s_jobs[i];
+            if (j.udp) {
+                if (j.state == JOB_READING) udpWaiting = true;
+                continue;
+            }
+            if (j.state == JOB_CONNECTING || j.state == JOB_SENDING) FD_SET(j.fd, &wr);
+            else if (j.state == JOB_READING)                         FD_SET(j.fd, &rd);
+            else continue;
+            if (j.fd > maxFd) maxFd = j.fd;
+        }
+        if (udpWaiting) {
+            FD_SET(s_udpFd, &rd);
+            if (s_udpFd > maxFd) maxFd = s_udpFd;
+        }
+        if (maxFd < 0) continue;                        // only pending TCP left
+
+        uint32_t left = deadlineMs - elapsed;
+        timeval tv = { (time_t)(left / 1000), (suseconds_t)((left % 1000) * 1000) };
+        int n = select(maxFd + 1, &rd, &wr, nullptr, &tv);
+        if (n < 0) break;
+        if (n == 0) continue;
+
+        for (int i = 0; i < s_count; i++) {
+            FanoutJob& j = s_jobs[i];
+            if (j.udp || j.fd < 0) continue;
+            if (FD_ISSET(j.fd, &wr))      onWritable(j);
+            else if (FD_ISSET(j.fd, &rd)) onReadable(j);
+        }
+        if (udpWaiting && FD_ISSET(s_udpFd, &rd)) onUdpReadable();
+    }
+
+    int ok = 0;
+    for (int i = 0; i < s_count; i++) {
+        FanoutJob& j = s_jobs[i];
+        if (!isDone(j)) finish(j, false);               // deadline
+        if (j.state == JOB_OK) {
+            ok++;
+        } else {
+            Serial.printf("[Fanout] %s:%u failed (%s)\n", j.ip.toString().c_str(),
+                          j.port, j.status ? j.line : "no response");
+        }
+    }
+    if (s_udpFd >= 0) {
+        close(s_udpFd);
+        s_udpFd = -1;
+    }
+    Serial.printf("[Fanout] %d/%d ok in %lums\n", ok, s_count, millis() - t0);
+    return ok;
+}
+
+bool fanoutOk(int job) {
+    return job >= 0 && job < s_count && s_jobs[job].state == JOB_OK;
+}
+
+int fanoutStatus(int job) {
+    return (job >= 0 && job < s_count) ? s_jobs[job].status : 0;
+}
@@ -0,0 +1,146 @@
+// ============================================================================
+// Light State — last-applied output and re-probe backoff per light
+// ============================================================================
+
+#include "light_state.h"
+#include <esp_private/esp_clk.h>
+
+struct LightSlot {
+    uint32_t key;        // hash of "<ip>/<id>", 0 = free
+    uint32_t applied;    // lightStatePreset()/lightStateRGB(), 0 = unknown
+    uint32_t appliedAt;  // nowSec() of the acknowledgement
+    uint32_t nextRetry;  // nowSec(); only meaningful with failures
+    uint32_t lastUse;    // for eviction
+    uint8_t  failures;
+};
+
+struct RtcLightState {
+    uint32_t  magic;
+    LightSlot slots[LIGHT_STATE_SLOTS];
+};
+static const uint32_t LIGHT_STATE_MAGIC = 0x3254534C;  // "LST2"
+RTC_DATA_ATTR static RtcLightState rtc_lights = {};
+
+static const uint32_t STATE_PRESET = 0x01000000;
+static const uint32_t STATE_RGB    = 0x02000000;
+
+// RTC timer since power-on — runs through deep sleep, never stepped
+static uint32_t nowSec() {
+    return (uint32_t)(esp_clk_rtc_time() / 1000000ULL);
+}
+
+// FNV-1a over ip, '/', id — never 0, which marks a free slot
+static uint32_t lightKey(const String& ip, const String& id) {
+    uint32_t h = 2166136261u;
+    for (const char* p = ip.c_str(); *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    h = (h ^ '/') * 16777619u;
+    for (const char* p = id.c_str(); *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    return h ? h : 1;
+}
+
+static void ensureValid() {
+    if (rtc_lights.magic == LIGHT_STATE_MAGIC) return;
+    memset(&rtc_lights, 0, sizeof(rtc_lights));
+    rtc_lights.magic = LIGHT_STATE_MAGIC;
+}
+
+static LightSlot* findSlot(uint32_t key) {
+    ensureValid();
+    for (int i = 0; i < LIGHT_STATE_SLOTS; i++)
+        if (rtc_lights.slots[i].key == key) return &rtc_lights.slots[i];
+    return nullptr;
+}
+
+// Existing slot, else a free one, else the least recently used
+static LightSlot* claimSlot(uint32_t key) {
+    LightSlot* s = findSlot(key);
+    if (s) return s;
+    LightSlot* victim = &rtc_lights.slots[0];
+    for (int i = 0; i < LIGHT_STATE_SLOTS; i++) {
+        LightSlot& c = rtc_lights.slots[i];
+        if (c.key == 0) { victim = &c; break; }
+        if (c.lastUse < victim->lastUse) victim = &c;
+    }
+    memset(victim, 0, sizeof(*victim));
+    victim->key = key;
+    return victim;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+uint32_t lightStatePreset(int presetId) {
+    return STATE_PRESET | (uint32_t)(presetId & 0xFFFF);
+}
+
+uint32_t lightStateRGB(uint8_t r, uint8_t g, uint8_t b) {
+    return STATE_RGB | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+static bool trusted(const LightSlot& s) {
+    return s.failures == 0 && s.applied != 0 &&
+           nowSec() - s.appliedAt < LIGHT_STATE_TTL_SEC;
+}
+
+bool lightStateCurrent(const String& ip, const String& id, uint32_t state) {
+    const LightSlot* s = findSlot(lightKey(ip, id));
+    return s && state != 0 && s->applied == state && trusted(*s);
+}
+
+bool lightStateDue(const String& ip, const String& id) {
+    const LightSlot* s = findSlot(lightKey(ip, id));
+    if (!s || s->failures == 0) return true;
+    // A record older than the timer (RTC memory kept over a reset) can
+    // leave nextRetry far out — cap it
+    int32_t wait = (int32_t)(s->nextRetry - nowSec());
+    return wait <= 0 || wait > LIGHT_RETRY_MAX_SEC;
+}
+
+void lightStateRecord(const String& ip, const String& id, uint32_t state, bool ok) {
+    LightSlot* s = claimSlot(lightKey(ip, id));
+    uint32_t now = nowSec();
+    s->lastUse = now;
+
+    if (ok) {
+        if (s->failures)
+            Serial.printf("[Lights] %s back after %u failure(s)\n", ip.c_str(), s->failures);
+        s->applied   = state;
+        s->appliedAt = now;
+        s->failures  = 0;
+        return;
+    }
+
+    s->applied = 0;
+    if (s->failures < 255) s->failures++;
+    uint32_t delaySec = LIGHT_RETRY_BASE_SEC;
+    for (int i = 1; i < s->failures && delaySec < LIGHT_RETRY_MAX_SEC; i++) delaySec *= 2;
+    if (delaySec > LIGHT_RETRY_MAX_SEC) delaySec = LIGHT_RETRY_MAX_SEC;
+    s->nextRetry = now + delaySec;
+    Serial.printf("[Lights] %s failed (%u in a row) — retry in %lus\n",
+                  ip.c_str(), s->failures, (unsigned long)delaySec);
+}
+
+void lightStateReachable(const String& ip, const String& id) {
+    LightSlot* s = findSlot(lightKey(ip, id));
+    if (!s) return;
+    s->failures = 0;
+    s->applied  = 0;
+}
+
+void lightStateClear() {
+    memset(&rtc_lights, 0, sizeof(rtc_lights));
+    rtc_lights.magic = LIGHT_STATE_MAGIC;
+}
+
+bool lightStateStale() {
+    ensureValid();
+    for (int i = 0; i < LIGHT_STATE_SLOTS; i++) {
+        const LightSlot& s = rtc_lights.slots[i];
+        if (s.key == 0 || trusted(s)) continue;
+        // A failing light only counts once its retry is due
+        int32_t wait = (int32_t)(s.nextRetry - nowSec());
+        if (s.failures == 0 || wait <= 0 || wait > LIGHT_RETRY_MAX_SEC) return true;
+    }
+    return false;
+}
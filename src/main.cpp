@@ -37,7 +37,23 @@
 #include "audio.h"
 #include "light_control.h"
 #include "light_devices.h"
+#include "light_state.h"
 #include "wled_provision.h"
+#include "https_conn.h"
+#include "wifi_link.h"
+#include "clock_sync.h"
+#include "calendar_schedule.h"
+#include "poll_policy.h"
+#include "config_snapshot.h"
+#include "wake_profiler.h"
+#include "output_pipeline.h"
+#include "team_board.h"
+#include "presence_merge.h"
+#include "input.h"
+#include "power_policy.h"
+#include "ulp_monitor.h"
+#include "poll_arena.h"
+#include "office_hours.h"
 
 // ============================================================================
 // Hardware pins  (Waveshare ESP32-S3-ePaper-1.54 V2)
@@ -77,28 +93,31 @@ enum AppState {
 static AppState            g_state              = STATE_BOOT;
 static DeviceCodeResponse  g_deviceCode;
 static PresenceState       g_currentPresence;
-static String              g_lastAvailability   = "";
+static Availability        g_lastAvailability   = AV_NONE;
 static unsigned long       g_lastPollTime       = 0;
 static unsigned long       g_lastPresenceCheck  = 0;
+static int                 g_pollIntervalSec    = 0;      // adaptive; 0 = presenceInterval
 static unsigned long       g_authStartTime      = 0;
 static int                 g_pollFailures       = 0;
 static PodSettings         g_settings;
 static LightConfig         g_lightCfg;
+static uint8_t             g_teamChanged        = 0;      // board rows changed by the last poll
+static bool                g_bleFromSettings    = false;  // setup mode entered from Settings
 
 static const unsigned long PRESENCE_INTERVAL    = 30000;  // default 30 s, overridden by settings
 static const int           MAX_POLL_FAILURES    = 5;      // allow 5 transient errors
-static int                 g_partialCount       = 0;      // track partial refreshes for periodic full
 
 // ---- Power management ----
 static unsigned long       g_lastBatteryCheck   = 0;
 static const int           BATTERY_WARN_PCT     = 15;
 static const int           BATTERY_SHUTDOWN_PCT = 5;
+static const uint32_t      ALERT_DRAIN_MS       = 8000;   // longest a clip may hold off power-off / sleep
 static bool                g_serialDisabled     = false;
 
 // ---- Deep sleep state (RTC memory — survives deep sleep) ----
 RTC_DATA_ATTR static bool    rtc_deepSleepActive = false;
 RTC_DATA_ATTR static uint8_t rtc_stableCount     = 0;
-RTC_DATA_ATTR static char    rtc_lastAvailability[32] = "";
+RTC_DATA_ATTR static uint8_t rtc_lastAvailability = AV_NONE;   // Availability
 
 static const int DEEP_SLEEP_THRESHOLD = 3;  // unchanged polls before deep sleep
 
@@ -109,15 +128,21 @@ void initializeHardware();
 bool connectWiFi(unsigned long timeoutMs = 15000);
 void checkPowerOff();
 void updateAndDisplayPresence();
+bool pollBothPresence(PresenceState& st);
 void handleMenu();
 void handleSettings();
 void runWledZeroConfig();
 void waitForAnyButton();
 void checkBattery();
 void enterDeepSleep(int intervalSec);
-void syncNTP();
 bool isOfficeHours();
 int  secondsUntilOfficeStart();
+int  nextPollInterval();
+
+// Team board replaces the single-user screen (Teams only)
+static bool teamMode() {
+    return g_settings.platform == PLATFORM_TEAMS && teamBoardActive();
+}
 
 // ============================================================================
 // setup()
@@ -150,9 +175,22 @@ void setup() {
         default: break;
     }
     Serial.printf("[Main] Reset reason: %s (%d)\n", reasonStr, (int)reason);
+    httpsLogTlsMode();
 
     pinMode(BOOT_BUTTON, INPUT_PULLUP);
     pinMode(PWR_BUTTON,  INPUT_PULLUP);
+    inputInit(BOOT_BUTTON, PWR_BUTTON);
+    powerPolicyInit();
+    pollArenaInit();
+
+    // Stop the deep-sleep battery monitor before anything else uses the ADC
+    UlpReport ulp;
+    bool haveUlp = ulpMonitorCollect(ulp);
+
+    // Clock mode from the supply now, not at the first loop(): on USB the
+    // console and the splash gate mustn't run under auto light sleep
+    batteryInit();
+    powerSetUsbMode(batteryOnUSB(batteryReadVoltage()));
 
     // ========================================================================
     // Deep sleep fast-path — minimal wake, poll, return to sleep
@@ -161,14 +199,22 @@ void setup() {
     if (reason == ESP_RST_DEEPSLEEP && rtc_deepSleepActive) {
         esp_sleep_wakeup_cause_t wakeup = esp_sleep_get_wakeup_cause();
 
-        if (wakeup == ESP_SLEEP_WAKEUP_TIMER) {
-            Serial.println("[DeepSleep] Timer wake — fast poll");
-            setCpuFrequencyMhz(80);
+        if (wakeup == ESP_SLEEP_WAKEUP_TIMER || wakeup == ESP_SLEEP_WAKEUP_ULP) {
+            bool ulpWake = (wakeup == ESP_SLEEP_WAKEUP_ULP);
+            if (ulpWake) Serial.printf("[DeepSleep] ULP wake (%s)\n", ulpWakeReasonName(ulp.reason));
+            else         Serial.println("[DeepSleep] Timer wake — fast poll");
+            unsigned long t0 = millis();
 
             // --- Battery check first (may shutdown before spending power) ---
-            batteryInit();
-            float voltage = batteryReadVoltage();
-            int   pct     = batteryPercent(voltage);
+            // The ULP sampled it moments ago; the ADC is only read if it didn't
+            float voltage;
+            if (haveUlp) {
+                voltage = ulp.voltage;
+            } else {
+                batteryInit();
+                voltage = batteryReadVoltage();
+            }
+            int pct = batteryPercent(voltage);
 
             if (batteryOnUSB(voltage)) {
                 // USB plugged in — exit to full normal boot (WOT mode)
@@ -179,14 +225,21 @@ void setup() {
                 goto normalBoot;
             }
 
+            // Profile this wake from here (a USB exit isn't a sleep cycle)
+            wakeProfBegin();
+            wakeProfSetBattery((int)(voltage * 1000));
+            wakeProfAdd(WP_BATTERY, millis() - t0);
+
             // Critical battery → shutdown
             if (pct <= BATTERY_SHUTDOWN_PCT) {
                 Serial.printf("[DeepSleep] CRITICAL %d%% — shutdown\n", pct);
+                wakeProfSetOutcome(WAKE_LOW_BATTERY);
+                wakeProfEnd(0);
                 initializeHardware();
                 audioInit(false);
                 audioAttention(3);   // forced beep
                 drawLowBatteryScreen(pct, true);
-                delay(3000);
+                audioWaitIdle(ALERT_DRAIN_MS);
                 checkPowerOff();
                 return;
             }
@@ -194,38 +247,72 @@ void setup() {
             // Low battery → forced beep every wake (regardless of settings)
             if (pct <= BATTERY_WARN_PCT) {
                 Serial.printf("[DeepSleep] Low battery %d%% — forced beep\n", pct);
+                t0 = millis();
                 audioInit(false);
                 audioAttention(1);
+                wakeProfAdd(WP_AUDIO, millis() - t0);
+            }
+
+            // The ULP woke us for the warning alone — the poll isn't due yet
+            if (ulpWake && ulp.secondsLeft > ULP_SAMPLE_SEC) {
+                Serial.printf("[DeepSleep] Poll due in %ds — back to sleep\n", ulp.secondsLeft);
+                wakeProfSetOutcome(WAKE_LOW_BATTERY);
+                enterDeepSleep(ulp.secondsLeft);
+                return;
             }
 
             // --- Load config + credentials ---
-            if (sdInit()) Serial.println("[DeepSleep] SD mounted");
-            loadSettings(g_settings);
-            loadLightConfig(g_lightCfg);
-            loadCredentialsFromNVS();
-            g_lightCfg.type     = (LightType)g_light_type.toInt();
-            g_lightCfg.ip       = g_light_ip;
-            g_settings.platform = (Platform)g_platform.toInt();
-            if (g_timezone.length() > 0) g_settings.timezone = g_timezone;
-
-            // --- WiFi connect (need 240 MHz for radio) ---
-            setCpuFrequencyMhz(240);
-            if (!connectWiFi()) {
+            // From the RTC/NVS snapshot; the SD card stays unpowered unless
+            // an asset (image, sound, refresh token) is actually needed.
+            t0 = millis();
+            if (!configSnapshotRestore(g_settings, g_lightCfg)) {
+                unsigned long tSd = millis();
+                if (sdInit()) Serial.println("[DeepSleep] SD mounted");
+                t0 += millis() - tSd;   // sdInit() books its own phase
+                loadSettings(g_settings);
+                loadLightConfig(g_lightCfg);
+                teamBoardLoad();
+                loadCredentialsFromNVS();
+                g_lightCfg.type     = (LightType)g_light_type.toInt();
+                g_lightCfg.ip       = g_light_ip;
+                g_settings.platform = (Platform)g_platform.toInt();
+                if (g_timezone.length() > 0) g_settings.timezone = g_timezone;
+                configSnapshotCapture(g_settings, g_lightCfg);
+            }
+            displaySetFullRefreshEvery(g_settings.fullRefreshEvery);
+            clockInit(g_settings.timezone);
+            wakeProfAdd(WP_SETTINGS, millis() - t0);
+
+            // --- WiFi connect (the TLS that follows raises the clock itself) ---
+            t0 = millis();
+            bool wifiOk = connectWiFi();
+            wakeProfAdd(WP_WIFI, millis() - t0);
+            if (!wifiOk) {
                 Serial.println("[DeepSleep] WiFi failed — back to sleep");
-                setCpuFrequencyMhz(80);
+                wakeProfSetOutcome(WAKE_WIFI_FAIL);
                 enterDeepSleep(g_settings.presenceInterval);
                 return;
             }
 
-            // --- NTP sync + office hours check ---
-            syncNTP();
+            // --- Clock + office hours check ---
+            // time() survived deep sleep on the RTC; NTP only when due, and
+            // in the background while the presence request runs.  Only an
+            // office-hours check with no usable clock has to wait for it.
+            bool ntpPending = clockNeedsSync();
+            if (ntpPending) clockStartSync();
+            if (g_settings.officeHoursEnabled && !clockIsValid()) {
+                t0 = millis();
+                clockFinishSync(5000);
+                wakeProfAdd(WP_NTP, millis() - t0);
+            }
             if (!isOfficeHours()) {
                 Serial.println("[DeepSleep] Outside office hours — sleeping");
+                wakeProfSetOutcome(WAKE_OFF_HOURS);
                 int sleepSec = secondsUntilOfficeStart();
                 if (sleepSec < 60) sleepSec = 60;
+                httpsCloseAll();
                 WiFi.disconnect(true);
                 WiFi.mode(WIFI_OFF);
-                setCpuFrequencyMhz(80);
                 enterDeepSleep(sleepSec);
                 return;
             }
@@ -234,42 +321,100 @@ void setup() {
             PresenceState st;
             bool gotPresence = false;
 
+            // Access tokens are cached across deep sleep — only go back to
+            // the auth server when the cached one is missing or near expiry
+            // (or the presence API rejected it with 401).
             if (g_settings.platform == PLATFORM_ZOOM) {
-                if (zoomFetchToken(g_tenant_id, g_client_id, g_client_secret))
+                zoomLoadCachedToken();
+                bool haveToken = (zoomHasValidToken() && !zoomIsTokenExpiringSoon()) ||
+                                 zoomFetchToken(g_tenant_id, g_client_id, g_client_secret);
+                if (haveToken)
                     gotPresence = getZoomPresence(zoomGetAccessToken(), st);
+                if (!gotPresence && haveToken && !zoomHasValidToken() &&
+                    zoomFetchToken(g_tenant_id, g_client_id, g_client_secret))
+                    gotPresence = getZoomPresence(zoomGetAccessToken(), st);
+            } else if (g_settings.platform == PLATFORM_BOTH) {
+                loadAuthFromNVS();
+                gotPresence = pollBothPresence(st);
+                if (gotPresence && hasValidToken() && calendarNeedsRefresh())
+                    calendarRefresh(getAccessToken());
             } else {
+                // Team board: every member in one batch request instead
+                auto poll = [&]() {
+                    return teamMode() ? teamFetch(getAccessToken(), g_teamChanged)
+                                      : getPresence(getAccessToken(), st);
+                };
                 loadAuthFromNVS();
-                if (refreshAccessToken(g_client_id, g_tenant_id))
-                    gotPresence = getPresence(getAccessToken(), st);
+                bool haveToken = (hasValidToken() && !isTokenExpiringSoon()) ||
+                                 refreshAccessToken(g_client_id, g_tenant_id);
+                if (haveToken)
+                    gotPresence = poll();
+                if (!gotPresence && haveToken && !hasValidToken() &&
+                    refreshAccessToken(g_client_id, g_tenant_id))
+                    gotPresence = poll();
+                // Same Graph connection — roughly one extra GET per day
+                if (gotPresence && !teamMode() && calendarNeedsRefresh())
+                    calendarRefresh(getAccessToken());
             }
 
-            bool changed = gotPresence &&
-                            strcmp(st.availability.c_str(), rtc_lastAvailability) != 0;
+            if (ntpPending) {
+                t0 = millis();
+                clockFinishSync(1000);
+                wakeProfAdd(WP_NTP, millis() - t0);
+            }
+
+            if (teamMode()) {
+                // Board rows are redrawn in place — the pod stays on the
+                // deep-sleep cadence (no lights or sound for other people)
+                if (gotPresence && g_teamChanged) {
+                    Serial.printf("[DeepSleep] Team board changed (rows 0x%02X)\n", g_teamChanged);
+                    wakeProfSetOutcome(WAKE_CHANGED);
+                    pollPolicyRecordChange();
+                    rtc_stableCount = 0;
+                    initializeHardware();
+                    drawTeamBoard(g_teamChanged);
+                    displayWaitIdle();
+                    wakeProfAdd(WP_EPD, display.epd2.refreshBusyMs());
+                } else if (rtc_stableCount < 255) {
+                    rtc_stableCount++;
+                }
+                httpsCloseAll();
+                WiFi.disconnect(true);
+                WiFi.mode(WIFI_OFF);
+                enterDeepSleep(nextPollInterval());
+                return;
+            }
+
+            bool changed = gotPresence && st.availability != rtc_lastAvailability;
 
             if (!changed) {
                 // UNCHANGED — back to deep sleep
-                rtc_stableCount++;
+                if (rtc_stableCount < 255) rtc_stableCount++;
                 Serial.printf("[DeepSleep] Unchanged (%s), stable=%d — sleeping\n",
-                              rtc_lastAvailability, rtc_stableCount);
+                              availabilityName((Availability)rtc_lastAvailability),
+                              rtc_stableCount);
+                httpsCloseAll();
                 WiFi.disconnect(true);
                 WiFi.mode(WIFI_OFF);
-                setCpuFrequencyMhz(80);
-                enterDeepSleep(g_settings.presenceInterval);
+                enterDeepSleep(nextPollInterval());
                 return;
             }
 
             // STATUS CHANGED — update display & lights, enter normal mode
             Serial.printf("[DeepSleep] Changed: %s → %s\n",
-                          rtc_lastAvailability, st.availability.c_str());
-            strncpy(rtc_lastAvailability, st.availability.c_str(), 31);
-            rtc_lastAvailability[31] = '\0';
+                          availabilityName((Availability)rtc_lastAvailability),
+                          availabilityName(st.availability));
+            calendarNotePresenceChange();
+            pollPolicyRecordChange();
+            rtc_lastAvailability = st.availability;
             rtc_deepSleepActive = false;
             rtc_stableCount     = 0;
 
+            // Panel and lights in parallel; codec init overlaps both
+            wakeProfSetOutcome(WAKE_CHANGED);
             initializeHardware();
-            drawStatusScreen(st.availability.c_str(), st.activity.c_str());
             lightDevicesLoad();
-            lightSetPresence(g_lightCfg, st.availability.c_str());
+            outputPresenceChanged(st.availability, st.activity, g_lightCfg, false);
 
             g_lastAvailability  = st.availability;
             g_currentPresence   = st;
@@ -277,9 +422,15 @@ void setup() {
             g_lastPresenceCheck = millis();
             g_lastBatteryCheck  = millis();
 
+            t0 = millis();
             audioInit(false);  // safe to call again — has internal guard
+            wakeProfAdd(WP_AUDIO, millis() - t0);
+            outputPipelineJoin();
+            displayWaitIdle();
+            wakeProfAdd(WP_EPD, display.epd2.refreshBusyMs());
+            wakeProfEnd(0);
+            pollArenaReset();
 
-            if (!batteryOnUSB(batteryReadVoltage())) setCpuFrequencyMhz(80);
             return;  // enter loop() in STATE_RUNNING
 
         } else {
@@ -292,19 +443,24 @@ void setup() {
     }
 
 normalBoot:
-    bool skipSplash = (reason == ESP_RST_DEEPSLEEP);
+    bool bleSetup   = bleSetupRequested();  // Settings → BLE Setup rebooted us
+    bool skipSplash = (reason == ESP_RST_DEEPSLEEP) || bleSetup;
 
     initializeHardware();
 
     // Mount SD card (before settings, so SD config is preferred)
     if (sdInit()) {
         Serial.printf("[Main] SD card: %s\n", sdCardInfo().c_str());
+        wakeProfFlush();
     } else {
         Serial.println("[Main] No SD card — using NVS for settings");
     }
 
     loadSettings(g_settings);
+    displaySetFullRefreshEvery(g_settings.fullRefreshEvery);
     loadLightConfig(g_lightCfg);
+    teamBoardLoad();
+    displayPrepareStatusFrames();
 
     // Audio init (ES8311 + I2S) — skip test tone on deep sleep resume
     audioInit(!skipSplash);
@@ -312,39 +468,39 @@ normalBoot:
     if (!skipSplash)
         drawSplashScreen(platformName(g_settings.platform));
 
+    // Decode the UI sounds while the splash refresh runs
+    audioPreload();
+
     // --- Splash gate: wait for BOOT press (short = continue, hold 3s = reset)
     if (!skipSplash) {
         Serial.println("[Main] Splash — press BOOT to continue, hold 3s for reset");
-        while (true) {
-            if (digitalRead(BOOT_BUTTON) == LOW) {
-                unsigned long holdStart = millis();
-                // Wait for release or 3-second hold
-                while (digitalRead(BOOT_BUTTON) == LOW) {
-                    if (millis() - holdStart >= 3000) {
-                        Serial.println("[Main] BOOT held 3s — factory reset");
-                        drawErrorScreen("Factory Reset", "Clearing all data...");
-                        clearStoredCredentials();
-                        clearAuthNVS();
-                        delay(2000);
-                        ESP.restart();
-                    }
-                    delay(50);
-                }
+        ButtonEvent ev;
+        while (inputWait(ev, INPUT_FOREVER)) {
+            if (ev.button != BTN_BOOT) continue;
+            if (ev.action == BTN_LONG) {
+                Serial.println("[Main] BOOT held 3s — factory reset");
+                drawErrorScreen("Factory Reset", "Clearing all data...");
+                clearStoredCredentials();
+                clearAuthNVS();
+                delay(2000);
+                ESP.restart();
+            }
+            if (ev.action == BTN_RELEASE) {
                 // Short press — continue boot
                 Serial.println("[Main] BOOT pressed — continuing");
                 if (g_settings.audioAlerts) audioBeep();
                 break;
             }
-            delay(50);
         }
     }
 
-    // --- BLE always initialised (also opens NVS) ---
-    initializeBLE();
-
-    // --- Credential check ---
-    if (!hasStoredCredentials()) {
-        Serial.println("[Main] No credentials — Setup Mode");
+    // --- Credential check — BLE only comes up for setup ---
+    g_bleFromSettings = bleSetup && hasStoredCredentials();
+    if (g_bleFromSettings || !hasStoredCredentials()) {
+        Serial.println(g_bleFromSettings ? "[Main] BLE setup requested — Setup Mode"
+                                         : "[Main] No credentials — Setup Mode");
+        if (g_bleFromSettings) loadCredentialsFromNVS();  // served by config reads
+        initializeBLE();
         g_state = STATE_SETUP_BLE;
         startBLEAdvertising();
         drawSetupScreen();
@@ -352,7 +508,7 @@ normalBoot:
     }
     loadCredentialsFromNVS();
 
-    // BLE no longer needed — free ~60 KB of RAM
+    // BLE not needed — its host + controller RAM goes back to the heap
     deinitBLE();
 
     // Sync BLE light globals → LightConfig (BLE saves to puck_creds namespace)
@@ -368,6 +524,8 @@ normalBoot:
                   platformName(g_settings.platform),
                   g_ssid.c_str(), g_client_id.c_str(), g_tenant_id.c_str());
     Serial.printf("[Main] Timezone: %s\n", g_settings.timezone.c_str());
+    clockInit(g_settings.timezone);
+    configSnapshotCapture(g_settings, g_lightCfg);
 
     // --- WiFi ---
     g_state = STATE_CONNECTING_WIFI;
@@ -377,8 +535,11 @@ normalBoot:
         return;
     }
 
-    // --- NTP time sync ---
-    syncNTP();
+    // --- NTP time sync (skipped if the RTC clock is still trustworthy) ---
+    if (clockNeedsSync()) {
+        clockStartSync();
+        clockFinishSync(5000);
+    }
 
     // --- Office hours check (battery only) ---
     if (!batteryOnUSB(batteryReadVoltage()) && !isOfficeHours()) {
@@ -392,11 +553,13 @@ normalBoot:
 
     // --- Light devices: load cache then discover ---
     lightDevicesLoad();
-    // Skip discovery on battery if we have cached devices
-    if (batteryOnUSB(batteryReadVoltage()) || lightDevicesGet().empty()) {
+    // Rediscover only when the cache is empty, or past its TTL on USB —
+    // on battery a stale cache still stands until the next USB boot
+    if (lightDevicesGet().empty() ||
+        (batteryOnUSB(batteryReadVoltage()) && lightDiscoveryDue())) {
         lightDiscoverAll(g_lightCfg);
     } else {
-        Serial.println("[Main] Battery mode — using cached light devices");
+        Serial.println("[Main] Using cached light devices");
     }
 
     // --- WLED zero-config auto-trigger (set during BLE first setup) ---
@@ -421,7 +584,8 @@ normalBoot:
     if (g_settings.platform == PLATFORM_ZOOM) {
         // Zoom S2S OAuth — automatic, no user interaction
         Serial.println("[Main] Zoom S2S — fetching token...");
-        if (zoomFetchToken(g_tenant_id, g_client_id, g_client_secret)) {
+        bool cached = zoomLoadCachedToken() && !zoomIsTokenExpiringSoon();
+        if (cached || zoomFetchToken(g_tenant_id, g_client_id, g_client_secret)) {
             g_state = STATE_RUNNING;
             g_lastPresenceCheck = 0;
             updateAndDisplayPresence();
@@ -435,7 +599,8 @@ normalBoot:
         if (hasStoredRefreshToken()) {
             // Retry refresh up to 3 times — deep sleep wake may have
             // transient network issues (DNS, TLS) that resolve quickly.
-            bool refreshed = false;
+            // A cached access token with time left skips the refresh.
+            bool refreshed = hasValidToken() && !isTokenExpiringSoon();
             for (int attempt = 1; attempt <= 3 && !refreshed; attempt++) {
                 Serial.printf("[Main] Token refresh attempt %d/3...\n", attempt);
                 refreshed = refreshAccessToken(g_client_id, g_tenant_id);
@@ -466,9 +631,40 @@ normalBoot:
             drawErrorScreen("Auth Error", detail);
         }
     }
+}
 
-    // Drop to 80 MHz on battery for idle power savings
-    if (!batteryOnUSB(batteryReadVoltage())) setCpuFrequencyMhz(80);
+// ============================================================================
+// Running-state buttons
+//   BOOT           = manual refresh
+//   PWR short      = menu (on release)
+//   PWR held 3 s   = power off
+// Returns true if the menu ran (the caller re-evaluates the state).
+// ============================================================================
+static bool handleRunningButton(const ButtonEvent& ev) {
+    if (ev.button == BTN_BOOT && ev.action == BTN_PRESS) {
+        outputPipelineJoin();
+        if (g_settings.audioAlerts) audioClick();
+        Serial.println("[Main] Manual refresh");
+        if (WiFi.status() != WL_CONNECTED) connectWiFi();
+        updateAndDisplayPresence();
+        g_lastPresenceCheck = millis();
+        rtc_stableCount = 0;  // user activity resets deep sleep
+        g_pollIntervalSec = 0;
+        return false;
+    }
+    if (ev.button != BTN_PWR) return false;
+
+    if (ev.action == BTN_LONG) {
+        checkPowerOff();    // never returns
+    } else if (ev.action == BTN_RELEASE && ev.heldMs < INPUT_LONG_MS) {
+        outputPipelineJoin();
+        if (g_settings.audioAlerts) audioClick();
+        rtc_stableCount = 0;  // user activity resets deep sleep
+        g_pollIntervalSec = 0;
+        handleMenu();
+        return true;
+    }
+    return false;
 }
 
 // ============================================================================
@@ -485,9 +681,18 @@ void loop() {
     switch (g_state) {
 
     // ---- BLE setup: just wait for callbacks ----------------------------
-    case STATE_SETUP_BLE:
-        delay(100);
+    case STATE_SETUP_BLE: {
+        // Opened from Settings: any button leaves without saving.  That's a
+        // reboot — the BLE memory can't be released and the stack restarted.
+        bleSetupService();
+        ButtonEvent ev;
+        if (inputWait(ev, 100) && g_bleFromSettings && ev.action == BTN_PRESS) {
+            Serial.println("[Main] Setup left — rebooting");
+            Serial.flush();
+            ESP.restart();
+        }
         break;
+    }
 
     // ---- Device-code auth: poll at interval ----------------------------
     case STATE_AUTH_DEVICE_CODE: {
@@ -500,10 +705,13 @@ void loop() {
             break;
         }
 
-        // BOOT button toggles between QR and code text
-        if (digitalRead(BOOT_BUTTON) == LOW) {
-            delay(200);  // debounce
-            while (digitalRead(BOOT_BUTTON) == LOW) delay(50);
+        // BOOT button toggles between QR and code text; otherwise sleep on
+        // the button queue until the next token poll is due
+        unsigned long sincePoll = millis() - g_lastPollTime;
+        unsigned long pollMs    = (unsigned long)g_deviceCode.interval * 1000UL;
+        ButtonEvent ev;
+        if (inputWait(ev, sincePoll < pollMs ? pollMs - sincePoll : 0) &&
+            ev.button == BTN_BOOT && ev.action == BTN_PRESS) {
             showingQR = !showingQR;
             if (showingQR) {
                 drawQRAuthScreen(g_deviceCode.user_code.c_str(),
@@ -519,6 +727,7 @@ void loop() {
             Serial.println("[Main] Polling for token...");
             int r = pollForToken(g_client_id, g_tenant_id,
                                  g_deviceCode.device_code);
+            pollArenaReset();
             if (r == 1) {
                 showingQR = true;  // reset for next time
                 saveAuthToNVS();
@@ -544,6 +753,7 @@ void loop() {
     case STATE_RUNNING: {
         bool onUSB = batteryOnUSB(batteryReadVoltage());
         batteryUpdateChargeLED(onUSB);
+        powerSetUsbMode(onUSB);   // USB: full clock, console up; battery: DFS + light sleep
 
         // --- Charging = WOT: full speed, serial on, no sleep ---
         if (onUSB) {
@@ -564,35 +774,32 @@ void loop() {
         }
 
         // --- Presence poll ---
-        bool needPoll = (millis() - g_lastPresenceCheck >=
-                         (unsigned long)g_settings.presenceInterval * 1000UL);
+        int  pollSec  = (onUSB || g_pollIntervalSec <= 0) ? g_settings.presenceInterval
+                                                          : g_pollIntervalSec;
+        bool needPoll = (millis() - g_lastPresenceCheck >= (unsigned long)pollSec * 1000UL);
         if (needPoll) {
             // Office hours check (on battery only)
             if (!onUSB && !isOfficeHours()) {
                 Serial.println("[Power] Outside office hours — deep sleep");
                 int sleepSec = secondsUntilOfficeStart();
                 if (sleepSec < 60) sleepSec = 60;  // minimum 1 min
-                strncpy(rtc_lastAvailability, g_lastAvailability.c_str(), 31);
-                rtc_lastAvailability[31] = '\0';
+                rtc_lastAvailability = g_lastAvailability;
                 rtc_deepSleepActive = true;
                 enterDeepSleep(sleepSec);
                 return;  // never reached
             }
 
-            // Boost CPU for WiFi + HTTPS
-            if (!onUSB) setCpuFrequencyMhz(240);
-
             if (WiFi.status() != WL_CONNECTED) {
                 Serial.println("[Main] Reconnecting WiFi for poll...");
                 if (!connectWiFi()) {
                     Serial.println("[Main] WiFi failed, will retry next cycle");
                     g_lastPresenceCheck = millis();
-                    if (!onUSB) setCpuFrequencyMhz(80);
                     delay(1000);
                     break;
                 }
             }
             g_lastPresenceCheck = millis();
+            if (clockNeedsSync()) clockStartSync();   // completes in background
 
             // Platform-aware token refresh
             if (g_settings.platform == PLATFORM_ZOOM) {
@@ -604,90 +811,70 @@ void loop() {
             }
 
             // Track status change for deep sleep decision
-            String oldAvail = g_lastAvailability;
+            Availability oldAvail  = g_lastAvailability;
+            bool         hadStatus = teamMode() ? teamBoardFetched() : oldAvail != AV_NONE;
             updateAndDisplayPresence();
 
+            bool changed = hadStatus && (teamMode() ? g_teamChanged != 0
+                                                    : g_lastAvailability != oldAvail);
+            if (changed) pollPolicyRecordChange();
+
             if (!onUSB) {
                 // Track consecutive unchanged polls
-                if (g_lastAvailability == oldAvail && !oldAvail.isEmpty()) {
+                if (!changed && hadStatus) {
                     rtc_stableCount++;
                 } else {
                     rtc_stableCount = 0;
                 }
+                g_pollIntervalSec = nextPollInterval();
 
                 // Battery check (merged into wake cycle — no separate timer)
                 checkBattery();
-
-                setCpuFrequencyMhz(80);  // back to low speed
             }
         }
 
-        // --- BOOT = manual refresh ---
-        if (digitalRead(BOOT_BUTTON) == LOW) {
-            delay(200);
-            if (digitalRead(BOOT_BUTTON) == LOW) {
-                if (g_settings.audioAlerts) audioClick();
-                Serial.println("[Main] Manual refresh");
-                if (!onUSB) setCpuFrequencyMhz(240);
-                if (WiFi.status() != WL_CONNECTED) connectWiFi();
-                updateAndDisplayPresence();
-                g_lastPresenceCheck = millis();
-                rtc_stableCount = 0;  // user activity resets deep sleep
-                if (!onUSB) setCpuFrequencyMhz(80);
-                while (digitalRead(BOOT_BUTTON) == LOW) delay(50);
-            }
-        }
-
-        // --- PWR = short press opens menu, long press powers off ---
-        if (digitalRead(PWR_BUTTON) == LOW) {
-            unsigned long pressStart = millis();
-            while (digitalRead(PWR_BUTTON) == LOW) {
-                if (millis() - pressStart >= 3000) {
-                    checkPowerOff();
-                    break;
-                }
-                delay(50);
-            }
-            if (millis() - pressStart < 3000) {
-                if (g_settings.audioAlerts) audioClick();
-                delay(100);
-                rtc_stableCount = 0;  // user activity resets deep sleep
-                handleMenu();
-            }
-            break;  // re-evaluate state after menu
+        // --- Buttons: whatever the input ISR queued since the last pass ---
+        ButtonEvent ev;
+        while (inputWait(ev, 0)) {
+            if (handleRunningButton(ev)) return;  // state may have changed
         }
 
         // --- Power management ---
         if (onUSB) {
-            // USB: full power, no sleep, WiFi stays up
-            delay(100);
+            // USB: full power, WiFi stays up — block on the button queue
+            // until the next poll instead of spinning
+            unsigned long now      = millis();
+            unsigned long nextPoll = g_lastPresenceCheck + (unsigned long)pollSec * 1000UL;
+            if (inputWait(ev, nextPoll > now ? nextPoll - now : 0))
+                handleRunningButton(ev);
         } else if (rtc_stableCount >= DEEP_SLEEP_THRESHOLD) {
             // Stable long enough — enter deep sleep
             Serial.printf("[Power] %d stable polls — deep sleep\n",
                           rtc_stableCount);
-            strncpy(rtc_lastAvailability, g_lastAvailability.c_str(), 31);
-            rtc_lastAvailability[31] = '\0';
+            rtc_lastAvailability = g_lastAvailability;
             rtc_deepSleepActive = true;
-            enterDeepSleep(g_settings.presenceInterval);
+            enterDeepSleep(nextPollInterval());
             // Never returns
         } else {
             // Light sleep until next poll (building toward deep sleep)
             unsigned long now      = millis();
-            unsigned long nextPoll = g_lastPresenceCheck +
-                                     (unsigned long)g_settings.presenceInterval * 1000UL;
+            unsigned long nextPoll = g_lastPresenceCheck + (unsigned long)pollSec * 1000UL;
 
             if (nextPoll > now + 1000) {
                 unsigned long sleepMs = nextPoll - now - 500;
 
+                // Stages may still be on WiFi / the panel, a clip on I2S
+                outputPipelineJoin();
+                audioWaitIdle();
+
                 // Suspend WiFi for sleep
                 if (WiFi.getMode() != WIFI_OFF) {
+                    httpsCloseAll();
                     WiFi.disconnect(true);
                     WiFi.mode(WIFI_OFF);
                 }
 
-                // Configure GPIO wake for button presses
-                gpio_wakeup_enable((gpio_num_t)BOOT_BUTTON, GPIO_INTR_LOW_LEVEL);
-                gpio_wakeup_enable((gpio_num_t)PWR_BUTTON,  GPIO_INTR_LOW_LEVEL);
+                // Buttons are already armed as GPIO wake sources (input.h)
                 esp_sleep_enable_gpio_wakeup();
                 esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
 
@@ -699,22 +886,21 @@ void loop() {
                 esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
                 Serial.printf("[Power] Woke: %s\n",
                               cause == ESP_SLEEP_WAKEUP_GPIO ? "button" : "timer");
-                delay(50);  // debounce
-            } else {
-                delay(100);
+                // A button wake's press arrives once the debounce timer runs
+            } else if (inputWait(ev, 100)) {
+                handleRunningButton(ev);
             }
         }
         break;
     }
 
     // ---- Error: hold BOOT 3 s to restart --------------------------------
-    case STATE_ERROR:
-        if (digitalRead(BOOT_BUTTON) == LOW) {
-            delay(3000);
-            if (digitalRead(BOOT_BUTTON) == LOW) ESP.restart();
-        }
-        delay(100);
+    case STATE_ERROR: {
+        ButtonEvent ev;
+        if (inputWait(ev, 5000) && ev.button == BTN_BOOT && ev.action == BTN_LONG)
+            ESP.restart();
         break;
+    }
 
     default:
         delay(100);
@@ -724,6 +910,18 @@ void loop() {
 // ============================================================================
 // Hardware init
 // ============================================================================
+
+// Light sleep stalls the radio and I2S, so only nap on BUSY when neither runs
+static bool epdMayLightSleep() {
+    return WiFi.getMode() == WIFI_OFF && !outputPipelineBusy() && !audioIsPlaying();
+}
+
+// Panel RAM writes hold APB up so a clock switch can't stretch the SPI burst
+static void epdTransferHook(bool active) {
+    if (active) powerLockAcquire(PM_LOCK_APB_MAX);
+    else        powerLockRelease(PM_LOCK_APB_MAX);
+}
+
 void initializeHardware() {
     if (psramFound())
         Serial.printf("[HW] PSRAM: %d MB\n",
@@ -739,10 +937,13 @@ void initializeHardware() {
     batteryUpdateChargeLED(batteryOnUSB(batteryReadVoltage()));
 
     // GxEPD2 display
-    display.init(115200, true, 20, false, SPI,
-                 SPISettings(10000000, MSBFIRST, SPI_MODE0));
+    displayBegin();
     SPI.end();
     SPI.begin(EPD_SCK_PIN, -1, EPD_MOSI_PIN, -1);
+    // Refresh returns at once; the next panel access waits on the BUSY edge
+    display.epd2.setAsyncRefresh(true);
+    display.epd2.setBusySleepGate(epdMayLightSleep);
+    display.epd2.setTransferHook(epdTransferHook);
     Serial.printf("[HW] Display: %dx%d\n", display.width(), display.height());
 }
 
@@ -750,31 +951,49 @@ void initializeHardware() {
 // WiFi
 // ============================================================================
 bool connectWiFi(unsigned long timeoutMs) {
-    Serial.printf("[WiFi] Connecting to %s", g_ssid.c_str());
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(g_ssid.c_str(), g_password.c_str());
-
-    unsigned long t0 = millis();
-    while (WiFi.status() != WL_CONNECTED && millis() - t0 < timeoutMs) {
-        delay(500);
-        Serial.print(".");
-    }
-    Serial.println();
-
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.printf("[WiFi] ✓ IP %s\n", WiFi.localIP().toString().c_str());        esp_wifi_set_ps(WIFI_PS_MIN_MODEM);  // modem sleep between polls
-        Serial.println("[WiFi] Modem sleep enabled");        return true;
-    }
-    Serial.println("[WiFi] ✗ Failed");
-    return false;
+    return wifiConnect(g_ssid, g_password, timeoutMs);
 }
 
 // ============================================================================
 // Presence fetch + display update
 // ============================================================================
-void updateAndDisplayPresence() {
+// Nothing to draw; a light that restarted or whose acknowledged state aged
+// out (light_state.h) gets the current state again rather than waiting for
+// the next change
+static void presenceUnchanged(const PresenceState& st) {
+    Serial.printf("[Main] Unchanged: %s\n", availabilityName(st.availability));
+    if (g_lightCfg.type != LIGHT_NONE && lightStateStale()) {
+        Serial.println("[Main] Re-sending light state");
+        lightSetPresence(g_lightCfg, st.availability, st.activity);
+    }
+}
+
+static void pollAndShowPresence() {
+    // The previous change's stages own display/lights/audio until joined
+    outputPipelineJoin();
+
     // Platform-aware token validation and presence fetch
-    if (g_settings.platform == PLATFORM_ZOOM) {
+    if (g_settings.platform == PLATFORM_BOTH) {
+        PresenceState st;
+        if (pollBothPresence(st)) {
+            if (st.availability != g_lastAvailability) {
+                outputPresenceChanged(st.availability, st.activity,
+                                      g_lightCfg, g_settings.audioAlerts);
+                if (g_lastAvailability != AV_NONE) calendarNotePresenceChange();
+                g_lastAvailability = st.availability;
+            } else {
+                presenceUnchanged(st);
+            }
+            g_currentPresence = st;
+            if (hasValidToken() && calendarNeedsRefresh()) calendarRefresh(getAccessToken());
+        } else if (!hasValidToken() && !zoomHasValidToken()) {
+            outputPipelineJoin();
+            g_state = STATE_ERROR;
+            drawErrorScreen("Auth Lost", "Check Teams / Zoom");
+            if (g_settings.audioAlerts) audioAttention(3);
+            lightOff(g_lightCfg);
+        }
+    } else if (g_settings.platform == PLATFORM_ZOOM) {
         if (!zoomHasValidToken()) {
             Serial.println("[Main] Zoom token invalid — re-fetching");
             if (!zoomFetchToken(g_tenant_id, g_client_id, g_client_secret)) {
@@ -788,19 +1007,17 @@ void updateAndDisplayPresence() {
         PresenceState st;
         if (getZoomPresence(zoomGetAccessToken(), st)) {
             if (st.availability != g_lastAvailability) {
-                drawStatusScreen(st.availability.c_str(),
-                                 st.activity.c_str());
-                lightSetPresence(g_lightCfg, st.availability.c_str());
+                outputPresenceChanged(st.availability, st.activity,
+                                      g_lightCfg, g_settings.audioAlerts);
                 g_lastAvailability = st.availability;
-                if (g_settings.audioAlerts) audioNotify();
             } else {
-                Serial.printf("[Main] Unchanged: %s\n",
-                              st.availability.c_str());
+                presenceUnchanged(st);
             }
             g_currentPresence = st;
         }
     } else {
         // Teams flow
+        g_teamChanged = 0;
         if (!hasValidToken()) {
             Serial.println("[Main] Token invalid — refreshing");
             if (!refreshAccessToken(g_client_id, g_tenant_id)) {
@@ -813,20 +1030,32 @@ void updateAndDisplayPresence() {
         }
 
         PresenceState st;
-        if (getPresence(getAccessToken(), st)) {
+        if (teamMode()) {
+            bool ok = teamFetch(getAccessToken(), g_teamChanged) ||
+                      (!hasValidToken() && refreshAccessToken(g_client_id, g_tenant_id) &&
+                       teamFetch(getAccessToken(), g_teamChanged));
+            if (ok) {
+                // Drawn even when nothing changed if another screen is up
+                drawTeamBoard(g_teamChanged);
+            } else if (!hasValidToken()) {
+                g_state = STATE_ERROR;
+                drawErrorScreen("Auth Lost", "Scan QR to re-auth");
+                if (g_settings.audioAlerts) audioAttention(3);
+            }
+        } else if (getPresence(getAccessToken(), st)) {
             if (st.availability != g_lastAvailability) {
-                drawStatusScreen(st.availability.c_str(),
-                                 st.activity.c_str());
-                lightSetPresence(g_lightCfg, st.availability.c_str());
+                outputPresenceChanged(st.availability, st.activity,
+                                      g_lightCfg, g_settings.audioAlerts);
+                if (g_lastAvailability != AV_NONE) calendarNotePresenceChange();
                 g_lastAvailability = st.availability;
-                if (g_settings.audioAlerts) audioNotify();
             } else {
-                Serial.printf("[Main] Unchanged: %s\n",
-                              st.availability.c_str());
+                presenceUnchanged(st);
             }
             g_currentPresence = st;
+            if (calendarNeedsRefresh()) calendarRefresh(getAccessToken());
         } else if (!hasValidToken()) {
             if (!refreshAccessToken(g_client_id, g_tenant_id)) {
+                outputPipelineJoin();
                 g_state = STATE_ERROR;
                 drawErrorScreen("Auth Lost", "Scan QR to re-auth");
                 if (g_settings.audioAlerts) audioAttention(3);
@@ -836,51 +1065,67 @@ void updateAndDisplayPresence() {
     }
 }
 
-// ============================================================================
-// NTP + Office Hours helpers
-// ============================================================================
-void syncNTP() {
-    if (g_settings.timezone.length() == 0) return;
-    Serial.printf("[NTP] Syncing with TZ: %s\n", g_settings.timezone.c_str());
-    configTzTime(g_settings.timezone.c_str(), "pool.ntp.org", "time.nist.gov");
-    struct tm t;
-    if (getLocalTime(&t, 5000)) {
-        Serial.printf("[NTP] Time: %04d-%02d-%02d %02d:%02d:%02d (wday=%d)\n",
-                      t.tm_year+1900, t.tm_mon+1, t.tm_mday,
-                      t.tm_hour, t.tm_min, t.tm_sec, t.tm_wday);
-    } else {
-        Serial.println("[NTP] Failed to get time");
-    }
+void updateAndDisplayPresence() {
+    pollAndShowPresence();
+    pollArenaReset();       // every request of the cycle has finished
 }
 
+// Teams + Zoom: both presence requests in flight at once, then merged.
+// Tokens come from the caches; a refresh here is sequential but rare.
+bool pollBothPresence(PresenceState& st) {
+    if (!zoomHasValidToken()) zoomLoadCachedToken();
+    bool graphTok = (hasValidToken() && !isTokenExpiringSoon()) ||
+                    refreshAccessToken(g_client_id, g_tenant_id);
+    bool zoomTok  = !g_zoom_account.isEmpty() &&
+                    ((zoomHasValidToken() && !zoomIsTokenExpiringSoon()) ||
+                     zoomFetchToken(g_zoom_account, g_zoom_client_id, g_client_secret));
+
+    PresenceState teams, zoom;
+    fetchBothPresence(graphTok ? getAccessToken()     : nullptr,
+                      zoomTok  ? zoomGetAccessToken() : nullptr, teams, zoom);
+
+    // A 401 dropped that side's token — one more try on its own
+    if (graphTok && !teams.valid && !hasValidToken() &&
+        refreshAccessToken(g_client_id, g_tenant_id))
+        getPresence(getAccessToken(), teams);
+    if (zoomTok && !zoom.valid && !zoomHasValidToken() &&
+        zoomFetchToken(g_zoom_account, g_zoom_client_id, g_client_secret))
+        getZoomPresence(zoomGetAccessToken(), zoom);
+
+    if (!mergePresence(teams, zoom, g_settings.mergeRule, st)) return false;
+    Serial.printf("[Main] Merged (%s): %s\n",
+                  mergeRuleName(g_settings.mergeRule), availabilityName(st.availability));
+    return true;
+}
+
+// ============================================================================
+// Office Hours helpers
+// ============================================================================
 bool isOfficeHours() {
     if (!g_settings.officeHoursEnabled) return true;  // disabled = always on
     struct tm t;
     if (!getLocalTime(&t, 100)) return true;  // can't tell = assume on
-    // tm_wday: 0=Sun,1=Mon..6=Sat → remap to bit0=Mon..bit6=Sun
-    int dayBit = (t.tm_wday == 0) ? 6 : (t.tm_wday - 1);
-    if (!(g_settings.officeDays & (1 << dayBit))) return false;
-    int nowMin   = t.tm_hour * 60 + t.tm_min;
-    int startMin = g_settings.officeStartHour * 60 + g_settings.officeStartMin;
-    int endMin   = g_settings.officeEndHour   * 60 + g_settings.officeEndMin;
-    return (nowMin >= startMin && nowMin < endMin);
+    return officeHoursActive(g_settings, t);
 }
 
 int secondsUntilOfficeStart() {
     struct tm t;
     if (!getLocalTime(&t, 100)) return 3600;  // fallback 1h
-    int startMin = g_settings.officeStartHour * 60 + g_settings.officeStartMin;
-    // Check remaining days this week + wrap
-    for (int ahead = 0; ahead < 8; ahead++) {
-        int wday = (t.tm_wday + ahead) % 7;
-        int dayBit = (wday == 0) ? 6 : (wday - 1);
-        if (!(g_settings.officeDays & (1 << dayBit))) continue;
-        int nowMin = (ahead == 0) ? (t.tm_hour * 60 + t.tm_min) : 0;
-        if (ahead == 0 && nowMin >= startMin) continue;  // already past start today
-        int secsToday = (startMin - nowMin) * 60 - t.tm_sec;
-        return ahead * 86400 + secsToday;
+    int sec = officeHoursSecondsToStart(g_settings, t);
+    return sec >= 0 ? sec : 3600;             // no office days set
+}
+
+// Sleep length before the next poll (battery only).  The poll policy sets
+// the pace from change history and unchanged-poll backoff; on Teams a
+// calendar schedule can only shorten it (tight around meetings, wake
+// before the next one).  The shorter of the two wins.
+int nextPollInterval() {
+    int sec = pollPolicyNextSleep(g_settings, rtc_stableCount);
+    if (g_settings.platform != PLATFORM_ZOOM && calendarHasSchedule()) {
+        int cal = calendarNextSleep(g_settings.presenceInterval, g_settings.maxStaleness);
+        if (cal < sec) sec = cal;
     }
-    return 3600;  // fallback
+    return sec;
 }
 
 // ============================================================================
@@ -892,13 +1137,14 @@ void checkBattery() {
 
     if (batteryOnUSB(voltage))
         return;  // USB powered — no concern
+    if (pct <= BATTERY_WARN_PCT) outputPipelineJoin();   // needs the codec
 
     // Critical — force shutdown to protect battery
     if (pct <= BATTERY_SHUTDOWN_PCT) {
         Serial.printf("[Power] CRITICAL %d%% — auto-shutdown\n", pct);
         audioAttention(3);   // forced beep regardless of settings
         drawLowBatteryScreen(pct, true);
-        delay(3000);
+        audioWaitIdle(ALERT_DRAIN_MS);
         checkPowerOff();
         return;
     }
@@ -915,15 +1161,20 @@ void checkBattery() {
 // ============================================================================
 void checkPowerOff() {
     Serial.println("[Main] Powering off...");
+    outputPipelineJoin();
     // Graceful cleanup — turn off peripherals before power cut
     batteryUpdateChargeLED(false);
     lightOff(g_lightCfg);
+    audioWaitIdle(ALERT_DRAIN_MS);   // let an alert finish; audioShutdown() stops the rest
     audioShutdown();
+    pollPolicyFlush();
+    httpsCloseAll();
     WiFi.disconnect(true);
     WiFi.mode(WIFI_OFF);
     drawShutdownScreen();
+    displayWaitIdle();
     // Wait for button release
-    while (digitalRead(PWR_BUTTON) == LOW) delay(50);
+    inputWaitRelease(BTN_PWR);
     delay(500);  // let user see the screen
     // Release GPIO holds from deep sleep before driving pin LOW
     gpio_hold_dis((gpio_num_t)VBAT_PWR_PIN);
@@ -940,6 +1191,9 @@ void checkPowerOff() {
 // enterDeepSleep — hold power latch, set wake sources, sleep
 // ============================================================================
 void enterDeepSleep(int intervalSec) {
+    outputPipelineJoin();
+    httpsLogStats();
+    wakeProfEnd(intervalSec);
     Serial.printf("[DeepSleep] Sleeping %d s\n", intervalSec);
     Serial.flush();
 
@@ -947,12 +1201,19 @@ void enterDeepSleep(int intervalSec) {
     batteryUpdateChargeLED(false);
 
     // Turn off WiFi
+    httpsCloseAll();
     WiFi.disconnect(true);
     WiFi.mode(WIFI_OFF);
 
-    // Suspend audio codec to save power
+    // Let an alert clip finish (cut off past ALERT_DRAIN_MS), then
+    // suspend the codec to save power
+    if (!audioWaitIdle(ALERT_DRAIN_MS)) audioStop();
     audioSuspend();
 
+    // Finish the last refresh (light-sleeps on BUSY now the radio is off),
+    // then hibernate the panel with its state saved for a warm resume
+    displayWarmSleep();
+
     // Hold power latch HIGH during deep sleep
     gpio_hold_en((gpio_num_t)VBAT_PWR_PIN);
     gpio_deep_sleep_hold_en();
@@ -964,6 +1225,9 @@ void enterDeepSleep(int intervalSec) {
     // Wake on timer
     esp_sleep_enable_timer_wakeup((uint64_t)intervalSec * 1000000ULL);
 
+    // Wake early for a battery threshold (ULP)
+    ulpMonitorStart(intervalSec, BATTERY_WARN_PCT, BATTERY_SHUTDOWN_PCT);
+
     esp_deep_sleep_start();
     // Never returns
 }
@@ -972,16 +1236,9 @@ void enterDeepSleep(int intervalSec) {
 // Wait for any button press (used by info sub-screens)
 // ============================================================================
 void waitForAnyButton() {
-    // Wait for all buttons to be released first
-    while (digitalRead(BOOT_BUTTON) == LOW || digitalRead(PWR_BUTTON) == LOW)
-        delay(50);
-    // Wait for a press
-    while (digitalRead(BOOT_BUTTON) == HIGH && digitalRead(PWR_BUTTON) == HIGH)
-        delay(50);
-    delay(200);  // debounce
-    // Wait for release
-    while (digitalRead(BOOT_BUTTON) == LOW || digitalRead(PWR_BUTTON) == LOW)
-        delay(50);
+    // Presses made before the screen appeared don't count
+    inputFlush();
+    inputWaitRelease(inputWaitPress());
 }
 
 // ============================================================================
@@ -992,17 +1249,13 @@ void handleLightAction(LightDevice& dev) {
     drawLightActionScreen(dev, sel);
 
     while (true) {
-        if (digitalRead(BOOT_BUTTON) == LOW) {
-            delay(200);
-            if (g_settings.audioAlerts) audioClick();
+        PodButton btn = inputWaitPress();
+        if (g_settings.audioAlerts) audioClick();
+        if (btn == BTN_BOOT) {
             sel = (sel + 1) % LACT_COUNT;
             drawLightActionScreen(dev, sel, true);
-            while (digitalRead(BOOT_BUTTON) == LOW) delay(50);
-        }
-        if (digitalRead(PWR_BUTTON) == LOW) {
-            delay(200);
-            if (g_settings.audioAlerts) audioClick();
-            while (digitalRead(PWR_BUTTON) == LOW) delay(50);
+        } else {
+            inputWaitRelease(BTN_PWR);
 
             switch (sel) {
             case LACT_TEST:
@@ -1038,7 +1291,6 @@ void handleLightAction(LightDevice& dev) {
                 return;
             }
         }
-        delay(50);
     }
 }
 
@@ -1068,11 +1320,22 @@ void runWledZeroConfig() {
     }
 
     // Wait for button press to dismiss
-    while (digitalRead(BOOT_BUTTON) == HIGH && digitalRead(PWR_BUTTON) == HIGH) {
-        delay(50);
-    }
-    delay(200);
-    while (digitalRead(BOOT_BUTTON) == LOW || digitalRead(PWR_BUTTON) == LOW) delay(50);
+    waitForAnyButton();
+}
+
+// Redraws the Lights screen while discovery is still running
+struct LightsView {
+    int           selected;
+    int           scrollOffset;
+    unsigned long lastDraw;
+};
+
+static void lightsDiscoveryProgress(void* ctx) {
+    LightsView* v = (LightsView*)ctx;
+    // A partial refresh takes ~0.3 s — batch devices that answer together
+    if (millis() - v->lastDraw < 1000) return;
+    v->lastDraw = millis();
+    drawLightsScreen(v->selected, lightDevicesGet(), v->scrollOffset, true);
 }
 
 void handleLights() {
@@ -1088,9 +1351,10 @@ void handleLights() {
     while (true) {
         int totalItems = 3 + (int)devs.size() + 1;  // Discover + Provision All + Setup New + devices + Back
 
-        if (digitalRead(BOOT_BUTTON) == LOW) {
-            delay(200);
-            if (g_settings.audioAlerts) audioClick();
+        PodButton btn = inputWaitPress();
+        if (g_settings.audioAlerts) audioClick();
+
+        if (btn == BTN_BOOT) {
             selected = (selected + 1) % totalItems;
 
             // Adjust scroll to keep selected visible
@@ -1098,21 +1362,17 @@ void handleLights() {
             if (selected >= scrollOffset + maxVisible) scrollOffset = selected - maxVisible + 1;
 
             drawLightsScreen(selected, devs, scrollOffset, true);
-            while (digitalRead(BOOT_BUTTON) == LOW) delay(50);
-        }
-
-        if (digitalRead(PWR_BUTTON) == LOW) {
-            delay(200);
-            if (g_settings.audioAlerts) audioClick();
-            while (digitalRead(PWR_BUTTON) == LOW) delay(50);
+        } else {
+            inputWaitRelease(BTN_PWR);
 
             if (selected == 0) {
                 // Discover
                 Serial.println("[Lights] Running discovery...");
-                lightDiscoverAll(g_lightCfg);
-                // Reset selection
+                // Reset selection; the list grows on screen as devices answer
                 selected = 0;
                 scrollOffset = 0;
+                LightsView view = { selected, scrollOffset, millis() };
+                lightDiscoverAll(g_lightCfg, lightsDiscoveryProgress, &view);
                 drawLightsScreen(selected, devs, scrollOffset, true);
             } else if (selected == 1) {
                 // Provision All
@@ -1138,7 +1398,6 @@ void handleLights() {
                 }
             }
         }
-        delay(50);
     }
 }
 
@@ -1150,26 +1409,22 @@ void handleLights() {
 void handleMenu() {
     Serial.println("[Menu] Entering menu");
     // Wait for PWR release from the press that opened the menu
-    while (digitalRead(PWR_BUTTON) == LOW) delay(50);
+    inputWaitRelease(BTN_PWR);
 
     int selected = 0;
     drawMenuScreen(selected, g_settings, g_lightCfg);  // first draw: full refresh
 
     while (true) {
+        PodButton btn = inputWaitPress();
+        if (g_settings.audioAlerts) audioClick();
+
         // BOOT = next item
-        if (digitalRead(BOOT_BUTTON) == LOW) {
-            delay(200);
-            if (g_settings.audioAlerts) audioClick();
+        if (btn == BTN_BOOT) {
             selected = (selected + 1) % MENU_COUNT;
             drawMenuScreen(selected, g_settings, g_lightCfg, true);  // partial
-            while (digitalRead(BOOT_BUTTON) == LOW) delay(50);
-        }
-
-        // PWR = select
-        if (digitalRead(PWR_BUTTON) == LOW) {
-            delay(200);
-            if (g_settings.audioAlerts) audioClick();
-            while (digitalRead(PWR_BUTTON) == LOW) delay(50);
+        } else {
+            // PWR = select
+            inputWaitRelease(BTN_PWR);
 
             switch (selected) {
             case MENU_DEVICE_INFO: {
@@ -1177,22 +1432,16 @@ void handleMenu() {
                 int bp = batteryPercent(bv);
                 String ip = WiFi.localIP().toString();
                 bool outsideOH = g_settings.officeHoursEnabled && !isOfficeHours();
+                char prof1[40], prof2[40], heap[40];
+                wakeProfDescribe(prof1, sizeof(prof1), prof2, sizeof(prof2));
+                pollArenaDescribe(heap, sizeof(heap));
                 drawDeviceInfoScreen(g_ssid.c_str(), ip.c_str(),
                                      g_client_id.c_str(), g_tenant_id.c_str(),
-                                     bv, bp, outsideOH, true);
+                                     bv, bp, outsideOH, prof1, prof2, heap, true);
                 // BOOT = close, PWR = reboot
-                while (true) {
-                    if (digitalRead(BOOT_BUTTON) == LOW) {
-                        delay(200);
-                        while (digitalRead(BOOT_BUTTON) == LOW) delay(50);
-                        break;  // back to menu
-                    }
-                    if (digitalRead(PWR_BUTTON) == LOW) {
-                        delay(200);
-                        Serial.println("[Menu] Rebooting...");
-                        ESP.restart();
-                    }
-                    delay(50);
+                if (inputWaitPress() == BTN_PWR) {
+                    Serial.println("[Menu] Rebooting...");
+                    ESP.restart();
                 }
                 drawMenuScreen(selected, g_settings, g_lightCfg, true);
                 break;
@@ -1207,24 +1456,18 @@ void handleMenu() {
                     tokenOk    = hasValidToken();
                     expSec     = getTokenExpirySeconds();
                 }
+                char calLine[40], sleepLine[40];
+                calendarDescribe(calLine, sizeof(calLine), sleepLine, sizeof(sleepLine));
                 drawAuthInfoScreen(tokenOk, expSec,
-                                   g_lastAvailability.c_str(), true);
+                                   availabilityName(g_lastAvailability),
+                                   calLine, sleepLine, true);
                 // BOOT = back to menu, PWR = factory reset
-                while (true) {
-                    if (digitalRead(BOOT_BUTTON) == LOW) {
-                        delay(200);
-                        while (digitalRead(BOOT_BUTTON) == LOW) delay(50);
-                        break;  // back to menu
-                    }
-                    if (digitalRead(PWR_BUTTON) == LOW) {
-                        delay(200);
-                        while (digitalRead(PWR_BUTTON) == LOW) delay(50);
-                        Serial.println("[Menu] Factory reset!");
-                        clearStoredCredentials();
-                        delay(500);
-                        ESP.restart();
-                    }
-                    delay(50);
+                if (inputWaitPress() == BTN_PWR) {
+                    inputWaitRelease(BTN_PWR);
+                    Serial.println("[Menu] Factory reset!");
+                    clearStoredCredentials();
+                    delay(500);
+                    ESP.restart();
                 }
                 drawMenuScreen(selected, g_settings, g_lightCfg, true);
                 break;
@@ -1246,14 +1489,15 @@ void handleMenu() {
 
             case MENU_EXIT:
                 Serial.println("[Menu] Exit");
-                if (g_lastAvailability.length() > 0) {
-                    drawStatusScreen(g_currentPresence.availability.c_str(),
-                                     g_currentPresence.activity.c_str());
+                if (teamMode()) {
+                    drawTeamBoard(0);
+                } else if (g_lastAvailability != AV_NONE) {
+                    drawStatusScreen(g_currentPresence.availability,
+                                     g_currentPresence.activity);
                 }
                 return;
             }
         }
-        delay(50);
     }
 }
 
@@ -1267,20 +1511,16 @@ void handleSettings() {
     drawSettingsScreen(selected, g_settings, g_lightCfg);  // full refresh
 
     while (true) {
+        PodButton btn = inputWaitPress();
+        if (g_settings.audioAlerts) audioClick();
+
         // BOOT = next item
-        if (digitalRead(BOOT_BUTTON) == LOW) {
-            delay(200);
-            if (g_settings.audioAlerts) audioClick();
+        if (btn == BTN_BOOT) {
             selected = (selected + 1) % SET_COUNT;
             drawSettingsScreen(selected, g_settings, g_lightCfg, true);
-            while (digitalRead(BOOT_BUTTON) == LOW) delay(50);
-        }
-
-        // PWR = select
-        if (digitalRead(PWR_BUTTON) == LOW) {
-            delay(200);
-            if (g_settings.audioAlerts) audioClick();
-            while (digitalRead(PWR_BUTTON) == LOW) delay(50);
+        } else {
+            // PWR = select
+            inputWaitRelease(BTN_PWR);
 
             switch (selected) {
             case SET_LIGHT_TYPE: {
@@ -1326,18 +1566,20 @@ void handleSettings() {
                 break;
             }
 
+            case SET_POLL_PROFILE: {
+                int p = (int)g_settings.pollProfile + 1;
+                if (p >= (int)POLL_PROFILE_COUNT) p = 0;
+                g_settings.pollProfile = (PollProfile)p;
+                saveSettings(g_settings);
+                Serial.printf("[Settings] Poll profile → %s\n",
+                              pollProfileName(g_settings.pollProfile));
+                drawSettingsScreen(selected, g_settings, g_lightCfg, true);
+                break;
+            }
+
             case SET_BLE_SETUP: {
                 Serial.println("[Settings] Starting BLE setup");
-                initializeBLE();       // re-init after deinitBLE()
-                loadCredentialsFromNVS();  // populate globals for onRead
-                drawSetupScreen();
-                startBLEAdvertising();
-                waitForAnyButton();
-                stopBLEAdvertising();
-                deinitBLE();           // free RAM again
-                loadSettings(g_settings);
-                loadLightConfig(g_lightCfg);
-                drawSettingsScreen(selected, g_settings, g_lightCfg, true);
+                bleRequestSetup();     // BLE RAM was released at boot — never returns
                 break;
             }
 
@@ -1346,6 +1588,5 @@ void handleSettings() {
                 return;
             }
         }
-        delay(50);
     }
 }
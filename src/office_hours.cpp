@@ -0,0 +1,32 @@
+// ============================================================================
+// Office Hours — is the pod on duty, and how long until it next is
+// ============================================================================
+
+#include "office_hours.h"
+
+// tm_wday: 0=Sun,1=Mon..6=Sat → bit0=Mon..bit6=Sun
+static bool officeDay(const PodSettings& s, int wday) {
+    int dayBit = (wday == 0) ? 6 : (wday - 1);
+    return (s.officeDays & (1 << dayBit)) != 0;
+}
+
+bool officeHoursActive(const PodSettings& s, const struct tm& local) {
+    if (!s.officeHoursEnabled) return true;  // disabled = always on
+    if (!officeDay(s, local.tm_wday)) return false;
+    int nowMin   = local.tm_hour * 60 + local.tm_min;
+    int startMin = s.officeStartHour * 60 + s.officeStartMin;
+    int endMin   = s.officeEndHour   * 60 + s.officeEndMin;
+    return (nowMin >= startMin && nowMin < endMin);
+}
+
+int officeHoursSecondsToStart(const PodSettings& s, const struct tm& local) {
+    int nowSec   = (local.tm_hour * 60 + local.tm_min) * 60 + local.tm_sec;
+    int startSec = (s.officeStartHour * 60 + s.officeStartMin) * 60;
+    // Today (if the start is still ahead) through the same weekday next week
+    for (int ahead = 0; ahead < 8; ahead++) {
+        if (!officeDay(s, (local.tm_wday + ahead) % 7)) continue;
+        if (ahead == 0 && nowSec >= startSec) continue;  // already past start today
+        return ahead * 86400 + startSec - nowSec;
+    }
+    return -1;
+}
@@ -0,0 +1,135 @@
+// ============================================================================
+// Output Pipeline — display, lights and audio for a status change, in parallel
+// ============================================================================
+
+#include "output_pipeline.h"
+#include "display_ui.h"
+#include "audio.h"
+#include "wake_profiler.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/event_groups.h>
+
+// Stage done-bits (set = idle)
+#define STAGE_DISPLAY   BIT0
+#define STAGE_LIGHT     BIT1
+#define STAGE_AUDIO     BIT2
+#define STAGE_ALL       (STAGE_DISPLAY | STAGE_LIGHT | STAGE_AUDIO)
+
+// Lights sit next to the WiFi/lwIP tasks on core 0; the panel and the
+// codec share core 1 with loop() — the EPD stage mostly sleeps on BUSY.
+struct StageDef {
+    const char* name;
+    EventBits_t bit;
+    BaseType_t  core;
+    UBaseType_t priority;
+    uint32_t    stack;
+};
+
+static const StageDef STAGES[] = {
+    { "out_epd",   STAGE_DISPLAY, 1, 2, 8192 },
+    { "out_light", STAGE_LIGHT,   0, 2, 6144 },
+    { "out_audio", STAGE_AUDIO,   1, 3, 8192 },
+};
+static const int STAGE_COUNT = sizeof(STAGES) / sizeof(STAGES[0]);
+
+// ---- The change being output (written only while all stages are idle) ------
+static Availability s_availability = AV_UNKNOWN;
+static Activity     s_activity     = ACT_NONE;
+static LightConfig  s_light;
+
+static EventGroupHandle_t s_done    = nullptr;
+static TaskHandle_t       s_tasks[STAGE_COUNT] = {};
+static EventBits_t        s_pending = 0;     // stages started and not yet joined
+static bool               s_failed  = false; // couldn't create tasks — run inline
+
+// ----------------------------------------------------------------------------
+static void runStage(EventBits_t bit) {
+    switch (bit) {
+    case STAGE_DISPLAY:
+        drawStatusScreen(s_availability, s_activity);
+        break;
+    case STAGE_LIGHT: {
+        WakePhaseTimer timer(WP_LIGHT);
+        lightSetPresence(s_light, s_availability, s_activity);
+        break;
+    }
+    case STAGE_AUDIO: {
+        WakePhaseTimer timer(WP_AUDIO);
+        audioNotify();
+        break;
+    }
+    }
+}
+
+static void stageTask(void* arg) {
+    const StageDef* def = (const StageDef*)arg;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        runStage(def->bit);
+        xEventGroupSetBits(s_done, def->bit);
+    }
+}
+
+static bool ensureTasks() {
+    if (s_done) return true;
+    if (s_failed) return false;
+    s_done = xEventGroupCreate();
+    if (!s_done) { s_failed = true; return false; }
+    xEventGroupSetBits(s_done, STAGE_ALL);
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const StageDef& d = STAGES[i];
+        if (xTaskCreatePinnedToCore(stageTask, d.name, d.stack, (void*)&d,
+                                    d.priority, &s_tasks[i], d.core) != pdPASS) {
+            Serial.printf("[Output] Can't start %s — running stages inline\n", d.name);
+            for (int j = 0; j < i; j++) vTaskDelete(s_tasks[j]);
+            vEventGroupDelete(s_done);
+            s_done   = nullptr;
+            s_failed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void outputPresenceChanged(Availability availability, Activity activity,
+                           const LightConfig& light, bool notify) {
+    outputPipelineJoin();
+
+    s_availability = availability;
+    s_activity     = activity;
+    s_light        = light;
+
+    EventBits_t want = STAGE_DISPLAY;
+    if (light.type != LIGHT_NONE) want |= STAGE_LIGHT;
+    if (notify)                   want |= STAGE_AUDIO;
+
+    if (!ensureTasks()) {
+        // Sequential fallback — same order as before the pipeline
+        for (int i = 0; i < STAGE_COUNT; i++)
+            if (want & STAGES[i].bit) runStage(STAGES[i].bit);
+        return;
+    }
+
+    xEventGroupClearBits(s_done, want);
+    s_pending = want;
+    for (int i = 0; i < STAGE_COUNT; i++)
+        if (want & STAGES[i].bit) xTaskNotifyGive(s_tasks[i]);
+}
+
+void outputPipelineJoin() {
+    if (!s_pending) return;
+    unsigned long t0 = millis();
+    xEventGroupWaitBits(s_done, s_pending, pdFALSE, pdTRUE, portMAX_DELAY);
+    s_pending = 0;
+    Serial.printf("[Output] Stages joined (waited %lums)\n", millis() - t0);
+}
+
+bool outputPipelineBusy() {
+    if (!s_pending) return false;
+    return (xEventGroupGetBits(s_done) & s_pending) != s_pending;
+}
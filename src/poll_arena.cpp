@@ -0,0 +1,207 @@
+// ============================================================================
+// Poll Arena — PSRAM scratch memory for a poll cycle's HTTP and JSON work
+// ============================================================================
+
+#include "poll_arena.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+
+// Every block starts with its size, so realloc can copy and free can tell
+// an arena block from a heap fallback.  8 bytes keeps payloads aligned.
+struct BlockHdr {
+    uint32_t size;
+    uint32_t inArena;
+};
+static const size_t HDR   = sizeof(BlockHdr);
+static const size_t ALIGN = 8;
+
+static uint8_t*     s_base      = nullptr;
+static size_t       s_top       = 0;    // bytes in use
+static size_t       s_last      = 0;    // offset of the newest block (grows in place)
+static uint32_t     s_live      = 0;    // arena blocks not yet freed
+static size_t       s_peak      = 0;
+static size_t       s_cyclePeak = 0;
+static uint32_t     s_fallbacks = 0;    // blocks the arena couldn't hold this cycle
+static portMUX_TYPE s_mux       = portMUX_INITIALIZER_UNLOCKED;
+
+static size_t alignUp(size_t n) {
+    return (n + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+static BlockHdr* hdrOf(void* p) {
+    return (BlockHdr*)((uint8_t*)p - HDR);
+}
+
+static void notePeak() {
+    if (s_top > s_cyclePeak) s_cyclePeak = s_top;
+    if (s_top > s_peak)      s_peak      = s_top;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void pollArenaInit() {
+    if (s_base) return;
+    s_base = (uint8_t*)heap_caps_malloc(POLL_ARENA_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (s_base)
+        Serial.printf("[Arena] %u KB in PSRAM\n", (unsigned)(POLL_ARENA_SIZE / 1024));
+    else
+        Serial.println("[Arena] No PSRAM — requests use the heap");
+}
+
+void* pollArenaAlloc(size_t size) {
+    size_t need = alignUp(HDR + size);
+    BlockHdr* h = nullptr;
+
+    if (s_base) {
+        portENTER_CRITICAL(&s_mux);
+        if (s_live == 0) s_top = 0;         // nothing live — start over
+        if (need <= POLL_ARENA_SIZE - s_top) {
+            h = (BlockHdr*)(s_base + s_top);
+            s_last = s_top;
+            s_top += need;
+            s_live++;
+            notePeak();
+        } else {
+            s_fallbacks++;
+        }
+        portEXIT_CRITICAL(&s_mux);
+    }
+    if (h) {
+        h->size    = size;
+        h->inArena = 1;
+        return (uint8_t*)h + HDR;
+    }
+
+    // Full (or no PSRAM): still keep it off internal RAM when possible
+    h = (BlockHdr*)heap_caps_malloc(HDR + size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!h) h = (BlockHdr*)malloc(HDR + size);
+    if (!h) return nullptr;
+    h->size    = size;
+    h->inArena = 0;
+    return (uint8_t*)h + HDR;
+}
+
+void pollArenaFree(void* p) {
+    if (!p) return;
+    BlockHdr* h = hdrOf(p);
+    if (!h->inArena) {
+        free(h);
+        return;
+    }
+    portENTER_CRITICAL(&s_mux);
+    if (s_live) s_live--;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void* pollArenaRealloc(void* p, size_t size) {
+    if (!p) return pollArenaAlloc(size);
+    BlockHdr* h = hdrOf(p);
+
+    // The newest arena block just moves the top (shrinkToFit, mostly)
+    if (h->inArena) {
+        bool done = false;
+        portENTER_CRITICAL(&s_mux);
+        size_t off = (uint8_t*)h - s_base;
+        if (off == s_last && off + alignUp(HDR + size) <= POLL_ARENA_SIZE) {
+            s_top   = off + alignUp(HDR + size);
+            h->size = size;
+            notePeak();
+            done = true;
+        }
+        portEXIT_CRITICAL(&s_mux);
+        if (done) return p;
+    }
+
+    void* q = pollArenaAlloc(size);
+    if (!q) return nullptr;
+    memcpy(q, p, h->size < size ? h->size : size);
+    pollArenaFree(p);
+    return q;
+}
+
+void pollArenaReset() {
+    if (!s_base) return;
+    portENTER_CRITICAL(&s_mux);
+    uint32_t live      = s_live;
+    size_t   cyclePeak = s_cyclePeak;
+    uint32_t fallbacks = s_fallbacks;
+    if (live == 0) {
+        s_top       = 0;
+        s_cyclePeak = 0;
+        s_fallbacks = 0;
+    }
+    portEXIT_CRITICAL(&s_mux);
+
+    if (live) {
+        Serial.printf("[Arena] %u block(s) still live — not reset\n", (unsigned)live);
+        return;
+    }
+    if (cyclePeak == 0) return;
+    Serial.printf("[Arena] Cycle peak %u B (boot peak %u B)", (unsigned)cyclePeak,
+                  (unsigned)s_peak);
+    if (fallbacks) Serial.printf(", %u block(s) on the heap", (unsigned)fallbacks);
+    Serial.println();
+}
+
+size_t pollArenaPeak() {
+    return s_peak;
+}
+
+void pollArenaDescribe(char* line, size_t len) {
+    const uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    size_t freeB = heap_caps_get_free_size(caps);
+    size_t minB  = heap_caps_get_minimum_free_size(caps);
+    size_t big   = heap_caps_get_largest_free_block(caps);
+    unsigned frag = freeB ? 100 - (unsigned)(big * 100 / freeB) : 0;
+    snprintf(line, len, "Heap:%uk min:%uk frag:%u%%",
+             (unsigned)(freeB / 1024), (unsigned)(minB / 1024), frag);
+}
+
+// ============================================================================
+// StrBuf
+// ============================================================================
+
+StrBuf::StrBuf(size_t capacity)
+    : _buf((char*)pollArenaAlloc(capacity + 1)), _cap(capacity), _len(0), _overflow(false)
+{
+    if (_buf) _buf[0] = '\0';
+    else      _cap = 0;
+}
+
+StrBuf::~StrBuf() {
+    pollArenaFree(_buf);
+}
+
+size_t StrBuf::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t StrBuf::write(const uint8_t* data, size_t len) {
+    size_t room = _cap - _len;
+    if (len > room) {
+        len = room;
+        _overflow = true;
+    }
+    if (len == 0) return 0;
+    memcpy(_buf + _len, data, len);
+    _len += len;
+    _buf[_len] = '\0';
+    return len;
+}
+
+size_t StrBuf::readFrom(Stream& s) {
+    size_t room = _cap - _len;
+    if (room == 0) return 0;
+    size_t n = s.readBytes(_buf + _len, room);
+    _len += n;
+    _buf[_len] = '\0';
+    return n;
+}
+
+void StrBuf::clear() {
+    _len = 0;
+    _overflow = false;
+    if (_buf) _buf[0] = '\0';
+}
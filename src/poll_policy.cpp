@@ -0,0 +1,151 @@
+// ============================================================================
+// Poll Policy — adaptive presence poll interval from change history
+// ============================================================================
+
+#include "poll_policy.h"
+#include <Preferences.h>
+#include <time.h>
+#include <math.h>
+
+#define POLL_BUCKETS      168               // 7 days × 24 hours
+#define POLL_MAGIC        0x504F4C31UL      // "POL1"
+
+static const char*    POLL_NS           = "poll_policy";
+static const time_t   CLOCK_VALID_EPOCH = 1704067200;
+static const uint16_t HIST_MIN_TOTAL    = 12;   // changes before history is trusted
+static const uint8_t  FLUSH_EVERY       = 4;    // NVS write every N changes
+static const uint32_t DECAY_WEEKS       = 4;    // halve all buckets this often
+static const int      MAX_BACKOFF_STEPS = 6;
+static const int      HOUR_EDGE_SEC     = 15;   // wake just after a busy hour begins
+
+// ---- RTC state (survives deep sleep) ---------------------------------------
+struct RtcPollHistory {
+    uint32_t magic;
+    uint32_t decayWeek;         // epoch week of the last halving
+    uint16_t total;             // sum of counts
+    uint8_t  pending;           // changes not yet written to NVS
+    uint8_t  count[POLL_BUCKETS];
+};
+RTC_DATA_ATTR static RtcPollHistory rtc_poll = {};
+
+// ----------------------------------------------------------------------------
+// Cold boot: restore the histogram from NVS (or start empty)
+static void ensureLoaded() {
+    if (rtc_poll.magic == POLL_MAGIC) return;
+    memset(&rtc_poll, 0, sizeof(rtc_poll));
+    rtc_poll.magic = POLL_MAGIC;
+
+    Preferences prefs;
+    if (prefs.begin(POLL_NS, true)) {
+        if (prefs.getBytesLength("hist") == POLL_BUCKETS) {
+            prefs.getBytes("hist", rtc_poll.count, POLL_BUCKETS);
+            rtc_poll.decayWeek = prefs.getUInt("decay_wk", 0);
+            for (int i = 0; i < POLL_BUCKETS; i++) rtc_poll.total += rtc_poll.count[i];
+        }
+        prefs.end();
+    }
+    Serial.printf("[Poll] History: %u changes\n", rtc_poll.total);
+}
+
+static void halveAll() {
+    rtc_poll.total = 0;
+    for (int i = 0; i < POLL_BUCKETS; i++) {
+        rtc_poll.count[i] >>= 1;
+        rtc_poll.total += rtc_poll.count[i];
+    }
+}
+
+// Hour-of-week in local time, Monday 00:00 = 0
+static int bucketOf(const struct tm& t) {
+    int day = (t.tm_wday == 0) ? 6 : (t.tm_wday - 1);
+    return day * 24 + t.tm_hour;
+}
+
+// Bucket activity relative to the weekly mean (>1 = busier than usual)
+static float busyRatio(int bucket) {
+    float mean = rtc_poll.total / (float)POLL_BUCKETS;
+    float r = (rtc_poll.count[bucket] + 0.5f) / (mean + 0.5f);
+    if (r < 0.25f) r = 0.25f;
+    if (r > 4.0f)  r = 4.0f;
+    return r;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+int pollPolicyNextSleep(const PodSettings& s, int stableCount) {
+    ensureLoaded();
+    int minSec = s.pollMinSec < 10 ? 10 : s.pollMinSec;
+    int maxSec = s.pollMaxSec < minSec ? minSec : s.pollMaxSec;
+    bool battery = (s.pollProfile == POLL_BATTERY);
+
+    // 1. Back off over consecutive unchanged polls
+    float sec = (float)s.presenceInterval;
+    float growth = battery ? 1.5f : 1.2f;
+    int steps = stableCount < MAX_BACKOFF_STEPS ? stableCount : MAX_BACKOFF_STEPS;
+    for (int i = 0; i < steps; i++) sec *= growth;
+
+    // 2. Scale by how busy this hour-of-week usually is
+    time_t now = time(nullptr);
+    const char* why = "backoff";
+    if (now >= CLOCK_VALID_EPOCH && rtc_poll.total >= HIST_MIN_TOTAL) {
+        struct tm t;
+        localtime_r(&now, &t);
+        int b = bucketOf(t);
+        float r = busyRatio(b);
+        // Responsive trusts busy hours fully; battery trusts quiet hours fully
+        float k = (r > 1.0f) ? (battery ? 0.5f : 1.0f) : (battery ? 1.0f : 0.5f);
+        sec /= powf(r, k);
+        why = r > 1.0f ? "busy hour" : "quiet hour";
+
+        // 3. Don't sleep through the start of a busy hour (top-of-hour changes)
+        int toNextHour = 3600 - (t.tm_min * 60 + t.tm_sec) + HOUR_EDGE_SEC;
+        if (sec > toNextHour && busyRatio((b + 1) % POLL_BUCKETS) >= 2.0f) {
+            sec = (float)toNextHour;
+            why = "busy hour ahead";
+        }
+    }
+
+    int result = (int)sec;
+    if (result < minSec) result = minSec;
+    if (result > maxSec) result = maxSec;
+    Serial.printf("[Poll] Next poll in %ds (%s, %s, stable=%d)\n", result, why,
+                  pollProfileName(s.pollProfile), stableCount);
+    return result;
+}
+
+void pollPolicyRecordChange() {
+    time_t now = time(nullptr);
+    if (now < CLOCK_VALID_EPOCH) return;
+    ensureLoaded();
+
+    // Age out old habits so the histogram follows schedule changes
+    uint32_t week = (uint32_t)(now / (7 * 86400));
+    if (rtc_poll.decayWeek == 0) rtc_poll.decayWeek = week;
+    if (week - rtc_poll.decayWeek >= DECAY_WEEKS) {
+        halveAll();
+        rtc_poll.decayWeek = week;
+    }
+
+    struct tm t;
+    localtime_r(&now, &t);
+    int b = bucketOf(t);
+    if (rtc_poll.count[b] == 255) halveAll();
+    rtc_poll.count[b]++;
+    rtc_poll.total++;
+    Serial.printf("[Poll] Change recorded (bucket %d → %u)\n", b, rtc_poll.count[b]);
+
+    if (++rtc_poll.pending >= FLUSH_EVERY) pollPolicyFlush();
+}
+
+void pollPolicyFlush() {
+    if (rtc_poll.magic != POLL_MAGIC || rtc_poll.pending == 0) return;
+    Preferences prefs;
+    if (prefs.begin(POLL_NS, false)) {
+        prefs.putBytes("hist", rtc_poll.count, POLL_BUCKETS);
+        prefs.putUInt("decay_wk", rtc_poll.decayWeek);
+        prefs.end();
+        rtc_poll.pending = 0;
+    }
+}
@@ -0,0 +1,166 @@
+// ============================================================================
+// Power Policy — esp_pm frequency scaling with scoped locks
+// ============================================================================
+
+#include "power_policy.h"
+#include <esp_pm.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+static const char* LOCK_NAMES[PM_LOCK_COUNT] = { "cpu_max", "apb_max" };
+
+struct LockStats {
+    uint32_t depth;         // holders right now
+    int64_t  since;         // esp_timer µs when depth went 0 → 1
+    uint64_t totalUs;       // completed holds
+};
+
+static LockStats   s_stats[PM_LOCK_COUNT] = {};
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool         s_usb = false;
+
+// No-esp_pm fallback: setCpuFrequencyMhz() runs the APB-change callbacks,
+// which take mutexes and may log, so it can't go under s_mux.  This mutex
+// serialises the switches; each re-reads the depth, so the last one wins.
+static SemaphoreHandle_t s_clockMutex = nullptr;
+static StaticSemaphore_t s_clockMutexDef;
+
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t s_locks[PM_LOCK_COUNT] = {};
+static esp_pm_lock_handle_t s_usbLock = nullptr;   // not counted in the stats
+static bool                 s_pmOk    = false;
+#endif
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+#if CONFIG_PM_ENABLE
+static bool configure(bool lightSleep) {
+    esp_pm_config_esp32s3_t pm = {};
+    pm.max_freq_mhz       = POWER_MAX_MHZ;
+    pm.min_freq_mhz       = POWER_MIN_MHZ;
+    pm.light_sleep_enable = lightSleep;
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err == ESP_ERR_NOT_SUPPORTED && lightSleep) {
+        // Core built without tickless idle — frequency scaling only
+        Serial.println("[Power] Auto light sleep unavailable (no tickless idle)");
+        pm.light_sleep_enable = false;
+        err = esp_pm_configure(&pm);
+    }
+    if (err != ESP_OK) Serial.printf("[Power] esp_pm_configure failed: %d\n", (int)err);
+    return err == ESP_OK;
+}
+#endif
+
+void powerPolicyInit() {
+    if (!s_clockMutex) s_clockMutex = xSemaphoreCreateMutexStatic(&s_clockMutexDef);
+#if CONFIG_PM_ENABLE
+    if (s_pmOk) return;
+    static const esp_pm_lock_type_t TYPES[PM_LOCK_COUNT] = {
+        ESP_PM_CPU_FREQ_MAX, ESP_PM_APB_FREQ_MAX
+    };
+    for (int k = 0; k < PM_LOCK_COUNT; k++) {
+        if (esp_pm_lock_create(TYPES[k], 0, LOCK_NAMES[k], &s_locks[k]) != ESP_OK) {
+            Serial.printf("[Power] Can't create %s lock\n", LOCK_NAMES[k]);
+            return;
+        }
+    }
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "usb", &s_usbLock) != ESP_OK) return;
+    s_pmOk = configure(true);
+    if (s_pmOk)
+        Serial.printf("[Power] DFS %d–%d MHz, locks: %s, %s\n",
+                      POWER_MIN_MHZ, POWER_MAX_MHZ, LOCK_NAMES[0], LOCK_NAMES[1]);
+#else
+    setCpuFrequencyMhz(POWER_MIN_MHZ);
+#endif
+}
+
+// Fallback clock: full speed on USB or while a CPU_MAX lock is held
+static void applyFallbackClock() {
+    if (s_clockMutex) xSemaphoreTake(s_clockMutex, portMAX_DELAY);
+    portENTER_CRITICAL(&s_mux);
+    bool boost = s_usb || s_stats[PM_LOCK_CPU_MAX].depth > 0;
+    portEXIT_CRITICAL(&s_mux);
+    uint32_t mhz = boost ? POWER_MAX_MHZ : POWER_MIN_MHZ;
+    if (getCpuFrequencyMhz() != mhz) setCpuFrequencyMhz(mhz);
+    if (s_clockMutex) xSemaphoreGive(s_clockMutex);
+}
+
+void powerSetUsbMode(bool onUSB) {
+    if (onUSB == s_usb) return;
+    s_usb = onUSB;
+#if CONFIG_PM_ENABLE
+    if (s_pmOk) {
+        if (onUSB) esp_pm_lock_acquire(s_usbLock);
+        configure(!onUSB);
+        if (!onUSB) esp_pm_lock_release(s_usbLock);
+        return;
+    }
+#endif
+    // No esp_pm: only held CPU_MAX locks raise the clock on battery
+    applyFallbackClock();
+}
+
+// ============================================================================
+// Locks
+// ============================================================================
+
+// Only the depth bookkeeping is under s_mux.  Without esp_pm a first
+// acquire or last release then switches the clock in applyFallbackClock(),
+// which re-checks the depth, so two tasks racing can't leave it wrong.
+
+void powerLockAcquire(PowerLockKind kind) {
+    if (kind >= PM_LOCK_COUNT) return;
+    bool first;
+    portENTER_CRITICAL(&s_mux);
+    LockStats& s = s_stats[kind];
+    first = (s.depth++ == 0);
+    if (first) s.since = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_mux);
+
+#if CONFIG_PM_ENABLE
+    if (s_pmOk) {
+        esp_pm_lock_acquire(s_locks[kind]);
+        return;
+    }
+#endif
+    if (first && kind == PM_LOCK_CPU_MAX) applyFallbackClock();
+}
+
+void powerLockRelease(PowerLockKind kind) {
+    if (kind >= PM_LOCK_COUNT) return;
+    bool held, last = false;
+    portENTER_CRITICAL(&s_mux);
+    LockStats& s = s_stats[kind];
+    held = s.depth > 0;
+    if (held) {
+        last = (--s.depth == 0);
+        if (last) s.totalUs += esp_timer_get_time() - s.since;
+    }
+    portEXIT_CRITICAL(&s_mux);
+    if (!held) return;      // unbalanced release
+
+#if CONFIG_PM_ENABLE
+    if (s_pmOk) {
+        esp_pm_lock_release(s_locks[kind]);
+        return;
+    }
+#endif
+    if (last && kind == PM_LOCK_CPU_MAX) applyFallbackClock();
+}
+
+uint32_t powerLockHeldMs(PowerLockKind kind) {
+    if (kind >= PM_LOCK_COUNT) return 0;
+    portENTER_CRITICAL(&s_mux);
+    const LockStats& s = s_stats[kind];
+    uint64_t us = s.totalUs;
+    if (s.depth > 0) us += esp_timer_get_time() - s.since;
+    portEXIT_CRITICAL(&s_mux);
+    return (uint32_t)(us / 1000);
+}
+
+const char* powerLockName(PowerLockKind kind) {
+    return kind < PM_LOCK_COUNT ? LOCK_NAMES[kind] : "?";
+}
@@ -0,0 +1,77 @@
+// ============================================================================
+// Presence Merge — concurrent Graph + Zoom fetch and precedence rules
+// ============================================================================
+
+#include "presence_merge.h"
+#include "zoom_presence.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// mbedTLS handshakes want a deep stack; beside the WiFi tasks on core 0
+static const uint32_t    ZOOM_TASK_STACK = 10240;
+static const UBaseType_t ZOOM_TASK_PRIO  = 2;
+
+struct ZoomJob {
+    const char*       token;
+    PresenceState*    out;
+    SemaphoreHandle_t done;
+};
+
+static void zoomTask(void* arg) {
+    ZoomJob* job = (ZoomJob*)arg;
+    getZoomPresence(job->token, *job->out);
+    xSemaphoreGive(job->done);
+    vTaskDelete(nullptr);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void fetchBothPresence(const char* graphToken, const char* zoomToken,
+                       PresenceState& teams, PresenceState& zoom) {
+    teams.valid = false;
+    zoom.valid  = false;
+    unsigned long t0 = millis();
+
+    ZoomJob job = { zoomToken, &zoom, nullptr };
+    bool async = false;
+    if (zoomToken && graphToken) {
+        job.done = xSemaphoreCreateBinary();
+        async = job.done &&
+                xTaskCreatePinnedToCore(zoomTask, "zoom_poll", ZOOM_TASK_STACK, &job,
+                                        ZOOM_TASK_PRIO, nullptr, 0) == pdPASS;
+        if (!async) Serial.println("[Merge] Can't start zoom_poll — fetching in turn");
+    }
+
+    if (zoomToken && !async) getZoomPresence(zoomToken, zoom);
+    if (graphToken)          getPresence(graphToken, teams);
+    if (async)               xSemaphoreTake(job.done, portMAX_DELAY);
+    if (job.done)            vSemaphoreDelete(job.done);
+
+    Serial.printf("[Merge] Teams %s, Zoom %s (%lums%s)\n",
+                  teams.valid ? availabilityName(teams.availability) : "-",
+                  zoom.valid  ? availabilityName(zoom.availability)  : "-",
+                  millis() - t0, async ? ", concurrent" : "");
+}
+
+bool mergePresence(const PresenceState& teams, const PresenceState& zoom,
+                   MergeRule rule, PresenceState& out) {
+    const PresenceState* pick;
+    if (!teams.valid)     pick = &zoom;
+    else if (!zoom.valid) pick = &teams;
+    else {
+        // Higher rank = busier.  Being reachable (Available) outranks being
+        // away, so an idle Zoom client doesn't hide an active Teams session.
+        int rt = availabilityInfo(teams.availability).rank;
+        int rz = availabilityInfo(zoom.availability).rank;
+        switch (rule) {
+            case MERGE_TEAMS_FIRST: pick = (rt <= 1 && rz > rt) ? &zoom : &teams; break;
+            case MERGE_ZOOM_FIRST:  pick = (rz <= 1 && rt > rz) ? &teams : &zoom; break;
+            default:                pick = (rz > rt) ? &zoom : &teams;            break;
+        }
+    }
+    out = *pick;
+    return out.valid;
+}
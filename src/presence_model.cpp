@@ -0,0 +1,155 @@
+// ============================================================================
+// Presence Model — state tables and the name → code parsers
+// ============================================================================
+
+#include "presence_model.h"
+#include "status_frames.h"
+
+// ---- One row per code (same order as the enums) -----------------------------
+//
+//  name               label            screen       screen2    team    RGB           WLED frame             icon        inv   rank
+static constexpr AvailabilityInfo AVAIL[AV_COUNT] = {
+    { "PresenceUnknown", "Unknown",        "UNKNOWN",   nullptr,   "?",    80,  80,  80, 6, -1,               ICON_NONE,  false, 0 },
+    { "Available",       "Available",      "AVAILABLE", nullptr,   "Free",  0, 255,   0, 1, FRAME_AVAILABLE,  ICON_TICK,  false, 4 },
+    { "AvailableIdle",   "Available",      "AVAILABLE", nullptr,   "Free",  0, 255,   0, 1, FRAME_AVAILABLE,  ICON_TICK,  false, 4 },
+    { "Away",            "Away",           "AWAY",      nullptr,   "Away", 255, 191,  0, 2, FRAME_AWAY,       ICON_CLOCK, false, 2 },
+    { "BeRightBack",     "Be Right Back",  "BRB",       nullptr,   "BRB",  255, 191,  0, 2, FRAME_BRB,        ICON_CLOCK, false, 3 },
+    { "Busy",            "Busy",           "BUSY",      nullptr,   "Busy", 255,   0,  0, 3, FRAME_BUSY,       ICON_NONE,  true,  5 },
+    { "BusyIdle",        "Busy",           "BUSY",      nullptr,   "Busy", 255,   0,  0, 3, FRAME_BUSY,       ICON_NONE,  true,  5 },
+    { "DoNotDisturb",    "Do Not Disturb", "DO NOT",    "DISTURB", "DND",  255,   0,  0, 4, FRAME_DND,        ICON_BAR,   true,  6 },
+    { "Offline",         "Offline",        "OFFLINE",   nullptr,   "Off",    0,   0,  0, 6, FRAME_OFFLINE,    ICON_CROSS, false, 1 },
+};
+
+//  name                       label              WLED  frame
+static constexpr ActivityInfo ACTS[ACT_COUNT] = {
+    { "",                        "",                0, -1               },
+    { "InACall",                 "In a Call",       5, FRAME_CALL       },
+    { "InAConferenceCall",       "Conference Call", 5, FRAME_CALL       },
+    { "InAMeeting",              "In a Meeting",    5, FRAME_CALL       },
+    { "Presenting",              "Presenting",      5, FRAME_PRESENTING },
+    { "OutOfOffice",             "Out of Office",   0, FRAME_OOO        },
+    { "OffWork",                 "Off Work",        0, -1               },
+    { "Inactive",                "Inactive",        0, -1               },
+    { "UrgentInterruptionsOnly", "Urgent Only",     0, -1               },
+    { "CalendarEvent",           "Calendar Event",  0, -1               },
+};
+
+// ---- Parse tables (sorted by name — checked below) --------------------------
+struct NameCode {
+    const char* name;
+    uint8_t     code;
+};
+
+static constexpr NameCode GRAPH_AVAIL[] = {
+    { "Available",       AV_AVAILABLE      },
+    { "AvailableIdle",   AV_AVAILABLE_IDLE },
+    { "Away",            AV_AWAY           },
+    { "BeRightBack",     AV_BE_RIGHT_BACK  },
+    { "Busy",            AV_BUSY           },
+    { "BusyIdle",        AV_BUSY_IDLE      },
+    { "DoNotDisturb",    AV_DO_NOT_DISTURB },
+    { "Offline",         AV_OFFLINE        },
+    { "PresenceUnknown", AV_UNKNOWN        },
+};
+
+// Activities that only repeat the availability ("Busy", "Away"…) aren't
+// listed — they parse to ACT_NONE like anything unknown
+static constexpr NameCode GRAPH_ACT[] = {
+    { "InACall",                 ACT_IN_A_CALL            },
+    { "InAConferenceCall",       ACT_IN_A_CONFERENCE_CALL },
+    { "InAMeeting",              ACT_IN_A_MEETING         },
+    { "Inactive",                ACT_INACTIVE             },
+    { "OffWork",                 ACT_OFF_WORK             },
+    { "OutOfOffice",             ACT_OUT_OF_OFFICE        },
+    { "Presenting",              ACT_PRESENTING           },
+    { "UrgentInterruptionsOnly", ACT_URGENT_ONLY          },
+};
+
+struct ZoomStatus {
+    const char* name;
+    uint8_t     avail;
+    uint8_t     act;
+};
+
+static constexpr ZoomStatus ZOOM[] = {
+    { "Available",         AV_AVAILABLE,      ACT_NONE           },
+    { "Away",              AV_AWAY,           ACT_NONE           },
+    { "Busy",              AV_BUSY,           ACT_NONE           },
+    { "Do_Not_Disturb",    AV_DO_NOT_DISTURB, ACT_NONE           },
+    { "In_A_Zoom_Meeting", AV_BUSY,           ACT_IN_A_MEETING   },
+    { "In_Calendar_Event", AV_BUSY,           ACT_CALENDAR_EVENT },
+    { "Offline",           AV_OFFLINE,        ACT_NONE           },
+    { "On_A_Call",         AV_BUSY,           ACT_IN_A_CALL      },
+    { "Out_of_Office",     AV_AWAY,           ACT_OUT_OF_OFFICE  },
+    { "Presenting",        AV_BUSY,           ACT_PRESENTING     },
+};
+
+// ---- Compile-time checks ----------------------------------------------------
+static constexpr bool nameBefore(const char* a, const char* b) {
+    return *a != *b ? (unsigned char)*a < (unsigned char)*b
+                    : (*a != '\0' && nameBefore(a + 1, b + 1));
+}
+
+template <typename T, size_t N>
+static constexpr bool sortedFrom(const T (&t)[N], size_t i) {
+    return i + 1 >= N || (nameBefore(t[i].name, t[i + 1].name) && sortedFrom(t, i + 1));
+}
+
+static_assert(sortedFrom(GRAPH_AVAIL, 0), "GRAPH_AVAIL must be sorted by name");
+static_assert(sortedFrom(GRAPH_ACT, 0),   "GRAPH_ACT must be sorted by name");
+static_assert(sortedFrom(ZOOM, 0),        "ZOOM must be sorted by name");
+static_assert(sizeof(GRAPH_AVAIL) / sizeof(GRAPH_AVAIL[0]) == AV_COUNT,
+              "every availability needs a Graph name");
+
+template <typename T, size_t N>
+static const T* findName(const T (&t)[N], const char* s) {
+    size_t lo = 0, hi = N;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int c = strcmp(s, t[mid].name);
+        if (c == 0) return &t[mid];
+        if (c < 0) hi = mid;
+        else       lo = mid + 1;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+const AvailabilityInfo& availabilityInfo(Availability a) {
+    return AVAIL[a < AV_COUNT ? a : AV_UNKNOWN];
+}
+
+const ActivityInfo& activityInfo(Activity a) {
+    return ACTS[a < ACT_COUNT ? a : ACT_NONE];
+}
+
+Availability presenceParseAvailability(const char* graph) {
+    const NameCode* e = graph ? findName(GRAPH_AVAIL, graph) : nullptr;
+    if (!e && graph) Serial.printf("[Presence] Unknown availability \"%s\"\n", graph);
+    return e ? (Availability)e->code : AV_UNKNOWN;
+}
+
+Activity presenceParseActivity(const char* graph) {
+    const NameCode* e = graph ? findName(GRAPH_ACT, graph) : nullptr;
+    return e ? (Activity)e->code : ACT_NONE;
+}
+
+bool presenceParseZoom(const char* status, Availability& avail, Activity& act) {
+    const ZoomStatus* e = status ? findName(ZOOM, status) : nullptr;
+    avail = e ? (Availability)e->avail : AV_UNKNOWN;
+    act   = e ? (Activity)e->act       : ACT_NONE;
+    return e != nullptr;
+}
+
+int presenceFrameSlot(Availability a, Activity act) {
+    int slot = activityInfo(act).frame;
+    return slot >= 0 ? slot : availabilityInfo(a).frame;
+}
+
+int presenceWledPreset(Availability a, Activity act) {
+    int preset = activityInfo(act).wledPreset;
+    return preset ? preset : availabilityInfo(a).wledPreset;
+}
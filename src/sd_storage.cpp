@@ -3,6 +3,7 @@
 // ============================================================================
 
 #include "sd_storage.h"
+#include "wake_profiler.h"
 #include <FS.h>
 #include <SD_MMC.h>
 #include <ArduinoJson.h>
@@ -13,8 +14,10 @@
 #define SDMMC_D0_PIN    40
 
 static bool g_sd_mounted = false;
+static bool g_sd_tried   = false;   // sdInit() already attempted this boot
 
 static const char* CONFIG_PATH = "/config.json";
+static const size_t CONFIG_DOC_SIZE = 3072;   // settings + an 8-member team list
 
 // ============================================================================
 // Init / deinit
@@ -22,6 +25,8 @@ static const char* CONFIG_PATH = "/config.json";
 
 bool sdInit() {
     if (g_sd_mounted) return true;
+    g_sd_tried = true;
+    WakePhaseTimer timer(WP_SD_MOUNT);
 
     // Configure 1-wire SDMMC on custom GPIOs
     SD_MMC.setPins(SDMMC_CLK_PIN, SDMMC_CMD_PIN, SDMMC_D0_PIN);
@@ -64,6 +69,13 @@ bool sdMounted() {
     return g_sd_mounted;
 }
 
+bool sdEnsureMounted() {
+    if (g_sd_mounted) return true;
+    if (g_sd_tried) return false;
+    Serial.println("[SD] Mounting on demand");
+    return sdInit();
+}
+
 void sdDeinit() {
     if (g_sd_mounted) {
         SD_MMC.end();
@@ -99,7 +111,7 @@ bool sdLoadConfig(SdConfig& cfg) {
         return false;
     }
 
-    StaticJsonDocument<1024> doc;
+    DynamicJsonDocument doc(CONFIG_DOC_SIZE);
     DeserializationError err = deserializeJson(doc, f);
     f.close();
 
@@ -113,6 +125,11 @@ bool sdLoadConfig(SdConfig& cfg) {
     cfg.audioAlerts      = doc["audioAlerts"]      | cfg.audioAlerts;
     cfg.presenceInterval = doc["presenceInterval"] | cfg.presenceInterval;
     cfg.fullRefreshEvery = doc["fullRefreshEvery"] | cfg.fullRefreshEvery;
+    cfg.maxStaleness     = doc["maxStaleness"]     | cfg.maxStaleness;
+    cfg.pollProfile      = doc["pollProfile"]      | cfg.pollProfile;
+    cfg.pollMinSec       = doc["pollMinSec"]       | cfg.pollMinSec;
+    cfg.pollMaxSec       = doc["pollMaxSec"]       | cfg.pollMaxSec;
+    cfg.mergeRule        = doc["presenceMerge"]    | cfg.mergeRule;
     cfg.timezone         = doc["timezone"]         | cfg.timezone.c_str();
     cfg.officeHoursEnabled = doc["officeHoursEnabled"] | cfg.officeHoursEnabled;
     cfg.officeStartHour    = doc["officeStartHour"]    | cfg.officeStartHour;
@@ -121,6 +138,18 @@ bool sdLoadConfig(SdConfig& cfg) {
     cfg.officeEndMin       = doc["officeEndMin"]       | cfg.officeEndMin;
     cfg.officeDays         = doc["officeDays"]         | cfg.officeDays;
 
+    cfg.teamBoard = doc["teamBoard"] | cfg.teamBoard;
+    cfg.teamCount = 0;
+    for (JsonObject m : doc["team"].as<JsonArray>()) {
+        if (cfg.teamCount >= SD_TEAM_MAX) {
+            Serial.printf("[SD] Team list truncated to %d members\n", SD_TEAM_MAX);
+            break;
+        }
+        SdTeamMember& t = cfg.team[cfg.teamCount++];
+        t.id   = m["id"]   | "";
+        t.name = m["name"] | "";
+    }
+
     Serial.printf("[SD] Config loaded: platform=%d invert=%d audio=%d interval=%d fullEvery=%d tz=%s\n",
                   cfg.platform, cfg.invertDisplay, cfg.audioAlerts,
                   cfg.presenceInterval, cfg.fullRefreshEvery,
@@ -131,12 +160,24 @@ bool sdLoadConfig(SdConfig& cfg) {
 bool sdSaveConfig(const SdConfig& cfg) {
     if (!g_sd_mounted) return false;
 
-    StaticJsonDocument<1024> doc;
+    // Start from the file on the card so keys we don't own survive
+    DynamicJsonDocument doc(CONFIG_DOC_SIZE);
+    File in = SD_MMC.open(CONFIG_PATH, FILE_READ);
+    if (in) {
+        if (deserializeJson(doc, in) || !doc.is<JsonObject>()) doc.to<JsonObject>();
+        in.close();
+    }
+
     doc["platform"]         = cfg.platform;
     doc["invertDisplay"]    = cfg.invertDisplay;
     doc["audioAlerts"]      = cfg.audioAlerts;
     doc["presenceInterval"] = cfg.presenceInterval;
     doc["fullRefreshEvery"] = cfg.fullRefreshEvery;
+    doc["maxStaleness"]     = cfg.maxStaleness;
+    doc["pollProfile"]      = cfg.pollProfile;
+    doc["pollMinSec"]       = cfg.pollMinSec;
+    doc["pollMaxSec"]       = cfg.pollMaxSec;
+    doc["presenceMerge"]    = cfg.mergeRule;
     doc["timezone"]           = cfg.timezone;
     doc["officeHoursEnabled"] = cfg.officeHoursEnabled;
     doc["officeStartHour"]    = cfg.officeStartHour;
@@ -163,7 +204,7 @@ bool sdSaveConfig(const SdConfig& cfg) {
 // ============================================================================
 
 bool sdWriteText(const char* path, const String& content) {
-    if (!g_sd_mounted) {
+    if (!sdEnsureMounted()) {
         Serial.printf("[SD] Write failed (not mounted): %s\n", path);
         return false;
     }
@@ -187,8 +228,31 @@ bool sdWriteText(const char* path, const String& content) {
     return true;
 }
 
+bool sdAppendText(const char* path, const String& content) {
+    if (!sdEnsureMounted()) {
+        Serial.printf("[SD] Append failed (not mounted): %s\n", path);
+        return false;
+    }
+
+    File f = SD_MMC.open(path, FILE_APPEND);
+    if (!f) {
+        Serial.printf("[SD] Failed to open for append: %s\n", path);
+        return false;
+    }
+
+    size_t written = f.print(content);
+    f.close();
+
+    if (written != content.length()) {
+        Serial.printf("[SD] Short append: %d/%d bytes to %s\n",
+                      written, content.length(), path);
+        return false;
+    }
+    return true;
+}
+
 String sdReadText(const char* path) {
-    if (!g_sd_mounted) return "";
+    if (!sdEnsureMounted()) return "";
 
     File f = SD_MMC.open(path, FILE_READ);
     if (!f) return "";
@@ -203,12 +267,12 @@ String sdReadText(const char* path) {
 // ============================================================================
 
 bool sdFileExists(const char* path) {
-    if (!g_sd_mounted) return false;
+    if (!sdEnsureMounted()) return false;
     return SD_MMC.exists(path);
 }
 
 int32_t sdFileSize(const char* path) {
-    if (!g_sd_mounted) return -1;
+    if (!sdEnsureMounted()) return -1;
     File f = SD_MMC.open(path, FILE_READ);
     if (!f) return -1;
     int32_t sz = f.size();
@@ -216,9 +280,18 @@ int32_t sdFileSize(const char* path) {
     return sz;
 }
 
+time_t sdFileModified(const char* path) {
+    if (!sdEnsureMounted()) return 0;
+    File f = SD_MMC.open(path, FILE_READ);
+    if (!f) return 0;
+    time_t t = f.getLastWrite();
+    f.close();
+    return t;
+}
+
 uint8_t* sdReadFile(const char* path, size_t& outLen) {
     outLen = 0;
-    if (!g_sd_mounted) return nullptr;
+    if (!sdEnsureMounted()) return nullptr;
 
     File f = SD_MMC.open(path, FILE_READ);
     if (!f) {
@@ -255,7 +328,7 @@ uint8_t* sdReadFile(const char* path, size_t& outLen) {
 }
 
 bool sdLoadBitmap(const char* path, uint8_t* buf, size_t bufLen) {
-    if (!g_sd_mounted || !buf) return false;
+    if (!sdEnsureMounted() || !buf) return false;
 
     File f = SD_MMC.open(path, FILE_READ);
     if (!f) {
@@ -295,7 +368,7 @@ static uint16_t readLE16(const uint8_t* p) {
 }
 
 bool sdLoadBMP(const char* path, uint8_t* pixelBuf, size_t bufLen) {
-    if (!g_sd_mounted || !pixelBuf) return false;
+    if (!sdEnsureMounted() || !pixelBuf) return false;
 
     File f = SD_MMC.open(path, FILE_READ);
     if (!f) {
@@ -4,6 +4,7 @@
 
 #include "settings.h"
 #include "sd_storage.h"
+#include "config_snapshot.h"
 #include <Preferences.h>
 
 static const char* SETTINGS_NS = "pod_settings";
@@ -12,10 +13,28 @@ const char* platformName(Platform p) {
     switch (p) {
         case PLATFORM_TEAMS: return "Teams";
         case PLATFORM_ZOOM:  return "Zoom";
+        case PLATFORM_BOTH:  return "Teams+Zoom";
         default:             return "Unknown";
     }
 }
 
+const char* pollProfileName(PollProfile p) {
+    switch (p) {
+        case POLL_RESPONSIVE: return "Responsive";
+        case POLL_BATTERY:    return "Battery";
+        default:              return "Unknown";
+    }
+}
+
+const char* mergeRuleName(MergeRule r) {
+    switch (r) {
+        case MERGE_BUSIEST:     return "Busiest";
+        case MERGE_TEAMS_FIRST: return "Teams first";
+        case MERGE_ZOOM_FIRST:  return "Zoom first";
+        default:                return "Unknown";
+    }
+}
+
 void loadSettings(PodSettings& s) {
     // Try SD card first
     if (sdMounted()) {
@@ -26,6 +45,11 @@ void loadSettings(PodSettings& s) {
             s.audioAlerts      = cfg.audioAlerts;
             s.presenceInterval = cfg.presenceInterval;
             s.fullRefreshEvery = cfg.fullRefreshEvery;
+            s.maxStaleness     = cfg.maxStaleness;
+            s.pollProfile      = (PollProfile)cfg.pollProfile;
+            s.pollMinSec       = cfg.pollMinSec;
+            s.pollMaxSec       = cfg.pollMaxSec;
+            s.mergeRule        = (MergeRule)cfg.mergeRule;
             s.timezone            = cfg.timezone;
             s.officeHoursEnabled  = cfg.officeHoursEnabled;
             s.officeStartHour     = cfg.officeStartHour;
@@ -46,6 +70,11 @@ void loadSettings(PodSettings& s) {
         s.audioAlerts      = prefs.getBool("audio",    false);
         s.presenceInterval = prefs.getInt("interval",  120);
         s.fullRefreshEvery = prefs.getInt("fullEvery", 10);
+        s.maxStaleness     = prefs.getInt("max_stale", 900);
+        s.pollProfile      = (PollProfile)prefs.getInt("poll_prof", POLL_RESPONSIVE);
+        s.pollMinSec       = prefs.getInt("poll_min",  30);
+        s.pollMaxSec       = prefs.getInt("poll_max",  900);
+        s.mergeRule        = (MergeRule)prefs.getInt("merge_rule", MERGE_BUSIEST);
         s.timezone            = prefs.getString("timezone", "");
         s.officeHoursEnabled  = prefs.getBool("oh_enabled", false);
         s.officeStartHour     = prefs.getInt("oh_start_h", 8);
@@ -75,6 +104,11 @@ void saveSettings(const PodSettings& s) {
         cfg.audioAlerts      = s.audioAlerts;
         cfg.presenceInterval = s.presenceInterval;
         cfg.fullRefreshEvery = s.fullRefreshEvery;
+        cfg.maxStaleness     = s.maxStaleness;
+        cfg.pollProfile      = (int)s.pollProfile;
+        cfg.pollMinSec       = s.pollMinSec;
+        cfg.pollMaxSec       = s.pollMaxSec;
+        cfg.mergeRule        = (int)s.mergeRule;
         cfg.timezone            = s.timezone;
         cfg.officeHoursEnabled  = s.officeHoursEnabled;
         cfg.officeStartHour     = s.officeStartHour;
@@ -86,6 +120,7 @@ void saveSettings(const PodSettings& s) {
     } else {
         Serial.println("[Settings] WARNING: SD not mounted, settings not saved");
     }
+    configSnapshotUpdateSettings(s);
 
     Serial.printf("[Settings] Saved: platform=%s invert=%d audio=%d interval=%d fullEvery=%d\n",
                   platformName(s.platform), s.invertDisplay, s.audioAlerts,
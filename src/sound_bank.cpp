@@ -0,0 +1,380 @@
+// ============================================================================
+// Sound Bank — decoded SD clips in PSRAM + a compile-time sine wavetable
+// ============================================================================
+
+#include "sound_bank.h"
+#include "sd_storage.h"
+#include <FS.h>
+#include <SD_MMC.h>
+#include <esp_heap_caps.h>
+#include "MP3DecoderHelix.h"
+
+using namespace libhelix;
+
+#define CLIP_MAX_FRAMES   (4 * 16000)   // per clip: 4 s at 16 kHz (512 KB)
+#define READ_CHUNK        1024
+#define TONE_AMPLITUDE    24000         // ~73% of int16 max — loud enough for tiny speaker
+
+static const char* const SOUND_PATHS[SND_COUNT] = {
+    "/audio/click.mp3",
+    "/audio/notify.mp3",
+    "/audio/attention.mp3",
+};
+
+struct BankSlot {
+    SoundClip clip;
+    bool      loaded;
+    bool      tried;
+};
+
+static BankSlot s_bank[SND_COUNT] = {};
+static int      s_rate = 16000;
+
+// ============================================================================
+// Wavetable — one sine period, computed by the compiler
+//
+// The constexpr helpers are single-expression (C++11) so this builds with
+// the toolchain's default standard.
+// ============================================================================
+
+#define SINE_BITS 8
+#define SINE_LEN  (1 << SINE_BITS)
+
+namespace {
+
+constexpr double PI_D = 3.14159265358979323846;
+
+// Taylor series to x^25 — exact to int16 over [-pi, pi]
+constexpr double sinSeries(double x, double term, int n) {
+    return n > 12 ? term : term + sinSeries(x, -term * x * x / ((2 * n) * (2 * n + 1)), n + 1);
+}
+
+constexpr double sineAt(int i) {
+    return sinSeries(2 * PI_D * i / SINE_LEN - (2 * i > SINE_LEN ? 2 * PI_D : 0.0),
+                     2 * PI_D * i / SINE_LEN - (2 * i > SINE_LEN ? 2 * PI_D : 0.0), 1);
+}
+
+constexpr int16_t sineSample(int i) {
+    return sineAt(i) * TONE_AMPLITUDE < 0 ? int16_t(sineAt(i) * TONE_AMPLITUDE - 0.5)
+                                          : int16_t(sineAt(i) * TONE_AMPLITUDE + 0.5);
+}
+
+template <int... I> struct Indices {};
+template <int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+template <typename> struct SineTable;
+template <int... I> struct SineTable<Indices<I...>> {
+    static constexpr int16_t v[sizeof...(I)] = { sineSample(I)... };
+};
+template <int... I> constexpr int16_t SineTable<Indices<I...>>::v[sizeof...(I)];
+
+typedef SineTable<MakeIndices<SINE_LEN>::type> Sine;
+
+static_assert(Sine::v[0] == 0, "sine table origin");
+static_assert(Sine::v[SINE_LEN / 4] == TONE_AMPLITUDE, "sine table peak");
+static_assert(Sine::v[3 * SINE_LEN / 4] == -TONE_AMPLITUDE, "sine table trough");
+
+}  // namespace
+
+uint32_t soundToneStep(int freqHz, int sampleRate) {
+    return (uint32_t)(((uint64_t)freqHz << 32) / (uint32_t)sampleRate);
+}
+
+void soundToneFill(uint32_t& phase, uint32_t step, int32_t* frames, int count) {
+    for (int i = 0; i < count; i++) {
+        int32_t sample = (int32_t)Sine::v[phase >> (32 - SINE_BITS)] << 16;
+        frames[i * 2]     = sample;  // left
+        frames[i * 2 + 1] = sample;  // right
+        phase += step;
+    }
+}
+
+// ============================================================================
+// Resampling (linear, Q16) → 32-bit stereo
+// ============================================================================
+
+void soundResamplerInit(SoundResampler& r, int dstRate) {
+    r.srcRate = 0;
+    r.dstRate = dstRate;
+    r.step    = 0x10000;
+    r.pos     = 0;
+    r.prevL   = r.prevR = 0;
+}
+
+// a·(65536 − f) + b·f: the interpolated sample, already in the slot's
+// upper 16 bits.  Each term fits int32 (|a| ≤ 32768, weight ≤ 65536).
+static inline int32_t lerpSlot(int32_t a, int32_t b, int32_t f) {
+    return a * (0x10000 - f) + b * f;
+}
+
+void soundResample(SoundResampler& r, const int16_t* pcm, size_t len, int nChans,
+                   int srcRate, SoundSink sink, void* ctx) {
+    if (len == 0 || nChans <= 0 || srcRate <= 0) return;
+    const int  n      = (int)(len / nChans);
+    const int  rc     = nChans >= 2 ? 1 : 0;   // right-channel offset (mono: reuse left)
+    if (n <= 0) return;
+
+    if (srcRate != r.srcRate) {
+        r.srcRate = srcRate;
+        r.step    = (uint32_t)(((uint64_t)srcRate << 16) / (uint32_t)r.dstRate);
+        r.pos     = 0;
+        r.prevL   = pcm[0];
+        r.prevR   = pcm[rc];
+    }
+
+    int32_t* out = r.out;
+    int fill = 0;
+    uint32_t pos = r.pos;
+    const uint32_t end = (uint32_t)n << 16;
+
+    if (r.step == 0x10000 && (pos & 0xFFFF) == 0) {
+        // Same rate: widen and (for mono) duplicate, one frame behind.
+        // esp-dsp has no s16 → s32 widening kernel, and this is one load
+        // and two stores per frame, so it stays a plain loop, a block at
+        // a time without the per-frame fill check.
+        int i = (int)(pos >> 16);
+        if (i == 0 && i < n) {
+            out[0] = r.prevL << 16;
+            out[1] = r.prevR << 16;
+            fill = 1;
+            i = 1;
+        }
+        while (i < n) {
+            int count = n - i;
+            if (count > SOUND_BLOCK - fill) count = SOUND_BLOCK - fill;
+            const int16_t* s = pcm + (i - 1) * nChans;
+            int32_t* o = out + fill * 2;
+            for (int k = 0; k < count; k++, s += nChans, o += 2) {
+                o[0] = (int32_t)s[0] << 16;
+                o[1] = (int32_t)s[rc] << 16;
+            }
+            fill += count;
+            i    += count;
+            if (fill == SOUND_BLOCK) {
+                sink(out, fill, ctx);
+                fill = 0;
+            }
+        }
+        pos = end;
+    } else {
+        // Frames that interpolate from the held frame of the last block
+        while (pos < 0x10000 && pos < end) {
+            int32_t f = (int32_t)(pos & 0xFFFF);
+            out[fill * 2]     = lerpSlot(r.prevL, pcm[0], f);
+            out[fill * 2 + 1] = lerpSlot(r.prevR, pcm[rc], f);
+            fill++;
+            pos += r.step;
+        }
+        while (pos < end) {
+            const int16_t* a = pcm + ((pos >> 16) - 1) * nChans;
+            const int16_t* b = a + nChans;
+            int32_t f = (int32_t)(pos & 0xFFFF);
+            out[fill * 2]     = lerpSlot(a[0], b[0], f);
+            out[fill * 2 + 1] = lerpSlot(a[rc], b[rc], f);
+            if (++fill == SOUND_BLOCK) {
+                sink(out, fill, ctx);
+                fill = 0;
+            }
+            pos += r.step;
+        }
+    }
+    if (fill > 0) sink(out, fill, ctx);
+
+    r.pos   = pos - end;
+    r.prevL = pcm[(n - 1) * nChans];
+    r.prevR = pcm[(n - 1) * nChans + rc];
+}
+
+#ifdef POD_AUDIO_BENCH
+// ---- Microbenchmark ----
+//
+// The loop soundResample() replaced: nearest sample, one 64-bit divide per
+// output frame, widening one frame at a time into a 128-frame block.
+static void nearestConvert(const int16_t* pcm, size_t len, int nChans, int srcRate,
+                           int dstRate, SoundSink sink, void* ctx) {
+    int srcFrames = (int)(len / nChans);
+    int dstFrames = (srcRate == dstRate)
+                        ? srcFrames
+                        : (int)((int64_t)srcFrames * dstRate / srcRate);
+    const int BLOCK = 128;
+    int32_t outBuf[BLOCK * 2];
+    for (int i = 0; i < dstFrames; ) {
+        int count = (dstFrames - i < BLOCK) ? dstFrames - i : BLOCK;
+        for (int j = 0; j < count; j++) {
+            int srcIdx;
+            if (srcRate == dstRate) {
+                srcIdx = i + j;
+            } else {
+                srcIdx = (int)((int64_t)(i + j) * srcRate / dstRate);
+                if (srcIdx >= srcFrames) srcIdx = srcFrames - 1;
+            }
+            int16_t sL, sR;
+            if (nChans >= 2) {
+                sL = pcm[srcIdx * 2];
+                sR = pcm[srcIdx * 2 + 1];
+            } else {
+                sL = sR = pcm[srcIdx];
+            }
+            outBuf[j * 2]     = (int32_t)sL << 16;
+            outBuf[j * 2 + 1] = (int32_t)sR << 16;
+        }
+        sink(outBuf, count, ctx);
+        i += count;
+    }
+}
+
+static void benchSink(const int32_t* frames, int count, void* ctx) {
+    *(volatile int32_t*)ctx += frames[0] + count;  // keep the work observable
+}
+
+void soundResampleBench() {
+    static const int FRAMES = 1152;          // one MPEG-1 layer III frame
+    static const int BLOCKS = 64;
+    static int16_t pcm[FRAMES * 2];
+    static SoundResampler rs;
+    uint32_t phase = 0, step = soundToneStep(440, 44100);
+    for (int i = 0; i < FRAMES; i++) {
+        int32_t s[2];
+        soundToneFill(phase, step, s, 1);
+        pcm[i * 2] = pcm[i * 2 + 1] = (int16_t)(s[0] >> 16);
+    }
+
+    const int rates[] = { 44100, 22050, 16000 };
+    for (int ri = 0; ri < 3; ri++) {
+        for (int ch = 1; ch <= 2; ch++) {
+            int srcRate = rates[ri];
+            int32_t out = (int32_t)((int64_t)FRAMES * BLOCKS * 16000 / srcRate);
+            volatile int32_t sinkAcc = 0;
+
+            uint32_t c0 = ESP.getCycleCount();
+            for (int b = 0; b < BLOCKS; b++)
+                nearestConvert(pcm, FRAMES * ch, ch, srcRate, 16000, benchSink, (void*)&sinkAcc);
+            uint32_t c1 = ESP.getCycleCount();
+            soundResamplerInit(rs, 16000);
+            for (int b = 0; b < BLOCKS; b++)
+                soundResample(rs, pcm, FRAMES * ch, ch, srcRate, benchSink, (void*)&sinkAcc);
+            uint32_t c2 = ESP.getCycleCount();
+
+            Serial.printf("[Bench] resample %5d->16000 %s: nearest %.1f, linear %.1f cycles/frame\n",
+                          srcRate, ch == 2 ? "stereo" : "mono  ",
+                          (float)(c1 - c0) / out, (float)(c2 - c1) / out);
+        }
+    }
+}
+#endif
+
+// ============================================================================
+// Clip decoding
+// ============================================================================
+
+// Decode target for the Helix callback
+static int32_t* s_dst       = nullptr;
+static size_t   s_dstFrames = 0;
+static bool     s_dstFull   = false;
+
+static void bankSink(const int32_t* frames, int count, void*) {
+    size_t room = CLIP_MAX_FRAMES - s_dstFrames;
+    if ((size_t)count > room) {
+        count = (int)room;
+        s_dstFull = true;  // clip truncated at CLIP_MAX_FRAMES
+    }
+    memcpy(s_dst + s_dstFrames * 2, frames, (size_t)count * 8);
+    s_dstFrames += count;
+}
+
+static SoundResampler s_resampler;
+
+static void bankPcm(MP3FrameInfo& info, int16_t* pcm, size_t len, void*) {
+    soundResample(s_resampler, pcm, len, info.nChans, info.samprate, bankSink, nullptr);
+}
+
+static MP3DecoderHelix s_decoder(bankPcm);
+
+static bool decodeClip(SoundId id, BankSlot& slot) {
+    const char* path = SOUND_PATHS[id];
+    if (!sdFileExists(path)) return false;
+    File f = SD_MMC.open(path, FILE_READ);
+    if (!f) return false;
+
+    s_dst = (int32_t*)heap_caps_malloc(CLIP_MAX_FRAMES * 8, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!s_dst) {
+        Serial.printf("[Sound] No PSRAM for %s\n", path);
+        f.close();
+        return false;
+    }
+    s_dstFrames = 0;
+    s_dstFull   = false;
+
+    unsigned long t0 = millis();
+    static uint8_t chunk[READ_CHUNK];
+    soundResamplerInit(s_resampler, s_rate);
+    s_decoder.begin();
+    while (!s_dstFull) {
+        int n = f.read(chunk, sizeof(chunk));
+        if (n <= 0) break;
+        s_decoder.write(chunk, n);
+    }
+    s_decoder.end();
+    f.close();
+
+    if (s_dstFrames == 0) {
+        Serial.printf("[Sound] %s: no audio decoded\n", path);
+        heap_caps_free(s_dst);
+        s_dst = nullptr;
+        return false;
+    }
+
+    // Give back the unused tail of the worst-case buffer
+    int32_t* fit = (int32_t*)heap_caps_realloc(s_dst, s_dstFrames * 8,
+                                               MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    slot.clip.frames = fit ? fit : s_dst;
+    slot.clip.count  = s_dstFrames;
+    s_dst = nullptr;
+
+    Serial.printf("[Sound] %s: %u frames (%u KB) in %lums%s\n", path,
+                  (unsigned)slot.clip.count, (unsigned)(slot.clip.count * 8 / 1024),
+                  millis() - t0, s_dstFull ? " [truncated]" : "");
+    return true;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void soundBankInit(int sampleRate) {
+    if (sampleRate != s_rate) soundBankFree();
+    s_rate = sampleRate;
+}
+
+const char* soundPath(SoundId id) {
+    return id < SND_COUNT ? SOUND_PATHS[id] : "";
+}
+
+bool soundBankAvailable(SoundId id) {
+    if (id >= SND_COUNT) return false;
+    if (s_bank[id].loaded) return true;
+    if (s_bank[id].tried) return false;
+    return sdEnsureMounted() && sdFileExists(SOUND_PATHS[id]);
+}
+
+const SoundClip* soundBankGet(SoundId id) {
+    if (id >= SND_COUNT) return nullptr;
+    BankSlot& slot = s_bank[id];
+    if (!slot.loaded && !slot.tried) {
+        slot.tried  = true;
+        slot.loaded = sdEnsureMounted() && decodeClip(id, slot);
+    }
+    return slot.loaded ? &slot.clip : nullptr;
+}
+
+void soundBankLoadAll() {
+    for (int i = 0; i < SND_COUNT; i++) soundBankGet((SoundId)i);
+}
+
+void soundBankFree() {
+    for (int i = 0; i < SND_COUNT; i++) {
+        if (s_bank[i].loaded) heap_caps_free((void*)s_bank[i].clip.frames);
+        s_bank[i] = BankSlot();
+    }
+}
@@ -0,0 +1,212 @@
+// ============================================================================
+// Status Frames — pre-rendered presence screens, ready to send to the panel
+// ============================================================================
+
+#include "status_frames.h"
+#include "sd_storage.h"
+#include <esp_partition.h>
+#include <esp_heap_caps.h>
+#include <esp_rom_crc.h>
+
+#define FRAMES_MAGIC        0x46524D32UL    // "FRM2"
+#define FRAMES_SUBTYPE      0x40            // custom data subtype (partitions.csv)
+#define FRAMES_SECTOR       0x1000
+#define FRAMES_DATA_OFFSET  FRAMES_SECTOR   // header gets the first sector
+
+static const char* FRAMES_LABEL = "frames";
+
+// ---- Slot table --------------------------------------------------------------
+struct FrameSlotDef {
+    const char*  bmpPath;
+    Availability availability;  // canonical pair drawn when there's no BMP
+    Activity     activity;
+};
+
+static const FrameSlotDef SLOTS[FRAME_SLOT_COUNT] = {
+    { "/graphics/status_call.bmp",       AV_BUSY,           ACT_IN_A_CALL     },
+    { "/graphics/status_presenting.bmp", AV_DO_NOT_DISTURB, ACT_PRESENTING    },
+    { "/graphics/status_available.bmp",  AV_AVAILABLE,      ACT_NONE          },
+    { "/graphics/status_away.bmp",       AV_AWAY,           ACT_NONE          },
+    { "/graphics/status_brb.bmp",        AV_BE_RIGHT_BACK,  ACT_NONE          },
+    { "/graphics/status_busy.bmp",       AV_BUSY,           ACT_NONE          },
+    { "/graphics/status_dnd.bmp",        AV_DO_NOT_DISTURB, ACT_NONE          },
+    { "/graphics/status_offline.bmp",    AV_OFFLINE,        ACT_NONE          },
+    { "/graphics/status_OoO.bmp",        AV_AWAY,           ACT_OUT_OF_OFFICE },
+};
+
+// ---- Store layout (identical in flash and PSRAM) ---------------------------
+struct FrameSlotInfo {
+    uint8_t  source;            // FrameSource
+    uint8_t  availability;      // FRAME_DRAWN only
+    uint8_t  activity;
+    uint32_t crc;
+};
+
+struct FrameStoreHeader {
+    uint32_t      magic;
+    uint32_t      manifest;
+    FrameSlotInfo slot[FRAME_SLOT_COUNT];
+};
+
+static const size_t STORE_SIZE = FRAMES_DATA_OFFSET + FRAME_SLOT_COUNT * STATUS_FRAME_BYTES;
+
+static const esp_partition_t* s_part      = nullptr;
+static uint8_t*               s_ram       = nullptr;   // PSRAM fallback store
+static bool                   s_opened    = false;
+static FrameStoreHeader       s_header;                // committed header
+static bool                   s_headerOk  = false;
+static FrameStoreHeader       s_pending;               // header being rebuilt
+
+// ----------------------------------------------------------------------------
+static bool storeOpen() {
+    if (s_opened) return s_part || s_ram;
+    s_opened = true;
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                      (esp_partition_subtype_t)FRAMES_SUBTYPE,
+                                      FRAMES_LABEL);
+    if (s_part && s_part->size < STORE_SIZE) {
+        Serial.printf("[Frames] Partition too small (%u < %u)\n",
+                      (unsigned)s_part->size, (unsigned)STORE_SIZE);
+        s_part = nullptr;
+    }
+    if (s_part) {
+        Serial.printf("[Frames] Flash store at 0x%06x\n", (unsigned)s_part->address);
+        return true;
+    }
+    s_ram = (uint8_t*)heap_caps_calloc(1, STORE_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    Serial.printf("[Frames] No '%s' partition — %s\n", FRAMES_LABEL,
+                  s_ram ? "PSRAM store (this session only)" : "cache disabled");
+    return s_ram != nullptr;
+}
+
+static bool storeRead(size_t offset, void* dst, size_t len) {
+    if (s_part) return esp_partition_read(s_part, offset, dst, len) == ESP_OK;
+    memcpy(dst, s_ram + offset, len);
+    return true;
+}
+
+static bool storeWrite(size_t offset, const void* src, size_t len) {
+    if (s_part) return esp_partition_write(s_part, offset, src, len) == ESP_OK;
+    memcpy(s_ram + offset, src, len);
+    return true;
+}
+
+static bool storeErase() {
+    if (s_part) {
+        size_t len = (STORE_SIZE + FRAMES_SECTOR - 1) & ~(size_t)(FRAMES_SECTOR - 1);
+        return esp_partition_erase_range(s_part, 0, len) == ESP_OK;
+    }
+    memset(s_ram, 0, STORE_SIZE);
+    return true;
+}
+
+static bool loadHeader() {
+    if (s_headerOk) return true;
+    if (!storeOpen()) return false;
+    if (!storeRead(0, &s_header, sizeof(s_header))) return false;
+    s_headerOk = (s_header.magic == FRAMES_MAGIC);
+    return s_headerOk;
+}
+
+static size_t frameOffset(int slot) {
+    return FRAMES_DATA_OFFSET + (size_t)slot * STATUS_FRAME_BYTES;
+}
+
+static uint32_t crcOf(uint32_t crc, const void* data, size_t len) {
+    return esp_rom_crc32_le(crc, (const uint8_t*)data, len);
+}
+
+// ============================================================================
+// Slot mapping
+// ============================================================================
+
+const char* statusFrameBmpPath(int slot) {
+    if (slot < 0 || slot >= FRAME_SLOT_COUNT) return nullptr;
+    return SLOTS[slot].bmpPath;
+}
+
+void statusFrameCanonical(int slot, Availability& availability, Activity& activity) {
+    availability = SLOTS[slot].availability;
+    activity     = SLOTS[slot].activity;
+}
+
+// ============================================================================
+// Manifest
+// ============================================================================
+
+uint32_t statusFramesManifest(const char* salt) {
+    uint32_t crc = crcOf(0, salt, strlen(salt));
+    for (int i = 0; i < FRAME_SLOT_COUNT; i++) {
+        int32_t size  = sdFileSize(SLOTS[i].bmpPath);
+        time_t  mtime = size >= 0 ? sdFileModified(SLOTS[i].bmpPath) : 0;
+        crc = crcOf(crc, &size, sizeof(size));
+        crc = crcOf(crc, &mtime, sizeof(mtime));
+    }
+    return crc;
+}
+
+bool statusFramesValid(uint32_t manifest) {
+    return loadHeader() && s_header.manifest == manifest;
+}
+
+// ============================================================================
+// Rebuild
+// ============================================================================
+
+bool statusFramesBeginRebuild() {
+    if (!storeOpen()) return false;
+    s_headerOk = false;
+    memset(&s_pending, 0, sizeof(s_pending));
+    if (!storeErase()) {
+        Serial.println("[Frames] Erase failed");
+        return false;
+    }
+    return true;
+}
+
+bool statusFramesPut(int slot, FrameSource src, Availability availability,
+                     Activity activity, const uint8_t* frame) {
+    if (slot < 0 || slot >= FRAME_SLOT_COUNT || !storeOpen()) return false;
+    FrameSlotInfo& info = s_pending.slot[slot];
+    if (!storeWrite(frameOffset(slot), frame, STATUS_FRAME_BYTES)) return false;
+
+    info.source = src;
+    if (src == FRAME_DRAWN) {
+        info.availability = availability;
+        info.activity     = activity;
+    }
+    info.crc = crcOf(0, frame, STATUS_FRAME_BYTES);
+    return true;
+}
+
+bool statusFramesCommit(uint32_t manifest) {
+    if (!storeOpen()) return false;
+    s_pending.magic    = FRAMES_MAGIC;
+    s_pending.manifest = manifest;
+    if (!storeWrite(0, &s_pending, sizeof(s_pending))) return false;
+    s_header   = s_pending;
+    s_headerOk = true;
+    return true;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+FrameSource statusFramesGet(Availability availability, Activity activity, uint8_t* out) {
+    int slot = statusFrameSlot(availability, activity);
+    if (slot < 0 || !loadHeader()) return FRAME_NONE;
+
+    const FrameSlotInfo& info = s_header.slot[slot];
+    if (info.source == FRAME_NONE) return FRAME_NONE;
+    if (info.source == FRAME_DRAWN &&
+        (info.availability != availability || info.activity != activity))
+        return FRAME_NONE;
+
+    if (!storeRead(frameOffset(slot), out, STATUS_FRAME_BYTES) ||
+        crcOf(0, out, STATUS_FRAME_BYTES) != info.crc) {
+        Serial.printf("[Frames] Slot %d unreadable\n", slot);
+        return FRAME_NONE;
+    }
+    return (FrameSource)info.source;
+}
@@ -0,0 +1,180 @@
+// ============================================================================
+// Team Board — Graph getPresencesByUserId for the configured members
+// ============================================================================
+
+#include "team_board.h"
+#include "teams_auth.h"
+#include "https_conn.h"
+#include "poll_arena.h"
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+
+static const char* TEAM_URL =
+    "https://graph.microsoft.com/v1.0/communications/getPresencesByUserId";
+
+#define TEAM_ID_LEN   37    // Entra object id (GUID) + NUL
+#define TEAM_NAME_LEN 16
+
+struct RtcTeam {
+    uint32_t magic;
+    uint8_t  enabled;
+    uint8_t  count;
+    uint8_t  avail[TEAM_MAX_MEMBERS];   // Availability, AV_NONE = not fetched
+    char     id[TEAM_MAX_MEMBERS][TEAM_ID_LEN];
+    char     name[TEAM_MAX_MEMBERS][TEAM_NAME_LEN];
+};
+static const uint32_t TEAM_MAGIC = 0x324D4554;  // "TEM2"
+RTC_DATA_ATTR static RtcTeam rtc_team = {};
+
+static bool teamValid() {
+    return rtc_team.magic == TEAM_MAGIC;
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void teamBoardConfigure(const SdConfig& cfg) {
+    RtcTeam next = {};
+    next.magic   = TEAM_MAGIC;
+    next.enabled = cfg.teamBoard;
+
+    for (int i = 0; i < cfg.teamCount && next.count < TEAM_MAX_MEMBERS; i++) {
+        const SdTeamMember& m = cfg.team[i];
+        if (m.id.isEmpty() || m.id.length() >= TEAM_ID_LEN) {
+            Serial.printf("[Team] Skipping member %d — bad id \"%s\"\n", i, m.id.c_str());
+            continue;
+        }
+        int n = next.count++;
+        strncpy(next.id[n], m.id.c_str(), TEAM_ID_LEN - 1);
+        strncpy(next.name[n], m.name.isEmpty() ? m.id.c_str() : m.name.c_str(),
+                TEAM_NAME_LEN - 1);
+
+        // Same member in the same row: keep the state that's on the panel
+        next.avail[n] = AV_NONE;
+        if (teamValid() && n < rtc_team.count && strcmp(rtc_team.id[n], next.id[n]) == 0)
+            next.avail[n] = rtc_team.avail[n];
+    }
+
+    rtc_team = next;
+    Serial.printf("[Team] Board %s, %d member(s)\n",
+                  rtc_team.enabled ? "on" : "off", rtc_team.count);
+}
+
+void teamBoardLoad() {
+    SdConfig cfg;
+    if (sdMounted() && sdLoadConfig(cfg)) teamBoardConfigure(cfg);
+}
+
+bool teamBoardActive() {
+    return teamValid() && rtc_team.enabled && rtc_team.count > 0;
+}
+
+bool teamBoardFetched() {
+    if (!teamValid() || rtc_team.count == 0) return false;
+    for (int i = 0; i < rtc_team.count; i++)
+        if (rtc_team.avail[i] == AV_NONE) return false;
+    return true;
+}
+
+int teamBoardCount() {
+    return teamValid() ? rtc_team.count : 0;
+}
+
+const char* teamMemberName(int i) {
+    if (i < 0 || i >= teamBoardCount()) return "";
+    return rtc_team.name[i];
+}
+
+Availability teamMemberAvailability(int i) {
+    if (i < 0 || i >= teamBoardCount() || rtc_team.avail[i] >= AV_COUNT)
+        return AV_UNKNOWN;
+    return (Availability)rtc_team.avail[i];
+}
+
+// ============================================================================
+// Graph batch lookup
+// ============================================================================
+
+bool teamFetch(const char* accessToken, uint8_t& changed) {
+    changed = 0;
+    if (!teamBoardActive()) return false;
+
+    StrBuf req(16 + TEAM_MAX_MEMBERS * (TEAM_ID_LEN + 2));
+    req.print("{\"ids\":[");
+    for (int i = 0; i < rtc_team.count; i++) {
+        if (i) req.print(',');
+        req.print('"');
+        req.print(rtc_team.id[i]);
+        req.print('"');
+    }
+    req.print("]}");
+
+    HTTPClient http;
+    if (!httpsBegin(http, TEAM_URL)) {
+        Serial.println("[Team] http.begin failed");
+        return false;
+    }
+    httpsAddBearer(http, accessToken);
+    http.addHeader("Content-Type", "application/json");
+    http.addHeader("Accept", "application/json");
+
+    int httpCode = httpsSend(http, "POST", req.c_str(), req.length());
+    Serial.printf("[Team] HTTP %d (%d ids)\n", httpCode, rtc_team.count);
+
+    if (httpCode == 401) {
+        HttpsBody(http).drain();
+        httpsEnd(http);
+        Serial.println("[Team] 401 — token expired");
+        invalidateAccessToken();
+        return false;
+    }
+    if (httpCode != 200) {
+        // 403 here usually means Presence.Read.All hasn't been consented yet
+        // (the pod signed in before the board had members)
+        StrBuf err(256);
+        httpsReadError(http, err);
+        httpsEnd(http);
+        Serial.printf("[Team] Error: %s\n", err.c_str());
+        return false;
+    }
+
+    StaticJsonDocument<96> filter;
+    filter["value"][0]["id"]           = true;
+    filter["value"][0]["availability"] = true;
+    StaticJsonDocument<1536> doc;
+    HttpsBody body(http);
+    DeserializationError jsonErr = deserializeJson(doc, body,
+                                                   DeserializationOption::Filter(filter));
+    body.drain();
+    httpsEnd(http);
+    if (jsonErr) {
+        Serial.printf("[Team] JSON error: %s (%u bytes read)\n",
+                      jsonErr.c_str(), (unsigned)body.bytesRead());
+        return false;
+    }
+
+    // Rows are matched by id — the response order isn't guaranteed, and a
+    // member Graph doesn't return (deleted account) shows as unknown
+    uint8_t next[TEAM_MAX_MEMBERS];
+    memset(next, 0, sizeof(next));
+    for (JsonObject p : doc["value"].as<JsonArray>()) {
+        const char* id = p["id"] | "";
+        for (int i = 0; i < rtc_team.count; i++) {
+            if (strcasecmp(id, rtc_team.id[i]) == 0) {
+                next[i] = presenceParseAvailability(p["availability"] | "PresenceUnknown");
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < rtc_team.count; i++) {
+        if (next[i] != rtc_team.avail[i]) {
+            changed |= (uint8_t)(1u << i);
+            Serial.printf("[Team] %s: %s\n", rtc_team.name[i],
+                          availabilityName((Availability)next[i]));
+        }
+        rtc_team.avail[i] = next[i];
+    }
+    return true;
+}
@@ -3,16 +3,27 @@
 // ============================================================================
 
 #include "teams_auth.h"
-#include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <Preferences.h>
 #include "sd_storage.h"
+#include "token_cache.h"
+#include "https_conn.h"
+#include "poll_arena.h"
+#include "team_board.h"
 
 // ---- internal state -------------------------------------------------------
-static String  s_access_token  = "";
-static String  s_refresh_token = "";
-static unsigned long s_token_expiry = 0;   // millis() when access token dies
+// Fixed buffers — token responses are parsed straight into these instead of
+// going through a payload String.  Graph access tokens run 1.5–3 KB.
+#define ACCESS_TOKEN_MAX   4096
+#define REFRESH_TOKEN_MAX  3072
+
+static char    s_access_token[ACCESS_TOKEN_MAX]   = "";
+static char    s_refresh_token[REFRESH_TOKEN_MAX] = "";
+static time_t  s_token_expiry  = 0;    // time() when access token dies
+static bool    s_refresh_loaded = false;   // read from SD/NVS on first use
+
+static void loadRefreshToken();
 
 static Preferences auth_prefs;
 static const char* AUTH_NS      = "puck_auth";
@@ -24,14 +35,73 @@ static const char* SCOPE_ENC =
     "+https%3A%2F%2Fgraph.microsoft.com%2FUser.Read"
     "+offline_access";
 
+// New sign-ins also ask for Calendars.Read (calendar-aware scheduling),
+// and for Presence.Read.All (other users' presence, no admin consent) only
+// when config.json has team board members — a tenant that restricts it
+// must still let a single-user pod sign in.
+// Refreshes keep the baseline scope: asking for a permission an older grant
+// never consented to fails with invalid_grant, and the v2 endpoint already
+// returns every consented Graph scope in the refreshed token.
+static const char* SCOPE_SIGNIN_ENC =
+    "https%3A%2F%2Fgraph.microsoft.com%2FPresence.Read"
+    "+https%3A%2F%2Fgraph.microsoft.com%2FUser.Read"
+    "+https%3A%2F%2Fgraph.microsoft.com%2FCalendars.Read"
+    "+offline_access";
+static const char* SCOPE_TEAM_ENC =
+    "+https%3A%2F%2Fgraph.microsoft.com%2FPresence.Read.All";
+
 // ---- endpoint helpers -----------------------------------------------------
-static String deviceCodeEndpoint(const String& tid) {
-    return "https://login.microsoftonline.com/" + tid +
-           "/oauth2/v2.0/devicecode";
+#define ENDPOINT_MAX 128                // host + tenant GUID or domain + path
+
+static void loginEndpoint(StrBuf& url, const String& tid, const char* path) {
+    url.print("https://login.microsoftonline.com/");
+    url.print(tid);
+    url.print(path);
 }
-static String tokenEndpoint(const String& tid) {
-    return "https://login.microsoftonline.com/" + tid +
-           "/oauth2/v2.0/token";
+
+// ---- token response parsing -----------------------------------------------
+// Copy into a fixed buffer; refuses (rather than truncates) what doesn't fit
+static bool storeToken(char* dst, size_t cap, const char* src, const char* what) {
+    size_t len = src ? strlen(src) : 0;
+    if (len == 0 || len >= cap) {
+        Serial.printf("[Auth] %s token %s (%u bytes)\n", what,
+                      len ? "too long" : "missing", (unsigned)len);
+        return false;
+    }
+    memcpy(dst, src, len + 1);
+    return true;
+}
+
+// Stream-parse a 200 token response, keeping only the fields we use
+// (id_token, scope etc. are skipped while reading)
+static bool readTokenResponse(HTTPClient& http) {
+    StaticJsonDocument<96> filter;
+    filter["access_token"]  = true;
+    filter["refresh_token"] = true;
+    filter["expires_in"]    = true;
+
+    ArenaJsonDocument doc(ACCESS_TOKEN_MAX + REFRESH_TOKEN_MAX + 256);
+    HttpsBody body(http);
+    DeserializationError err = deserializeJson(doc, body,
+                                               DeserializationOption::Filter(filter));
+    body.drain();
+    if (err) {
+        Serial.printf("[Auth] Token JSON parse FAILED: %s (%u bytes read)\n",
+                      err.c_str(), (unsigned)body.bytesRead());
+        return false;
+    }
+
+    if (!storeToken(s_access_token, sizeof(s_access_token),
+                    doc["access_token"].as<const char*>(), "Access"))
+        return false;
+    // Refresh responses may omit it — keep the one we have
+    const char* refresh = doc["refresh_token"];
+    if (refresh && storeToken(s_refresh_token, sizeof(s_refresh_token), refresh, "Refresh"))
+        s_refresh_loaded = true;
+    int expiresIn  = doc["expires_in"] | 3600;
+    s_token_expiry = time(nullptr) + expiresIn;
+    tokenCacheStore(TOKEN_SLOT_TEAMS, s_access_token, s_token_expiry);
+    return true;
 }
 
 // ============================================================================
@@ -44,40 +114,48 @@ bool startDeviceCodeFlow(const String& clientId, const String& tenantId,
     response.valid = false;
     Serial.println("[Auth] Starting Device Code Flow...");
 
-    WiFiClientSecure client;
-    client.setInsecure();                       // TODO: pin root CA for prod
     HTTPClient http;
 
-    String url  = deviceCodeEndpoint(tenantId);
-    String body = "client_id=" + clientId + "&scope=" + String(SCOPE_ENC);
+    StrBuf url(ENDPOINT_MAX);
+    loginEndpoint(url, tenantId, "/oauth2/v2.0/devicecode");
+    bool team = teamBoardActive();
+    StrBuf body(64 + clientId.length() + strlen(SCOPE_SIGNIN_ENC) + strlen(SCOPE_TEAM_ENC));
+    body.print("client_id=");
+    body.print(clientId);
+    body.print("&scope=");
+    body.print(SCOPE_SIGNIN_ENC);
+    if (team) body.print(SCOPE_TEAM_ENC);
+    Serial.printf("[Auth] Scope: baseline + Calendars.Read%s\n", team ? " + Presence.Read.All" : "");
 
     Serial.printf("[Auth] POST %s\n", url.c_str());
-    if (!http.begin(client, url)) {
+    if (!httpsBegin(http, url.c_str())) {
         Serial.println("[Auth] http.begin failed");
         return false;
     }
     http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-    int code = http.POST(body);
+    int code = httpsSend(http, "POST", body.c_str(), body.length());
     Serial.printf("[Auth] HTTP %d\n", code);
 
     if (code != 200) {
-        String errPayload = http.getString();
-        Serial.println(errPayload);
-        http.end();
+        StrBuf errPayload(1024);
+        httpsReadError(http, errPayload);
+        Serial.println(errPayload.c_str());
+        httpsEnd(http);
 
         // Parse Azure error for a user-friendly message
-        DynamicJsonDocument errDoc(1024);
-        if (!deserializeJson(errDoc, errPayload) && errDoc.containsKey("error")) {
+        ArenaJsonDocument errDoc(1024);
+        if (!deserializeJson(errDoc, errPayload.c_str()) && errDoc.containsKey("error")) {
             response.user_code = errDoc["error"].as<String>();  // reuse field for error detail
         }
         return false;
     }
 
-    String payload = http.getString();
-    http.end();
-
-    DynamicJsonDocument doc(1024);
-    if (deserializeJson(doc, payload)) {
+    ArenaJsonDocument doc(1024);
+    HttpsBody resp(http);
+    DeserializationError err = deserializeJson(doc, resp);
+    resp.drain();
+    httpsEnd(http);
+    if (err) {
         Serial.println("[Auth] JSON parse error");
         return false;
     }
@@ -107,58 +185,58 @@ bool startDeviceCodeFlow(const String& clientId, const String& tenantId,
 int pollForToken(const String& clientId, const String& tenantId,
                  const String& deviceCode)
 {
-    WiFiClientSecure client;
-    client.setInsecure();
     HTTPClient http;
 
-    String url  = tokenEndpoint(tenantId);
-    String body = "grant_type=urn%3Aietf%3Aparams%3Aoauth%3Agrant-type%3Adevice_code"
-                  "&client_id=" + clientId +
-                  "&device_code=" + deviceCode;
+    StrBuf url(ENDPOINT_MAX);
+    loginEndpoint(url, tenantId, "/oauth2/v2.0/token");
+    StrBuf body(128 + clientId.length() + deviceCode.length());
+    body.print("grant_type=urn%3Aietf%3Aparams%3Aoauth%3Agrant-type%3Adevice_code"
+               "&client_id=");
+    body.print(clientId);
+    body.print("&device_code=");
+    body.print(deviceCode);
 
-    if (!http.begin(client, url)) return -1;
+    if (!httpsBegin(http, url.c_str())) return -1;
     http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-    int httpCode = http.POST(body);
-    String payload = http.getString();
-    http.end();
+    int httpCode = httpsSend(http, "POST", body.c_str(), body.length());
 
     if (httpCode == 200) {
-        DynamicJsonDocument doc(16384);  // MS token JWTs can exceed 4KB
-        DeserializationError jsonErr = deserializeJson(doc, payload);
-        if (jsonErr) {
-            Serial.printf("[Auth] Token JSON parse FAILED: %s (payload %d bytes)\n",
-                          jsonErr.c_str(), payload.length());
-            return -1;
-        }
-
-        s_access_token  = doc["access_token"].as<String>();
-        s_refresh_token = doc["refresh_token"].as<String>();
-        int expiresIn   = doc["expires_in"] | 3600;
-        s_token_expiry  = millis() + (unsigned long)expiresIn * 1000UL;
-
+        bool ok = readTokenResponse(http);
+        httpsEnd(http);
+        if (!ok) return -1;
         Serial.println("[Auth] ✓ Token acquired!");
         return 1;   // success
     }
 
     if (httpCode == 400) {
-        DynamicJsonDocument doc(2048);
-        DeserializationError jsonErr = deserializeJson(doc, payload);
+        // authorization_pending arrives every few seconds while the user
+        // signs in — parse only the error fields
+        StaticJsonDocument<64> filter;
+        filter["error"]             = true;
+        filter["error_description"] = true;
+        ArenaJsonDocument doc(1024);
+        HttpsBody resp(http);
+        DeserializationError jsonErr = deserializeJson(doc, resp,
+                                                       DeserializationOption::Filter(filter));
+        resp.drain();
+        httpsEnd(http);
         if (!jsonErr) {
-            String err = doc["error"].as<String>();
-            Serial.printf("[Auth] Poll response: %s\n", err.c_str());
-            if (err == "authorization_pending" || err == "slow_down")
+            const char* err = doc["error"] | "";
+            Serial.printf("[Auth] Poll response: %s\n", err);
+            if (strcmp(err, "authorization_pending") == 0 || strcmp(err, "slow_down") == 0)
                 return 0;   // keep waiting
-            String errDesc = doc["error_description"].as<String>();
-            Serial.printf("[Auth] Fatal: %s\n", err.c_str());
-            Serial.printf("[Auth] Detail: %.300s\n", errDesc.c_str());
+            Serial.printf("[Auth] Fatal: %s\n", err);
+            Serial.printf("[Auth] Detail: %.300s\n", doc["error_description"] | "");
             return -1;  // genuinely rejected
         }
         // JSON parse failed on 400 — log it and treat as transient
-        Serial.printf("[Auth] 400 JSON parse failed: %s\n", jsonErr.c_str());
-        Serial.printf("[Auth] Payload (%d bytes): %.200s\n", payload.length(), payload.c_str());
+        Serial.printf("[Auth] 400 JSON parse failed: %s (%u bytes)\n",
+                      jsonErr.c_str(), (unsigned)resp.bytesRead());
         return 0;
     }
 
+    if (httpCode > 0) HttpsBody(http).drain();
+    httpsEnd(http);
     // Transient HTTP errors (5xx, network issues) — don't give up
     Serial.printf("[Auth] Unexpected HTTP %d — treating as transient\n", httpCode);
     return -1;
@@ -169,48 +247,47 @@ int pollForToken(const String& clientId, const String& tenantId,
 // ============================================================================
 
 bool refreshAccessToken(const String& clientId, const String& tenantId) {
-    if (s_refresh_token.isEmpty()) {
+    loadRefreshToken();
+    if (s_refresh_token[0] == '\0') {
         Serial.println("[Auth] No refresh token");
         return false;
     }
     Serial.println("[Auth] Refreshing token...");
 
-    WiFiClientSecure client;
-    client.setInsecure();
     HTTPClient http;
 
-    String url  = tokenEndpoint(tenantId);
-    String body = "grant_type=refresh_token"
-                  "&client_id=" + clientId +
-                  "&refresh_token=" + s_refresh_token +
-                  "&scope=" + String(SCOPE_ENC);
-
-    if (!http.begin(client, url)) return false;
+    StrBuf url(ENDPOINT_MAX);
+    loginEndpoint(url, tenantId, "/oauth2/v2.0/token");
+    StrBuf body(64 + clientId.length() + strlen(s_refresh_token) + strlen(SCOPE_ENC));
+    body.print("grant_type=refresh_token&client_id=");
+    body.print(clientId);
+    body.print("&refresh_token=");
+    body.print(s_refresh_token);
+    body.print("&scope=");
+    body.print(SCOPE_ENC);
+
+    if (!httpsBegin(http, url.c_str())) return false;
     http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-    int httpCode = http.POST(body);
-    String payload = http.getString();
-    http.end();
+    int httpCode = httpsSend(http, "POST", body.c_str(), body.length());
 
     if (httpCode != 200) {
+        StrBuf payload(512);                  // small error body
+        httpsReadError(http, payload);
+        httpsEnd(http);
         Serial.printf("[Auth] Refresh failed HTTP %d\n", httpCode);
         // Only invalidate on definitive rejection (invalid_grant) —
         // transient failures (network, DNS, timeout) should NOT erase
         // the token so we can retry next cycle instead of forcing re-auth.
-        if (httpCode == 400 && payload.indexOf("invalid_grant") >= 0) {
+        if (httpCode == 400 && strstr(payload.c_str(), "invalid_grant")) {
             Serial.println("[Auth] Refresh token revoked — clearing");
-            s_refresh_token = "";
+            s_refresh_token[0] = '\0';
         }
         return false;
     }
 
-    DynamicJsonDocument doc(16384);  // MS token JWTs can exceed 4KB
-    if (deserializeJson(doc, payload)) return false;
-
-    s_access_token = doc["access_token"].as<String>();
-    if (doc.containsKey("refresh_token"))
-        s_refresh_token = doc["refresh_token"].as<String>();
-    int expiresIn  = doc["expires_in"] | 3600;
-    s_token_expiry = millis() + (unsigned long)expiresIn * 1000UL;
+    bool ok = readTokenResponse(http);
+    httpsEnd(http);
+    if (!ok) return false;
 
     Serial.println("[Auth] ✓ Token refreshed");
     saveAuthToNVS();
@@ -221,19 +298,23 @@ bool refreshAccessToken(const String& clientId, const String& tenantId) {
 // Accessors
 // ============================================================================
 
-String getAccessToken()       { return s_access_token; }
-bool   hasValidToken()        { return !s_access_token.isEmpty() && millis() < s_token_expiry; }
-bool   hasStoredRefreshToken() { return !s_refresh_token.isEmpty(); }
+const char* getAccessToken()  { return s_access_token; }
+bool   hasValidToken()        { return s_access_token[0] != '\0' && time(nullptr) < s_token_expiry; }
+bool   hasStoredRefreshToken() { loadRefreshToken(); return s_refresh_token[0] != '\0'; }
 bool   isTokenExpiringSoon()  {
     if (s_token_expiry == 0) return false;
-    unsigned long now = millis();
     // Already expired, or within 5 minutes of expiry
-    return (now >= s_token_expiry) || (s_token_expiry - now < 300000UL);
+    return time(nullptr) + 300 >= s_token_expiry;
 }
 long   getTokenExpirySeconds() {
     if (s_token_expiry == 0) return 0;
-    long diff = (long)(s_token_expiry - millis()) / 1000L;
-    return diff;
+    return (long)(s_token_expiry - time(nullptr));
+}
+
+void invalidateAccessToken() {
+    s_access_token[0] = '\0';
+    s_token_expiry = 0;
+    tokenCacheClear(TOKEN_SLOT_TEAMS);
 }
 
 // ============================================================================
@@ -243,24 +324,39 @@ long   getTokenExpirySeconds() {
 static const char* SD_REFRESH_PATH = "/refresh_token.txt";
 
 void loadAuthFromNVS() {
-    // Try SD card first
+    // Access token from the deep-sleep cache (lets a timer wake skip refresh)
+    if (tokenCacheLoad(TOKEN_SLOT_TEAMS, s_access_token, sizeof(s_access_token),
+                       s_token_expiry)) {
+        Serial.printf("[Auth] Cached access token valid for %lds\n",
+                      getTokenExpirySeconds());
+    }
+    // The refresh token waits until it's needed — a timer wake with a
+    // cached access token never touches the SD card
+    s_refresh_loaded = false;
+}
+
+static void loadRefreshToken() {
+    if (s_refresh_loaded) return;
+    s_refresh_loaded = true;
+
+    // Refresh token: try SD card first
     String tok = sdReadText(SD_REFRESH_PATH);
     tok.trim();
-    if (tok.length() > 0) {
-        s_refresh_token = tok;
+    if (tok.length() > 0 &&
+        storeToken(s_refresh_token, sizeof(s_refresh_token), tok.c_str(), "Refresh")) {
         Serial.println("[Auth] Refresh token loaded from SD");
         return;
     }
 
     // Fallback: read from NVS (legacy / no-SD boot)
+    s_refresh_token[0] = '\0';
     if (auth_prefs.begin(AUTH_NS, true)) {
-        s_refresh_token = auth_prefs.getString(KEY_REFRESH, "");
+        if (auth_prefs.getString(KEY_REFRESH, s_refresh_token, sizeof(s_refresh_token)) == 0)
+            s_refresh_token[0] = '\0';
         auth_prefs.end();
-    } else {
-        s_refresh_token = "";
     }
     Serial.printf("[Auth] Refresh token from NVS fallback: %s\n",
-                  s_refresh_token.isEmpty() ? "(none)" : "(present)");
+                  s_refresh_token[0] ? "(present)" : "(none)");
 }
 
 void saveAuthToNVS() {
@@ -281,8 +377,10 @@ void clearAuthNVS() {
     auth_prefs.begin(AUTH_NS, false);
     auth_prefs.clear();
     auth_prefs.end();
-    s_access_token  = "";
-    s_refresh_token = "";
-    s_token_expiry  = 0;
+    tokenCacheClear(TOKEN_SLOT_TEAMS);
+    s_access_token[0]  = '\0';
+    s_refresh_token[0] = '\0';
+    s_refresh_loaded   = true;
+    s_token_expiry     = 0;
     Serial.println("[Auth] Auth cleared (SD + NVS)");
 }
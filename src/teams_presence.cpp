@@ -3,64 +3,65 @@
 // ============================================================================
 
 #include "teams_presence.h"
-#include <WiFiClientSecure.h>
+#include "teams_auth.h"
+#include "https_conn.h"
+#include "poll_arena.h"
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 
-bool getPresence(const String& accessToken, PresenceState& state) {
+bool getPresence(const char* accessToken, PresenceState& state) {
     state.valid = false;
 
-    WiFiClientSecure client;
-    client.setInsecure();       // TODO: pin root CA
     HTTPClient http;
 
-    if (!http.begin(client,
+    if (!httpsBegin(http,
                     "https://graph.microsoft.com/v1.0/me/presence")) {
         Serial.println("[Presence] http.begin failed");
         return false;
     }
-    http.addHeader("Authorization", "Bearer " + accessToken);
+    httpsAddBearer(http, accessToken);
     http.addHeader("Accept", "application/json");
 
-    int httpCode = http.GET();
-    String payload = http.getString();
-    http.end();
-
+    int httpCode = httpsSend(http, "GET");
     Serial.printf("[Presence] HTTP %d\n", httpCode);
 
     if (httpCode == 401) {
+        HttpsBody(http).drain();
+        httpsEnd(http);
         Serial.println("[Presence] 401 — token expired");
+        invalidateAccessToken();    // don't reuse it from the sleep cache
         return false;
     }
     if (httpCode != 200) {
-        Serial.printf("[Presence] Error: %s\n", payload.c_str());
+        StrBuf err(256);
+        httpsReadError(http, err);
+        httpsEnd(http);
+        Serial.printf("[Presence] Error: %s\n", err.c_str());
         return false;
     }
 
-    DynamicJsonDocument doc(2048);
-    DeserializationError jsonErr = deserializeJson(doc, payload);
+    // "@odata.context", "id" and friends are skipped while reading
+    StaticJsonDocument<64> filter;
+    filter["availability"] = true;
+    filter["activity"]     = true;
+    StaticJsonDocument<192> doc;
+    HttpsBody body(http);
+    DeserializationError jsonErr = deserializeJson(doc, body,
+                                                   DeserializationOption::Filter(filter));
+    body.drain();
+    httpsEnd(http);
     if (jsonErr) {
-        Serial.printf("[Presence] JSON error: %s (payload %d bytes)\n",
-                      jsonErr.c_str(), payload.length());
-        Serial.printf("[Presence] Payload: %.200s\n", payload.c_str());
+        Serial.printf("[Presence] JSON error: %s (%u bytes read)\n",
+                      jsonErr.c_str(), (unsigned)body.bytesRead());
         return false;
     }
 
-    state.availability = doc["availability"].as<String>();
-    state.activity     = doc["activity"].as<String>();
+    const char* avail = doc["availability"] | "PresenceUnknown";
+    const char* act   = doc["activity"]     | "";
+    state.availability = presenceParseAvailability(avail);
+    state.activity     = presenceParseActivity(act);
     state.valid        = true;
 
-    Serial.printf("[Presence] %s (%s)\n",
-                  state.availability.c_str(), state.activity.c_str());
+    Serial.printf("[Presence] %s (%s)\n", avail, act);
     return true;
 }
-
-const char* availabilityLabel(const String& a) {
-    if (a == "Available")       return "Available";
-    if (a == "Busy")            return "Busy";
-    if (a == "DoNotDisturb")    return "Do Not Disturb";
-    if (a == "Away")            return "Away";
-    if (a == "BeRightBack")     return "Be Right Back";
-    if (a == "Offline")         return "Offline";
-    return "Unknown";
-}
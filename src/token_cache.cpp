@@ -0,0 +1,125 @@
+// ============================================================================
+// Token Cache — access tokens that survive deep sleep
+// ============================================================================
+
+#include "token_cache.h"
+#include <Preferences.h>
+
+// Teams JWTs are typically 1.5–2.5 KB, Zoom S2S tokens well under that.
+// Anything longer goes to NVS so RTC memory stays within budget.
+#define TOKEN_RTC_MAX   3072
+#define TOKEN_MAGIC     0x544B4331UL   // "TKC1"
+
+// Anything before 2024-01-01 means time() is still counting from power-on
+static const time_t CLOCK_VALID_EPOCH = 1704067200;
+
+static const char* TOKEN_NS = "tok_cache";
+
+// ---- RTC slot (survives deep sleep, lost on power-on) ----------------------
+struct RtcTokenSlot {
+    uint32_t magic;
+    uint8_t  slot;
+    uint16_t len;
+    time_t   issued;    // time() when stored — detects clock resets
+    time_t   expiry;    // time() when the token dies
+    char     token[TOKEN_RTC_MAX];
+};
+
+RTC_DATA_ATTR static RtcTokenSlot rtc_token = {};
+
+bool tokenClockIsSet(time_t t) {
+    return t >= CLOCK_VALID_EPOCH;
+}
+
+// ============================================================================
+// Store
+// ============================================================================
+
+bool tokenCacheStore(TokenSlot slot, const char* token, time_t expiry) {
+    time_t now = time(nullptr);
+    size_t len = token ? strlen(token) : 0;
+    if (len == 0 || expiry <= now) return false;
+
+    if (len < TOKEN_RTC_MAX) {
+        rtc_token.slot   = slot;
+        rtc_token.len    = len;
+        rtc_token.issued = now;
+        rtc_token.expiry = expiry;
+        memcpy(rtc_token.token, token, len + 1);
+        rtc_token.magic  = TOKEN_MAGIC;
+        Serial.printf("[Token] Cached in RTC (%u bytes, %lds left)\n",
+                      rtc_token.len, (long)(expiry - now));
+        return true;
+    }
+
+    // Too large for RTC — spill to NVS.  Only useful with a real wall clock,
+    // otherwise the expiry can't be trusted after a power cycle.
+    rtc_token.magic = 0;
+    if (!tokenClockIsSet(now)) {
+        Serial.printf("[Token] %u bytes, clock not set — not cached\n", (unsigned)len);
+        return false;
+    }
+    Preferences prefs;
+    if (!prefs.begin(TOKEN_NS, false)) return false;
+    prefs.putUChar("slot", slot);
+    prefs.putString("tok", token);
+    prefs.putLong64("issued", (int64_t)now);
+    prefs.putLong64("exp", (int64_t)expiry);
+    prefs.end();
+    Serial.printf("[Token] Cached in NVS (%u bytes, %lds left)\n",
+                  (unsigned)len, (long)(expiry - now));
+    return true;
+}
+
+// ============================================================================
+// Load
+// ============================================================================
+
+bool tokenCacheLoad(TokenSlot slot, char* token, size_t cap, time_t& expiry) {
+    time_t now = time(nullptr);
+
+    if (rtc_token.magic == TOKEN_MAGIC && rtc_token.slot == slot) {
+        if (now >= rtc_token.issued && now < rtc_token.expiry &&
+            rtc_token.len < cap) {
+            memcpy(token, rtc_token.token, rtc_token.len + 1);
+            expiry = rtc_token.expiry;
+            Serial.printf("[Token] RTC hit (%lds left)\n", (long)(expiry - now));
+            return true;
+        }
+        Serial.println("[Token] RTC token expired");
+        rtc_token.magic = 0;
+        return false;
+    }
+
+    // NVS fallback — requires a set clock on both ends
+    if (!tokenClockIsSet(now)) return false;
+    Preferences prefs;
+    if (!prefs.begin(TOKEN_NS, true)) return false;
+    bool ok = false;
+    if (prefs.getUChar("slot", 0) == slot) {
+        time_t issued = (time_t)prefs.getLong64("issued", 0);
+        time_t exp    = (time_t)prefs.getLong64("exp", 0);
+        if (tokenClockIsSet(issued) && now >= issued && now < exp &&
+            prefs.getString("tok", token, cap) > 1) {   // length includes the NUL
+            expiry = exp;
+            ok     = true;
+        }
+    }
+    prefs.end();
+    if (ok) Serial.printf("[Token] NVS hit (%lds left)\n", (long)(expiry - now));
+    return ok;
+}
+
+// ============================================================================
+// Clear
+// ============================================================================
+
+void tokenCacheClear(TokenSlot slot) {
+    if (rtc_token.slot == slot) rtc_token.magic = 0;
+
+    Preferences prefs;
+    if (prefs.begin(TOKEN_NS, false)) {
+        if (prefs.getUChar("slot", 0) == slot) prefs.clear();
+        prefs.end();
+    }
+}
@@ -0,0 +1,176 @@
+// ============================================================================
+// ULP Monitor — battery watch during deep sleep
+// ============================================================================
+
+#include "ulp_monitor.h"
+#include "battery.h"
+#include <esp_sleep.h>
+#include <time.h>
+
+#if CONFIG_ESP32S3_ULP_COPROC_ENABLED
+#include <esp32s3/ulp.h>
+#include <driver/adc.h>
+#include <soc/rtc_cntl_reg.h>
+#endif
+
+static const char* REASON_NAMES[] = { "none", "batt_warn", "batt_shutdown" };
+
+// ---- Sleep the ULP was started for (RTC memory) ----
+struct RtcUlp {
+    uint32_t magic;
+    uint32_t deadline;      // time() the armed poll is due
+};
+static const uint32_t ULP_MAGIC = 0x31504C55;  // "ULP1"
+RTC_DATA_ATTR static RtcUlp rtc_ulp = {};
+
+#if CONFIG_ESP32S3_ULP_COPROC_ENABLED
+
+// ---- RTC slow memory layout (32-bit words; the ULP uses the low 16 bits) ----
+enum {
+    W_SAMPLE = 0,           // last averaged raw reading
+    W_SEQ,                  // samples taken
+    W_REASON,               // UlpWakeReason it woke the SoC for
+    W_WARN_RAW,             // wake when sample <  this (0 = off)
+    W_SHUT_RAW,             // wake when sample <  this
+    W_DATA_COUNT
+};
+static const uint32_t PROG_ADDR    = 8;    // words — program follows the data
+static const int      ULP_SAMPLES  = 8;    // ADC reads averaged per wake
+static const int      ULP_SHIFT    = 3;    // log2(ULP_SAMPLES); 8 × 4095 fits 16 bits
+
+static_assert(PROG_ADDR >= W_DATA_COUNT, "ULP program would overwrite its data words");
+
+enum { L_SAMPLE, L_SAMPLED, L_SHUT, L_WARN, L_WAKE };
+
+static void ulpStop() {
+    CLEAR_PERI_REG_MASK(RTC_CNTL_ULP_CP_TIMER_REG, RTC_CNTL_ULP_CP_SLP_TIMER_EN);
+}
+
+// R3 = data base (0), R0 = sample, R1/R2 scratch.  A subtraction that
+// borrows sets the overflow flag, so "a < b" is SUBR a−b then BXF.
+static bool loadProgram() {
+    const ulp_insn_t program[] = {
+        I_MOVI(R3, 0),
+        I_MOVI(R0, 0),
+        I_MOVI(R2, ULP_SAMPLES),
+    M_LABEL(L_SAMPLE),
+        I_ADC(R1, 0, BATTERY_ADC_CHANNEL),
+        I_ADDR(R0, R0, R1),
+        I_SUBI(R2, R2, 1),
+        M_BXZ(L_SAMPLED),
+        M_BX(L_SAMPLE),
+    M_LABEL(L_SAMPLED),
+        I_RSHI(R0, R0, ULP_SHIFT),
+        I_ST(R0, R3, W_SAMPLE),
+        I_LD(R1, R3, W_SEQ),
+        I_ADDI(R1, R1, 1),
+        I_ST(R1, R3, W_SEQ),
+
+        I_LD(R1, R3, W_SHUT_RAW),
+        I_SUBR(R2, R0, R1),
+        M_BXF(L_SHUT),
+        I_LD(R1, R3, W_WARN_RAW),
+        I_SUBR(R2, R0, R1),
+        M_BXF(L_WARN),
+        I_HALT(),                           // nothing to report — sleep on
+
+    M_LABEL(L_SHUT),
+        I_MOVI(R2, ULP_WAKE_BATT_SHUTDOWN),
+        M_BX(L_WAKE),
+    M_LABEL(L_WARN),
+        I_MOVI(R2, ULP_WAKE_BATT_WARN),
+    M_LABEL(L_WAKE),
+        I_ST(R2, R3, W_REASON),
+        I_WAKE(),
+        I_END(),                            // no more samples until restarted
+        I_HALT(),
+    };
+    // Data + program must fit the slow memory reserved for the ULP (labels
+    // take no space once loaded, so this over-counts slightly)
+    static_assert(PROG_ADDR * sizeof(uint32_t) + sizeof(program) <= CONFIG_ESP32S3_ULP_COPROC_RESERVE_MEM,
+                  "ULP program doesn't fit CONFIG_ESP32S3_ULP_COPROC_RESERVE_MEM");
+    size_t size = sizeof(program) / sizeof(ulp_insn_t);
+    esp_err_t err = ulp_process_macros_and_load(PROG_ADDR, program, &size);
+    if (err != ESP_OK) {
+        Serial.printf("[ULP] Program load failed: %s\n", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+#endif  // CONFIG_ESP32S3_ULP_COPROC_ENABLED
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool ulpMonitorStart(int sleepSec, int warnPct, int shutdownPct) {
+#if CONFIG_ESP32S3_ULP_COPROC_ENABLED
+    ulpStop();
+    float now = batteryReadVoltage();
+    uint16_t shutRaw = batteryRawForVoltage(batteryVoltageAtPercent(shutdownPct));
+    uint16_t warnRaw = batteryPercent(now) > warnPct
+                     ? batteryRawForVoltage(batteryVoltageAtPercent(warnPct)) : 0;
+
+    if (!loadProgram()) return false;
+    RTC_SLOW_MEM[W_SAMPLE]   = 0;
+    RTC_SLOW_MEM[W_SEQ]      = 0;
+    RTC_SLOW_MEM[W_REASON]   = ULP_WAKE_NONE;
+    RTC_SLOW_MEM[W_WARN_RAW] = warnRaw;
+    RTC_SLOW_MEM[W_SHUT_RAW] = shutRaw;
+
+    // Hand ADC1 to the ULP (analogRead() takes it back after the wake)
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten((adc1_channel_t)BATTERY_ADC_CHANNEL, ADC_ATTEN_DB_11);
+    adc1_ulp_enable();
+
+    ulp_set_wakeup_period(0, (uint32_t)ULP_SAMPLE_SEC * 1000000UL);
+    esp_err_t err = ulp_run(PROG_ADDR);
+    if (err != ESP_OK) {
+        Serial.printf("[ULP] Start failed: %s\n", esp_err_to_name(err));
+        return false;
+    }
+    esp_sleep_enable_ulp_wakeup();
+
+    time_t t = time(nullptr);
+    rtc_ulp.magic    = ULP_MAGIC;
+    rtc_ulp.deadline = (uint32_t)t + (sleepSec > 0 ? sleepSec : 0);
+    Serial.printf("[ULP] Watching every %ds: warn<%u shut<%u (now %.2fV)\n",
+                  ULP_SAMPLE_SEC, warnRaw, shutRaw, now);
+    return true;
+#else
+    (void)sleepSec; (void)warnPct; (void)shutdownPct;
+    return false;
+#endif
+}
+
+bool ulpMonitorCollect(UlpReport& out) {
+    out.reason      = ULP_WAKE_NONE;
+    out.voltage     = 0;
+    out.samples     = 0;
+    out.secondsLeft = 0;
+#if CONFIG_ESP32S3_ULP_COPROC_ENABLED
+    if (rtc_ulp.magic != ULP_MAGIC) return false;
+    ulpStop();
+    rtc_ulp.magic = 0;      // one report per start
+
+    out.samples = RTC_SLOW_MEM[W_SEQ] & 0xFFFF;
+    if (out.samples == 0) return false;
+    out.voltage = batteryVoltageFromRaw(RTC_SLOW_MEM[W_SAMPLE] & 0xFFFF);
+    uint32_t reason = RTC_SLOW_MEM[W_REASON] & 0xFFFF;
+    if (reason <= ULP_WAKE_BATT_SHUTDOWN) out.reason = (UlpWakeReason)reason;
+
+    int32_t left = (int32_t)(rtc_ulp.deadline - (uint32_t)time(nullptr));
+    out.secondsLeft = left > 0 ? left : 0;
+    Serial.printf("[ULP] %u sample(s), last %.2fV, wake: %s, poll in %ds\n",
+                  (unsigned)out.samples, out.voltage, ulpWakeReasonName(out.reason),
+                  out.secondsLeft);
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* ulpWakeReasonName(UlpWakeReason reason) {
+    return reason <= ULP_WAKE_BATT_SHUTDOWN ? REASON_NAMES[reason] : "?";
+}
@@ -0,0 +1,243 @@
+// ============================================================================
+// Wake Profiler — where a timer wake's time (and charge) goes
+// ============================================================================
+
+#include "wake_profiler.h"
+#include "sd_storage.h"
+#include "power_policy.h"
+#include <WiFi.h>
+#include <esp_timer.h>
+#include <time.h>
+
+#define WAKE_RING       16
+#define WAKE_MAGIC      0x57414B32UL    // "WAK2"
+
+static const char*   WAKES_CSV    = "/user/wakes.csv";
+static const uint8_t FLUSH_BATCH  = 8;      // append to SD every N records
+
+// Rough current model for the mAh/day estimate (whole board, 3.7 V)
+static const float AWAKE_MA = 45.0f;    // CPU + PSRAM, radio off
+static const float RADIO_MA = 75.0f;    // extra while WiFi phases run
+static const float EPD_MA   = 5.0f;     // extra while the panel refreshes
+static const float SLEEP_MA = 0.15f;    // deep sleep
+
+static const char* PHASE_NAMES[WP_PHASE_COUNT] = {
+    "battery", "sd_mount", "settings", "wifi", "ntp", "tls",
+    "http", "json", "epd", "light", "audio"
+};
+static const char* OUTCOME_NAMES[WAKE_OUTCOME_COUNT] = {
+    "unchanged", "changed", "wifi_fail", "off_hours", "low_batt"
+};
+
+struct WakeRecord {
+    uint32_t epoch;                     // time() at wake (0 = clock unset)
+    uint16_t phaseMs[WP_PHASE_COUNT];
+    uint16_t totalMs;                   // reset → end of wake
+    uint16_t battMv;
+    uint16_t sleepSec;
+    int8_t   rssi;
+    uint8_t  cpuMhz;                    // peak during the wake
+    uint8_t  outcome;
+    uint16_t lockMs[PM_LOCK_COUNT];     // time each power lock was held
+};
+
+// ---- RTC ring (survives deep sleep) ----------------------------------------
+struct RtcWakeRing {
+    uint32_t   magic;
+    uint8_t    head;                    // next slot to write
+    uint8_t    count;
+    uint8_t    unflushed;               // newest N not yet in the CSV
+    WakeRecord rec[WAKE_RING];
+};
+RTC_DATA_ATTR static RtcWakeRing rtc_wakes = {};
+
+static bool       s_open = false;
+static WakeRecord s_cur;
+static uint32_t   s_lockBase[PM_LOCK_COUNT];   // powerLockHeldMs() at begin
+
+// ----------------------------------------------------------------------------
+static uint16_t sat16(uint32_t v) {
+    return v > 0xFFFF ? 0xFFFF : (uint16_t)v;
+}
+
+static void notePeakMhz() {
+    uint32_t mhz = getCpuFrequencyMhz();
+    if (mhz > s_cur.cpuMhz) s_cur.cpuMhz = mhz > 255 ? 255 : (uint8_t)mhz;
+}
+
+static const WakeRecord& recordAt(int age) {            // 0 = oldest
+    int idx = (rtc_wakes.head + WAKE_RING - rtc_wakes.count + age) % WAKE_RING;
+    return rtc_wakes.rec[idx];
+}
+
+static void sortU16(uint16_t* v, int n) {
+    for (int i = 1; i < n; i++) {
+        uint16_t x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) { v[j + 1] = v[j]; j--; }
+        v[j + 1] = x;
+    }
+}
+
+// Nearest-rank percentile of a sorted array
+static uint16_t pct(const uint16_t* v, int n, int p) {
+    int rank = (p * n + 99) / 100;
+    if (rank < 1) rank = 1;
+    return v[rank - 1];
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void wakeProfBegin() {
+    if (rtc_wakes.magic != WAKE_MAGIC) {
+        memset(&rtc_wakes, 0, sizeof(rtc_wakes));
+        rtc_wakes.magic = WAKE_MAGIC;
+    }
+    memset(&s_cur, 0, sizeof(s_cur));
+    time_t now = time(nullptr);
+    s_cur.epoch = now > 0 ? (uint32_t)now : 0;
+    s_cur.rssi  = 0;
+    notePeakMhz();
+    for (int k = 0; k < PM_LOCK_COUNT; k++)
+        s_lockBase[k] = powerLockHeldMs((PowerLockKind)k);
+    s_open = true;
+}
+
+void wakeProfAdd(WakePhase phase, uint32_t ms) {
+    if (!s_open || phase >= WP_PHASE_COUNT) return;
+    s_cur.phaseMs[phase] = sat16(s_cur.phaseMs[phase] + ms);
+    notePeakMhz();
+}
+
+void wakeProfSetBattery(int millivolts) {
+    if (s_open) s_cur.battMv = millivolts > 0 ? sat16(millivolts) : 0;
+}
+
+void wakeProfSetOutcome(WakeOutcome outcome) {
+    if (s_open) s_cur.outcome = outcome;
+}
+
+void wakeProfEnd(int sleepSec) {
+    if (!s_open) return;
+    s_open = false;
+    notePeakMhz();
+    s_cur.totalMs  = sat16((uint32_t)(esp_timer_get_time() / 1000));
+    s_cur.sleepSec = sleepSec > 0 ? sat16(sleepSec) : 0;
+    if (WiFi.status() == WL_CONNECTED) s_cur.rssi = (int8_t)WiFi.RSSI();
+    for (int k = 0; k < PM_LOCK_COUNT; k++)
+        s_cur.lockMs[k] = sat16(powerLockHeldMs((PowerLockKind)k) - s_lockBase[k]);
+
+    rtc_wakes.rec[rtc_wakes.head] = s_cur;
+    rtc_wakes.head = (rtc_wakes.head + 1) % WAKE_RING;
+    if (rtc_wakes.count < WAKE_RING) rtc_wakes.count++;
+    if (rtc_wakes.unflushed < WAKE_RING) rtc_wakes.unflushed++;
+
+    Serial.printf("[Prof] Wake %ums (%s): wifi %u tls %u http %u json %u epd %u"
+                  " | cpu_max %u apb_max %u\n",
+                  s_cur.totalMs, OUTCOME_NAMES[s_cur.outcome],
+                  s_cur.phaseMs[WP_WIFI], s_cur.phaseMs[WP_TLS],
+                  s_cur.phaseMs[WP_HTTP], s_cur.phaseMs[WP_JSON],
+                  s_cur.phaseMs[WP_EPD],
+                  s_cur.lockMs[PM_LOCK_CPU_MAX], s_cur.lockMs[PM_LOCK_APB_MAX]);
+
+    if (rtc_wakes.unflushed >= FLUSH_BATCH && sdMounted()) wakeProfFlush();
+}
+
+// ============================================================================
+// CSV export
+// ============================================================================
+
+void wakeProfFlush() {
+    if (rtc_wakes.magic != WAKE_MAGIC || rtc_wakes.unflushed == 0 || !sdMounted())
+        return;
+
+    String csv;
+    if (!sdFileExists(WAKES_CSV)) {
+        csv = "epoch,outcome,total_ms,cpu_mhz,rssi,batt_mv,sleep_s";
+        for (int p = 0; p < WP_PHASE_COUNT; p++) {
+            csv += ',';
+            csv += PHASE_NAMES[p];
+        }
+        for (int k = 0; k < PM_LOCK_COUNT; k++) {
+            csv += ",hold_";
+            csv += powerLockName((PowerLockKind)k);
+        }
+        csv += '\n';
+    }
+    int first = rtc_wakes.count - rtc_wakes.unflushed;   // lost ones dropped
+    if (first < 0) first = 0;
+    char row[192];
+    for (int i = first; i < rtc_wakes.count; i++) {
+        const WakeRecord& r = recordAt(i);
+        int n = snprintf(row, sizeof(row), "%u,%s,%u,%u,%d,%u,%u",
+                         (unsigned)r.epoch, OUTCOME_NAMES[r.outcome], r.totalMs,
+                         r.cpuMhz, r.rssi, r.battMv, r.sleepSec);
+        for (int p = 0; p < WP_PHASE_COUNT && n < (int)sizeof(row); p++)
+            n += snprintf(row + n, sizeof(row) - n, ",%u", r.phaseMs[p]);
+        for (int k = 0; k < PM_LOCK_COUNT && n < (int)sizeof(row); k++)
+            n += snprintf(row + n, sizeof(row) - n, ",%u", r.lockMs[k]);
+        csv += row;
+        csv += '\n';
+    }
+    if (sdAppendText(WAKES_CSV, csv)) {
+        Serial.printf("[Prof] %u wake(s) appended to %s\n",
+                      rtc_wakes.unflushed, WAKES_CSV);
+        rtc_wakes.unflushed = 0;
+    }
+}
+
+// ============================================================================
+// Summary
+// ============================================================================
+
+void wakeProfDescribe(char* line1, size_t len1, char* line2, size_t len2) {
+    int n = (rtc_wakes.magic == WAKE_MAGIC) ? rtc_wakes.count : 0;
+    if (n == 0) {
+        snprintf(line1, len1, "Wakes: none recorded");
+        line2[0] = '\0';
+        return;
+    }
+
+    uint16_t v[WAKE_RING];
+    for (int i = 0; i < n; i++) v[i] = recordAt(i).totalMs;
+    sortU16(v, n);
+    uint16_t med = pct(v, n, 50), p95 = pct(v, n, 95);
+
+    // Slowest phase by median
+    int slow = 0;
+    uint16_t slowMed = 0, slowP95 = 0;
+    for (int p = 0; p < WP_PHASE_COUNT; p++) {
+        for (int i = 0; i < n; i++) v[i] = recordAt(i).phaseMs[p];
+        sortU16(v, n);
+        if (pct(v, n, 50) > slowMed) {
+            slow = p;
+            slowMed = pct(v, n, 50);
+            slowP95 = pct(v, n, 95);
+        }
+    }
+
+    // Charge per wake and wake rate from the recorded cycles
+    float mAs = 0, cycleSec = 0;
+    for (int i = 0; i < n; i++) {
+        const WakeRecord& r = recordAt(i);
+        uint32_t radio = r.phaseMs[WP_WIFI] + r.phaseMs[WP_NTP] + r.phaseMs[WP_TLS] +
+                         r.phaseMs[WP_HTTP] + r.phaseMs[WP_JSON];
+        mAs += r.totalMs / 1000.0f * AWAKE_MA + radio / 1000.0f * RADIO_MA +
+               r.phaseMs[WP_EPD] / 1000.0f * EPD_MA;
+        cycleSec += r.totalMs / 1000.0f + r.sleepSec;
+    }
+    mAs /= n;
+    cycleSec /= n;
+    float awakeSec = 0;
+    for (int i = 0; i < n; i++) awakeSec += recordAt(i).totalMs / 1000.0f;
+    awakeSec /= n;
+    float wakesPerDay = cycleSec > 0 ? 86400.0f / cycleSec : 0;
+    float sleepHours  = 24.0f * (cycleSec > 0 ? 1.0f - awakeSec / cycleSec : 0);
+    float mAhDay = wakesPerDay * mAs / 3600.0f + SLEEP_MA * sleepHours;
+
+    snprintf(line1, len1, "Wake %.1fs p95 %.1fs (%d)", med / 1000.0f, p95 / 1000.0f, n);
+    snprintf(line2, len2, "%s %.1f/%.1fs ~%.0fmAh/d", PHASE_NAMES[slow],
+             slowMed / 1000.0f, slowP95 / 1000.0f, mAhDay);
+}
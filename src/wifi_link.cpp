@@ -0,0 +1,178 @@
+// ============================================================================
+// WiFi Link — station connect with RTC-cached fast reconnect
+// ============================================================================
+
+#include "wifi_link.h"
+#include <WiFi.h>
+#include <esp_wifi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <time.h>
+
+#define WIFI_CACHE_MAGIC  0x57464331UL   // "WFC1"
+
+static const unsigned long FAST_TIMEOUT_MS   = 3000;   // direct join budget
+static const time_t        LEASE_REUSE_SEC   = 4 * 3600;  // re-run DHCP after this
+
+// ---- RTC cache (survives deep sleep) ---------------------------------------
+struct RtcWifiCache {
+    uint32_t magic;
+    uint32_t credHash;      // SSID + password — invalidates on re-provision
+    uint8_t  bssid[6];
+    uint8_t  channel;
+    bool     haveLease;
+    uint32_t ip, gateway, mask, dns;
+    time_t   leaseAt;       // time() when DHCP handed out the lease
+};
+RTC_DATA_ATTR static RtcWifiCache rtc_wifi = {};
+
+// Recent connect times per mode, for the median log line
+#define CONNECT_HISTORY  8
+enum { MODE_FAST = 0, MODE_FULL = 1 };
+RTC_DATA_ATTR static uint16_t rtc_connectMs[2][CONNECT_HISTORY] = {};
+RTC_DATA_ATTR static uint8_t  rtc_connectCount[2] = {};
+RTC_DATA_ATTR static uint8_t  rtc_connectNext[2]  = {};
+
+// ---- Event plumbing ----
+static EventGroupHandle_t s_wifiEvents = nullptr;
+#define BIT_GOT_IP        BIT0
+#define BIT_DISCONNECTED  BIT1
+
+static void onWifiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    if (!s_wifiEvents) return;
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+        xEventGroupSetBits(s_wifiEvents, BIT_GOT_IP);
+    else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+        xEventGroupSetBits(s_wifiEvents, BIT_DISCONNECTED);
+}
+
+static void ensureEvents() {
+    if (s_wifiEvents) return;
+    s_wifiEvents = xEventGroupCreate();
+    WiFi.onEvent(onWifiEvent, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent(onWifiEvent, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+}
+
+// ----------------------------------------------------------------------------
+static uint32_t credHash(const String& ssid, const String& password) {
+    uint32_t h = 2166136261UL;                       // FNV-1a
+    for (unsigned i = 0; i < ssid.length(); i++)     { h ^= (uint8_t)ssid[i];     h *= 16777619UL; }
+    h ^= 0xFF; h *= 16777619UL;
+    for (unsigned i = 0; i < password.length(); i++) { h ^= (uint8_t)password[i]; h *= 16777619UL; }
+    return h;
+}
+
+static void recordConnectTime(int mode, unsigned long ms) {
+    rtc_connectMs[mode][rtc_connectNext[mode]] = (uint16_t)min(ms, 65535UL);
+    rtc_connectNext[mode] = (rtc_connectNext[mode] + 1) % CONNECT_HISTORY;
+    if (rtc_connectCount[mode] < CONNECT_HISTORY) rtc_connectCount[mode]++;
+}
+
+static unsigned medianConnectTime(int mode) {
+    uint8_t n = rtc_connectCount[mode];
+    if (n == 0) return 0;
+    uint16_t v[CONNECT_HISTORY];
+    memcpy(v, rtc_connectMs[mode], sizeof(v));
+    // Insertion sort — at most 8 entries
+    for (int i = 1; i < n; i++) {
+        uint16_t x = v[i]; int j = i - 1;
+        while (j >= 0 && v[j] > x) { v[j + 1] = v[j]; j--; }
+        v[j + 1] = x;
+    }
+    return (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+// Block until GOT_IP, or DISCONNECTED when `failOnDisconnect`, or timeout
+static bool waitForIP(unsigned long timeoutMs, bool failOnDisconnect) {
+    EventBits_t waitBits = BIT_GOT_IP | (failOnDisconnect ? BIT_DISCONNECTED : 0);
+    EventBits_t bits = xEventGroupWaitBits(s_wifiEvents, waitBits, pdTRUE, pdFALSE,
+                                           pdMS_TO_TICKS(timeoutMs));
+    return (bits & BIT_GOT_IP) && WiFi.status() == WL_CONNECTED;
+}
+
+static void saveCache(uint32_t hash, bool dhcp) {
+    memcpy(rtc_wifi.bssid, WiFi.BSSID(), 6);
+    rtc_wifi.channel  = (uint8_t)WiFi.channel();
+    rtc_wifi.credHash = hash;
+    if (dhcp) {
+        rtc_wifi.ip        = (uint32_t)WiFi.localIP();
+        rtc_wifi.gateway   = (uint32_t)WiFi.gatewayIP();
+        rtc_wifi.mask      = (uint32_t)WiFi.subnetMask();
+        rtc_wifi.dns       = (uint32_t)WiFi.dnsIP(0);
+        rtc_wifi.leaseAt   = time(nullptr);
+        rtc_wifi.haveLease = rtc_wifi.ip != 0;
+    }
+    rtc_wifi.magic = WIFI_CACHE_MAGIC;
+}
+
+// ============================================================================
+// Connect
+// ============================================================================
+
+bool wifiConnect(const String& ssid, const String& password,
+                 unsigned long timeoutMs)
+{
+    ensureEvents();
+    WiFi.persistent(false);         // RTC cache replaces the flash copy
+    WiFi.mode(WIFI_STA);
+
+    uint32_t hash = credHash(ssid, password);
+    unsigned long t0 = millis();
+
+    // --- Fast path: known BSSID + channel, static lease if still fresh ---
+    if (rtc_wifi.magic == WIFI_CACHE_MAGIC && rtc_wifi.credHash == hash) {
+        time_t now = time(nullptr);
+        bool useLease = rtc_wifi.haveLease && now >= rtc_wifi.leaseAt &&
+                        now - rtc_wifi.leaseAt < LEASE_REUSE_SEC;
+        if (useLease) {
+            WiFi.config(IPAddress(rtc_wifi.ip), IPAddress(rtc_wifi.gateway),
+                        IPAddress(rtc_wifi.mask), IPAddress(rtc_wifi.dns));
+        }
+        Serial.printf("[WiFi] Fast connect to %s (ch %u%s)\n", ssid.c_str(),
+                      rtc_wifi.channel, useLease ? ", static lease" : "");
+
+        xEventGroupClearBits(s_wifiEvents, BIT_GOT_IP | BIT_DISCONNECTED);
+        WiFi.begin(ssid.c_str(), password.c_str(), rtc_wifi.channel, rtc_wifi.bssid);
+        if (waitForIP(min(FAST_TIMEOUT_MS, timeoutMs), true)) {
+            unsigned long dt = millis() - t0;
+            saveCache(hash, !useLease);
+            recordConnectTime(MODE_FAST, dt);
+            Serial.printf("[WiFi] ✓ IP %s in %lums (median fast %ums / full %ums)\n",
+                          WiFi.localIP().toString().c_str(), dt,
+                          medianConnectTime(MODE_FAST), medianConnectTime(MODE_FULL));
+            esp_wifi_set_ps(WIFI_PS_MIN_MODEM);  // modem sleep between polls
+            return true;
+        }
+
+        // AP moved / lease gone — forget it and do it the slow way
+        Serial.println("[WiFi] Fast connect failed — full scan");
+        rtc_wifi.magic = 0;
+        WiFi.disconnect();
+        if (useLease) {                 // 0.0.0.0 → back to DHCP
+            IPAddress none((uint32_t)0);
+            WiFi.config(none, none, none);
+        }
+    }
+
+    // --- Full path: scan + DHCP ---
+    Serial.printf("[WiFi] Connecting to %s\n", ssid.c_str());
+    unsigned long t1 = millis();
+    xEventGroupClearBits(s_wifiEvents, BIT_GOT_IP | BIT_DISCONNECTED);
+    WiFi.begin(ssid.c_str(), password.c_str());
+
+    unsigned long elapsed = millis() - t0;
+    unsigned long remaining = (elapsed < timeoutMs) ? timeoutMs - elapsed : 0;
+    if (remaining > 0 && waitForIP(remaining, false)) {
+        unsigned long dt = millis() - t1;
+        saveCache(hash, true);
+        recordConnectTime(MODE_FULL, dt);
+        Serial.printf("[WiFi] ✓ IP %s in %lums (median fast %ums / full %ums)\n",
+                      WiFi.localIP().toString().c_str(), dt,
+                      medianConnectTime(MODE_FAST), medianConnectTime(MODE_FULL));
+        esp_wifi_set_ps(WIFI_PS_MIN_MODEM);  // modem sleep between polls
+        Serial.println("[WiFi] Modem sleep enabled");
+        return true;
+    }
+    Serial.println("[WiFi] ✗ Failed");
+    return false;
+}
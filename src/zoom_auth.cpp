@@ -10,21 +10,40 @@
 // ============================================================================
 
 #include "zoom_auth.h"
-#include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
-#include <base64.h>
+#include <mbedtls/base64.h>
+#include "token_cache.h"
+#include "https_conn.h"
+#include "poll_arena.h"
 
 // ---- internal state -------------------------------------------------------
-static String       s_zoom_token   = "";
-static unsigned long s_zoom_expiry = 0;   // millis() when token expires
+#define ZOOM_TOKEN_MAX  2048       // S2S tokens are ~600–1000 bytes
+
+static char   s_zoom_token[ZOOM_TOKEN_MAX] = "";
+static time_t s_zoom_expiry = 0;   // time() when token expires
 
 // ============================================================================
-// Base64 encode client_id:client_secret for Basic auth
+// Authorization: Basic base64(client_id:client_secret)
 // ============================================================================
-static String makeBasicAuth(const String& clientId, const String& clientSecret) {
-    String raw = clientId + ":" + clientSecret;
-    return base64::encode(raw);
+static void addBasicAuth(HTTPClient& http, const String& clientId,
+                         const String& clientSecret) {
+    StrBuf raw(clientId.length() + 1 + clientSecret.length());
+    raw.print(clientId);
+    raw.print(':');
+    raw.print(clientSecret);
+
+    StrBuf auth(6 + 4 * ((raw.length() + 2) / 3));
+    auth.print("Basic ");
+    const uint8_t* src = (const uint8_t*)raw.c_str();
+    for (size_t off = 0; off < raw.length(); off += 48) {   // 48 in → 64 out
+        unsigned char out[65];
+        size_t olen = 0;
+        size_t n = raw.length() - off < 48 ? raw.length() - off : 48;
+        mbedtls_base64_encode(out, sizeof(out), &olen, src + off, n);
+        auth.write(out, olen);
+    }
+    http.addHeader("Authorization", auth.c_str());
 }
 
 // ============================================================================
@@ -36,41 +55,57 @@ bool zoomFetchToken(const String& accountId,
 {
     Serial.println("[Zoom] Fetching S2S token...");
 
-    WiFiClientSecure client;
-    client.setInsecure();   // TODO: pin root CA for prod
     HTTPClient http;
 
-    if (!http.begin(client, "https://zoom.us/oauth/token")) {
+    if (!httpsBegin(http, "https://zoom.us/oauth/token")) {
         Serial.println("[Zoom] http.begin failed");
         return false;
     }
 
     http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-    http.addHeader("Authorization", "Basic " + makeBasicAuth(clientId, clientSecret));
+    addBasicAuth(http, clientId, clientSecret);
 
-    String body = "grant_type=account_credentials&account_id=" + accountId;
-
-    int httpCode = http.POST(body);
-    String payload = http.getString();
-    http.end();
+    StrBuf body(48 + accountId.length());
+    body.print("grant_type=account_credentials&account_id=");
+    body.print(accountId);
 
+    int httpCode = httpsSend(http, "POST", body.c_str(), body.length());
     Serial.printf("[Zoom] HTTP %d\n", httpCode);
 
     if (httpCode != 200) {
-        Serial.printf("[Zoom] Token request failed: %s\n", payload.c_str());
-        s_zoom_token = "";
+        StrBuf err(256);
+        httpsReadError(http, err);
+        httpsEnd(http);
+        Serial.printf("[Zoom] Token request failed: %s\n", err.c_str());
+        s_zoom_token[0] = '\0';
         return false;
     }
 
-    DynamicJsonDocument doc(2048);
-    if (deserializeJson(doc, payload)) {
-        Serial.println("[Zoom] JSON parse error");
+    // Skip scope / api_url while reading; only the token is kept
+    StaticJsonDocument<64> filter;
+    filter["access_token"] = true;
+    filter["expires_in"]   = true;
+    ArenaJsonDocument doc(ZOOM_TOKEN_MAX + 128);
+    HttpsBody resp(http);
+    DeserializationError err = deserializeJson(doc, resp,
+                                               DeserializationOption::Filter(filter));
+    resp.drain();
+    httpsEnd(http);
+    if (err) {
+        Serial.printf("[Zoom] JSON parse error: %s\n", err.c_str());
         return false;
     }
 
-    s_zoom_token  = doc["access_token"].as<String>();
+    const char* tok = doc["access_token"] | "";
+    size_t len = strlen(tok);
+    if (len == 0 || len >= sizeof(s_zoom_token)) {
+        Serial.printf("[Zoom] Bad token length %u\n", (unsigned)len);
+        return false;
+    }
+    memcpy(s_zoom_token, tok, len + 1);
     int expiresIn = doc["expires_in"] | 3600;
-    s_zoom_expiry = millis() + (unsigned long)expiresIn * 1000UL;
+    s_zoom_expiry = time(nullptr) + expiresIn;
+    tokenCacheStore(TOKEN_SLOT_ZOOM, s_zoom_token, s_zoom_expiry);
 
     Serial.printf("[Zoom] ✓ Token acquired (expires in %ds)\n", expiresIn);
     return true;
@@ -79,14 +114,29 @@ bool zoomFetchToken(const String& accountId,
 // ============================================================================
 // Accessors
 // ============================================================================
-String zoomGetAccessToken()       { return s_zoom_token; }
-bool   zoomHasValidToken()        { return !s_zoom_token.isEmpty() && millis() < s_zoom_expiry; }
+const char* zoomGetAccessToken()  { return s_zoom_token; }
+bool   zoomHasValidToken()        { return s_zoom_token[0] != '\0' && time(nullptr) < s_zoom_expiry; }
 bool   zoomIsTokenExpiringSoon()  {
     if (s_zoom_expiry == 0) return false;
-    unsigned long now = millis();
-    return (now >= s_zoom_expiry) || (s_zoom_expiry - now < 300000UL);  // 5 min
+    return time(nullptr) + 300 >= s_zoom_expiry;  // 5 min
 }
 long   zoomGetTokenExpirySeconds() {
     if (s_zoom_expiry == 0) return 0;
-    return (long)(s_zoom_expiry - millis()) / 1000L;
+    return (long)(s_zoom_expiry - time(nullptr));
+}
+
+// ============================================================================
+// Deep-sleep token cache
+// ============================================================================
+bool zoomLoadCachedToken() {
+    if (!tokenCacheLoad(TOKEN_SLOT_ZOOM, s_zoom_token, sizeof(s_zoom_token), s_zoom_expiry))
+        return false;
+    Serial.printf("[Zoom] Cached token valid for %lds\n", zoomGetTokenExpirySeconds());
+    return true;
+}
+
+void zoomInvalidateToken() {
+    s_zoom_token[0] = '\0';
+    s_zoom_expiry = 0;
+    tokenCacheClear(TOKEN_SLOT_ZOOM);
 }